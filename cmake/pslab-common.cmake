@@ -11,6 +11,22 @@ endif()
 set(CMAKE_C_STANDARD 23)
 set(CMAKE_C_STANDARD_REQUIRED ON)
 
+# USB buffer sizes, in bytes. The TinyUSB CDC FIFOs must hold at least two
+# endpoint transfers, and the application buffers must be powers of 2. See
+# doc/bus_architecture_design.md for the theoretical throughput of each
+# setting.
+set(PSLAB_USB_CDC_EP_BUFSIZE 64 CACHE STRING
+    "Largest CDC transfer, a multiple of the 64-byte packet size")
+set(PSLAB_USB_CDC_RX_FIFO_SIZE 256 CACHE STRING "TinyUSB CDC RX FIFO size")
+set(PSLAB_USB_CDC_TX_FIFO_SIZE 256 CACHE STRING "TinyUSB CDC TX FIFO size")
+set(PSLAB_USB_RX_BUFFER_SIZE 512 CACHE STRING "SCPI USB RX buffer size")
+set(PSLAB_USB_TX_BUFFER_SIZE 512 CACHE STRING "SCPI USB TX buffer size")
+
+# What the second CDC interface of the USB device carries: the log (LOG), or a
+# bridge to UART bus 0 (UART), in which case the log stays on UART bus 2
+set(PSLAB_USB_CONSOLE LOG CACHE STRING "USB console function: LOG or UART")
+set_property(CACHE PSLAB_USB_CONSOLE PROPERTY STRINGS LOG UART)
+
 # Common source formatting and linting targets
 function(setup_code_quality_targets)
     # Glob all C source files in the current directory and subdirectories
@@ -5,14 +5,46 @@
 #define CFG_TUSB_MCU            OPT_MCU_STM32H5
 #define CFG_TUSB_RHPORT0_MODE   OPT_MODE_DEVICE
 
-// Enable only CDC (virtual COM port)
-#define CFG_TUD_CDC             1
+// CDC (virtual COM port) and USBTMC/USB488 for SCPI, a second CDC for the
+// console, vendor class bulk pipe for streaming
+#define CFG_TUD_CDC             2
 #define CFG_TUD_MSC             0
 #define CFG_TUD_HID             0
-#define CFG_TUD_VENDOR          0
+#define CFG_TUD_VENDOR          1
+#define CFG_TUD_USBTMC          1
+#define CFG_TUD_USBTMC_ENABLE_488 1
 
 #define CFG_TUD_ENDPOINT0_SIZE  64
-#define CFG_TUD_CDC_RX_BUFSIZE  64
-#define CFG_TUD_CDC_TX_BUFSIZE  64
+
+// CDC FIFO sizes are set from CMake (PSLAB_USB_CDC_*). The FSDEV driver
+// uses a single packet buffer per bulk endpoint. Each transfer moves up to
+// EP_BUFSIZE bytes as a run of packets refilled from the interrupt handler,
+// and the FIFOs hold two transfers, so that the application can fill or
+// drain one while the other is in flight. An OUT transfer longer than a
+// packet only ends early on a short packet, so commands that end on a packet
+// boundary wait for more data.
+#ifndef CFG_TUD_CDC_EP_BUFSIZE
+#define CFG_TUD_CDC_EP_BUFSIZE  64
+#endif
+#ifndef CFG_TUD_CDC_RX_BUFSIZE
+#define CFG_TUD_CDC_RX_BUFSIZE  256
+#endif
+#ifndef CFG_TUD_CDC_TX_BUFSIZE
+#define CFG_TUD_CDC_TX_BUFSIZE  256
+#endif
+
+#if CFG_TUD_CDC_EP_BUFSIZE % 64 != 0
+#error "CFG_TUD_CDC_EP_BUFSIZE must be a multiple of the 64-byte packet size"
+#endif
+#if CFG_TUD_CDC_RX_BUFSIZE < 2 * CFG_TUD_CDC_EP_BUFSIZE || \
+    CFG_TUD_CDC_TX_BUFSIZE < 2 * CFG_TUD_CDC_EP_BUFSIZE
+#error "CDC FIFOs must hold two endpoint transfers"
+#endif
+
+// Each vendor transfer moves up to EPSIZE bytes as a run of 64-byte packets,
+// refilled from a FIFO deep enough to keep the endpoint busy
+#define CFG_TUD_VENDOR_EPSIZE       512
+#define CFG_TUD_VENDOR_RX_BUFSIZE   512
+#define CFG_TUD_VENDOR_TX_BUFSIZE   2048
 
 #endif  // TUSB_CONFIG_H
@@ -1,10 +1,99 @@
+#include <stdint.h>
 
 #include "protocol.h"
+#include "system/adc_arbiter.h"
 #include "system/led.h"
+#include "system/scheduler.h"
 #include "system/system.h"
 #include "util/error.h"
 #include "util/logging.h"
 
+enum {
+    // USB_task must run at least once per millisecond; USB interrupts also
+    // signal the task when they wake the CPU
+    PROTOCOL_TASK_PERIOD_US = 1000,
+    PROTOCOL_TASK_DEADLINE_US = 1000,
+    ARBITER_TASK_PERIOD_US = 1000,
+    ARBITER_TASK_DEADLINE_US = 2000,
+    BOOT_TASK_PERIOD_US = 1000,
+    LOG_TASK_PERIOD_US = 10000,
+    CONSOLE_TASK_PERIOD_US = 1000,
+    LED_TASK_PERIOD_US = 1000000, // 1 second
+    PERF_TASK_PERIOD_US = 1000000, // CPU load accounting window
+    LOG_TASK_MAX_ENTRIES = 0xF,
+};
+
+static void protocol_task_entry(void *context)
+{
+    (void)context;
+    protocol_task();
+}
+
+static void arbiter_task_entry(void *context)
+{
+    (void)context;
+    // Hand the ADC over between instrument sessions
+    ADC_ARB_task();
+}
+
+static void log_task_entry(void *context)
+{
+    (void)context;
+    LOG_task(LOG_TASK_MAX_ENTRIES);
+}
+
+static void console_task_entry(void *context)
+{
+    (void)context;
+    SYSTEM_console_task();
+}
+
+static void led_task_entry(void *context)
+{
+    (void)context;
+    LED_toggle(LED_YELLOW);
+}
+
+static SCHED_Task *g_boot_task = nullptr;
+
+static void boot_task_entry(void *context)
+{
+    (void)context;
+
+    if (!SYSTEM_boot_task()) {
+        return;
+    }
+
+    // Log output, the USB console and the status LED only exist after the
+    // deferred init; the boot task has nothing left to do
+    SCHED_remove_task(g_boot_task);
+    g_boot_task = nullptr;
+    SCHED_add_task(&(SCHED_TaskConfig){
+        .name = "log",
+        .function = log_task_entry,
+        .priority = SCHED_PRIORITY_LOW,
+        .period_us = LOG_TASK_PERIOD_US,
+    });
+    SCHED_add_task(&(SCHED_TaskConfig){
+        .name = "console",
+        .function = console_task_entry,
+        .priority = SCHED_PRIORITY_LOW,
+        .period_us = CONSOLE_TASK_PERIOD_US,
+    });
+    SCHED_add_task(&(SCHED_TaskConfig){
+        .name = "led",
+        .function = led_task_entry,
+        .priority = SCHED_PRIORITY_LOW,
+        .period_us = LED_TASK_PERIOD_US,
+    });
+}
+
+static void perf_task_entry(void *context)
+{
+    (void)context;
+    SYSTEM_perf_task();
+}
+
 int main(void)
 {
     SYSTEM_init();
@@ -13,23 +102,48 @@ int main(void)
     // Initialize the protocol
     if (!protocol_init()) {
         LOG_ERROR("Failed to initialize protocol");
+        // Bring up the log output without waiting for USB so that the error
+        // does not stay in the log buffer
+        SYSTEM_boot_finish();
+        LOG_task(UINT32_MAX);
         return -1;
     }
+    SYSTEM_boot_mark(SYSTEM_BOOT_USB_INIT);
 
-    // Main application loop
-    while (1) {
-        // Process protocol tasks
-        protocol_task();
+    SCHED_init();
 
-        LOG_task(0xF);
+    SCHED_Task *protocol = SCHED_add_task(&(SCHED_TaskConfig){
+        .name = "protocol",
+        .function = protocol_task_entry,
+        .priority = SCHED_PRIORITY_HIGH,
+        .period_us = PROTOCOL_TASK_PERIOD_US,
+        .deadline_us = PROTOCOL_TASK_DEADLINE_US,
+    });
+    SCHED_Task *arbiter = SCHED_add_task(&(SCHED_TaskConfig){
+        .name = "adc_arbiter",
+        .function = arbiter_task_entry,
+        .priority = SCHED_PRIORITY_NORMAL,
+        .period_us = ARBITER_TASK_PERIOD_US,
+        .deadline_us = ARBITER_TASK_DEADLINE_US,
+    });
+    g_boot_task = SCHED_add_task(&(SCHED_TaskConfig){
+        .name = "boot",
+        .function = boot_task_entry,
+        .priority = SCHED_PRIORITY_LOW,
+        .period_us = BOOT_TASK_PERIOD_US,
+    });
+    SCHED_add_task(&(SCHED_TaskConfig){
+        .name = "perf",
+        .function = perf_task_entry,
+        .priority = SCHED_PRIORITY_LOW,
+        .period_us = PERF_TASK_PERIOD_US,
+    });
 
-        static uint32_t last_toggle = 0;
-        uint32_t const blink_period = 1000; // 1 second
-        if (SYSTEM_get_tick() - last_toggle >= blink_period) {
-            LED_toggle(LED_YELLOW);
-            last_toggle = SYSTEM_get_tick();
-        }
-    }
+    // Sleep when idle; service USB traffic and finished acquisitions as soon
+    // as their interrupts wake the CPU
+    SYSTEM_set_wake_task(SYSTEM_WAKE_USB, protocol);
+    SYSTEM_set_wake_task(SYSTEM_WAKE_DMA, arbiter);
+    SCHED_set_idle_hook(SYSTEM_idle);
 
-    __builtin_unreachable();
+    SCHED_run();
 }
@@ -37,7 +37,10 @@ void protocol_deinit(void);
  * @brief Main protocol task
  *
  * This function should be called periodically (typically in the main loop)
- * to process incoming USB data and handle SCPI commands.
+ * to process incoming USB data and handle SCPI commands. Pending input is
+ * read until 512 bytes have been read or 250 us have passed per transport
+ * and call; the rest waits for the next call. These limits bound the input
+ * read, not the time its commands take to run.
  */
 void protocol_task(void);
 
@@ -4,10 +4,17 @@
  *
  * This module implements the common SCPI protocol infrastructure including
  * USB communication, SCPI context management, and IEEE 488.2 commands.
+ *
+ * SCPI is served on two USB transports at once: the CDC virtual serial port
+ * and the USBTMC/USB488 interface used by VISA. Each transport has its own
+ * SCPI context, with its own input buffer, error queue and status registers,
+ * over the same command tree. On USBTMC, the end of each response is marked
+ * with EOM, and service requests are sent on the interrupt endpoint.
  */
 
 #include "protocol.h"
 
+#include <assert.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -15,18 +22,58 @@
 #include "lib/scpi/scpi.h"
 
 #include "system/bus/usb.h"
+#include "system/bus/usbtmc.h"
 #include "system/system.h"
 #include "util/error.h"
+#include "util/logging.h"
 #include "util/util.h"
 
+// CDC buffer sizes, set from CMake (PSLAB_USB_RX/TX_BUFFER_SIZE)
+#ifndef PSLAB_USB_RX_BUFFER_SIZE
+#define PSLAB_USB_RX_BUFFER_SIZE 512
+#endif
+#ifndef PSLAB_USB_TX_BUFFER_SIZE
+#define PSLAB_USB_TX_BUFFER_SIZE 512
+#endif
+
 // Buffer sizes for USB communication (internal to this module)
 enum {
-    USB_RX_BUFFER_SIZE = 512,
-    USB_TX_BUFFER_SIZE = 512,
+    USB_RX_BUFFER_SIZE = PSLAB_USB_RX_BUFFER_SIZE,
+    USB_TX_BUFFER_SIZE = PSLAB_USB_TX_BUFFER_SIZE,
+    TMC_RX_BUFFER_SIZE = 512,
+    TMC_TX_BUFFER_SIZE = 512,
     SCPI_INPUT_BUFFER_SIZE = 256,
     SCPI_ERROR_QUEUE_SIZE = 16
 };
 
+static_assert(
+    (USB_RX_BUFFER_SIZE & (USB_RX_BUFFER_SIZE - 1)) == 0 &&
+        (USB_TX_BUFFER_SIZE & (USB_TX_BUFFER_SIZE - 1)) == 0,
+    "USB buffer sizes must be powers of 2"
+);
+
+// Give up on a response if the host stops reading it for this long
+enum { PROTOCOL_WRITE_TIMEOUT_MS = 1000 };
+
+// Input read per transport and protocol_task call, so that bursts of
+// pipelined commands are handled in one call. The budget bounds how much
+// input is read, not how long the commands in it take to run: it is checked
+// between chunks, and every command completed by a chunk runs before the
+// check. Each transport has its own share, so that a busy CDC host cannot
+// hold back USBTMC input, or the other way round.
+enum {
+    PROTOCOL_READ_CHUNK_SIZE = 64, // One full-speed packet
+    PROTOCOL_DRAIN_MAX_BYTES = 512,
+    PROTOCOL_DRAIN_MAX_US = 250,
+};
+
+/**
+ * @brief Read input of a SCPI transport
+ *
+ * @return Number of bytes read, 0 if no input is pending
+ */
+typedef uint32_t (*ProtocolReadFn)(uint8_t *buf, uint32_t size);
+
 // Forward declarations of DMM functions needed by common
 extern scpi_result_t scpi_cmd_configure_voltage_dc(scpi_t *context);
 extern scpi_result_t scpi_cmd_initiate_voltage_dc(scpi_t *context);
@@ -50,8 +97,15 @@ extern scpi_result_t scpi_cmd_configure_oscilloscope_acquire_points_q(
 extern scpi_result_t scpi_cmd_configure_oscilloscope_acquire_srate_q(
     scpi_t *context
 );
+extern scpi_result_t scpi_cmd_configure_oscilloscope_resolution(
+    scpi_t *context
+);
+extern scpi_result_t scpi_cmd_configure_oscilloscope_resolution_q(
+    scpi_t *context
+);
 extern scpi_result_t scpi_cmd_initiate_oscilloscope(scpi_t *context);
 extern scpi_result_t scpi_cmd_fetch_oscilloscope_data_q(scpi_t *context);
+extern scpi_result_t scpi_cmd_fetch_oscilloscope_bulk_q(scpi_t *context);
 extern scpi_result_t scpi_cmd_read_oscilloscope_q(scpi_t *context);
 extern scpi_result_t scpi_cmd_measure_oscilloscope_q(scpi_t *context);
 extern scpi_result_t scpi_cmd_abort_oscilloscope(scpi_t *context);
@@ -59,6 +113,13 @@ extern scpi_result_t scpi_cmd_status_oscilloscope_acquisition_q(scpi_t *context
 );
 extern void dso_reset_state(void);
 
+// Forward declarations of SYSTem diagnostics commands
+extern scpi_result_t scpi_cmd_system_idle_q(scpi_t *context);
+extern scpi_result_t scpi_cmd_system_idle_reset(scpi_t *context);
+extern scpi_result_t scpi_cmd_system_performance_q(scpi_t *context);
+extern scpi_result_t scpi_cmd_system_performance_reset(scpi_t *context);
+extern scpi_result_t scpi_cmd_system_boot_timing_q(scpi_t *context);
+
 // Static storage for buffers
 static uint8_t g_usb_rx_buffer_data[USB_RX_BUFFER_SIZE];
 static uint8_t g_usb_tx_buffer_data[USB_TX_BUFFER_SIZE];
@@ -71,9 +132,21 @@ static scpi_t g_scpi_context;
 static char g_scpi_input_buffer[SCPI_INPUT_BUFFER_SIZE];
 static scpi_error_t g_scpi_error_queue_data[SCPI_ERROR_QUEUE_SIZE];
 
+// USBTMC transport buffers and SCPI context
+static uint8_t g_tmc_rx_buffer_data[TMC_RX_BUFFER_SIZE];
+static uint8_t g_tmc_tx_buffer_data[TMC_TX_BUFFER_SIZE];
+static CircularBuffer g_tmc_rx_buffer;
+static CircularBuffer g_tmc_tx_buffer;
+static scpi_t g_scpi_tmc_context;
+static char g_scpi_tmc_input_buffer[SCPI_INPUT_BUFFER_SIZE];
+static scpi_error_t g_scpi_tmc_error_queue_data[SCPI_ERROR_QUEUE_SIZE];
+
 // Protocol state (internal to common.c)
 static bool g_protocol_initialized = false;
 
+// Block to send without copying, see protocol_register_block
+static USB_TxBlock g_zero_copy_block = { 0 };
+
 /**
  * @brief USB RX callback - called when data is received
  */
@@ -84,8 +157,97 @@ static void usb_rx_callback(USB_Handle *handle, uint32_t bytes_available)
     // Data processing will happen in the main protocol task
 }
 
+/**
+ * @brief Wait until no zero-copy block is queued
+ *
+ * Keeps stepping the USB stack while the host reads the block.
+ *
+ * @return true once the block has been released, false if the host has not
+ *         read it within PROTOCOL_WRITE_TIMEOUT_MS
+ */
+bool protocol_wait_block(void)
+{
+    if (!g_usb_handle || !USB_tx_block_pending(g_usb_handle)) {
+        return true;
+    }
+
+    uint32_t const start = SYSTEM_get_tick();
+
+    while (USB_tx_block_pending(g_usb_handle)) {
+        if (SYSTEM_get_tick() - start > PROTOCOL_WRITE_TIMEOUT_MS) {
+            return false;
+        }
+        USB_task(g_usb_handle);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Register a block to be sent without copying
+ *
+ * The next SCPI write of exactly this memory, such as the data part of
+ * SCPI_ResultArbitraryBlock, is handed to the USB layer as a descriptor
+ * instead of being copied into the TX buffer. The memory must stay unchanged
+ * until the callback runs; the callback also runs if the write fails.
+ *
+ * @param data First byte of the block
+ * @param size Number of bytes
+ * @param callback Called once the USB layer has released the memory
+ * @param context User context passed to the callback
+ */
+void protocol_register_block(
+    void const *data,
+    size_t size,
+    USB_TxBlockCallback callback,
+    void *context
+)
+{
+    g_zero_copy_block = (USB_TxBlock){
+        .data = data,
+        .size = (uint32_t)size,
+        .callback = callback,
+        .context = context,
+    };
+}
+
+/**
+ * @brief Queue the registered zero-copy block
+ *
+ * @return Number of bytes queued, 0 on failure
+ */
+static size_t protocol_write_block(void)
+{
+    USB_TxBlock const block = g_zero_copy_block;
+    g_zero_copy_block = (USB_TxBlock){ 0 };
+
+    Error error = ERROR_NONE;
+    TRY
+    {
+        // Only one block can be queued at a time
+        if (!protocol_wait_block()) {
+            THROW(ERROR_TIMEOUT);
+        }
+        USB_write_block(g_usb_handle, &block);
+    }
+    CATCH(error)
+    {
+        LOG_ERROR("Protocol: block write failed: %s", error_to_string(error));
+        if (block.callback) {
+            block.callback(block.context, false);
+        }
+        return 0;
+    }
+
+    return block.size;
+}
+
 /**
  * @brief SCPI write function - sends data via USB
+ *
+ * Waits for the host to read responses that do not fit in the TX buffer, such
+ * as large arbitrary blocks, so that they are never truncated. A block
+ * registered with protocol_register_block is queued without copying.
  */
 static size_t protocol_write(scpi_t *context, char const *data, size_t len)
 {
@@ -95,7 +257,119 @@ static size_t protocol_write(scpi_t *context, char const *data, size_t len)
         return 0;
     }
 
-    return USB_write(g_usb_handle, (uint8_t const *)data, (uint32_t)len);
+    if (g_zero_copy_block.data != nullptr &&
+        (uint8_t const *)data == g_zero_copy_block.data &&
+        len == g_zero_copy_block.size) {
+        return protocol_write_block();
+    }
+
+    Error error = ERROR_NONE;
+    TRY
+    {
+        USB_write_all(
+            g_usb_handle,
+            (uint8_t const *)data,
+            (uint32_t)len,
+            PROTOCOL_WRITE_TIMEOUT_MS
+        );
+    }
+    CATCH(error)
+    {
+        LOG_ERROR("Protocol: write failed: %s", error_to_string(error));
+        return 0;
+    }
+
+    return len;
+}
+
+/**
+ * @brief SCPI flush function - sends the end of the response right away
+ *
+ * The parser flushes after the newline that ends each response.
+ */
+static scpi_result_t protocol_flush(scpi_t *context)
+{
+    (void)context; // Unused parameter
+
+    if (g_usb_handle) {
+        USB_tx_flush(g_usb_handle);
+    }
+    return SCPI_RES_OK;
+}
+
+/**
+ * @brief SCPI write function for USBTMC
+ *
+ * USBTMC responses are sent from the transport's TX buffer, so a registered
+ * zero-copy block is copied like any other data and released right away.
+ */
+static size_t protocol_tmc_write(scpi_t *context, char const *data, size_t len)
+{
+    (void)context; // Unused parameter
+
+    USB_TxBlock const block = g_zero_copy_block;
+    bool const is_block = block.data != nullptr &&
+                          (uint8_t const *)data == block.data &&
+                          len == block.size;
+    if (is_block) {
+        g_zero_copy_block = (USB_TxBlock){ 0 };
+    }
+
+    Error error = ERROR_NONE;
+    TRY
+    {
+        USBTMC_write_all(
+            (uint8_t const *)data, (uint32_t)len, PROTOCOL_WRITE_TIMEOUT_MS
+        );
+    }
+    CATCH(error)
+    {
+        LOG_ERROR("Protocol: USBTMC write failed: %s", error_to_string(error));
+    }
+
+    if (is_block && block.callback) {
+        block.callback(block.context, error == ERROR_NONE);
+    }
+
+    return error == ERROR_NONE ? len : 0;
+}
+
+/**
+ * @brief SCPI flush function for USBTMC - ends the response message
+ *
+ * The parser flushes after the newline that ends each response.
+ */
+static scpi_result_t protocol_tmc_flush(scpi_t *context)
+{
+    (void)context; // Unused parameter
+    USBTMC_end_message();
+    return SCPI_RES_OK;
+}
+
+/**
+ * @brief SCPI control function for USBTMC - forwards service requests
+ */
+static scpi_result_t protocol_tmc_control(
+    scpi_t *context,
+    scpi_ctrl_name_t ctrl,
+    scpi_reg_val_t val
+)
+{
+    (void)context; // Unused parameter
+
+    if (ctrl == SCPI_CTRL_SRQ) {
+        USBTMC_request_service((uint8_t)val);
+    }
+
+    return SCPI_RES_OK;
+}
+
+/**
+ * @brief USBTMC status byte callback
+ */
+static uint8_t protocol_tmc_status(void)
+{
+    return (uint8_t)SCPI_RegGet(&g_scpi_tmc_context, SCPI_REG_STB);
 }
 
 /**
@@ -119,7 +393,16 @@ static scpi_interface_t g_scpi_interface = {
     .error = nullptr,
     .write = protocol_write,
     .control = nullptr,
-    .flush = nullptr,
+    .flush = protocol_flush,
+    .reset = protocol_reset,
+};
+
+// SCPI interface implementation for USBTMC
+static scpi_interface_t g_scpi_tmc_interface = {
+    .error = nullptr,
+    .write = protocol_tmc_write,
+    .control = protocol_tmc_control,
+    .flush = protocol_tmc_flush,
     .reset = protocol_reset,
 };
 
@@ -145,6 +428,13 @@ static scpi_command_t const g_SCPI_COMMANDS[] = {
     { "SYSTem:ERRor:COUNt?", SCPI_SystemErrorCountQ },
     { "SYSTem:VERSion?", SCPI_SystemVersionQ },
 
+    // SYSTem diagnostics commands
+    { "SYSTem:IDLE?", scpi_cmd_system_idle_q },
+    { "SYSTem:IDLE:RESet", scpi_cmd_system_idle_reset },
+    { "SYSTem:PERFormance?", scpi_cmd_system_performance_q },
+    { "SYSTem:PERFormance:RESet", scpi_cmd_system_performance_reset },
+    { "SYSTem:BOOT:TIMing?", scpi_cmd_system_boot_timing_q },
+
     // DMM commands (Digital Multimeter)
     { "DMM:CONFigure[:VOLTage][:DC]", scpi_cmd_configure_voltage_dc },
     { "DMM:INITiate[:VOLTage][:DC]", scpi_cmd_initiate_voltage_dc },
@@ -167,8 +457,13 @@ static scpi_command_t const g_SCPI_COMMANDS[] = {
       scpi_cmd_configure_oscilloscope_acquire_points_q },
     { "OSCilloscope:CONFigure:ACQuire:SRATe?",
       scpi_cmd_configure_oscilloscope_acquire_srate_q },
+    { "OSCilloscope:CONFigure:RESolution",
+      scpi_cmd_configure_oscilloscope_resolution },
+    { "OSCilloscope:CONFigure:RESolution?",
+      scpi_cmd_configure_oscilloscope_resolution_q },
     { "OSCilloscope:INITiate", scpi_cmd_initiate_oscilloscope },
     { "OSCilloscope:FETCh[:DATa]?", scpi_cmd_fetch_oscilloscope_data_q },
+    { "OSCilloscope:FETCh:BULK?", scpi_cmd_fetch_oscilloscope_bulk_q },
     { "OSCilloscope:READ?", scpi_cmd_read_oscilloscope_q },
     { "OSCilloscope:MEASure?", scpi_cmd_measure_oscilloscope_q },
     { "OSCilloscope:ABORt", scpi_cmd_abort_oscilloscope },
@@ -222,6 +517,38 @@ bool protocol_init(void)
         SCPI_ERROR_QUEUE_SIZE
     );
 
+    // Initialize the USBTMC context and transport; CDC works without it
+    SCPI_Init(
+        &g_scpi_tmc_context,
+        g_SCPI_COMMANDS,
+        &g_scpi_tmc_interface,
+        scpi_units_def,
+        "FOSSASIA",
+        "PSLab",
+        "1.0",
+        "v1.0.0",
+        g_scpi_tmc_input_buffer,
+        SCPI_INPUT_BUFFER_SIZE,
+        g_scpi_tmc_error_queue_data,
+        SCPI_ERROR_QUEUE_SIZE
+    );
+    circular_buffer_init(
+        &g_tmc_rx_buffer, g_tmc_rx_buffer_data, TMC_RX_BUFFER_SIZE
+    );
+    circular_buffer_init(
+        &g_tmc_tx_buffer, g_tmc_tx_buffer_data, TMC_TX_BUFFER_SIZE
+    );
+
+    Error error = ERROR_NONE;
+    TRY
+    {
+        USBTMC_init(&g_tmc_rx_buffer, &g_tmc_tx_buffer, protocol_tmc_status);
+    }
+    CATCH(error)
+    {
+        LOG_ERROR("Protocol: USBTMC init failed: %s", error_to_string(error));
+    }
+
     g_protocol_initialized = true;
     return true;
 }
@@ -240,13 +567,74 @@ void protocol_deinit(void)
         USB_deinit(g_usb_handle);
         g_usb_handle = nullptr;
     }
+    USBTMC_deinit();
 
     protocol_reset((scpi_t *)0);
     g_protocol_initialized = false;
 }
 
+/**
+ * @brief Read input from the CDC interface
+ */
+static uint32_t protocol_cdc_read(uint8_t *buf, uint32_t size)
+{
+    if (!USB_rx_ready(g_usb_handle)) {
+        return 0;
+    }
+    return USB_read(g_usb_handle, buf, size);
+}
+
+/**
+ * @brief Read input from the USBTMC interface
+ */
+static uint32_t protocol_tmc_read(uint8_t *buf, uint32_t size)
+{
+    if (USBTMC_rx_available() == 0) {
+        return 0;
+    }
+    return USBTMC_read(buf, size);
+}
+
+/**
+ * @brief Feed pending input of a transport to its SCPI parser
+ *
+ * Reads chunks until no input is left, or PROTOCOL_DRAIN_MAX_BYTES have been
+ * read, or PROTOCOL_DRAIN_MAX_US have passed. Each command runs as soon as the
+ * parser sees the end of its message, so a call can overrun the time budget
+ * by the commands in its last chunk. A message cut short by the budget is
+ * completed on the next call.
+ *
+ * @param context SCPI context of the transport
+ * @param read Input source of the transport
+ */
+static void protocol_drain(scpi_t *context, ProtocolReadFn read)
+{
+    uint8_t buffer[PROTOCOL_READ_CHUNK_SIZE];
+    uint64_t const start_us = SYSTEM_get_time_us();
+    uint32_t budget = PROTOCOL_DRAIN_MAX_BYTES;
+
+    while (budget > 0) {
+        uint32_t const size =
+            budget < sizeof(buffer) ? budget : (uint32_t)sizeof(buffer);
+        uint32_t const bytes_read = read(buffer, size);
+        if (bytes_read == 0) {
+            return;
+        }
+
+        budget -= bytes_read;
+        SCPI_Input(context, (char *)buffer, (int)bytes_read);
+
+        if (SYSTEM_get_time_us() - start_us >= PROTOCOL_DRAIN_MAX_US) {
+            return;
+        }
+    }
+}
+
 /**
  * @brief Main protocol task - processes USB data and SCPI commands
+ *
+ * Each transport is drained within its own budget; input left over waits for
+ * the next call.
  */
 void protocol_task(void)
 {
@@ -258,15 +646,11 @@ void protocol_task(void)
     USB_task(g_usb_handle);
 
     // Process incoming USB data
-    if (USB_rx_ready(g_usb_handle)) {
-        uint8_t buffer[64];
-        uint32_t bytes_read = USB_read(g_usb_handle, buffer, sizeof(buffer));
+    protocol_drain(&g_scpi_context, protocol_cdc_read);
 
-        if (bytes_read > 0) {
-            // Feed data to SCPI parser
-            SCPI_Input(&g_scpi_context, (char *)buffer, (int)bytes_read);
-        }
-    }
+    // Process incoming USBTMC messages, stepped by USB_task above
+    USBTMC_task();
+    protocol_drain(&g_scpi_tmc_context, protocol_tmc_read);
 }
 
 /**
@@ -13,6 +13,8 @@
 #include "lib/scpi/error.h"
 #include "lib/scpi/scpi.h"
 
+#include "system/bus/usb.h"
+#include "system/bus/usb_stream.h"
 #include "system/instrument/dso.h"
 #include "system/system.h"
 #include "util/error.h"
@@ -23,8 +25,30 @@ enum {
     TIMEBASE_DEFAULT = 100, // 100 µs / div
     BUFFER_SIZE_DEFAULT = 512,
     HORIZONTAL_DIVISIONS = 10, // Standard oscilloscope divisions
+    BULK_TIMEOUT_MS = 1000, // Longest the host may stall the bulk pipe
 };
 
+// Bits per sample of each DSO resolution
+static uint32_t const g_RESOLUTION_BITS[] = {
+    [DSO_RESOLUTION_12BIT] = 12,
+    [DSO_RESOLUTION_10BIT] = 10,
+    [DSO_RESOLUTION_8BIT] = 8,
+    [DSO_RESOLUTION_6BIT] = 6,
+};
+
+enum {
+    RESOLUTION_COUNT = sizeof(g_RESOLUTION_BITS) / sizeof(g_RESOLUTION_BITS[0])
+};
+
+// Zero-copy output (implemented in common.c)
+extern void protocol_register_block(
+    void const *data,
+    size_t size,
+    USB_TxBlockCallback callback,
+    void *context
+);
+extern bool protocol_wait_block(void);
+
 // DSO state (internal to this module)
 static struct {
     DSO_Handle *dso_handle;
@@ -32,12 +56,14 @@ static struct {
     uint32_t acquisition_buffer_size;
     uint32_t timebase_us;
     bool acquisition_complete;
+    bool buffer_locked; // Buffer is being sent to the host
 } g_dso_state = {
     .dso_handle = nullptr,
     .acquisition_buffer = nullptr,
     .acquisition_buffer_size = 0,
     .timebase_us = TIMEBASE_DEFAULT,
     .acquisition_complete = false,
+    .buffer_locked = false,
 };
 
 /**
@@ -45,6 +71,46 @@ static struct {
  */
 void dso_complete_callback(void) { g_dso_state.acquisition_complete = true; }
 
+/**
+ * @brief Transfer callback - called when the host has read the buffer
+ *
+ * @param context The buffer that was sent
+ * @param completed true if the whole buffer was sent
+ */
+static void dso_transfer_callback(void *context, bool completed)
+{
+    if (!completed) {
+        LOG_WARN("DSO: waveform transfer aborted");
+    }
+
+    // A reset while the buffer was being sent left it for us to free
+    if (context != g_dso_state.acquisition_buffer) {
+        free(context);
+        return;
+    }
+
+    g_dso_state.buffer_locked = false;
+}
+
+/**
+ * @brief Wait until the host has read the acquisition buffer
+ *
+ * FETCh sends the buffer without copying it, so it must not be refilled,
+ * resized or freed until the transfer has completed.
+ *
+ * @param context SCPI context for error reporting
+ * @return SCPI_RES_OK once the buffer is free, SCPI_RES_ERR if the host has
+ *         stopped reading
+ */
+static scpi_result_t wait_for_buffer(scpi_t *context)
+{
+    if (g_dso_state.buffer_locked && !protocol_wait_block()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+    return SCPI_RES_OK;
+}
+
 /**
  * @brief Reset DSO state to default values
  */
@@ -57,12 +123,17 @@ void dso_reset_state(void)
         g_dso_state.dso_handle = nullptr;
     }
 
-    // Free acquisition buffer if allocated
+    // Free acquisition buffer if allocated. If it is still being sent, the
+    // transfer callback frees it instead.
     if (g_dso_state.acquisition_buffer) {
-        free(g_dso_state.acquisition_buffer);
+        if (!g_dso_state.buffer_locked) {
+            free(g_dso_state.acquisition_buffer);
+        }
         g_dso_state.acquisition_buffer = nullptr;
     }
 
+    g_dso_state.buffer_locked = false;
+
     g_dso_state.acquisition_buffer_size = 0;
     g_dso_state.timebase_us = TIMEBASE_DEFAULT;
     g_dso_state.acquisition_complete = false;
@@ -100,9 +171,15 @@ static scpi_result_t configure_sample_rate_and_buffer(
         return SCPI_RES_ERR;
     }
 
+    // The buffer may be reallocated below
+    if (wait_for_buffer(context) != SCPI_RES_OK) {
+        return SCPI_RES_ERR;
+    }
+
     // Check if sample rate is achievable with current DSO mode
     // Use the mode parameter (the new mode being set)
-    uint32_t max_sample_rate = DSO_get_max_sample_rate(mode);
+    uint32_t max_sample_rate =
+        DSO_get_max_sample_rate(mode, config->resolution);
 
     if (sample_rate > max_sample_rate) {
         SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
@@ -416,8 +493,8 @@ scpi_result_t scpi_cmd_configure_oscilloscope_acquire_points_q(scpi_t *context)
 /**
  * @brief OSCilloscope:CONFigure:ACQuire:SRATe? - Query current DSO sample rate
  *
- * Returns the currently configured sample rate in samples per second.
- * The sample rate is calculated based on the timebase and buffer size.
+ * Returns the sample rate in samples per second that the trigger timer
+ * achieves for the configured rate.
  */
 scpi_result_t scpi_cmd_configure_oscilloscope_acquire_srate_q(scpi_t *context)
 {
@@ -428,6 +505,86 @@ scpi_result_t scpi_cmd_configure_oscilloscope_acquire_srate_q(scpi_t *context)
     return SCPI_RES_OK;
 }
 
+/**
+ * @brief OSCilloscope:CONFigure:RESolution - Set DSO sample resolution
+ *
+ * Syntax: OSCilloscope:CONFigure:RESolution {12|10|8|6}
+ *
+ * Sets the resolution in bits per sample. Lower resolutions allow higher
+ * sample rates; the current sample rate is checked against the maximum rate
+ * of the new resolution.
+ */
+scpi_result_t scpi_cmd_configure_oscilloscope_resolution(scpi_t *context)
+{
+    uint32_t bits = 0;
+
+    // Parse required parameter
+    if (!SCPI_ParamUInt32(context, &bits, true)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_MISSING_PARAMETER);
+        return SCPI_RES_ERR;
+    }
+
+    size_t resolution = 0;
+    while (resolution < RESOLUTION_COUNT &&
+           g_RESOLUTION_BITS[resolution] != bits) {
+        resolution++;
+    }
+    if (resolution == RESOLUTION_COUNT) {
+        SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+        return SCPI_RES_ERR;
+    }
+
+    if (g_dso_state.dso_handle &&
+        DSO_is_acquisition_in_progress(g_dso_state.dso_handle)) {
+        // Can't change configuration while acquisition is in progress
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    // Get current configuration or use default
+    DSO_Config config = g_dso_state.dso_handle
+                            ? DSO_get_config(g_dso_state.dso_handle)
+                            : (DSO_Config)DSO_CONFIG_DEFAULT;
+
+    config.resolution = (DSO_Resolution)resolution;
+
+    // Use current buffer size, or default if not set
+    uint32_t buffer_size = g_dso_state.acquisition_buffer_size > 0
+                               ? g_dso_state.acquisition_buffer_size
+                               : BUFFER_SIZE_DEFAULT;
+
+    // Validate the sample rate against the new resolution
+    scpi_result_t result = configure_sample_rate_and_buffer(
+        context, buffer_size, config.mode, &config
+    );
+    if (result != SCPI_RES_OK) {
+        return result;
+    }
+
+    // Apply configuration
+    return apply_dso_config(context, &config);
+}
+
+/**
+ * @brief OSCilloscope:CONFigure:RESolution? - Query current DSO resolution
+ *
+ * Returns the currently configured resolution in bits per sample.
+ */
+scpi_result_t scpi_cmd_configure_oscilloscope_resolution_q(scpi_t *context)
+{
+    DSO_Config config = g_dso_state.dso_handle
+                            ? DSO_get_config(g_dso_state.dso_handle)
+                            : (DSO_Config)DSO_CONFIG_DEFAULT;
+
+    if ((size_t)config.resolution >= RESOLUTION_COUNT) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultUInt32(context, g_RESOLUTION_BITS[config.resolution]);
+    return SCPI_RES_OK;
+}
+
 /**
  * @brief OSCilloscope:INITiate - Start DSO data acquisition
  */
@@ -459,6 +616,11 @@ scpi_result_t scpi_cmd_initiate_oscilloscope(scpi_t *context)
         }
     }
 
+    // The acquisition overwrites the buffer
+    if (wait_for_buffer(context) != SCPI_RES_OK) {
+        return SCPI_RES_ERR;
+    }
+
     // Clear acquisition flags
     g_dso_state.acquisition_complete = false;
 
@@ -493,9 +655,12 @@ scpi_result_t scpi_cmd_abort_oscilloscope(scpi_t *context)
 }
 
 /**
- * @brief OSCilloscope:FETCh:DATa? - Fetch the oscilloscope data
+ * @brief Wait for the acquisition to finish and stop the DSO
+ *
+ * @param context SCPI context for error reporting
+ * @return SCPI_RES_OK if a complete record is in the acquisition buffer
  */
-scpi_result_t scpi_cmd_fetch_oscilloscope_data_q(scpi_t *context)
+static scpi_result_t finish_acquisition(scpi_t *context)
 {
     // Check if DSO is configured
     if (!g_dso_state.dso_handle || !g_dso_state.acquisition_buffer) {
@@ -527,9 +692,34 @@ scpi_result_t scpi_cmd_fetch_oscilloscope_data_q(scpi_t *context)
     }
 
     DSO_stop(g_dso_state.dso_handle);
+    return SCPI_RES_OK;
+}
 
-    // Output acquisition data as SCPI arbitrary block
+/**
+ * @brief OSCilloscope:FETCh:DATa? - Fetch the oscilloscope data
+ */
+scpi_result_t scpi_cmd_fetch_oscilloscope_data_q(scpi_t *context)
+{
+    if (finish_acquisition(context) != SCPI_RES_OK) {
+        return SCPI_RES_ERR;
+    }
+
+    // A previous fetch of the same record may still be in progress
+    if (wait_for_buffer(context) != SCPI_RES_OK) {
+        return SCPI_RES_ERR;
+    }
+
+    // Output acquisition data as SCPI arbitrary block. The USB layer sends it
+    // straight from the acquisition buffer, which stays locked until the host
+    // has read it.
     size_t data_size = g_dso_state.acquisition_buffer_size * sizeof(uint16_t);
+    g_dso_state.buffer_locked = true;
+    protocol_register_block(
+        g_dso_state.acquisition_buffer,
+        data_size,
+        dso_transfer_callback,
+        g_dso_state.acquisition_buffer
+    );
     SCPI_ResultArbitraryBlock(
         context, (char *)g_dso_state.acquisition_buffer, data_size
     );
@@ -537,6 +727,49 @@ scpi_result_t scpi_cmd_fetch_oscilloscope_data_q(scpi_t *context)
     return SCPI_RES_OK;
 }
 
+/**
+ * @brief OSCilloscope:FETCh:BULK? - Fetch the oscilloscope data over bulk
+ *
+ * Sends the record as one frame on the USB bulk stream instead of as a SCPI
+ * block, and replies with the frame's sequence number once the frame has
+ * been queued. The host must keep reading the bulk pipe while it waits for
+ * the reply.
+ */
+scpi_result_t scpi_cmd_fetch_oscilloscope_bulk_q(scpi_t *context)
+{
+    if (finish_acquisition(context) != SCPI_RES_OK) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!USB_STREAM_ready()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    // The frame is copied into the stream buffer, so the record is only read
+    // here and stays free for the next acquisition
+    uint32_t sequence = 0;
+    Error err = ERROR_NONE;
+    TRY
+    {
+        sequence = USB_STREAM_write_frame(
+            USB_STREAM_TYPE_DSO_RECORD,
+            g_dso_state.acquisition_buffer,
+            g_dso_state.acquisition_buffer_size * sizeof(uint16_t),
+            BULK_TIMEOUT_MS
+        );
+    }
+    CATCH(err)
+    {
+        LOG_ERROR("DSO bulk transfer error: %s", error_to_string(err));
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultUInt32(context, sequence);
+    return SCPI_RES_OK;
+}
+
 /**
  * @brief OSCilloscope:READ? - Initiate and fetch oscilloscope data
  */
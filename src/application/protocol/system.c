@@ -0,0 +1,106 @@
+/**
+ * @file system.c
+ * @brief SYSTem diagnostics SCPI commands implementation
+ *
+ * This module implements the SCPI commands that report firmware runtime
+ * diagnostics, such as the idle sleep statistics, the CPU load and the boot
+ * timing.
+ */
+
+#include "lib/scpi/error.h"
+#include "lib/scpi/scpi.h"
+#include "util/perf.h"
+
+#include "system/system.h"
+
+/**
+ * @brief SYSTem:IDLE? - Query idle sleep statistics
+ *
+ * Returns, comma separated: sleep count, serviced wake-ups, average and
+ * maximum wake-up to task start latency in us, total sleep time in us, and
+ * wake-ups caused by USB, DMA, UART, timer and other interrupts.
+ */
+scpi_result_t scpi_cmd_system_idle_q(scpi_t *context)
+{
+    SYSTEM_IdleStats stats = SYSTEM_get_idle_stats();
+
+    SCPI_ResultUInt32(context, stats.sleep_count);
+    SCPI_ResultUInt32(context, stats.serviced_count);
+    SCPI_ResultUInt32(context, stats.avg_latency_us);
+    SCPI_ResultUInt32(context, stats.max_latency_us);
+    SCPI_ResultUInt64(context, stats.sleep_time_us);
+    for (int i = 0; i < SYSTEM_WAKE_COUNT; i++) {
+        SCPI_ResultUInt32(context, stats.wake_count[i]);
+    }
+
+    return SCPI_RES_OK;
+}
+
+/**
+ * @brief SYSTem:IDLE:RESet - Reset idle sleep statistics
+ */
+scpi_result_t scpi_cmd_system_idle_reset(scpi_t *context)
+{
+    (void)context;
+    SYSTEM_reset_idle_stats();
+    return SCPI_RES_OK;
+}
+
+/**
+ * @brief SYSTem:PERFormance? - Query CPU load and interrupt service times
+ *
+ * Reports the last completed accounting window. Returns, comma separated:
+ * CPU cycle frequency in Hz, window length in cycles and CPU load in permille,
+ * followed by sample count, minimum, average and maximum duration in cycles
+ * for idle sleep, ADC DMA, UART DMA and USB interrupts, the USB stack work
+ * deferred to PendSV, and ADC arbiter session switches.
+ */
+scpi_result_t scpi_cmd_system_performance_q(scpi_t *context)
+{
+    SYSTEM_PerfStats stats = SYSTEM_get_perf_stats();
+
+    SCPI_ResultUInt32(context, stats.cycle_frequency);
+    SCPI_ResultUInt64(context, stats.window_cycles);
+    SCPI_ResultUInt32(context, stats.load_permille);
+    for (int i = 0; i < PERF_SOURCE_COUNT; i++) {
+        PERF_Stats const *source = &stats.sources[i];
+        uint32_t avg = source->count > 0
+            ? (uint32_t)(source->total_cycles / source->count)
+            : 0;
+
+        SCPI_ResultUInt32(context, source->count);
+        SCPI_ResultUInt32(context, source->min_cycles);
+        SCPI_ResultUInt32(context, avg);
+        SCPI_ResultUInt32(context, source->max_cycles);
+    }
+
+    return SCPI_RES_OK;
+}
+
+/**
+ * @brief SYSTem:PERFormance:RESet - Discard samples and restart the window
+ */
+scpi_result_t scpi_cmd_system_performance_reset(scpi_t *context)
+{
+    (void)context;
+    SYSTEM_reset_perf_stats();
+    return SCPI_RES_OK;
+}
+
+/**
+ * @brief SYSTem:BOOT:TIMing? - Query boot phase timestamps
+ *
+ * Returns, comma separated, the time since reset in us at which the clocks
+ * were configured, USB was started, the host enumerated the device, logging
+ * came up and the deferred init completed. Phases not reached yet report 0.
+ */
+scpi_result_t scpi_cmd_system_boot_timing_q(scpi_t *context)
+{
+    SYSTEM_BootTiming timing = SYSTEM_get_boot_timing();
+
+    for (int i = 0; i < SYSTEM_BOOT_PHASE_COUNT; i++) {
+        SCPI_ResultUInt64(context, timing.phase_us[i]);
+    }
+
+    return SCPI_RES_OK;
+}
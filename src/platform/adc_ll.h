@@ -10,10 +10,20 @@
 #ifndef PSLAB_ADC_LL_H
 #define PSLAB_ADC_LL_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #define MAX_SIMULTANEOUS_CHANNELS 2
 
+// Native conversion resolution of the ADC, in bits
+#define ADC_LL_NATIVE_RESOLUTION_BITS 12
+
+// Maximum resolution delivered by the oversampler in high-resolution mode
+#define ADC_LL_MAX_OVERSAMPLED_RESOLUTION_BITS 16
+
+// Maximum number of segments in a linked-list acquisition
+#define ADC_LL_MAX_SEGMENTS 8
+
 typedef enum {
     ADC_TRIGGER_TIMER1 = 1,
     ADC_TRIGGER_TIMER1_TRGO2 = 11, // TIM1 TRGO2
@@ -45,12 +55,57 @@ typedef enum {
     ADC_LL_CHANNEL_15 = 15
 } ADC_LL_Channel;
 
+/**
+ * @brief ADC conversion resolution
+ *
+ * Lower resolutions shorten the conversion time and raise the maximum sample
+ * rate. Samples are right-aligned, so an 8-bit sample ranges from 0 to 255.
+ */
+typedef enum {
+    ADC_LL_RESOLUTION_12BIT = 0, // 12.5 ADC clock cycles per conversion
+    ADC_LL_RESOLUTION_10BIT, // 10.5 ADC clock cycles per conversion
+    ADC_LL_RESOLUTION_8BIT, // 8.5 ADC clock cycles per conversion
+    ADC_LL_RESOLUTION_6BIT, // 6.5 ADC clock cycles per conversion
+    ADC_LL_RESOLUTION_COUNT
+} ADC_LL_Resolution;
+
+/**
+ * @brief ADC sampling time, in ADC clock cycles
+ *
+ * Short sampling times raise the maximum sample rate but require a low source
+ * impedance for the sampling capacitor to settle. ADC_LL_SAMPLING_TIME_DEFAULT
+ * selects 92.5 cycles. The remaining values are ordered by duration.
+ */
+typedef enum {
+    ADC_LL_SAMPLING_TIME_DEFAULT = 0,
+    ADC_LL_SAMPLING_TIME_2CYCLES_5,
+    ADC_LL_SAMPLING_TIME_6CYCLES_5,
+    ADC_LL_SAMPLING_TIME_12CYCLES_5,
+    ADC_LL_SAMPLING_TIME_24CYCLES_5,
+    ADC_LL_SAMPLING_TIME_47CYCLES_5,
+    ADC_LL_SAMPLING_TIME_92CYCLES_5,
+    ADC_LL_SAMPLING_TIME_247CYCLES_5,
+    ADC_LL_SAMPLING_TIME_640CYCLES_5,
+    ADC_LL_SAMPLING_TIME_COUNT
+} ADC_LL_SamplingTime;
+
 typedef enum {
     ADC_LL_MODE_SINGLE = 0, // Single ADC operation
     ADC_LL_MODE_SIMULTANEOUS, // Simultaneous sampling on ADC1 and ADC2
     ADC_LL_MODE_INTERLEAVED // Interleaved sampling on ADC1 and ADC2
 } ADC_LL_Mode;
 
+/**
+ * @brief Acquisition segment
+ *
+ * One buffer of a linked-list acquisition. The size counts every sample
+ * stored in the buffer, so in dual modes it covers both ADCs and must be even.
+ */
+typedef struct {
+    uint16_t *buffer; // Segment buffer
+    uint32_t size; // Number of samples in the segment buffer
+} ADC_LL_Segment;
+
 /**
  * @brief ADC configuration structure
  */
@@ -62,8 +117,90 @@ typedef struct {
     uint32_t buffer_size; // Buffer size (number of samples per channel)
     uint32_t oversampling_ratio; // Oversampling ratio (1, 2, 4, 8, 16, 32, 64,
                                  // 128, 256)
+    bool high_resolution; // Keep extra oversampling bits (up to 16-bit)
+    ADC_LL_Resolution resolution; // Conversion resolution
+    ADC_LL_SamplingTime sampling_time; // Sampling time of the channels
+    ADC_LL_Segment const *segments; // Linked-list segments (replace
+                                    // output_buffer if segment_count > 0)
+    uint32_t segment_count; // Number of segments, 0 for a single buffer
+    bool circular; // Loop back to the first segment after the last one
 } ADC_LL_Config;
 
+/**
+ * @brief Injected conversion configuration structure
+ *
+ * Injected conversions run on ADC1 through the injected sequence (JSQR).
+ * They are started by software and preempt any ongoing regular sequence, so
+ * they can be used while a timer-triggered regular acquisition is running.
+ *
+ * The hardware oversampler ratio is shared with the regular sequence, so
+ * injected oversampling is done by accumulating conversions in the
+ * end-of-conversion interrupt. The result follows the same resolution rules
+ * as regular oversampling (see ADC_LL_init). Injected conversions always
+ * report 12-bit values: if a regular acquisition runs ADC1 at a lower
+ * resolution, each conversion is scaled up to 12 bits.
+ */
+typedef struct {
+    ADC_LL_Channel channel; // ADC channel to convert
+    uint32_t oversampling_ratio; // Oversampling ratio (1, 2, 4, 8, 16, 32, 64,
+                                 // 128, 256)
+    bool high_resolution; // Keep extra oversampling bits (up to 16-bit)
+} ADC_LL_InjectedConfig;
+
+/**
+ * @brief ADC analog watchdog
+ *
+ * Watchdog 1 compares with the full sample resolution. Watchdogs 2 and 3 only
+ * compare the 8 most significant bits of a 12-bit sample.
+ */
+typedef enum {
+    ADC_LL_WATCHDOG_1 = 0,
+    ADC_LL_WATCHDOG_2,
+    ADC_LL_WATCHDOG_3,
+    ADC_LL_WATCHDOG_COUNT
+} ADC_LL_Watchdog;
+
+/**
+ * @brief Analog watchdog configuration structure
+ *
+ * Thresholds are given in the units of the samples stored in the output
+ * buffer. With oversampling, the hardware compares only the 12 most
+ * significant bits of the 16-bit result, so the thresholds are rounded down
+ * to that granularity.
+ */
+typedef struct {
+    ADC_LL_Channel channel; // ADC channel to monitor
+    uint16_t low_threshold; // Event when a sample falls below this value
+    uint16_t high_threshold; // Event when a sample rises above this value
+} ADC_LL_WatchdogConfig;
+
+/**
+ * @brief Callback function type for analog watchdog events.
+ *
+ * This callback is called from interrupt context when a monitored sample
+ * leaves the threshold window. The position is the index of the next sample
+ * the DMA writes, counted from the start of the output buffer or, in
+ * linked-list mode, from the start of the first segment. It is 0 if no
+ * regular acquisition is initialized.
+ *
+ * @param watchdog Watchdog that detected the event
+ * @param position DMA position at the time of the event
+ */
+typedef void (*ADC_LL_WatchdogCallback)(
+    ADC_LL_Watchdog watchdog,
+    uint32_t position
+);
+
+/**
+ * @brief Callback function type for injected conversion complete events.
+ *
+ * This callback is called from interrupt context once all oversampled
+ * injected conversions have completed.
+ *
+ * @param value Oversampled conversion result
+ */
+typedef void (*ADC_LL_InjectedCompleteCallback)(uint16_t value);
+
 /**
  * @brief Callback function type for ADC complete events.
  *
@@ -89,6 +226,48 @@ typedef void (*ADC_LL_CompleteCallback)(
     uint32_t total_samples
 );
 
+/**
+ * @brief Callback function type for half-transfer events.
+ *
+ * This callback is called from interrupt context each time the DMA has
+ * filled one half of the block it is writing: half 0 when it reaches the
+ * middle of the block, half 1 when the block is complete. For single-block
+ * acquisitions the block is the whole output buffer. Linked-list
+ * acquisitions report the halves of every DMA block; a block is at most
+ * 64 KB, so larger segments consist of several blocks.
+ *
+ * The block counter starts at 0 on ADC_LL_start and increments with every
+ * event, so a consumer that processes the halves of a circular acquisition
+ * can detect halves it missed.
+ *
+ * @param buffer Pointer to the first sample of the filled half
+ * @param half Index of the filled half (0 or 1)
+ * @param total_samples Number of samples in the filled half
+ * @param block Block counter value of this event
+ */
+typedef void (*ADC_LL_HalfCompleteCallback)(
+    uint16_t *buffer,
+    uint32_t half,
+    uint32_t total_samples,
+    uint32_t block
+);
+
+/**
+ * @brief Callback function type for segment complete events.
+ *
+ * This callback is called from interrupt context each time the DMA has filled
+ * one segment of a linked-list acquisition.
+ *
+ * @param index Index of the completed segment
+ * @param buffer Pointer to the segment buffer
+ * @param total_samples Number of samples in the segment buffer
+ */
+typedef void (*ADC_LL_SegmentCallback)(
+    uint32_t index,
+    uint16_t *buffer,
+    uint32_t total_samples
+);
+
 /**
  * @brief Initialize the ADC peripheral(s).
  *
@@ -96,12 +275,42 @@ typedef void (*ADC_LL_CompleteCallback)(
  * For single-channel mode, only ADC1 is used. For simultaneous and interleaved
  * modes, both ADC1 and ADC2 are configured.
  *
+ * Oversampling:
+ * - Normal mode: the accumulated sum is shifted right by log2(ratio), so
+ *   samples stay in the native ADC_LL_NATIVE_RESOLUTION_BITS range for every
+ *   ratio.
+ * - High-resolution mode: the accumulated sum is shifted right only as far as
+ *   needed to fit ADC_LL_MAX_OVERSAMPLED_RESOLUTION_BITS, so samples have
+ *   min(12 + log2(ratio), 16) bits.
+ * Oversampling assumes 12-bit conversions; with a lower resolution the
+ * accumulated sum has correspondingly fewer bits.
+ *
  * Buffer Requirements:
  * - Single mode: Buffer accommodates buffer_size samples
  * - Simultaneous mode: Buffer accommodates 2 * buffer_size samples
  * - Interleaved mode: Buffer accommodates 2 * buffer_size samples
  *
+ * Linked-list mode:
+ * When segments are given, the DMA runs through a chain of GPDMA linked-list
+ * items that fill the segments in order, without CPU involvement between
+ * them. Segments larger than one DMA block (64 KB) are split over several
+ * items, so a single output_buffer that exceeds the block size, or any
+ * circular acquisition, also runs in linked-list mode. With circular set, the
+ * chain loops back to the first segment and runs until ADC_LL_stop, e.g. as
+ * ping-pong buffers; the complete callback is then never called. Otherwise
+ * the ADC stops after the last segment and the complete callback reports the
+ * first segment buffer and the number of samples of all segments. The
+ * segment array must stay valid until ADC_LL_deinit.
+ *
+ * Calibration:
+ * The ADCs are calibrated when they are first initialized. The calibration
+ * factors are kept, and reinitializations within a minute write them back
+ * instead of calibrating again.
+ *
  * @param config Pointer to ADC configuration structure.
+ *
+ * @throws ERROR_INVALID_ARGUMENT if the segments do not fit in the available
+ * linked-list items
  */
 void ADC_LL_init(ADC_LL_Config const *config);
 
@@ -138,6 +347,28 @@ void ADC_LL_stop(void);
  */
 void ADC_LL_set_complete_callback(ADC_LL_CompleteCallback callback);
 
+/**
+ * @brief Set the callback for half-transfer events.
+ *
+ * Together with a circular acquisition, this allows processing one half of
+ * the buffer while the DMA fills the other one, without stopping the ADC.
+ * The callback is called before the segment and complete callbacks of the
+ * same DMA event.
+ *
+ * @param callback Pointer to the callback function to be set.
+ */
+void ADC_LL_set_half_complete_callback(ADC_LL_HalfCompleteCallback callback);
+
+/**
+ * @brief Set the callback for segment complete events.
+ *
+ * The callback is called for each completed segment of a linked-list
+ * acquisition, including the last one before the complete callback.
+ *
+ * @param callback Pointer to the callback function to be set.
+ */
+void ADC_LL_set_segment_callback(ADC_LL_SegmentCallback callback);
+
 /**
  * @brief Get the current ADC operation mode.
  *
@@ -163,26 +394,152 @@ ADC_LL_Mode ADC_LL_get_mode(void);
 uint32_t ADC_LL_get_sample_rate(void);
 
 /**
- * @brief Get the reference voltage reading.
+ * @brief Get the cached reference voltage reading.
  *
- * This function returns the reference voltage that was measured during ADC
- * initialization. The value is obtained by reading the internal VREFINT
+ * This function returns the cached analog supply (VDDA) voltage, which is the
+ * ADC reference. The value is obtained by converting the internal VREFINT
  * channel and calculating the actual reference voltage using factory
  * calibration data.
  *
- * @return Reference voltage in millivolts, or 0 if ADC is not initialized.
+ * VDDA is measured once, the first time ADC1 is brought up. After that it is
+ * refreshed in the background: when the cached value is older than the
+ * refresh period, this function starts a VREFINT conversion on the injected
+ * sequence and returns the cached value without waiting for it. Reconfiguring
+ * the ADC never remeasures VDDA. The cached value is kept while the ADC is
+ * deinitialized.
+ *
+ * @param[out] age_ms Receives the age of the returned value in milliseconds.
+ * May be NULL.
+ * @return Reference voltage in millivolts, or 0 if it was never measured.
  */
-uint32_t ADC_LL_get_reference_voltage(void);
+uint32_t ADC_LL_get_reference_voltage(uint32_t *age_ms);
 
 /**
- * @brief Get the maximum sample rate for a given ADC mode.
+ * @brief Calibrate ADC1 and measure VDDA ahead of the first acquisition.
  *
- * This function returns the theoretical maximum sample rate for the specified
- * ADC mode based on the hardware capabilities.
+ * Brings ADC1 up on its own, runs the offset calibration and the blocking
+ * first VDDA measurement, and powers ADC1 down again. The first instrument
+ * that uses the ADC then starts from the cached reference voltage. Does
+ * nothing if VDDA was already measured or the ADC is in use.
+ */
+void ADC_LL_prepare(void);
+
+/**
+ * @brief Get the maximum sample rate for a given ADC configuration.
+ *
+ * This function returns the maximum sample rate for the specified ADC mode,
+ * resolution and sampling time, based on the ADC clock frequency:
+ *
+ * Rate = ADC_Clock_Rate / (Sample_Time + Conversion_Time)
+ *
+ * In interleaved mode, ADC1 and ADC2 alternate and the rate is doubled.
  *
  * @param mode ADC operation mode.
- * @return Maximum sample rate in Hz.
+ * @param resolution ADC conversion resolution.
+ * @param sampling_time ADC sampling time.
+ * @return Maximum sample rate in Hz, or 0 if the arguments are invalid.
+ */
+uint32_t ADC_LL_get_max_sample_rate(
+    ADC_LL_Mode mode,
+    ADC_LL_Resolution resolution,
+    ADC_LL_SamplingTime sampling_time
+);
+
+/**
+ * @brief Initialize injected conversions on ADC1.
+ *
+ * Configures the injected sequence of ADC1 for the given channel. If ADC1 is
+ * not in use by a regular acquisition, it is brought up on its own. A regular
+ * acquisition may be initialized and deinitialized while injected conversions
+ * are configured; the injected configuration is preserved.
+ *
+ * @param config Pointer to injected configuration structure.
+ *
+ * @throws ERROR_INVALID_ARGUMENT if config is NULL or contains invalid values
+ * @throws ERROR_RESOURCE_BUSY if injected conversions are already initialized
+ * @throws ERROR_HARDWARE_FAULT if the ADC could not be configured
+ */
+void ADC_LL_injected_init(ADC_LL_InjectedConfig const *config);
+
+/**
+ * @brief Deinitialize injected conversions.
+ *
+ * Stops any pending injected conversion. ADC1 is released if no regular
+ * acquisition is using it.
+ */
+void ADC_LL_injected_deinit(void);
+
+/**
+ * @brief Start an injected conversion.
+ *
+ * Starts a software-triggered injected conversion. The configured injected
+ * complete callback is called when the oversampled result is available.
+ *
+ * @throws ERROR_RESOURCE_UNAVAILABLE if injected conversions are not
+ * initialized
+ * @throws ERROR_HARDWARE_FAULT if the conversion could not be started
+ */
+void ADC_LL_injected_start(void);
+
+/**
+ * @brief Set the callback for injected conversion complete events.
+ *
+ * @param callback Pointer to the callback function to be set.
+ */
+void ADC_LL_set_injected_complete_callback(
+    ADC_LL_InjectedCompleteCallback callback
+);
+
+/**
+ * @brief Initialize an analog watchdog.
+ *
+ * Configures the watchdog to monitor a channel converted by ADC1, or by ADC2
+ * in dual modes, and arms it. The channel is monitored in regular and
+ * injected conversions. Watchdogs are one-shot: after an event the watchdog
+ * stays configured but reports no further events until ADC_LL_watchdog_arm
+ * is called.
+ *
+ * The watchdog must be initialized after ADC_LL_init or ADC_LL_injected_init
+ * and while no conversion is running. Reinitializing or deinitializing the
+ * ADC disables all watchdogs.
+ *
+ * @param watchdog Watchdog to initialize.
+ * @param config Pointer to watchdog configuration structure.
+ *
+ * @throws ERROR_INVALID_ARGUMENT if watchdog or config is invalid, or the
+ * channel is not converted
+ * @throws ERROR_RESOURCE_UNAVAILABLE if the ADC is not initialized
+ * @throws ERROR_RESOURCE_BUSY if a conversion is running
+ * @throws ERROR_HARDWARE_FAULT if the watchdog could not be configured
+ */
+void ADC_LL_watchdog_init(
+    ADC_LL_Watchdog watchdog,
+    ADC_LL_WatchdogConfig const *config
+);
+
+/**
+ * @brief Deinitialize an analog watchdog.
+ *
+ * @param watchdog Watchdog to deinitialize.
+ */
+void ADC_LL_watchdog_deinit(ADC_LL_Watchdog watchdog);
+
+/**
+ * @brief Re-arm an analog watchdog after an event.
+ *
+ * Can be called while conversions are running.
+ *
+ * @param watchdog Watchdog to arm.
+ *
+ * @throws ERROR_RESOURCE_UNAVAILABLE if the watchdog is not initialized
+ */
+void ADC_LL_watchdog_arm(ADC_LL_Watchdog watchdog);
+
+/**
+ * @brief Set the callback for analog watchdog events.
+ *
+ * @param callback Pointer to the callback function to be set.
  */
-uint32_t ADC_LL_get_max_sample_rate(ADC_LL_Mode mode);
+void ADC_LL_set_watchdog_callback(ADC_LL_WatchdogCallback callback);
 
 #endif // ADC_LL_H
@@ -0,0 +1,71 @@
+/**
+ * @file cycle_ll.h
+ * @brief Low-level CPU cycle counter interface for PSLab Mini
+ *
+ * This module exposes a free-running 32-bit CPU cycle counter, a periodic
+ * tick hook that fires well before the counter can wrap, and a minimal
+ * interrupt-masking critical section. The system timebase builds its 64-bit
+ * monotonic time on top of these primitives.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef PSLAB_LL_CYCLE_H
+#define PSLAB_LL_CYCLE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Tick callback type
+ *
+ * Called from interrupt context at least once per millisecond.
+ */
+typedef void (*CYCLE_LL_TickCallback)(void);
+
+/**
+ * @brief Initialize and start the cycle counter
+ *
+ * The counter restarts from zero.
+ */
+void CYCLE_LL_init(void);
+
+/**
+ * @brief Get the current value of the 32-bit cycle counter
+ *
+ * @return Cycle count, wrapping at 2^32
+ */
+uint32_t CYCLE_LL_get_count(void);
+
+/**
+ * @brief Get the rate of the cycle counter
+ *
+ * @return Counter frequency in Hz
+ */
+uint32_t CYCLE_LL_get_frequency(void);
+
+/**
+ * @brief Set the periodic tick callback
+ *
+ * @param callback Function to call on every tick, or nullptr to disable
+ */
+void CYCLE_LL_set_tick_callback(CYCLE_LL_TickCallback callback);
+
+/**
+ * @brief Mask interrupts
+ *
+ * Calls may nest as long as each is paired with CYCLE_LL_exit_critical in
+ * reverse order.
+ *
+ * @return Previous interrupt mask state
+ */
+uint32_t CYCLE_LL_enter_critical(void);
+
+/**
+ * @brief Restore the interrupt mask state
+ *
+ * @param state State returned by the matching CYCLE_LL_enter_critical call
+ */
+void CYCLE_LL_exit_critical(uint32_t state);
+
+#endif // PSLAB_LL_CYCLE_H
@@ -18,13 +18,26 @@
 
 #include "util/error.h"
 #include "util/logging.h"
-#include "util/si_prefix.h"
+#include "util/perf.h"
+#include "util/ramfunc.h"
 
 #include "adc_ll.h"
+#include "cycle_ll.h"
 #include "platform.h"
 
 enum { ADC_IRQ_PRIORITY = 1 }; // ADC interrupt priority
 
+enum { ADC_VREFINT_TIMEOUT_MS = 1 }; // VREFINT conversion timeout
+
+enum { ADC_VDDA_REFRESH_PERIOD_MS = 1000 }; // Cached VDDA refresh period
+
+enum { ADC_CALIBRATION_MAX_AGE_MS = 60000 }; // Reuse of calibration factors
+
+// The GPDMA block size field is 16 bits wide; keep blocks word aligned
+enum { ADC_DMA_MAX_BLOCK_SAMPLES = 32766 };
+
+enum { ADC_DMA_MAX_NODES = 16 }; // Linked-list items for one acquisition
+
 typedef struct {
     ADC_HandleTypeDef
         *adc_handles[MAX_SIMULTANEOUS_CHANNELS]; // Pointers to ADC handles
@@ -34,13 +47,56 @@ typedef struct {
     uint16_t *buffer_data; // Pointer to ADC data buffer
     uint32_t buffer_size; // Size of the ADC data buffer (per channel)
     ADC_LL_CompleteCallback complete_callback; // Callback for ADC completion
+    ADC_LL_SegmentCallback segment_callback; // Callback for segment completion
+    ADC_LL_HalfCompleteCallback half_complete_callback; // Half-transfer events
+    uint32_t volatile block_count; // Half-transfer events since start
     ADC_LL_Channel channels[MAX_SIMULTANEOUS_CHANNELS]; // ADC channels
     ADC_LL_Mode mode; // Current ADC mode
     uint32_t oversampling_ratio; // Oversampling ratio
-    uint32_t vref_mv; // Reference voltage in millivolts
+    bool high_resolution; // Keep extra oversampling bits
+    ADC_LL_Resolution resolution; // Conversion resolution
+    ADC_LL_SamplingTime sampling_time; // Channel sampling time
     bool initialized; // Flag to indicate if the ADC is initialized
 } ADCInstance;
 
+typedef struct {
+    ADC_LL_Channel channel; // Injected channel
+    uint32_t oversampling_ratio; // Number of conversions to accumulate
+    uint32_t shift_bits; // Right shift applied to the accumulated result
+    uint32_t volatile accumulator; // Sum of conversions so far
+    uint32_t volatile remaining; // Conversions left in the current reading
+    ADC_LL_InjectedCompleteCallback complete_callback; // Completion callback
+    bool volatile busy; // Flag to indicate a reading is in progress
+    bool standalone; // ADC1 is enabled for injected conversions only
+    bool initialized; // Flag to indicate if injected conversions are set up
+} ADCInjectedInstance;
+
+typedef struct {
+    uint32_t volatile vdda_mv; // Last measured VDDA, 0 if never measured
+    uint32_t volatile timestamp_ms; // Tick of the last measurement
+    bool volatile converting; // VREFINT is converting on the injected sequence
+    bool volatile refresh_pending; // Refresh waits for the injected sequence
+} VDDATracker;
+
+typedef struct {
+    uint16_t *buffer; // First sample written by the item
+    uint32_t samples; // Number of samples written by the item
+    uint32_t segment; // Segment the item belongs to
+} ADCListItem;
+
+typedef struct {
+    DMA_NodeTypeDef nodes[ADC_DMA_MAX_NODES]; // GPDMA linked-list items
+    DMA_QListTypeDef queue; // Queue chaining the items
+    ADC_LL_Segment segments[ADC_LL_MAX_SEGMENTS]; // Acquisition segments
+    ADCListItem items[ADC_DMA_MAX_NODES]; // Buffer area of each item
+    uint32_t node_count; // Number of items in the queue
+    uint32_t segment_count; // Number of segments
+    uint32_t total_samples; // Samples reported on completion
+    uint32_t volatile current_node; // Item the DMA is filling
+    bool circular; // Queue loops back to the first item
+    bool enabled; // Acquisition runs from the linked list
+} ADCLinkedList;
+
 static ADC_HandleTypeDef g_hadc1 = { nullptr };
 
 static ADC_HandleTypeDef g_hadc2 = { nullptr };
@@ -64,10 +120,41 @@ static ADCInstance g_adc_instance = {
     .channels = { ADC_LL_CHANNEL_0, ADC_LL_CHANNEL_1 },
     .mode = ADC_LL_MODE_SINGLE,
     .oversampling_ratio = 1,
-    .vref_mv = 0,
+    .high_resolution = false,
+    .initialized = false,
+};
+
+static ADCInjectedInstance g_adc_injected = {
+    .channel = ADC_LL_CHANNEL_0,
+    .oversampling_ratio = 1,
+    .complete_callback = nullptr,
+    .busy = false,
+    .standalone = false,
     .initialized = false,
 };
 
+static VDDATracker g_vdda = { 0 };
+
+typedef struct {
+    uint32_t factor; // Single-ended calibration factor
+    uint32_t timestamp_ms; // Tick of the calibration
+    bool valid; // Flag to indicate if the factor has been measured
+} ADCCalibration;
+
+// Calibration factors of ADC1 and ADC2, kept across reinitializations
+static ADCCalibration g_adc_calibration[MAX_SIMULTANEOUS_CHANNELS] = { 0 };
+
+static ADCLinkedList g_adc_list = { 0 };
+
+typedef struct {
+    uint32_t adc_mask; // ADCs monitoring the channel, bit n for ADC n + 1
+    bool initialized; // Flag to indicate if the watchdog is configured
+} ADCWatchdogInstance;
+
+static ADCWatchdogInstance g_adc_watchdogs[ADC_LL_WATCHDOG_COUNT] = { 0 };
+
+static ADC_LL_WatchdogCallback g_watchdog_callback = nullptr;
+
 /**
  * @brief Gets the GPIO pin configuration for a given ADC channel.
  *
@@ -292,6 +379,94 @@ static void ADC_DMA_ErrorCallback(DMA_HandleTypeDef *hdma)
     HAL_ADC_ErrorCallback(&g_hadc1);
 }
 
+/**
+ * @brief Gets the number of linked-list items needed for a segment.
+ *
+ * @param samples Number of samples in the segment.
+ * @return Number of DMA blocks the segment is split into.
+ */
+static uint32_t get_segment_node_count(uint32_t samples)
+{
+    return (samples + ADC_DMA_MAX_BLOCK_SAMPLES - 1) /
+           ADC_DMA_MAX_BLOCK_SAMPLES;
+}
+
+/**
+ * @brief Builds the linked-list queue and initializes the DMA channel with it.
+ *
+ * Each segment is split into items of at most one DMA block. The items take
+ * their transfer settings from the DMA handle and raise a transfer complete
+ * event each, so every item reports through the conversion complete callback.
+ *
+ * @param hdma Pointer to DMA handle with its transfer settings filled in.
+ * @param src_address Address of the ADC data register to read from.
+ */
+static void configure_linked_list_dma(
+    DMA_HandleTypeDef *hdma,
+    uint32_t src_address
+)
+{
+    ADCLinkedList *list = &g_adc_list;
+    DMA_NodeConfTypeDef node_config = { 0 };
+
+    node_config.NodeType = DMA_GPDMA_LINEAR_NODE;
+    node_config.Init = hdma->Init;
+    node_config.Init.TransferEventMode = DMA_TCEM_EACH_LL_ITEM_TRANSFER;
+    node_config.DataHandlingConfig.DataExchange = DMA_EXCHANGE_NONE;
+    node_config.DataHandlingConfig.DataAlignment =
+        DMA_DATA_RIGHTALIGN_ZEROPADDED;
+    node_config.TriggerConfig.TriggerPolarity = DMA_TRIG_POLARITY_MASKED;
+    node_config.SrcAddress = src_address;
+
+    list->queue = (DMA_QListTypeDef){ 0 };
+    list->node_count = 0;
+
+    for (uint32_t i = 0; i < list->segment_count; i++) {
+        uint16_t *buffer = list->segments[i].buffer;
+        uint32_t remaining = list->segments[i].size;
+
+        while (remaining > 0) {
+            uint32_t samples = remaining < ADC_DMA_MAX_BLOCK_SAMPLES
+                                   ? remaining
+                                   : ADC_DMA_MAX_BLOCK_SAMPLES;
+            DMA_NodeTypeDef *node = &list->nodes[list->node_count];
+
+            node_config.DstAddress = (uint32_t)buffer;
+            node_config.DataSize = samples * sizeof(uint16_t);
+
+            if (HAL_DMAEx_List_BuildNode(&node_config, node) != HAL_OK ||
+                HAL_DMAEx_List_InsertNode_Tail(&list->queue, node) != HAL_OK) {
+                THROW(ERROR_HARDWARE_FAULT);
+            }
+
+            list->items[list->node_count++] = (ADCListItem){
+                .buffer = buffer,
+                .samples = samples,
+                .segment = i,
+            };
+            buffer += samples;
+            remaining -= samples;
+        }
+    }
+
+    if (list->circular &&
+        HAL_DMAEx_List_SetCircularMode(&list->queue) != HAL_OK) {
+        THROW(ERROR_HARDWARE_FAULT);
+    }
+
+    hdma->InitLinkedList.Priority = hdma->Init.Priority;
+    hdma->InitLinkedList.LinkStepMode = DMA_LSM_FULL_EXECUTION;
+    hdma->InitLinkedList.LinkAllocatedPort = DMA_LINK_ALLOCATED_PORT0;
+    hdma->InitLinkedList.TransferEventMode = DMA_TCEM_EACH_LL_ITEM_TRANSFER;
+    hdma->InitLinkedList.LinkedListMode =
+        list->circular ? DMA_LINKEDLIST_CIRCULAR : DMA_LINKEDLIST_NORMAL;
+
+    if (HAL_DMAEx_List_Init(hdma) != HAL_OK ||
+        HAL_DMAEx_List_LinkQ(hdma, &list->queue) != HAL_OK) {
+        THROW(ERROR_HARDWARE_FAULT);
+    }
+}
+
 /**
  * @brief Configures DMA handle with common settings for dual mode.
  *
@@ -327,7 +502,9 @@ static void configure_dual_mode_dma(
     hdma->XferCpltCallback = ADC_DMA_ConvCpltCallback;
     hdma->XferErrorCallback = ADC_DMA_ErrorCallback;
 
-    if (HAL_DMA_Init(hdma) != HAL_OK) {
+    if (g_adc_list.enabled) {
+        configure_linked_list_dma(hdma, (uint32_t)&ADC12_COMMON->CDR);
+    } else if (HAL_DMA_Init(hdma) != HAL_OK) {
         THROW(ERROR_HARDWARE_FAULT);
     }
     __HAL_LINKDMA(&g_hadc1, DMA_Handle, g_hdma_adc1_dual);
@@ -362,7 +539,9 @@ static void configure_single_mode_dma(
     hdma->Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
     hdma->Init.Mode = DMA_NORMAL;
 
-    if (HAL_DMA_Init(hdma) != HAL_OK) {
+    if (g_adc_list.enabled) {
+        configure_linked_list_dma(hdma, (uint32_t)&ADC1->DR);
+    } else if (HAL_DMA_Init(hdma) != HAL_OK) {
         THROW(ERROR_HARDWARE_FAULT);
     }
     __HAL_LINKDMA(&g_hadc1, DMA_Handle, g_hdma_adc);
@@ -384,6 +563,14 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef *hadc)
     // Enable ADC clock
     __HAL_RCC_ADC_CLK_ENABLE();
 
+    // ADC1 enabled for injected conversions only needs no DMA
+    if (!g_adc_instance.initialized) {
+        pin_config = get_pin_config(g_adc_injected.channel);
+        configure_adc_gpio(&pin_config);
+        LOG_FUNCTION_EXIT();
+        return;
+    }
+
     // Get pin configuration based on ADC instance
     if (hadc->Instance == ADC1) {
         pin_config = get_pin_config(g_adc_instance.channels[0]);
@@ -435,11 +622,60 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef *hadc)
  */
 static void validate_adc_config_structure(ADC_LL_Config const *config)
 {
-    if (config == nullptr || config->buffer_size == 0) {
+    if (config == nullptr) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    // Segments replace the output buffer
+    if (config->segment_count > 0) {
+        return;
+    }
+
+    if (config->buffer_size == 0 || config->output_buffer == nullptr) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    if (get_segment_node_count(config->buffer_size) > ADC_DMA_MAX_NODES) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+}
+
+/**
+ * @brief Validates the segments of a linked-list acquisition.
+ *
+ * @param config ADC configuration to validate.
+ */
+static void validate_segments(ADC_LL_Config const *config)
+{
+    if (config->segment_count == 0) {
+        return;
+    }
+
+    if (config->segments == nullptr ||
+        config->segment_count > ADC_LL_MAX_SEGMENTS) {
         THROW(ERROR_INVALID_ARGUMENT);
     }
 
-    if (config->output_buffer == nullptr) {
+    bool const dual_mode = config->mode == ADC_LL_MODE_SIMULTANEOUS ||
+                           config->mode == ADC_LL_MODE_INTERLEAVED;
+    uint32_t node_count = 0;
+
+    for (uint32_t i = 0; i < config->segment_count; i++) {
+        ADC_LL_Segment const *segment = &config->segments[i];
+
+        if (segment->buffer == nullptr || segment->size == 0) {
+            THROW(ERROR_INVALID_ARGUMENT);
+        }
+
+        // Dual modes transfer one 32-bit word per sample pair
+        if (dual_mode && (segment->size % 2) != 0) {
+            THROW(ERROR_INVALID_ARGUMENT);
+        }
+
+        node_count += get_segment_node_count(segment->size);
+    }
+
+    if (node_count > ADC_DMA_MAX_NODES) {
         THROW(ERROR_INVALID_ARGUMENT);
     }
 }
@@ -465,8 +701,14 @@ static void validate_oversampling_ratio(uint32_t ratio)
 static void validate_adc_config(ADC_LL_Config const *config)
 {
     validate_adc_config_structure(config);
+    validate_segments(config);
     validate_oversampling_ratio(config->oversampling_ratio);
 
+    if (config->resolution >= ADC_LL_RESOLUTION_COUNT ||
+        config->sampling_time >= ADC_LL_SAMPLING_TIME_COUNT) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
     if (g_adc_instance.initialized) {
         THROW(ERROR_RESOURCE_BUSY);
     }
@@ -489,9 +731,52 @@ static void initialize_adc_instance(ADC_LL_Config const *config)
     instance->mode = config->mode;
     instance->buffer_size = config->buffer_size;
     instance->oversampling_ratio = config->oversampling_ratio;
+    instance->high_resolution = config->high_resolution;
+    instance->resolution = config->resolution;
+    instance->sampling_time = config->sampling_time;
     instance->initialized = true; // Set before MSP init to configure mode
 }
 
+/**
+ * @brief Selects single-block or linked-list DMA for an acquisition.
+ *
+ * Linked-list mode is used for segmented and circular acquisitions and for a
+ * single output buffer that does not fit in one DMA block. A single buffer is
+ * then treated as one segment.
+ *
+ * @param config ADC configuration.
+ */
+static void initialize_linked_list(ADC_LL_Config const *config)
+{
+    ADCLinkedList *list = &g_adc_list;
+
+    list->circular = config->circular;
+    list->current_node = 0;
+
+    if (config->segment_count > 0) {
+        list->total_samples = 0;
+        for (uint32_t i = 0; i < config->segment_count; i++) {
+            list->segments[i] = config->segments[i];
+            list->total_samples += config->segments[i].size;
+        }
+        list->segment_count = config->segment_count;
+        list->enabled = true;
+        return;
+    }
+
+    list->segments[0] = (ADC_LL_Segment){
+        .buffer = config->output_buffer,
+        .size = config->buffer_size,
+    };
+    list->segment_count = 1;
+    // Report the same count as a single-block acquisition
+    list->total_samples = (config->mode == ADC_LL_MODE_SINGLE)
+                              ? config->buffer_size
+                              : config->buffer_size * 2;
+    list->enabled = config->circular ||
+                    config->buffer_size > ADC_DMA_MAX_BLOCK_SAMPLES;
+}
+
 /**
  * @brief Converts numeric oversampling ratio to HAL constant.
  *
@@ -522,22 +807,163 @@ static uint32_t get_hal_oversampling_ratio(uint32_t ratio)
     }
 }
 
+/**
+ * @brief Converts ADC_LL resolution to HAL constant.
+ *
+ * @param resolution ADC_LL resolution.
+ * @return Corresponding HAL resolution constant.
+ */
+static uint32_t get_hal_resolution(ADC_LL_Resolution resolution)
+{
+    switch (resolution) {
+    case ADC_LL_RESOLUTION_10BIT:
+        return ADC_RESOLUTION_10B;
+    case ADC_LL_RESOLUTION_8BIT:
+        return ADC_RESOLUTION_8B;
+    case ADC_LL_RESOLUTION_6BIT:
+        return ADC_RESOLUTION_6B;
+    case ADC_LL_RESOLUTION_12BIT:
+    default:
+        return ADC_RESOLUTION_12B;
+    }
+}
+
+/**
+ * @brief Gets the number of bits dropped by a resolution.
+ *
+ * @param resolution ADC_LL resolution.
+ * @return Difference between the native resolution and the given one.
+ */
+static uint32_t get_resolution_shift_bits(ADC_LL_Resolution resolution)
+{
+    switch (resolution) {
+    case ADC_LL_RESOLUTION_10BIT:
+        return ADC_LL_NATIVE_RESOLUTION_BITS - 10;
+    case ADC_LL_RESOLUTION_8BIT:
+        return ADC_LL_NATIVE_RESOLUTION_BITS - 8;
+    case ADC_LL_RESOLUTION_6BIT:
+        return ADC_LL_NATIVE_RESOLUTION_BITS - 6;
+    case ADC_LL_RESOLUTION_12BIT:
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Converts ADC_LL sampling time to HAL constant.
+ *
+ * @param sampling_time ADC_LL sampling time.
+ * @return Corresponding HAL sampling time constant.
+ */
+static uint32_t get_hal_sampling_time(ADC_LL_SamplingTime sampling_time)
+{
+    switch (sampling_time) {
+    case ADC_LL_SAMPLING_TIME_2CYCLES_5:
+        return ADC_SAMPLETIME_2CYCLES_5;
+    case ADC_LL_SAMPLING_TIME_6CYCLES_5:
+        return ADC_SAMPLETIME_6CYCLES_5;
+    case ADC_LL_SAMPLING_TIME_12CYCLES_5:
+        return ADC_SAMPLETIME_12CYCLES_5;
+    case ADC_LL_SAMPLING_TIME_24CYCLES_5:
+        return ADC_SAMPLETIME_24CYCLES_5;
+    case ADC_LL_SAMPLING_TIME_47CYCLES_5:
+        return ADC_SAMPLETIME_47CYCLES_5;
+    case ADC_LL_SAMPLING_TIME_247CYCLES_5:
+        return ADC_SAMPLETIME_247CYCLES_5;
+    case ADC_LL_SAMPLING_TIME_640CYCLES_5:
+        return ADC_SAMPLETIME_640CYCLES_5;
+    case ADC_LL_SAMPLING_TIME_92CYCLES_5:
+    case ADC_LL_SAMPLING_TIME_DEFAULT:
+    default:
+        return ADC_SAMPLETIME_92CYCLES_5;
+    }
+}
+
+/**
+ * @brief Calculates the oversampler right shift for a given ratio.
+ *
+ * The oversampler accumulates `ratio` samples, producing a result with
+ * 12 + log2(ratio) bits. In normal mode the full log2(ratio) shift is applied
+ * so that the result stays 12-bit. In high-resolution mode the result is only
+ * shifted as far as needed to fit in ADC_LL_MAX_OVERSAMPLED_RESOLUTION_BITS.
+ *
+ * @param ratio Oversampling ratio (power of 2, 1 to 256).
+ * @param high_resolution Keep extra oversampling bits.
+ * @return Number of bits to shift the accumulated result right.
+ */
+static uint32_t get_oversampling_shift_bits(
+    uint32_t ratio,
+    bool high_resolution
+)
+{
+    uint32_t ratio_bits = 0;
+    while ((1U << ratio_bits) < ratio) {
+        ratio_bits++;
+    }
+
+    if (!high_resolution) {
+        return ratio_bits;
+    }
+
+    uint32_t accumulated_bits = ADC_LL_NATIVE_RESOLUTION_BITS + ratio_bits;
+    if (accumulated_bits <= ADC_LL_MAX_OVERSAMPLED_RESOLUTION_BITS) {
+        return 0;
+    }
+    return accumulated_bits - ADC_LL_MAX_OVERSAMPLED_RESOLUTION_BITS;
+}
+
+/**
+ * @brief Converts numeric right shift to HAL constant.
+ *
+ * @param shift_bits Number of bits to shift right (0 to 8).
+ * @return Corresponding HAL right bit shift constant.
+ */
+static uint32_t get_hal_right_bit_shift(uint32_t shift_bits)
+{
+    switch (shift_bits) {
+    case 0:
+        return ADC_RIGHTBITSHIFT_NONE;
+    case 1:
+        return ADC_RIGHTBITSHIFT_1;
+    case 2:
+        return ADC_RIGHTBITSHIFT_2;
+    case 3:
+        return ADC_RIGHTBITSHIFT_3;
+    case 4:
+        return ADC_RIGHTBITSHIFT_4;
+    case 5:
+        return ADC_RIGHTBITSHIFT_5;
+    case 6:
+        return ADC_RIGHTBITSHIFT_6;
+    case 7:
+        return ADC_RIGHTBITSHIFT_7;
+    case 8:
+        return ADC_RIGHTBITSHIFT_8;
+    default:
+        return ADC_RIGHTBITSHIFT_NONE; // Default fallback
+    }
+}
+
 /**
  * @brief Configures oversampling for an ADC handle.
  *
  * @param adc_handle ADC handle to configure.
  * @param oversampling_ratio Oversampling ratio to apply.
+ * @param high_resolution Keep extra oversampling bits.
  */
 static void configure_adc_oversampling(
     ADC_HandleTypeDef *adc_handle,
-    uint32_t oversampling_ratio
+    uint32_t oversampling_ratio,
+    bool high_resolution
 )
 {
     if (oversampling_ratio > 1) {
         adc_handle->Init.OversamplingMode = ENABLE;
         adc_handle->Init.Oversampling.Ratio =
             get_hal_oversampling_ratio(oversampling_ratio);
-        adc_handle->Init.Oversampling.RightBitShift = ADC_RIGHTBITSHIFT_4;
+        adc_handle->Init.Oversampling.RightBitShift = get_hal_right_bit_shift(
+            get_oversampling_shift_bits(oversampling_ratio, high_resolution)
+        );
         adc_handle->Init.Oversampling.TriggeredMode =
             ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
         adc_handle->Init.Oversampling.OversamplingStopReset =
@@ -551,11 +977,15 @@ static void configure_adc_oversampling(
  * @brief Sets common ADC initialization parameters.
  *
  * @param adc_handle ADC handle to configure.
+ * @param resolution Conversion resolution.
  */
-static void set_common_adc_init_params(ADC_HandleTypeDef *adc_handle)
+static void set_common_adc_init_params(
+    ADC_HandleTypeDef *adc_handle,
+    ADC_LL_Resolution resolution
+)
 {
     adc_handle->Init.ClockPrescaler = ADC_CLOCK_ASYNC_DIV1;
-    adc_handle->Init.Resolution = ADC_RESOLUTION_12B;
+    adc_handle->Init.Resolution = get_hal_resolution(resolution);
     adc_handle->Init.DataAlign = ADC_DATAALIGN_RIGHT;
     adc_handle->Init.ScanConvMode = DISABLE;
     adc_handle->Init.EOCSelection = ADC_EOC_SINGLE_CONV;
@@ -564,7 +994,10 @@ static void set_common_adc_init_params(ADC_HandleTypeDef *adc_handle)
     adc_handle->Init.NbrOfConversion = 1;
     adc_handle->Init.DiscontinuousConvMode = DISABLE;
     adc_handle->Init.SamplingMode = ADC_SAMPLING_MODE_NORMAL;
-    adc_handle->Init.DMAContinuousRequests = DISABLE;
+    // Linked-list acquisitions raise a DMA end of transfer after every item,
+    // which would stop the ADC in one-shot DMA mode
+    adc_handle->Init.DMAContinuousRequests =
+        g_adc_list.enabled ? ENABLE : DISABLE;
     adc_handle->Init.Overrun = ADC_OVR_DATA_PRESERVED;
 }
 
@@ -578,7 +1011,7 @@ static void configure_adc1_init(ADC_LL_Config const *config)
     ADCInstance *instance = &g_adc_instance;
 
     instance->adc_handles[0]->Instance = ADC1;
-    set_common_adc_init_params(instance->adc_handles[0]);
+    set_common_adc_init_params(instance->adc_handles[0], config->resolution);
 
     instance->adc_handles[0]->Init.ExternalTrigConv =
         get_hal_trigger_source(config->trigger_source);
@@ -586,7 +1019,9 @@ static void configure_adc1_init(ADC_LL_Config const *config)
         ADC_EXTERNALTRIGCONVEDGE_RISING;
 
     configure_adc_oversampling(
-        instance->adc_handles[0], config->oversampling_ratio
+        instance->adc_handles[0],
+        config->oversampling_ratio,
+        config->high_resolution
     );
 }
 
@@ -600,7 +1035,7 @@ static void configure_adc2_init(ADC_LL_Config const *config)
     ADCInstance *instance = &g_adc_instance;
 
     instance->adc_handles[1]->Instance = ADC2;
-    set_common_adc_init_params(instance->adc_handles[1]);
+    set_common_adc_init_params(instance->adc_handles[1], config->resolution);
 
     // Configure trigger based on mode
     if (config->mode == ADC_LL_MODE_INTERLEAVED) {
@@ -616,7 +1051,9 @@ static void configure_adc2_init(ADC_LL_Config const *config)
     }
 
     configure_adc_oversampling(
-        instance->adc_handles[1], config->oversampling_ratio
+        instance->adc_handles[1],
+        config->oversampling_ratio,
+        config->high_resolution
     );
 }
 
@@ -626,17 +1063,19 @@ static void configure_adc2_init(ADC_LL_Config const *config)
  * @param adc_handle ADC handle to configure.
  * @param channel_config ADC channel configuration structure.
  * @param channel ADC channel to configure.
+ * @param sampling_time Channel sampling time.
  */
 static void configure_adc_channel(
     ADC_HandleTypeDef *adc_handle,
     ADC_ChannelConfTypeDef *channel_config,
-    ADC_LL_Channel channel
+    ADC_LL_Channel channel,
+    ADC_LL_SamplingTime sampling_time
 )
 {
     *channel_config = (ADC_ChannelConfTypeDef){ 0 };
     channel_config->Channel = get_hal_adc_channel(channel);
     channel_config->Rank = ADC_REGULAR_RANK_1;
-    channel_config->SamplingTime = ADC_SAMPLETIME_92CYCLES_5;
+    channel_config->SamplingTime = get_hal_sampling_time(sampling_time);
     channel_config->SingleDiff = ADC_SINGLE_ENDED;
     channel_config->OffsetNumber = ADC_OFFSET_NONE;
     channel_config->Offset = 0;
@@ -660,6 +1099,8 @@ static void configure_dual_mode(ADC_LL_Config const *config)
     } else {
         multimode.Mode = ADC_DUALMODE_REGSIMULT;
     }
+    // 16-bit DMA words also hold 8- and 6-bit results, keeping one buffer
+    // layout for every resolution
     multimode.DMAAccessMode = ADC_DMAACCESSMODE_12_10_BITS;
     multimode.TwoSamplingDelay = ADC_TWOSAMPLINGDELAY_1CYCLE;
 
@@ -669,96 +1110,151 @@ static void configure_dual_mode(ADC_LL_Config const *config)
 }
 
 /**
- * @brief Calculates VDDA (analog supply voltage) using the internal VREFINT
- * channel.
- *
- * This function temporarily configures ADC1 to read the internal VREFINT
- * channel and calculates the actual VDDA (analog supply voltage) using the
- * factory calibration value. VREFINT is a stable ~1.21V internal reference,
- * and by measuring it we can determine what VDDA must be.
- *
- * @param instance Pointer to ADC instance structure.
+ * @brief Configures the injected sequence of ADC1 to convert VREFINT.
  */
-static void read_vdda_voltage(ADCInstance *instance)
+static void configure_vrefint_injected(void)
 {
-    LOG_FUNCTION_ENTRY();
-    ADC_ChannelConfTypeDef vref_config = { 0 };
-    uint32_t vref_adc_value = 0;
+    ADC_InjectionConfTypeDef injected_config = { 0 };
 
-    // Configure VREFINT channel
-    vref_config.Channel = ADC_CHANNEL_VREFINT;
-    vref_config.Rank = ADC_REGULAR_RANK_1;
+    injected_config.InjectedChannel = ADC_CHANNEL_VREFINT;
+    injected_config.InjectedRank = ADC_INJECTED_RANK_1;
     // Longer sampling for internal channels
-    vref_config.SamplingTime = ADC_SAMPLETIME_247CYCLES_5;
-    vref_config.SingleDiff = ADC_SINGLE_ENDED;
-    vref_config.OffsetNumber = ADC_OFFSET_NONE;
-    vref_config.Offset = 0;
-
-    if (HAL_ADC_ConfigChannel(&g_hadc1, &vref_config)) {
-        LOG_ERROR("Failed to configure VREFINT channel");
+    injected_config.InjectedSamplingTime = ADC_SAMPLETIME_247CYCLES_5;
+    injected_config.InjectedSingleDiff = ADC_SINGLE_ENDED;
+    injected_config.InjectedOffsetNumber = ADC_OFFSET_NONE;
+    injected_config.InjectedOffset = 0;
+    injected_config.InjectedNbrOfConversion = 1;
+    injected_config.InjectedDiscontinuousConvMode = DISABLE;
+    injected_config.AutoInjectedConv = DISABLE;
+    injected_config.QueueInjectedContext = DISABLE;
+    injected_config.ExternalTrigInjecConv = ADC_INJECTED_SOFTWARE_START;
+    injected_config.ExternalTrigInjecConvEdge =
+        ADC_EXTERNALTRIGINJECCONV_EDGE_NONE;
+    injected_config.InjecOversamplingMode = DISABLE;
+
+    if (HAL_ADCEx_InjectedConfigChannel(&g_hadc1, &injected_config) !=
+        HAL_OK) {
         THROW(ERROR_HARDWARE_FAULT);
     }
+}
 
-    // Temporarily switch to software trigger for VREFINT reading
-    uint32_t original_trigger = g_hadc1.Init.ExternalTrigConv;
-    uint32_t original_trigger_edge = g_hadc1.Init.ExternalTrigConvEdge;
-    g_hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
-    g_hadc1.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
+/**
+ * @brief Stores a VREFINT conversion result in the VDDA cache.
+ *
+ * VDDA is calculated from the factory calibration value: VREFINT is a stable
+ * ~1.21V internal reference, so its reading determines what VDDA must be.
+ *
+ * @param vref_adc_value Raw VREFINT conversion result.
+ */
+static void store_vdda(uint32_t vref_adc_value)
+{
+    // This macro calculates: VDDA = (VREFINT_CAL * 3300) / ADC_DATA
+    // where VREFINT_CAL is the factory calibration value when VDDA was 3.3V
+    g_vdda.vdda_mv = __HAL_ADC_CALC_VREFANALOG_VOLTAGE(
+        vref_adc_value, g_hadc1.Init.Resolution
+    );
+    g_vdda.timestamp_ms = PLATFORM_get_tick();
+}
 
-    // Re-initialize ADC with software trigger
-    if (HAL_ADC_Init(&g_hadc1) != HAL_OK) {
-        LOG_ERROR("Failed to reconfigure ADC for software trigger");
-        THROW(ERROR_HARDWARE_FAULT);
-    }
+/**
+ * @brief Measures VDDA once, blocking, through the injected sequence.
+ *
+ * Only used to seed the VDDA cache the first time ADC1 is brought up; later
+ * measurements run in the background. Does not reinitialize ADC1, so the
+ * regular group configuration is left untouched. The injected sequence must
+ * be reconfigured by the caller if injected conversions are in use.
+ */
+static void measure_vdda(void)
+{
+    LOG_FUNCTION_ENTRY();
 
-    // Start ADC conversion
-    if (HAL_ADC_Start(&g_hadc1)) {
-        LOG_ERROR("Failed to start ADC conversion");
-        THROW(ERROR_HARDWARE_FAULT);
-    }
+    configure_vrefint_injected();
 
-    // Wait for conversion completion
-    uint32_t const sample_rate_khz = ADC_LL_get_sample_rate() / SI_KILO_INT;
-    if (!sample_rate_khz) {
-        LOG_ERROR(
-            "Invalid sample rate for VREFINT read: %lu Hz", sample_rate_khz
-        );
+    if (HAL_ADCEx_InjectedStart(&g_hadc1) != HAL_OK) {
+        LOG_ERROR("Failed to start VREFINT conversion");
         THROW(ERROR_HARDWARE_FAULT);
     }
-    uint32_t timeout_ms = 2 / sample_rate_khz; // 2 samples timeout
-    timeout_ms = timeout_ms ? timeout_ms : 1; // Ensure at least 1 ms timeout
-    LOG_DEBUG("VREFINT read timeout: %lu ms", timeout_ms);
-    if (HAL_ADC_PollForConversion(&g_hadc1, timeout_ms)) {
-        HAL_ADC_Stop(&g_hadc1);
+
+    // A single VREFINT conversion takes a few microseconds
+    if (HAL_ADCEx_InjectedPollForConversion(
+            &g_hadc1, ADC_VREFINT_TIMEOUT_MS
+        ) != HAL_OK) {
+        HAL_ADCEx_InjectedStop(&g_hadc1);
         LOG_ERROR("ADC conversion timeout for VREFINT");
         THROW(ERROR_HARDWARE_FAULT);
     }
 
-    vref_adc_value = HAL_ADC_GetValue(&g_hadc1);
+    uint32_t vref_adc_value =
+        HAL_ADCEx_InjectedGetValue(&g_hadc1, ADC_INJECTED_RANK_1);
+    HAL_ADCEx_InjectedStop(&g_hadc1);
+
+    store_vdda(vref_adc_value);
     LOG_DEBUG("VREFINT ADC value: %lu", vref_adc_value);
-    HAL_ADC_Stop(&g_hadc1);
+    LOG_DEBUG("Calculated VDDA: %lu mV", g_vdda.vdda_mv);
 
-    // Restore original trigger configuration
-    g_hadc1.Init.ExternalTrigConv = original_trigger;
-    g_hadc1.Init.ExternalTrigConvEdge = original_trigger_edge;
+    LOG_FUNCTION_EXIT();
+}
 
-    // Re-initialize ADC with original trigger configuration
-    if (HAL_ADC_Init(&g_hadc1) != HAL_OK) {
-        LOG_ERROR("Failed to restore ADC trigger configuration");
-        THROW(ERROR_HARDWARE_FAULT);
+/**
+ * @brief Seeds the VDDA cache if VDDA has never been measured.
+ */
+static void ensure_vdda_measured(void)
+{
+    if (g_vdda.vdda_mv == 0) {
+        measure_vdda();
     }
+}
 
-    // Calculate VDDA (analog supply voltage) using the HAL macro
-    // This macro calculates: VDDA = (VREFINT_CAL * 3300) / ADC_DATA
-    // where VREFINT_CAL is the factory calibration value when VDDA was 3.3V
-    uint32_t calculated_vdda =
-        __HAL_ADC_CALC_VREFANALOG_VOLTAGE(vref_adc_value, ADC_RESOLUTION_12B);
-    LOG_DEBUG("Calculated VDDA using HAL macro: %lu mV", calculated_vdda);
-    LOG_DEBUG("VREFINT_CAL factory value: %lu", (uint32_t)(*VREFINT_CAL_ADDR));
+/**
+ * @brief Drops a background VDDA refresh that was interrupted.
+ *
+ * Called when the injected sequence is stopped; the cached value is kept.
+ */
+static void abort_vdda_refresh(void)
+{
+    g_vdda.converting = false;
+    g_vdda.refresh_pending = false;
+}
+
+/**
+ * @brief Calibrates an ADC, or restores its last calibration factor.
+ *
+ * HAL_ADC_DeInit clears the calibration factor, so without the cache every
+ * reinitialization, e.g. each ADC arbiter slice switch, would run a full
+ * calibration. A factor younger than ADC_CALIBRATION_MAX_AGE_MS is written
+ * back instead; older factors are measured again to follow temperature and
+ * supply drift. The ADC is left disabled.
+ *
+ * @param hadc Pointer to the initialized, disabled ADC handle.
+ * @param calibration Calibration cache of the ADC.
+ */
+static void calibrate_adc_instance(
+    ADC_HandleTypeDef *hadc,
+    ADCCalibration *calibration
+)
+{
+    uint32_t const age_ms = PLATFORM_get_tick() - calibration->timestamp_ms;
+
+    if (calibration->valid && age_ms < ADC_CALIBRATION_MAX_AGE_MS) {
+        // The calibration factor can only be written while the ADC is enabled
+        if (ADC_Enable(hadc) != HAL_OK ||
+            HAL_ADCEx_Calibration_SetValue(
+                hadc, ADC_SINGLE_ENDED, calibration->factor
+            ) != HAL_OK ||
+            ADC_Disable(hadc) != HAL_OK) {
+            THROW(ERROR_HARDWARE_FAULT);
+        }
+        return;
+    }
 
-    instance->vref_mv = calculated_vdda;
+    if (HAL_ADCEx_Calibration_Start(hadc, ADC_SINGLE_ENDED) != HAL_OK) {
+        THROW(ERROR_HARDWARE_FAULT);
+    }
 
-    LOG_FUNCTION_EXIT();
+    calibration->factor =
+        HAL_ADCEx_Calibration_GetValue(hadc, ADC_SINGLE_ENDED);
+    calibration->timestamp_ms = PLATFORM_get_tick();
+    calibration->valid = true;
 }
 
 /**
@@ -773,84 +1269,290 @@ static void calibrate_adc(ADC_LL_Config const *config)
 {
     LOG_FUNCTION_ENTRY();
 
-    if (HAL_ADCEx_Calibration_Start(&g_hadc1, ADC_SINGLE_ENDED) != HAL_OK) {
-        THROW(ERROR_HARDWARE_FAULT);
-    }
+    calibrate_adc_instance(&g_hadc1, &g_adc_calibration[0]);
 
     if (config->mode == ADC_LL_MODE_SIMULTANEOUS ||
         config->mode == ADC_LL_MODE_INTERLEAVED) {
-        if (HAL_ADCEx_Calibration_Start(&g_hadc2, ADC_SINGLE_ENDED) != HAL_OK) {
-            THROW(ERROR_HARDWARE_FAULT);
-        }
+        calibrate_adc_instance(&g_hadc2, &g_adc_calibration[1]);
     }
 
     LOG_FUNCTION_EXIT();
 }
 
 /**
- * @brief Initializes the ADC peripheral(s).
+ * @brief Configures the injected sequence of ADC1.
  *
- * This function configures the ADC peripheral(s) with the specified settings.
- * For single-channel mode, only ADC1 is used. For dual-channel modes,
- * both ADC1 and ADC2 are configured.
- * The ADC uses timer-triggered conversions with DMA for all operations.
- * Oversampling is available for all configurations.
+ * Configures the injected channel GPIO and a single-rank, software-triggered
+ * injected sequence, and enables the ADC1 interrupt used to collect results.
  */
-void ADC_LL_init(ADC_LL_Config const *config)
+static void configure_injected_channel(void)
 {
-    LOG_FUNCTION_ENTRY();
+    ADC_InjectionConfTypeDef injected_config = { 0 };
+    ADC_LL_PinConfig pin_config = get_pin_config(g_adc_injected.channel);
 
-    validate_adc_config(config);
-    initialize_adc_instance(config);
+    configure_adc_gpio(&pin_config);
 
-    ADCInstance *instance = &g_adc_instance;
+    injected_config.InjectedChannel =
+        get_hal_adc_channel(g_adc_injected.channel);
+    injected_config.InjectedRank = ADC_INJECTED_RANK_1;
+    // Longer sampling for slow, possibly high-impedance, sources
+    injected_config.InjectedSamplingTime = ADC_SAMPLETIME_247CYCLES_5;
+    injected_config.InjectedSingleDiff = ADC_SINGLE_ENDED;
+    injected_config.InjectedOffsetNumber = ADC_OFFSET_NONE;
+    injected_config.InjectedOffset = 0;
+    injected_config.InjectedNbrOfConversion = 1;
+    injected_config.InjectedDiscontinuousConvMode = DISABLE;
+    injected_config.AutoInjectedConv = DISABLE;
+    injected_config.QueueInjectedContext = DISABLE;
+    injected_config.ExternalTrigInjecConv = ADC_INJECTED_SOFTWARE_START;
+    injected_config.ExternalTrigInjecConvEdge =
+        ADC_EXTERNALTRIGINJECCONV_EDGE_NONE;
+    injected_config.InjecOversamplingMode = DISABLE;
+
+    if (HAL_ADCEx_InjectedConfigChannel(&g_hadc1, &injected_config) !=
+        HAL_OK) {
+        THROW(ERROR_HARDWARE_FAULT);
+    }
 
-    // Set ADC instances first (required for calibration)
-    g_hadc1.Instance = ADC1;
-    g_hadc2.Instance = ADC2;
+    HAL_NVIC_SetPriority(ADC1_IRQn, ADC_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(ADC1_IRQn);
+}
 
-    // Configure ADC1 parameters
-    configure_adc1_init(config);
+/**
+ * @brief Brings up ADC1 for injected conversions only.
+ *
+ * Used when no regular acquisition owns ADC1. The regular group is left on
+ * software trigger and never started.
+ */
+static void init_adc1_standalone(void)
+{
+    LOG_FUNCTION_ENTRY();
 
-    // Configure ADC2 parameters for dual modes
-    if (config->mode == ADC_LL_MODE_SIMULTANEOUS ||
-        config->mode == ADC_LL_MODE_INTERLEAVED) {
-        configure_adc2_init(config);
-    }
+    g_hadc1.Instance = ADC1;
+    set_common_adc_init_params(&g_hadc1, ADC_LL_RESOLUTION_12BIT);
+    g_hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+    g_hadc1.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
+    g_hadc1.Init.OversamplingMode = DISABLE;
 
-    // Initialize ADC1
     if (HAL_ADC_Init(&g_hadc1) != HAL_OK) {
         THROW(ERROR_HARDWARE_FAULT);
     }
 
-    // Initialize ADC2 for dual modes
-    if (config->mode == ADC_LL_MODE_SIMULTANEOUS ||
-        config->mode == ADC_LL_MODE_INTERLEAVED) {
-        if (HAL_ADC_Init(&g_hadc2) != HAL_OK) {
-            THROW(ERROR_HARDWARE_FAULT);
-        }
+    calibrate_adc_instance(&g_hadc1, &g_adc_calibration[0]);
+
+    ensure_vdda_measured();
+
+    g_adc_injected.standalone = true;
+
+    LOG_FUNCTION_EXIT();
+}
+
+/**
+ * @brief Forgets the analog watchdogs when ADC1 is reinitialized.
+ *
+ * Deinitializing an ADC resets its watchdog registers, so the watchdogs only
+ * have to be marked as unconfigured.
+ */
+static void reset_watchdogs(void)
+{
+    for (uint32_t i = 0; i < ADC_LL_WATCHDOG_COUNT; i++) {
+        g_adc_watchdogs[i] = (ADCWatchdogInstance){ 0 };
+    }
+}
+
+/**
+ * @brief Releases ADC1 from standalone injected operation.
+ *
+ * Called before a regular acquisition takes over ADC1, so that ADC1 goes
+ * through a full initialization including MSP and DMA setup.
+ */
+static void release_adc1_standalone(void)
+{
+    if (!g_adc_injected.standalone) {
+        return;
+    }
+
+    HAL_ADCEx_InjectedStop_IT(&g_hadc1);
+    HAL_NVIC_DisableIRQ(ADC1_IRQn);
+    abort_vdda_refresh();
+
+    if (HAL_ADC_DeInit(&g_hadc1) != HAL_OK) {
+        THROW(ERROR_HARDWARE_FAULT);
+    }
+
+    g_adc_injected.standalone = false;
+}
+
+/**
+ * @brief Restarts an injected reading that was interrupted.
+ *
+ * Stopping or reinitializing the regular group also aborts any ongoing
+ * injected conversion. The interrupted reading is restarted from scratch.
+ */
+static void resume_injected_conversion(void)
+{
+    // A VREFINT conversion in progress resumes the reading when it completes
+    if (!g_adc_injected.initialized || !g_adc_injected.busy ||
+        g_vdda.converting) {
+        return;
+    }
+
+    g_adc_injected.accumulator = 0;
+    g_adc_injected.remaining = g_adc_injected.oversampling_ratio;
+
+    if (HAL_ADCEx_InjectedStart_IT(&g_hadc1) != HAL_OK) {
+        g_adc_injected.busy = false;
+        THROW(ERROR_HARDWARE_FAULT);
+    }
+}
+
+/**
+ * @brief Starts a background VDDA refresh on the injected sequence.
+ *
+ * The refresh is deferred while an injected reading is in progress and
+ * skipped if ADC1 is not enabled. Errors are logged and the cached value is
+ * kept, since the refresh runs in the background.
+ */
+static void start_vdda_refresh(void)
+{
+    if (g_vdda.converting ||
+        (!g_adc_instance.initialized && !g_adc_injected.standalone)) {
+        return;
+    }
+
+    if (g_adc_injected.busy) {
+        g_vdda.refresh_pending = true;
+        return;
+    }
+
+    g_vdda.refresh_pending = false;
+    g_vdda.converting = true;
+
+    Error error = ERROR_NONE;
+    TRY
+    {
+        configure_vrefint_injected();
+        HAL_NVIC_SetPriority(ADC1_IRQn, ADC_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(ADC1_IRQn);
+        if (HAL_ADCEx_InjectedStart_IT(&g_hadc1) != HAL_OK) {
+            THROW(ERROR_HARDWARE_FAULT);
+        }
+    }
+    CATCH(error)
+    {
+        LOG_ERROR("VDDA refresh failed, error %d", error);
+        g_vdda.converting = false;
+    }
+}
+
+/**
+ * @brief Completes a background VDDA refresh.
+ *
+ * Stores the result and hands the injected sequence back to the injected
+ * channel, resuming a reading that was requested in the meantime.
+ *
+ * @param hadc Pointer to the ADC handle structure.
+ */
+static void complete_vdda_refresh(ADC_HandleTypeDef *hadc)
+{
+    store_vdda(HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_1));
+    g_vdda.converting = false;
+
+    if (!g_adc_injected.initialized) {
+        return;
+    }
+
+    Error error = ERROR_NONE;
+    TRY
+    {
+        configure_injected_channel();
+        resume_injected_conversion();
+    }
+    CATCH(error)
+    {
+        LOG_ERROR("Failed to restore injected channel, error %d", error);
+    }
+}
+
+/**
+ * @brief Initializes the ADC peripheral(s).
+ *
+ * This function configures the ADC peripheral(s) with the specified settings.
+ * For single-channel mode, only ADC1 is used. For dual-channel modes,
+ * both ADC1 and ADC2 are configured.
+ * The ADC uses timer-triggered conversions with DMA for all operations.
+ * Oversampling is available for all configurations.
+ */
+void ADC_LL_init(ADC_LL_Config const *config)
+{
+    LOG_FUNCTION_ENTRY();
+
+    validate_adc_config(config);
+    release_adc1_standalone();
+    reset_watchdogs();
+    initialize_adc_instance(config);
+    initialize_linked_list(config);
+
+    ADCInstance *instance = &g_adc_instance;
+
+    // Set ADC instances first (required for calibration)
+    g_hadc1.Instance = ADC1;
+    g_hadc2.Instance = ADC2;
+
+    // Configure ADC1 parameters
+    configure_adc1_init(config);
+
+    // Configure ADC2 parameters for dual modes
+    if (config->mode == ADC_LL_MODE_SIMULTANEOUS ||
+        config->mode == ADC_LL_MODE_INTERLEAVED) {
+        configure_adc2_init(config);
+    }
+
+    // Initialize ADC1
+    if (HAL_ADC_Init(&g_hadc1) != HAL_OK) {
+        THROW(ERROR_HARDWARE_FAULT);
+    }
+
+    // Initialize ADC2 for dual modes
+    if (config->mode == ADC_LL_MODE_SIMULTANEOUS ||
+        config->mode == ADC_LL_MODE_INTERLEAVED) {
+        if (HAL_ADC_Init(&g_hadc2) != HAL_OK) {
+            THROW(ERROR_HARDWARE_FAULT);
+        }
     }
 
     // Perform ADC calibration after initialization
     calibrate_adc(config);
 
-    // Read VDDA voltage
-    read_vdda_voltage(instance);
+    // Seed the VDDA cache on first use; later refreshes run in the background
+    ensure_vdda_measured();
 
     // Configure channels
     configure_adc_channel(
-        instance->adc_handles[0], &g_config, config->channels[0]
+        instance->adc_handles[0],
+        &g_config,
+        config->channels[0],
+        config->sampling_time
     );
 
     // Configure ADC2 channel and dual mode for dual modes
     if (config->mode == ADC_LL_MODE_SIMULTANEOUS ||
         config->mode == ADC_LL_MODE_INTERLEAVED) {
         configure_adc_channel(
-            instance->adc_handles[1], &g_config2, config->channels[1]
+            instance->adc_handles[1],
+            &g_config2,
+            config->channels[1],
+            config->sampling_time
         );
 
         configure_dual_mode(config);
     }
+
+    // Keep injected conversions available alongside the regular group
+    if (g_adc_injected.initialized) {
+        configure_injected_channel();
+        resume_injected_conversion();
+    }
 }
 
 /**
@@ -877,6 +1579,7 @@ void ADC_LL_deinit(void)
 
     // Disable interrupts
     HAL_NVIC_DisableIRQ(ADC1_IRQn);
+    abort_vdda_refresh();
     if (instance->mode == ADC_LL_MODE_SIMULTANEOUS ||
         instance->mode == ADC_LL_MODE_INTERLEAVED) {
         HAL_NVIC_DisableIRQ(ADC2_IRQn);
@@ -885,6 +1588,14 @@ void ADC_LL_deinit(void)
         HAL_NVIC_DisableIRQ(GPDMA1_Channel6_IRQn);
     }
 
+    reset_watchdogs();
+
+    // Detach the linked-list queue so the channel can run single blocks again
+    if (g_adc_list.enabled) {
+        HAL_DMAEx_List_UnLinkQ(g_hadc1.DMA_Handle);
+        g_adc_list.enabled = false;
+    }
+
     // Deinitialize ADC peripherals
     if (HAL_ADC_DeInit(instance->adc_handles[0]) != HAL_OK) {
         THROW(ERROR_HARDWARE_FAULT);
@@ -903,10 +1614,21 @@ void ADC_LL_deinit(void)
     }
     instance->buffer_size = 0;
     instance->complete_callback = nullptr;
+    instance->segment_callback = nullptr;
+    instance->half_complete_callback = nullptr;
     instance->mode = ADC_LL_MODE_SINGLE;
     instance->oversampling_ratio = 1;
-    instance->vref_mv = 0;
+    instance->high_resolution = false;
+    instance->resolution = ADC_LL_RESOLUTION_12BIT;
+    instance->sampling_time = ADC_LL_SAMPLING_TIME_DEFAULT;
     instance->initialized = false;
+
+    // Hand ADC1 back to injected conversions if they are still in use
+    if (g_adc_injected.initialized) {
+        init_adc1_standalone();
+        configure_injected_channel();
+        resume_injected_conversion();
+    }
 }
 
 /**
@@ -926,29 +1648,39 @@ void ADC_LL_start(void)
     g_hadc1.State = HAL_ADC_STATE_READY;
     g_hadc2.State = HAL_ADC_STATE_READY;
 
+    uint16_t *buffer = g_adc_instance.buffer_data;
+    uint32_t buffer_size = g_adc_instance.buffer_size;
+
+    // The HAL programs the first linked-list item from the start arguments
+    g_adc_instance.block_count = 0;
+
+    if (g_adc_list.enabled) {
+        g_adc_list.current_node = 0;
+        buffer = g_adc_list.segments[0].buffer;
+        buffer_size = g_adc_list.segments[0].size;
+        if (buffer_size > ADC_DMA_MAX_BLOCK_SAMPLES) {
+            buffer_size = ADC_DMA_MAX_BLOCK_SAMPLES;
+        }
+    }
+
     if (g_adc_instance.mode == ADC_LL_MODE_SIMULTANEOUS ||
         g_adc_instance.mode == ADC_LL_MODE_INTERLEAVED) {
         // For dual mode DMA with 32-bit transfers, buffer_size should be in
         // 32-bit words Each 32-bit word contains 2x 16-bit ADC samples (ADC1 +
         // ADC2)
-        uint32_t dma_transfer_count = g_adc_instance.buffer_size / 2;
+        uint32_t dma_transfer_count = buffer_size / 2;
 
         // Start multimode DMA conversion (both simultaneous and interleaved use
         // multimode)
         if (HAL_ADCEx_MultiModeStart_DMA(
-                &g_hadc1,
-                (uint32_t *)g_adc_instance.buffer_data,
-                dma_transfer_count
+                &g_hadc1, (uint32_t *)buffer, dma_transfer_count
             ) != HAL_OK) {
             THROW(ERROR_HARDWARE_FAULT);
         }
     } else {
         // Single mode DMA conversion
-        if (HAL_ADC_Start_DMA(
-                &g_hadc1,
-                (uint32_t *)g_adc_instance.buffer_data,
-                g_adc_instance.buffer_size
-            ) != HAL_OK) {
+        if (HAL_ADC_Start_DMA(&g_hadc1, (uint32_t *)buffer, buffer_size) !=
+            HAL_OK) {
             THROW(ERROR_HARDWARE_FAULT);
         }
     }
@@ -977,6 +1709,9 @@ void ADC_LL_stop(void)
         // Single mode
         HAL_ADC_Stop_DMA(&g_hadc1);
     }
+
+    // Stopping the regular group also stops the injected group
+    resume_injected_conversion();
 }
 
 /**
@@ -992,6 +1727,26 @@ void ADC_LL_set_complete_callback(ADC_LL_CompleteCallback callback)
     g_adc_instance.complete_callback = callback;
 }
 
+/**
+ * @brief Sets the callback for half-transfer events.
+ *
+ * @param callback Pointer to the callback function to be set.
+ */
+void ADC_LL_set_half_complete_callback(ADC_LL_HalfCompleteCallback callback)
+{
+    g_adc_instance.half_complete_callback = callback;
+}
+
+/**
+ * @brief Sets the callback for segment complete events.
+ *
+ * @param callback Pointer to the callback function to be set.
+ */
+void ADC_LL_set_segment_callback(ADC_LL_SegmentCallback callback)
+{
+    g_adc_instance.segment_callback = callback;
+}
+
 /**
  * @brief Gets the current ADC operation mode.
  *
@@ -1112,8 +1867,9 @@ uint32_t ADC_LL_get_sample_rate(void)
         return 0;
     }
 
-    uint32_t sample_time_cycles_2x =
-        get_sample_time_cycles_2x(g_adc_instance.adc_configs[0].SamplingTime);
+    uint32_t sample_time_cycles_2x = get_sample_time_cycles_2x(
+        get_hal_sampling_time(g_adc_instance.sampling_time)
+    );
     if (sample_time_cycles_2x == 0) {
         LOG_ERROR("ADC_LL_get_sample_rate: Unsupported ADC sample time");
         return 0;
@@ -1131,33 +1887,164 @@ uint32_t ADC_LL_get_sample_rate(void)
     return adc_clock_hz / (total_cycles * prescaler);
 }
 
-uint32_t ADC_LL_get_reference_voltage(void)
+uint32_t ADC_LL_get_reference_voltage(uint32_t *age_ms)
 {
-    if (g_adc_instance.initialized) {
-        return g_adc_instance.vref_mv;
+    uint32_t age = PLATFORM_get_tick() - g_vdda.timestamp_ms;
+
+    if (g_vdda.vdda_mv != 0 && age >= ADC_VDDA_REFRESH_PERIOD_MS) {
+        // Keep the injected sequence stable while deciding who owns it
+        HAL_NVIC_DisableIRQ(ADC1_IRQn);
+        start_vdda_refresh();
+        if (g_adc_instance.initialized || g_adc_injected.initialized) {
+            HAL_NVIC_EnableIRQ(ADC1_IRQn);
+        }
     }
-    return 0;
+
+    if (age_ms != nullptr) {
+        *age_ms = age;
+    }
+    return g_vdda.vdda_mv;
 }
 
-uint32_t ADC_LL_get_max_sample_rate(ADC_LL_Mode mode)
+void ADC_LL_prepare(void)
 {
-    uint32_t const max_single_channel = 5000000; // 5 MHz
-    uint32_t const max_dual_channel = 10000000; // 10 MHz
+    if (g_vdda.vdda_mv != 0 || g_adc_instance.initialized ||
+        g_adc_injected.initialized) {
+        return;
+    }
+
+    init_adc1_standalone();
+    release_adc1_standalone();
+}
+
+uint32_t ADC_LL_get_max_sample_rate(
+    ADC_LL_Mode mode,
+    ADC_LL_Resolution resolution,
+    ADC_LL_SamplingTime sampling_time
+)
+{
+    if (resolution >= ADC_LL_RESOLUTION_COUNT ||
+        sampling_time >= ADC_LL_SAMPLING_TIME_COUNT) {
+        return 0;
+    }
+
+    uint32_t adc_clock_hz =
+        PLATFORM_get_peripheral_clock_speed(PLATFORM_CLOCK_ADC1);
+
+    // Sample and conversion times are both n.5 cycles, so the sum is whole
+    uint32_t total_cycles =
+        (get_sample_time_cycles_2x(get_hal_sampling_time(sampling_time)) +
+         get_conversion_time_cycles_2x(get_hal_resolution(resolution))) /
+        2;
+    uint32_t max_single_channel = adc_clock_hz / total_cycles;
+
     switch (mode) {
     case ADC_LL_MODE_SINGLE:
     case ADC_LL_MODE_SIMULTANEOUS:
         return max_single_channel;
     case ADC_LL_MODE_INTERLEAVED:
-        return max_dual_channel;
+        return max_single_channel * 2;
     default:
         return 0;
     }
 }
 
+/**
+ * @brief Handles the completion of one linked-list item.
+ *
+ * Items complete in queue order, so the item that just finished is tracked
+ * with a cursor. The segment callback fires when the last item of a segment
+ * completes. At the end of a non-circular queue the ADC is stopped, since
+ * continuous DMA requests would otherwise overrun it, and the acquisition is
+ * reported as complete.
+ */
+static void complete_linked_list_node(void)
+{
+    ADCLinkedList *list = &g_adc_list;
+    uint32_t node = list->current_node;
+    uint32_t segment = list->items[node].segment;
+    bool const last_node = node + 1 == list->node_count;
+    bool const segment_done =
+        last_node || list->items[node + 1].segment != segment;
+
+    list->current_node = last_node ? 0 : node + 1;
+
+    if (last_node && !list->circular) {
+        LL_ADC_REG_StopConversion(g_hadc1.Instance);
+    }
+
+    if (segment_done && g_adc_instance.segment_callback != nullptr) {
+        ADC_LL_Segment const *done = &list->segments[segment];
+        g_adc_instance.segment_callback(segment, done->buffer, done->size);
+    }
+
+    if (last_node && !list->circular &&
+        g_adc_instance.complete_callback != nullptr) {
+        g_adc_instance.complete_callback(
+            list->segments[0].buffer, list->total_samples
+        );
+    }
+}
+
+/**
+ * @brief Reports a filled half of the DMA block being written.
+ *
+ * The halves are split where the DMA raises its half-transfer event, which
+ * in dual modes falls on a sample pair boundary.
+ *
+ * @param half Index of the filled half (0 or 1).
+ */
+static void report_half_complete(uint32_t half)
+{
+    ADCInstance *instance = &g_adc_instance;
+
+    if (!instance->initialized || instance->half_complete_callback == nullptr) {
+        return;
+    }
+
+    uint16_t *buffer = instance->buffer_data;
+    uint32_t samples = instance->buffer_size;
+
+    if (g_adc_list.enabled) {
+        ADCListItem const *item = &g_adc_list.items[g_adc_list.current_node];
+        buffer = item->buffer;
+        samples = item->samples;
+    }
+
+    uint32_t const unit = (instance->mode == ADC_LL_MODE_SINGLE) ? 1 : 2;
+    uint32_t const first_half = samples / unit / 2 * unit;
+
+    if (half == 0) {
+        samples = first_half;
+    } else {
+        // The DMA transfers whole sample pairs in dual modes
+        samples = samples / unit * unit - first_half;
+        buffer += first_half;
+    }
+
+    instance->half_complete_callback(
+        buffer, half, samples, instance->block_count++
+    );
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    report_half_complete(0);
+}
+
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
 {
     (void)hadc;
 
+    // Report the second half before the item cursor moves on
+    report_half_complete(1);
+
+    if (g_adc_instance.initialized && g_adc_list.enabled) {
+        complete_linked_list_node();
+        return;
+    }
+
     if (g_adc_instance.initialized &&
         g_adc_instance.complete_callback != nullptr) {
         uint32_t total_samples = 0;
@@ -1178,15 +2065,167 @@ void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
     }
 }
 
-void GPDMA1_Channel6_IRQHandler(void)
+/**
+ * @brief Validates injected configuration parameters.
+ *
+ * @param config Injected configuration to validate.
+ */
+static void validate_injected_config(ADC_LL_InjectedConfig const *config)
 {
+    if (config == nullptr || config->channel > ADC_LL_CHANNEL_15) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    validate_oversampling_ratio(config->oversampling_ratio);
+
+    if (g_adc_injected.initialized) {
+        THROW(ERROR_RESOURCE_BUSY);
+    }
+}
+
+void ADC_LL_injected_init(ADC_LL_InjectedConfig const *config)
+{
+    LOG_FUNCTION_ENTRY();
+
+    validate_injected_config(config);
+
+    g_adc_injected.channel = config->channel;
+    g_adc_injected.oversampling_ratio = config->oversampling_ratio;
+    g_adc_injected.shift_bits = get_oversampling_shift_bits(
+        config->oversampling_ratio, config->high_resolution
+    );
+    g_adc_injected.accumulator = 0;
+    g_adc_injected.remaining = 0;
+    g_adc_injected.busy = false;
+
+    // Bring up ADC1 unless a regular acquisition already owns it
+    if (!g_adc_instance.initialized) {
+        init_adc1_standalone();
+    }
+
+    configure_injected_channel();
+    g_adc_injected.initialized = true;
+
+    LOG_FUNCTION_EXIT();
+}
+
+void ADC_LL_injected_deinit(void)
+{
+    if (!g_adc_injected.initialized) {
+        return;
+    }
+
+    HAL_ADCEx_InjectedStop_IT(&g_hadc1);
+    abort_vdda_refresh();
+    g_adc_injected.busy = false;
+    g_adc_injected.initialized = false;
+    g_adc_injected.complete_callback = nullptr;
+
+    // Release ADC1 if no regular acquisition is using it
+    if (g_adc_injected.standalone) {
+        HAL_NVIC_DisableIRQ(ADC1_IRQn);
+        reset_watchdogs();
+        if (HAL_ADC_DeInit(&g_hadc1) != HAL_OK) {
+            THROW(ERROR_HARDWARE_FAULT);
+        }
+        g_adc_injected.standalone = false;
+    }
+}
+
+void ADC_LL_injected_start(void)
+{
+    if (!g_adc_injected.initialized) {
+        THROW(ERROR_RESOURCE_UNAVAILABLE);
+    }
+
+    // Keep a VREFINT refresh from completing between the two steps
+    HAL_NVIC_DisableIRQ(ADC1_IRQn);
+    g_adc_injected.busy = true;
+
+    Error error = ERROR_NONE;
+    TRY { resume_injected_conversion(); }
+    CATCH(error)
+    {
+        HAL_NVIC_EnableIRQ(ADC1_IRQn);
+        THROW(error);
+    }
+    HAL_NVIC_EnableIRQ(ADC1_IRQn);
+}
+
+void ADC_LL_set_injected_complete_callback(
+    ADC_LL_InjectedCompleteCallback callback
+)
+{
+    g_adc_injected.complete_callback = callback;
+}
+
+/**
+ * @brief Injected conversion complete callback.
+ *
+ * Accumulates injected conversions until the oversampling ratio is reached,
+ * then reports the shifted result. VREFINT conversions of a background VDDA
+ * refresh share the injected sequence and are handled separately.
+ *
+ * @param hadc Pointer to the ADC handle structure.
+ */
+void HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (g_vdda.converting) {
+        complete_vdda_refresh(hadc);
+        return;
+    }
+
+    if (!g_adc_injected.busy) {
+        return;
+    }
+
+    // Scale up to 12 bits if a regular acquisition lowered the resolution
+    g_adc_injected.accumulator +=
+        HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_1)
+        << get_resolution_shift_bits(g_adc_instance.resolution);
+
+    if (--g_adc_injected.remaining > 0) {
+        // Trigger the next conversion of this reading
+        HAL_ADCEx_InjectedStart_IT(hadc);
+        return;
+    }
+
+    g_adc_injected.busy = false;
+    if (g_adc_injected.complete_callback != nullptr) {
+        g_adc_injected.complete_callback(
+            (uint16_t)(g_adc_injected.accumulator >> g_adc_injected.shift_bits)
+        );
+    }
+
+    // Run a VDDA refresh that was deferred by this reading
+    if (g_vdda.refresh_pending && !g_adc_injected.busy) {
+        start_vdda_refresh();
+    }
+}
+
+void ADC1_IRQHandler(void)
+{
+    HAL_ADC_IRQHandler(&g_hadc1); // Handle injected conversion interrupts
+}
+
+void ADC2_IRQHandler(void)
+{
+    HAL_ADC_IRQHandler(&g_hadc2); // Handle ADC2 analog watchdog interrupts
+}
+
+RAMFUNC void GPDMA1_Channel6_IRQHandler(void)
+{
+    uint32_t start = CYCLE_LL_get_count();
     HAL_DMA_IRQHandler(&g_hdma_adc); // Handle single mode DMA interrupts
+    PERF_record(PERF_SOURCE_ADC_DMA, CYCLE_LL_get_count() - start);
 }
 
-void GPDMA1_Channel7_IRQHandler(void)
+RAMFUNC void GPDMA1_Channel7_IRQHandler(void)
 {
+    uint32_t start = CYCLE_LL_get_count();
     HAL_DMA_IRQHandler(&g_hdma_adc1_dual
     ); // Handle ADC1 dual mode DMA interrupts
+    PERF_record(PERF_SOURCE_ADC_DMA, CYCLE_LL_get_count() - start);
 }
 
 /**
@@ -1206,3 +2245,325 @@ void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
     uint32_t error_code = HAL_ADC_GetError(hadc);
     LOG_ERROR("HAL_ADC_ErrorCallback: error code = 0x%08lX", error_code);
 }
+
+/**
+ * @brief Gets the HAL analog watchdog number.
+ *
+ * @param watchdog Analog watchdog.
+ * @return HAL analog watchdog number.
+ */
+static uint32_t get_hal_watchdog(ADC_LL_Watchdog watchdog)
+{
+    switch (watchdog) {
+    case ADC_LL_WATCHDOG_2:
+        return ADC_ANALOGWATCHDOG_2;
+    case ADC_LL_WATCHDOG_3:
+        return ADC_ANALOGWATCHDOG_3;
+    case ADC_LL_WATCHDOG_1:
+    default:
+        return ADC_ANALOGWATCHDOG_1;
+    }
+}
+
+/**
+ * @brief Gets the interrupt source of an analog watchdog.
+ *
+ * @param watchdog Analog watchdog.
+ * @return HAL interrupt source.
+ */
+static uint32_t get_watchdog_interrupt(ADC_LL_Watchdog watchdog)
+{
+    switch (watchdog) {
+    case ADC_LL_WATCHDOG_2:
+        return ADC_IT_AWD2;
+    case ADC_LL_WATCHDOG_3:
+        return ADC_IT_AWD3;
+    case ADC_LL_WATCHDOG_1:
+    default:
+        return ADC_IT_AWD1;
+    }
+}
+
+/**
+ * @brief Gets the ADCs that convert a channel.
+ *
+ * @param channel ADC channel.
+ * @return Bit mask of ADCs converting the channel, bit n for ADC n + 1.
+ */
+static uint32_t get_watchdog_adc_mask(ADC_LL_Channel channel)
+{
+    ADCInstance const *instance = &g_adc_instance;
+
+    if (!instance->initialized) {
+        return channel == g_adc_injected.channel ? 0x1 : 0x0;
+    }
+
+    switch (instance->mode) {
+    case ADC_LL_MODE_SIMULTANEOUS:
+        return (channel == instance->channels[0] ? 0x1 : 0x0) |
+               (channel == instance->channels[1] ? 0x2 : 0x0);
+    case ADC_LL_MODE_INTERLEAVED:
+        // Both ADCs convert the same channel
+        return channel == instance->channels[0] ? 0x3 : 0x0;
+    case ADC_LL_MODE_SINGLE:
+    default:
+        return channel == instance->channels[0] ? 0x1 : 0x0;
+    }
+}
+
+/**
+ * @brief Converts a threshold from sample units to HAL units.
+ *
+ * The HAL expects thresholds in the units of the conversion resolution.
+ * Oversampled results are compared on bits [15:4] of the data register
+ * instead, so the threshold is scaled to that range first.
+ *
+ * @param value Threshold in sample units.
+ * @return Threshold for HAL_ADC_AnalogWDGConfig.
+ */
+static uint32_t get_watchdog_threshold(uint32_t value)
+{
+    ADCInstance const *instance = &g_adc_instance;
+    uint32_t const resolution_shift =
+        get_resolution_shift_bits(instance->resolution);
+
+    if (instance->oversampling_ratio > 1) {
+        return (value >> 4) >> resolution_shift;
+    }
+
+    uint32_t const max_value =
+        (1U << (ADC_LL_NATIVE_RESOLUTION_BITS - resolution_shift)) - 1;
+    return value < max_value ? value : max_value;
+}
+
+/**
+ * @brief Gets the DMA position of the regular acquisition.
+ *
+ * @return Index of the next sample the DMA writes, 0 if no regular
+ * acquisition is initialized.
+ */
+static uint32_t get_dma_position(void)
+{
+    ADCInstance const *instance = &g_adc_instance;
+    DMA_HandleTypeDef *hdma = g_hadc1.DMA_Handle;
+
+    if (!instance->initialized || hdma == nullptr) {
+        return 0;
+    }
+
+    uint32_t const remaining = __HAL_DMA_GET_COUNTER(hdma) / sizeof(uint16_t);
+
+    if (!g_adc_list.enabled) {
+        // Dual modes transfer whole sample pairs
+        uint32_t const unit = (instance->mode == ADC_LL_MODE_SINGLE) ? 1 : 2;
+        return instance->buffer_size / unit * unit - remaining;
+    }
+
+    // The item cursor lags behind while a transfer complete is pending
+    uint32_t node = g_adc_list.current_node;
+    if (__HAL_DMA_GET_FLAG(hdma, DMA_FLAG_TC) != 0) {
+        node = (node + 1 == g_adc_list.node_count) ? 0 : node + 1;
+    }
+
+    uint32_t position = 0;
+    for (uint32_t i = 0; i < node; i++) {
+        position += g_adc_list.items[i].samples;
+    }
+
+    return position + g_adc_list.items[node].samples - remaining;
+}
+
+/**
+ * @brief Applies a watchdog configuration to one ADC.
+ *
+ * @param hadc Pointer to the ADC handle.
+ * @param watchdog Analog watchdog.
+ * @param config Watchdog configuration, or nullptr to disable the watchdog.
+ */
+static void configure_watchdog(
+    ADC_HandleTypeDef *hadc,
+    ADC_LL_Watchdog watchdog,
+    ADC_LL_WatchdogConfig const *config
+)
+{
+    ADC_AnalogWDGConfTypeDef awd_config = { 0 };
+
+    awd_config.WatchdogNumber = get_hal_watchdog(watchdog);
+    awd_config.WatchdogMode = ADC_ANALOGWATCHDOG_NONE;
+    awd_config.ITMode = DISABLE;
+    awd_config.FilteringConfig = ADC_AWD_FILTERING_NONE;
+    awd_config.HighThreshold = get_watchdog_threshold(UINT16_MAX);
+    awd_config.LowThreshold = 0;
+
+    // Watchdogs 2 and 3 add channels to the monitored set, clear it first
+    if (HAL_ADC_AnalogWDGConfig(hadc, &awd_config) != HAL_OK) {
+        THROW(ERROR_HARDWARE_FAULT);
+    }
+
+    if (config == nullptr) {
+        return;
+    }
+
+    awd_config.WatchdogMode = ADC_ANALOGWATCHDOG_SINGLE_REGINJEC;
+    awd_config.Channel = get_hal_adc_channel(config->channel);
+    awd_config.ITMode = ENABLE;
+    awd_config.HighThreshold = get_watchdog_threshold(config->high_threshold);
+    awd_config.LowThreshold = get_watchdog_threshold(config->low_threshold);
+
+    if (HAL_ADC_AnalogWDGConfig(hadc, &awd_config) != HAL_OK) {
+        THROW(ERROR_HARDWARE_FAULT);
+    }
+}
+
+/**
+ * @brief Checks whether any ADC in a mask is converting.
+ *
+ * @param adc_mask Bit mask of ADCs, bit n for ADC n + 1.
+ * @return true if a regular or injected conversion is running.
+ */
+static bool is_conversion_running(uint32_t adc_mask)
+{
+    for (uint32_t i = 0; i < MAX_SIMULTANEOUS_CHANNELS; i++) {
+        ADC_TypeDef *adc = g_adc_instance.adc_handles[i]->Instance;
+        if ((adc_mask & (1U << i)) != 0 &&
+            (LL_ADC_REG_IsConversionOngoing(adc) != 0 ||
+             LL_ADC_INJ_IsConversionOngoing(adc) != 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ADC_LL_watchdog_init(
+    ADC_LL_Watchdog watchdog,
+    ADC_LL_WatchdogConfig const *config
+)
+{
+    LOG_FUNCTION_ENTRY();
+
+    if (watchdog >= ADC_LL_WATCHDOG_COUNT || config == nullptr ||
+        config->channel > ADC_LL_CHANNEL_15 ||
+        config->low_threshold > config->high_threshold) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    if (!g_adc_instance.initialized && !g_adc_injected.initialized) {
+        THROW(ERROR_RESOURCE_UNAVAILABLE);
+    }
+
+    uint32_t const adc_mask = get_watchdog_adc_mask(config->channel);
+    if (adc_mask == 0) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    // The HAL only changes the monitored channel while the ADC is idle
+    if (is_conversion_running(adc_mask)) {
+        THROW(ERROR_RESOURCE_BUSY);
+    }
+
+    for (uint32_t i = 0; i < MAX_SIMULTANEOUS_CHANNELS; i++) {
+        if ((adc_mask & (1U << i)) != 0) {
+            configure_watchdog(
+                g_adc_instance.adc_handles[i], watchdog, config
+            );
+        }
+    }
+
+    g_adc_watchdogs[watchdog].adc_mask = adc_mask;
+    g_adc_watchdogs[watchdog].initialized = true;
+
+    HAL_NVIC_SetPriority(ADC1_IRQn, ADC_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(ADC1_IRQn);
+    if ((adc_mask & 0x2) != 0) {
+        HAL_NVIC_SetPriority(ADC2_IRQn, ADC_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(ADC2_IRQn);
+    }
+
+    LOG_FUNCTION_EXIT();
+}
+
+void ADC_LL_watchdog_deinit(ADC_LL_Watchdog watchdog)
+{
+    if (watchdog >= ADC_LL_WATCHDOG_COUNT ||
+        !g_adc_watchdogs[watchdog].initialized) {
+        return;
+    }
+
+    uint32_t const adc_mask = g_adc_watchdogs[watchdog].adc_mask;
+    g_adc_watchdogs[watchdog] = (ADCWatchdogInstance){ 0 };
+
+    for (uint32_t i = 0; i < MAX_SIMULTANEOUS_CHANNELS; i++) {
+        if ((adc_mask & (1U << i)) != 0) {
+            __HAL_ADC_DISABLE_IT(
+                g_adc_instance.adc_handles[i], get_watchdog_interrupt(watchdog)
+            );
+        }
+    }
+}
+
+void ADC_LL_watchdog_arm(ADC_LL_Watchdog watchdog)
+{
+    if (watchdog >= ADC_LL_WATCHDOG_COUNT ||
+        !g_adc_watchdogs[watchdog].initialized) {
+        THROW(ERROR_RESOURCE_UNAVAILABLE);
+    }
+
+    uint32_t const interrupt = get_watchdog_interrupt(watchdog);
+
+    for (uint32_t i = 0; i < MAX_SIMULTANEOUS_CHANNELS; i++) {
+        if ((g_adc_watchdogs[watchdog].adc_mask & (1U << i)) != 0) {
+            ADC_HandleTypeDef *hadc = g_adc_instance.adc_handles[i];
+            // Interrupt and flag bits share their positions
+            __HAL_ADC_CLEAR_FLAG(hadc, interrupt);
+            __HAL_ADC_ENABLE_IT(hadc, interrupt);
+        }
+    }
+}
+
+void ADC_LL_set_watchdog_callback(ADC_LL_WatchdogCallback callback)
+{
+    g_watchdog_callback = callback;
+}
+
+/**
+ * @brief Handles an analog watchdog event.
+ *
+ * Disarms the watchdog on every ADC it monitors, so a signal that stays
+ * outside the window does not flood the CPU with interrupts, and reports the
+ * DMA position.
+ *
+ * @param watchdog Watchdog that detected the event.
+ */
+static void handle_watchdog_event(ADC_LL_Watchdog watchdog)
+{
+    uint32_t const interrupt = get_watchdog_interrupt(watchdog);
+
+    for (uint32_t i = 0; i < MAX_SIMULTANEOUS_CHANNELS; i++) {
+        if ((g_adc_watchdogs[watchdog].adc_mask & (1U << i)) != 0) {
+            __HAL_ADC_DISABLE_IT(g_adc_instance.adc_handles[i], interrupt);
+        }
+    }
+
+    if (g_adc_watchdogs[watchdog].initialized &&
+        g_watchdog_callback != nullptr) {
+        g_watchdog_callback(watchdog, get_dma_position());
+    }
+}
+
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    handle_watchdog_event(ADC_LL_WATCHDOG_1);
+}
+
+void HAL_ADCEx_LevelOutOfWindow2Callback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    handle_watchdog_event(ADC_LL_WATCHDOG_2);
+}
+
+void HAL_ADCEx_LevelOutOfWindow3Callback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    handle_watchdog_event(ADC_LL_WATCHDOG_3);
+}
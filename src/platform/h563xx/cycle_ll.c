@@ -0,0 +1,55 @@
+/**
+ * @file cycle_ll.c
+ * @brief Low-level CPU cycle counter implementation for STM32H563xx
+ *
+ * The cycle counter is the DWT CYCCNT register, which counts core clock
+ * cycles and wraps after about 17 s at 250 MHz. The tick hook runs from the
+ * 1 ms SysTick interrupt through HAL_SYSTICK_Callback.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include "stm32h5xx_hal.h"
+
+#include "cycle_ll.h"
+
+static CYCLE_LL_TickCallback volatile g_tick_callback = nullptr;
+
+void CYCLE_LL_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t CYCLE_LL_get_count(void) { return DWT->CYCCNT; }
+
+uint32_t CYCLE_LL_get_frequency(void) { return SystemCoreClock; }
+
+void CYCLE_LL_set_tick_callback(CYCLE_LL_TickCallback callback)
+{
+    g_tick_callback = callback;
+}
+
+uint32_t CYCLE_LL_enter_critical(void)
+{
+    uint32_t state = __get_PRIMASK();
+    __disable_irq();
+    return state;
+}
+
+void CYCLE_LL_exit_critical(uint32_t state) { __set_PRIMASK(state); }
+
+/**
+ * @brief SysTick callback
+ *
+ * Called by HAL_SYSTICK_IRQHandler from the 1 ms SysTick interrupt.
+ */
+void HAL_SYSTICK_Callback(void)
+{
+    CYCLE_LL_TickCallback callback = g_tick_callback;
+    if (callback) {
+        callback();
+    }
+}
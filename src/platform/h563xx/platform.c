@@ -17,6 +17,7 @@
  * - APB1/2/3 Clocks: 250 MHz (no division)
  * - ADC Clock: 75 MHz (from PLL2R)
  * - Flash Latency: 5 wait states for 250 MHz operation
+ * - ICACHE: enabled, 2-way set associative, to hide the flash wait states
  *
  * @author PSLab Team
  * @date 2025
@@ -163,6 +164,25 @@ static void system_clock_config(void)
     }
 }
 
+/**
+ * @brief Enable the instruction cache
+ *
+ * With 5 flash wait states at 250 MHz, every instruction fetch that misses
+ * the flash prefetch buffer stalls the core. The ICACHE serves code fetched
+ * over the C-bus from flash; code in SRAM bypasses it. 2-way set associative
+ * mode gives a better hit rate than direct mapped for code that alternates
+ * between a loop and the functions it calls.
+ */
+static void icache_config(void)
+{
+    if (HAL_ICACHE_ConfigAssociativityMode(ICACHE_2WAYS) != HAL_OK) {
+        THROW(ERROR_HARDWARE_FAULT);
+    }
+    if (HAL_ICACHE_Enable() != HAL_OK) {
+        THROW(ERROR_HARDWARE_FAULT);
+    }
+}
+
 /**
  * @brief Initialize the platform hardware
  *
@@ -181,6 +201,8 @@ static void system_clock_config(void)
  *    - Configure all peripheral clocks
  *    - Enable HSI48 for USB operations
  *
+ * 3. icache_config(): Enable the instruction cache
+ *
  * After this function completes successfully, the system will be running at
  * 250 MHz with all essential hardware initialized and ready for application
  * use.
@@ -197,6 +219,7 @@ void PLATFORM_init(void)
     }
 
     system_clock_config();
+    icache_config();
 
     LOG_INFO("Platform hardware initialized");
 }
@@ -280,7 +303,8 @@ uint32_t PLATFORM_get_peripheral_clock_speed(PLATFORM_PeripheralClock clock)
         return get_clock_speed(APB1_CLK);
     }
     if (clock == PLATFORM_CLOCK_TIMER1 || clock == PLATFORM_CLOCK_TIMER8 ||
-        clock == PLATFORM_CLOCK_TIMER16 || clock == PLATFORM_CLOCK_TIMER17) {
+        clock == PLATFORM_CLOCK_TIMER15 || clock == PLATFORM_CLOCK_TIMER16 ||
+        clock == PLATFORM_CLOCK_TIMER17) {
         return get_clock_speed(APB2_CLK);
     }
 
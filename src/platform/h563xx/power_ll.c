@@ -0,0 +1,77 @@
+/**
+ * @file power_ll.c
+ * @brief Low-level power mode implementation for STM32H563xx
+ *
+ * Sleep mode is entered with WFI and SLEEPDEEP cleared. The wake-up source
+ * is read from the NVIC pending bits while interrupts are still masked.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "stm32h5xx_hal.h"
+
+#include "power_ll.h"
+
+// ADC DMA channels, see adc_ll.c
+static IRQn_Type const g_dma_irqs[] = {
+    GPDMA1_Channel6_IRQn,
+    GPDMA1_Channel7_IRQn,
+};
+
+// UART interrupts and UART DMA channels, see uart_ll.c
+static IRQn_Type const g_uart_irqs[] = {
+    USART1_IRQn,          USART2_IRQn,          USART3_IRQn,
+    GPDMA1_Channel0_IRQn, GPDMA1_Channel1_IRQn, GPDMA1_Channel2_IRQn,
+    GPDMA1_Channel3_IRQn, GPDMA1_Channel4_IRQn, GPDMA1_Channel5_IRQn,
+};
+
+// General-purpose timer interrupts
+static IRQn_Type const g_timer_irqs[] = {
+    TIM2_IRQn, TIM3_IRQn, TIM4_IRQn, TIM5_IRQn, TIM6_IRQn, TIM7_IRQn,
+};
+
+/**
+ * @brief Check whether any interrupt in a list is pending
+ */
+static bool is_any_pending(IRQn_Type const *irqs, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (NVIC_GetPendingIRQ(irqs[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t POWER_LL_sleep(void)
+{
+    CLEAR_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+    __DSB();
+    __WFI();
+
+    uint32_t sources = 0;
+
+    if (NVIC_GetPendingIRQ(USB_DRD_FS_IRQn)) {
+        sources |= 1U << POWER_LL_WAKE_USB;
+    }
+    if (is_any_pending(g_dma_irqs, sizeof(g_dma_irqs) / sizeof(IRQn_Type))) {
+        sources |= 1U << POWER_LL_WAKE_DMA;
+    }
+    if (is_any_pending(g_uart_irqs, sizeof(g_uart_irqs) / sizeof(IRQn_Type))) {
+        sources |= 1U << POWER_LL_WAKE_UART;
+    }
+    bool timer_pending = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0 ||
+        is_any_pending(g_timer_irqs, sizeof(g_timer_irqs) / sizeof(IRQn_Type));
+    if (timer_pending) {
+        sources |= 1U << POWER_LL_WAKE_TIMER;
+    }
+    if (sources == 0) {
+        sources = 1U << POWER_LL_WAKE_OTHER;
+    }
+
+    return sources;
+}
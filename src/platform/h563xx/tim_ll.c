@@ -15,33 +15,100 @@
 
 #include "util/error.h"
 #include "util/logging.h"
+#include "util/timer_solver.h"
 
 #include "platform.h"
 #include "tim_ll.h"
 
-enum { TIMER_DEFAULT_PRESCALER = 0 }; // Default prescaler value
-// 0 prescaler divides the timer clock by 1
-
 /*Timer Instance Structure with parameters for any give Instance*/
 typedef struct {
     TIM_HandleTypeDef *htim;
+    TIM_TypeDef *regs;
+    PLATFORM_PeripheralClock clock;
+    uint32_t max_period;
     uint32_t frequency;
+    uint32_t prescaler;
     uint32_t period;
+    uint32_t solved_clock; // Clock of the last solved frequency
+    uint32_t solved_freq; // Last solved frequency, 0 if none
+    TIMER_SOLVER_Values solved; // Solution for solved_freq
     bool initialized;
 } TimerInstance;
 
 /*TImer Handle initialization*/
+static TIM_HandleTypeDef g_htim1 = { nullptr };
+static TIM_HandleTypeDef g_htim2 = { nullptr };
+static TIM_HandleTypeDef g_htim3 = { nullptr };
+static TIM_HandleTypeDef g_htim4 = { nullptr };
+static TIM_HandleTypeDef g_htim5 = { nullptr };
 static TIM_HandleTypeDef g_htim6 = { nullptr };
 static TIM_HandleTypeDef g_htim7 = { nullptr };
+static TIM_HandleTypeDef g_htim8 = { nullptr };
+static TIM_HandleTypeDef g_htim15 = { nullptr };
 
 /*Array of Timer Instances*/
 static TimerInstance g_timer_instances[TIM_NUM_COUNT] = {
     [TIM_NUM_6] = {
         .htim = &g_htim6,
+        .regs = TIM6,
+        .clock = PLATFORM_CLOCK_TIMER6,
+        .max_period = 0xFFFF,
         .initialized = false,
     },
     [TIM_NUM_7] = {
         .htim = &g_htim7,
+        .regs = TIM7,
+        .clock = PLATFORM_CLOCK_TIMER7,
+        .max_period = 0xFFFF,
+        .initialized = false,
+    },
+    [TIM_NUM_1] = {
+        .htim = &g_htim1,
+        .regs = TIM1,
+        .clock = PLATFORM_CLOCK_TIMER1,
+        .max_period = 0xFFFF,
+        .initialized = false,
+    },
+    [TIM_NUM_2] = {
+        .htim = &g_htim2,
+        .regs = TIM2,
+        .clock = PLATFORM_CLOCK_TIMER2,
+        .max_period = 0xFFFFFFFF,
+        .initialized = false,
+    },
+    [TIM_NUM_3] = {
+        .htim = &g_htim3,
+        .regs = TIM3,
+        .clock = PLATFORM_CLOCK_TIMER3,
+        .max_period = 0xFFFF,
+        .initialized = false,
+    },
+    [TIM_NUM_4] = {
+        .htim = &g_htim4,
+        .regs = TIM4,
+        .clock = PLATFORM_CLOCK_TIMER4,
+        .max_period = 0xFFFF,
+        .initialized = false,
+    },
+    [TIM_NUM_5] = {
+        .htim = &g_htim5,
+        .regs = TIM5,
+        .clock = PLATFORM_CLOCK_TIMER5,
+        .max_period = 0xFFFFFFFF,
+        .initialized = false,
+    },
+    [TIM_NUM_8] = {
+        .htim = &g_htim8,
+        .regs = TIM8,
+        .clock = PLATFORM_CLOCK_TIMER8,
+        .max_period = 0xFFFF,
+        .initialized = false,
+    },
+    [TIM_NUM_15] = {
+        .htim = &g_htim15,
+        .regs = TIM15,
+        .clock = PLATFORM_CLOCK_TIMER15,
+        .max_period = 0xFFFF,
         .initialized = false,
     },
 };
@@ -58,93 +125,105 @@ static TimerInstance g_timer_instances[TIM_NUM_COUNT] = {
  */
 static uint32_t get_timer_clock_frequency(TIM_Num tim)
 {
+    return PLATFORM_get_peripheral_clock_speed(g_timer_instances[tim].clock);
+}
 
-    TimerInstance *instance = &g_timer_instances[tim];
-
-    PLATFORM_PeripheralClock clock_type = PLATFORM_CLOCK_INVALID;
-
-    if (instance->htim->Instance == TIM1) {
-        clock_type = PLATFORM_CLOCK_TIMER1;
-    }
-    if (instance->htim->Instance == TIM2) {
-        clock_type = PLATFORM_CLOCK_TIMER2;
-    }
-    if (instance->htim->Instance == TIM3) {
-        clock_type = PLATFORM_CLOCK_TIMER3;
+/**
+ * @brief Initialize the timer base MSP (MCU Support Package).
+ *
+ * This function is called by the HAL when initializing the timer base.
+ * It enables the clock for the specified timer instance and performs any
+ * necessary hardware-specific initialization.
+ *
+ * @param htim Pointer to the TIM_HandleTypeDef structure that contains
+ *             the configuration information for the specified timer.
+ */
+void HAL_TIM_Base_MspInit(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM1) {
+        __HAL_RCC_TIM1_CLK_ENABLE();
     }
-    if (instance->htim->Instance == TIM4) {
-        clock_type = PLATFORM_CLOCK_TIMER4;
+
+    if (htim->Instance == TIM2) {
+        __HAL_RCC_TIM2_CLK_ENABLE();
     }
-    if (instance->htim->Instance == TIM5) {
-        clock_type = PLATFORM_CLOCK_TIMER5;
+
+    if (htim->Instance == TIM3) {
+        __HAL_RCC_TIM3_CLK_ENABLE();
     }
-    if (instance->htim->Instance == TIM6) {
-        clock_type = PLATFORM_CLOCK_TIMER6;
+
+    if (htim->Instance == TIM4) {
+        __HAL_RCC_TIM4_CLK_ENABLE();
     }
-    if (instance->htim->Instance == TIM7) {
-        clock_type = PLATFORM_CLOCK_TIMER7;
+
+    if (htim->Instance == TIM5) {
+        __HAL_RCC_TIM5_CLK_ENABLE();
     }
-    if (instance->htim->Instance == TIM8) {
-        clock_type = PLATFORM_CLOCK_TIMER8;
+
+    if (htim->Instance == TIM6) {
+        /* Enable TIM6 clock */
+        __HAL_RCC_TIM6_CLK_ENABLE();
     }
-    if (instance->htim->Instance == TIM16) {
-        clock_type = PLATFORM_CLOCK_TIMER16;
+
+    if (htim->Instance == TIM7) {
+        /* Enable TIM7 clock */
+        __HAL_RCC_TIM7_CLK_ENABLE();
     }
-    if (instance->htim->Instance == TIM17) {
-        clock_type = PLATFORM_CLOCK_TIMER17;
+
+    if (htim->Instance == TIM8) {
+        __HAL_RCC_TIM8_CLK_ENABLE();
     }
 
-    return PLATFORM_get_peripheral_clock_speed(clock_type
-    ); // Return the system clock frequency
+    if (htim->Instance == TIM15) {
+        __HAL_RCC_TIM15_CLK_ENABLE();
+    }
 }
 
 /**
- * @brief Calculate timer values based on the specified period.
+ * @brief Deinitialize the timer base MSP (MCU Support Package).
  *
- * This function calculates the timer values required to achieve a specific
- * period for the timer. It uses the timer clock frequency to determine the
- * appropriate prescaler and auto-reload values.
+ * Disables the clock of the timer, so that timers returned to the trigger
+ * pool do not keep running.
  *
- * @param tim The timer count of the timer
+ * @param htim Pointer to the TIM_HandleTypeDef structure that contains
+ *             the configuration information for the specified timer.
  */
-static void calculate_timer_values(TIM_Num tim)
+void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef *htim)
 {
-    TimerInstance *instance = &g_timer_instances[tim];
-    if (instance->frequency == 0) {
-        // frequency should not be zero
-        THROW(ERROR_INVALID_ARGUMENT);
+    if (htim->Instance == TIM1) {
+        __HAL_RCC_TIM1_CLK_DISABLE();
     }
 
-    uint32_t tim_clock = get_timer_clock_frequency(tim);
+    if (htim->Instance == TIM2) {
+        __HAL_RCC_TIM2_CLK_DISABLE();
+    }
 
-    if (tim_clock == 0) {
-        // Invalid timer clock frequency
-        THROW(ERROR_INVALID_ARGUMENT);
+    if (htim->Instance == TIM3) {
+        __HAL_RCC_TIM3_CLK_DISABLE();
     }
 
-    instance->period = (tim_clock / instance->frequency) - 1;
-}
+    if (htim->Instance == TIM4) {
+        __HAL_RCC_TIM4_CLK_DISABLE();
+    }
+
+    if (htim->Instance == TIM5) {
+        __HAL_RCC_TIM5_CLK_DISABLE();
+    }
 
-/**
- * @brief Initialize the timer base MSP (MCU Support Package).
- *
- * This function is called by the HAL when initializing the timer base.
- * It enables the clock for the specified timer instance and performs any
- * necessary hardware-specific initialization.
- *
- * @param htim Pointer to the TIM_HandleTypeDef structure that contains
- *             the configuration information for the specified timer.
- */
-void HAL_TIM_Base_MspInit(TIM_HandleTypeDef *htim)
-{
     if (htim->Instance == TIM6) {
-        /* Enable TIM6 clock */
-        __HAL_RCC_TIM6_CLK_ENABLE();
+        __HAL_RCC_TIM6_CLK_DISABLE();
     }
 
     if (htim->Instance == TIM7) {
-        /* Enable TIM7 clock */
-        __HAL_RCC_TIM7_CLK_ENABLE();
+        __HAL_RCC_TIM7_CLK_DISABLE();
+    }
+
+    if (htim->Instance == TIM8) {
+        __HAL_RCC_TIM8_CLK_DISABLE();
+    }
+
+    if (htim->Instance == TIM15) {
+        __HAL_RCC_TIM15_CLK_DISABLE();
     }
 }
 
@@ -166,22 +245,31 @@ void TIM_LL_init(TIM_Num tim, uint32_t freq)
 
     TimerInstance *instance = &g_timer_instances[tim];
 
-    instance->frequency = freq;
+    instance->htim->Instance = instance->regs;
+    instance->htim->Channel = TIM_CHANNEL_1;
+
+    uint32_t const tim_clock = get_timer_clock_frequency(tim);
 
-    if (tim == TIM_NUM_6) {
-        instance->htim->Instance = TIM6;
-        instance->htim->Channel = TIM_CHANNEL_1;
-    } else if (tim == TIM_NUM_7) {
-        instance->htim->Instance = TIM7;
-        instance->htim->Channel = TIM_CHANNEL_1;
+    // The ADC arbiter reinitializes a session's timer on every grant; only
+    // search for the prescaler when the rate or the clock has changed
+    if (freq != instance->solved_freq || tim_clock != instance->solved_clock) {
+        instance->solved =
+            TIMER_SOLVER_solve(tim_clock, freq, instance->max_period);
+        instance->solved_clock = tim_clock;
+        instance->solved_freq = freq;
     }
 
-    calculate_timer_values(tim);
+    TIMER_SOLVER_Values const values = instance->solved;
 
-    instance->htim->Init.Prescaler = TIMER_DEFAULT_PRESCALER;
+    instance->prescaler = values.prescaler;
+    instance->period = values.period;
+    instance->frequency = TIMER_SOLVER_get_frequency(tim_clock, values);
+
+    instance->htim->Init.Prescaler = instance->prescaler;
     instance->htim->Init.CounterMode = TIM_COUNTERMODE_UP;
     instance->htim->Init.Period = instance->period;
     instance->htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    instance->htim->Init.RepetitionCounter = 0;
     instance->htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
 
     if (HAL_TIM_Base_Init(instance->htim) != HAL_OK) {
@@ -191,6 +279,8 @@ void TIM_LL_init(TIM_Num tim, uint32_t freq)
     TIM_MasterConfigTypeDef s_master_config = { 0 };
 
     s_master_config.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    // Only TIM1 and TIM8 have TRGO2; the HAL ignores it on other timers
+    s_master_config.MasterOutputTrigger2 = TIM_TRGO2_UPDATE;
     s_master_config.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
 
     if (HAL_TIMEx_MasterConfigSynchronization(
@@ -222,6 +312,7 @@ void TIM_LL_deinit(TIM_Num tim)
     HAL_TIM_Base_DeInit(instance->htim);
 
     instance->frequency = 0;
+    instance->prescaler = 0;
     instance->period = 0;
     instance->initialized = false;
 }
@@ -252,3 +343,23 @@ void TIM_LL_stop(TIM_Num tim)
         THROW(ERROR_HARDWARE_FAULT);
     }
 }
+
+/**
+ * @brief Get the frequency a timer achieves for a requested frequency
+ *
+ * @param tim TIM instance
+ * @param freq Requested frequency in Hz
+ * @return Achieved frequency in Hz
+ */
+uint32_t TIM_LL_get_achievable_frequency(TIM_Num tim, uint32_t freq)
+{
+    if (tim >= TIM_NUM_COUNT) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    return TIMER_SOLVER_get_achievable_frequency(
+        get_timer_clock_frequency(tim),
+        freq,
+        g_timer_instances[tim].max_period
+    );
+}
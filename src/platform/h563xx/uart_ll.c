@@ -25,7 +25,10 @@
 #include "stm32h5xx_hal.h"
 
 #include "util/error.h"
+#include "util/perf.h"
+#include "util/ramfunc.h"
 
+#include "cycle_ll.h"
 #include "uart_ll.h"
 
 enum { UART_IRQ_PRIO = 3 }; // NVIC priority for UART interrupts
@@ -552,6 +555,17 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
     }
 }
 
+/**
+ * @brief Common UART DMA interrupt handler with service time accounting
+ * @param hdma DMA handle
+ */
+RAMFUNC static void handle_dma_irq(DMA_HandleTypeDef *hdma)
+{
+    uint32_t start = CYCLE_LL_get_count();
+    HAL_DMA_IRQHandler(hdma);
+    PERF_record(PERF_SOURCE_UART_DMA, CYCLE_LL_get_count() - start);
+}
+
 /**
  * @brief Common UART interrupt handler
  * @param huart UART handle
@@ -600,29 +614,47 @@ void USART3_IRQHandler(void) { uart_irq_handler(&g_huart3); }
 /**
  * @brief GPDMA1 Channel0 interrupt handler (USART1 TX)
  */
-void GPDMA1_Channel0_IRQHandler(void) { HAL_DMA_IRQHandler(&g_hdma_usart1_tx); }
+RAMFUNC void GPDMA1_Channel0_IRQHandler(void)
+{
+    handle_dma_irq(&g_hdma_usart1_tx);
+}
 
 /**
  * @brief GPDMA1 Channel1 interrupt handler (USART1 RX)
  */
-void GPDMA1_Channel1_IRQHandler(void) { HAL_DMA_IRQHandler(&g_hdma_usart1_rx); }
+RAMFUNC void GPDMA1_Channel1_IRQHandler(void)
+{
+    handle_dma_irq(&g_hdma_usart1_rx);
+}
 
 /**
  * @brief GPDMA1 Channel2 interrupt handler (USART2 TX)
  */
-void GPDMA1_Channel2_IRQHandler(void) { HAL_DMA_IRQHandler(&g_hdma_usart2_tx); }
+RAMFUNC void GPDMA1_Channel2_IRQHandler(void)
+{
+    handle_dma_irq(&g_hdma_usart2_tx);
+}
 
 /**
  * @brief GPDMA1 Channel3 interrupt handler (USART2 RX)
  */
-void GPDMA1_Channel3_IRQHandler(void) { HAL_DMA_IRQHandler(&g_hdma_usart2_rx); }
+RAMFUNC void GPDMA1_Channel3_IRQHandler(void)
+{
+    handle_dma_irq(&g_hdma_usart2_rx);
+}
 
 /**
  * @brief GPDMA1 Channel4 interrupt handler (USART3 TX)
  */
-void GPDMA1_Channel4_IRQHandler(void) { HAL_DMA_IRQHandler(&g_hdma_usart3_tx); }
+RAMFUNC void GPDMA1_Channel4_IRQHandler(void)
+{
+    handle_dma_irq(&g_hdma_usart3_tx);
+}
 
 /**
  * @brief GPDMA1 Channel5 interrupt handler (USART3 RX)
  */
-void GPDMA1_Channel5_IRQHandler(void) { HAL_DMA_IRQHandler(&g_hdma_usart3_rx); }
+RAMFUNC void GPDMA1_Channel5_IRQHandler(void)
+{
+    handle_dma_irq(&g_hdma_usart3_rx);
+}
@@ -10,6 +10,14 @@
  * This file defines the USB device, configuration, and string descriptors for
  * the device, and implements TinyUSB callbacks to integrate with the USB
  * stack.
+ *
+ * The device is a composite of two CDC ACM functions, one carrying SCPI and
+ * one the console, a USBTMC/USB488 function, which also carries SCPI, and a
+ * vendor class function with a bulk endpoint pair for streaming. The USBTMC
+ * function is what VISA libraries open; it has the optional interrupt IN
+ * endpoint for service requests. The BOS and MS OS 2.0 descriptors make
+ * Windows bind WinUSB to the vendor function, so that libusb and WinUSB hosts
+ * can open it without an INF file; Linux and macOS need no driver for it.
  */
 
 #include <assert.h>
@@ -18,20 +26,52 @@
 
 #include "lib/tinyusb/src/tusb.h"
 
+#include "usb_descriptors.h"
 #include "usb_ll.h"
 
 #define LANG ((char const[]){ 0x09, 0x04 }) // English
 #define MANU ("FOSSASIA")
 #define PROD ("Pocket Science Lab")
 #define SERI (nullptr) // Unique identifier, calculated at runtime from MCU UID.
+#define ICDC ("PSLab SCPI")
+#define ICON ("PSLab Console")
+#define IVEN ("PSLab Stream")
+#define ITMC ("PSLab USBTMC")
+
+enum {
+    IDX_LANG,
+    IDX_MANU,
+    IDX_PROD,
+    IDX_SERI,
+    IDX_CDC,
+    IDX_CONSOLE,
+    IDX_VENDOR,
+    IDX_TMC,
+    IDX_TOT
+};
 
-enum { IDX_LANG, IDX_MANU, IDX_PROD, IDX_SERI, IDX_TOT };
+enum {
+    TMC_DESC_LEN = TUD_USBTMC_IF_DESCRIPTOR_LEN +
+                   TUD_USBTMC_BULK_DESCRIPTORS_LEN +
+                   TUD_USBTMC_INT_DESCRIPTOR_LEN,
+    CONFIG_TOTAL_LEN = TUD_CONFIG_DESC_LEN + 2 * TUD_CDC_DESC_LEN +
+                       TUD_VENDOR_DESC_LEN + TMC_DESC_LEN,
+    BOS_TOTAL_LEN = TUD_BOS_DESC_LEN + TUD_BOS_MICROSOFT_OS_DESC_LEN,
+    MS_OS_20_DESC_LEN = 0xB2,
+    // CDC notifications are at most 8 bytes
+    USB_CDC_NOTIF_PACKET_SIZE = 8,
+    // Full-speed bulk endpoints move at most 64 bytes per packet
+    USB_BULK_PACKET_SIZE = 64,
+    // USB488 service request notifications are two bytes
+    USB_TMC_INT_PACKET_SIZE = 2,
+    USB_TMC_INT_INTERVAL_MS = 1,
+};
 
 // Device
 tusb_desc_device_t const g_DESC_DEVICE = {
     .bLength = sizeof(tusb_desc_device_t),
     .bDescriptorType = TUSB_DESC_DEVICE,
-    .bcdUSB = 0x0200,
+    .bcdUSB = 0x0210, // 2.1 for the BOS descriptor
     .bDeviceClass = TUSB_CLASS_MISC,
     .bDeviceSubClass = MISC_SUBCLASS_COMMON,
     .bDeviceProtocol = MISC_PROTOCOL_IAD,
@@ -45,21 +85,112 @@ tusb_desc_device_t const g_DESC_DEVICE = {
     .bNumConfigurations = 0x01
 };
 
-// Configuration + CDC
+// Configuration + CDC (SCPI) + CDC (console) + vendor + USBTMC
 uint8_t const g_DESC_CONFIGURATION[] = {
-    TUD_CONFIG_DESCRIPTOR(
-        1,
-        2,
-        0,
-        TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN,
-        0x00,
-        100
+    TUD_CONFIG_DESCRIPTOR(1, USB_ITF_COUNT, 0, CONFIG_TOTAL_LEN, 0x00, 100),
+    TUD_CDC_DESCRIPTOR(
+        USB_ITF_CDC,
+        IDX_CDC,
+        USB_EP_CDC_NOTIF,
+        USB_CDC_NOTIF_PACKET_SIZE,
+        USB_EP_CDC_OUT,
+        USB_EP_CDC_IN,
+        USB_BULK_PACKET_SIZE
+    ),
+    TUD_CDC_DESCRIPTOR(
+        USB_ITF_CONSOLE,
+        IDX_CONSOLE,
+        USB_EP_CONSOLE_NOTIF,
+        USB_CDC_NOTIF_PACKET_SIZE,
+        USB_EP_CONSOLE_OUT,
+        USB_EP_CONSOLE_IN,
+        USB_BULK_PACKET_SIZE
+    ),
+    TUD_VENDOR_DESCRIPTOR(
+        USB_ITF_VENDOR,
+        IDX_VENDOR,
+        USB_EP_VENDOR_OUT,
+        USB_EP_VENDOR_IN,
+        USB_BULK_PACKET_SIZE
+    ),
+    TUD_USBTMC_IF_DESCRIPTOR(
+        USB_ITF_TMC, 3, IDX_TMC, TUD_USBTMC_PROTOCOL_USB488
+    ),
+    TUD_USBTMC_BULK_DESCRIPTORS(
+        USB_EP_TMC_OUT, USB_EP_TMC_IN, USB_BULK_PACKET_SIZE
     ),
-    TUD_CDC_DESCRIPTOR(0, 4, 0x81, 8, 0x01, 0x82, 64)
+    TUD_USBTMC_INT_DESCRIPTOR(
+        USB_EP_TMC_INT, USB_TMC_INT_PACKET_SIZE, USB_TMC_INT_INTERVAL_MS
+    )
+};
+
+// BOS, pointing the host at the MS OS 2.0 descriptor set
+uint8_t const g_DESC_BOS[] = {
+    TUD_BOS_DESCRIPTOR(BOS_TOTAL_LEN, 1),
+    TUD_BOS_MS_OS_20_DESCRIPTOR(
+        MS_OS_20_DESC_LEN,
+        USB_VENDOR_REQUEST_MICROSOFT
+    )
+};
+
+// MS OS 2.0 descriptor set: WinUSB for the vendor function
+uint8_t const g_DESC_MS_OS_20[] = {
+    // Set header: length, type, Windows version, total length
+    U16_TO_U8S_LE(0x000A),
+    U16_TO_U8S_LE(MS_OS_20_SET_HEADER_DESCRIPTOR),
+    U32_TO_U8S_LE(0x06030000),
+    U16_TO_U8S_LE(MS_OS_20_DESC_LEN),
+
+    // Configuration subset header: length, type, index, reserved, length
+    U16_TO_U8S_LE(0x0008),
+    U16_TO_U8S_LE(MS_OS_20_SUBSET_HEADER_CONFIGURATION),
+    0,
+    0,
+    U16_TO_U8S_LE(MS_OS_20_DESC_LEN - 0x0A),
+
+    // Function subset header: length, type, first interface, reserved, length
+    U16_TO_U8S_LE(0x0008),
+    U16_TO_U8S_LE(MS_OS_20_SUBSET_HEADER_FUNCTION),
+    USB_ITF_VENDOR,
+    0,
+    U16_TO_U8S_LE(MS_OS_20_DESC_LEN - 0x0A - 0x08),
+
+    // Compatible ID: length, type, compatible ID, sub-compatible ID
+    U16_TO_U8S_LE(0x0014),
+    U16_TO_U8S_LE(MS_OS_20_FEATURE_COMPATBLE_ID),
+    'W', 'I', 'N', 'U', 'S', 'B', 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+    // Registry property: length, type, REG_MULTI_SZ, name length, name
+    U16_TO_U8S_LE(MS_OS_20_DESC_LEN - 0x0A - 0x08 - 0x08 - 0x14),
+    U16_TO_U8S_LE(MS_OS_20_FEATURE_REG_PROPERTY),
+    U16_TO_U8S_LE(0x0007),
+    U16_TO_U8S_LE(0x002A),
+    'D', 0x00, 'e', 0x00, 'v', 0x00, 'i', 0x00, 'c', 0x00, 'e', 0x00,
+    'I', 0x00, 'n', 0x00, 't', 0x00, 'e', 0x00, 'r', 0x00, 'f', 0x00,
+    'a', 0x00, 'c', 0x00, 'e', 0x00, 'G', 0x00, 'U', 0x00, 'I', 0x00,
+    'D', 0x00, 's', 0x00, 0x00, 0x00,
+
+    // Property data: length, then the interface GUID, double terminated
+    U16_TO_U8S_LE(0x0050),
+    '{', 0x00, '8', 0x00, 'C', 0x00, '3', 0x00, 'A', 0x00, '5', 0x00,
+    'B', 0x00, '7', 0x00, '1', 0x00, '-', 0x00, '2', 0x00, 'E', 0x00,
+    '4', 0x00, 'F', 0x00, '-', 0x00, '4', 0x00, 'B', 0x00, '9', 0x00,
+    'D', 0x00, '-', 0x00, 'A', 0x00, '6', 0x00, 'C', 0x00, '0', 0x00,
+    '-', 0x00, '5', 0x00, 'F', 0x00, '1', 0x00, '7', 0x00, 'D', 0x00,
+    '2', 0x00, 'E', 0x00, '3', 0x00, 'B', 0x00, '9', 0x00, '4', 0x00,
+    '8', 0x00, '}', 0x00, 0x00, 0x00, 0x00, 0x00
 };
 
+static_assert(
+    sizeof(g_DESC_MS_OS_20) == MS_OS_20_DESC_LEN,
+    "MS OS 2.0 descriptor set has the wrong length"
+);
+
 // String descriptors
-char const *g_string_desc_arr[] = { LANG, MANU, PROD, SERI };
+char const *g_string_desc_arr[] = {
+    LANG, MANU, PROD, SERI, ICDC, ICON, IVEN, ITMC,
+};
 
 uint8_t const *tud_descriptor_device_cb(void)
 {
@@ -70,6 +201,39 @@ uint8_t const *tud_descriptor_configuration_cb(uint8_t index)
     (void)index;
     return g_DESC_CONFIGURATION;
 }
+uint8_t const *tud_descriptor_bos_cb(void) { return g_DESC_BOS; }
+
+/**
+ * @brief TinyUSB vendor control request callback
+ *
+ * Answers the host's request for the MS OS 2.0 descriptor set, announced in
+ * the BOS descriptor. Other vendor requests are stalled.
+ */
+bool tud_vendor_control_xfer_cb(
+    uint8_t rhport,
+    uint8_t stage,
+    tusb_control_request_t const *request
+)
+{
+    enum { MS_OS_20_DESCRIPTOR_INDEX = 7 };
+
+    if (stage != CONTROL_STAGE_SETUP) {
+        return true;
+    }
+
+    if (request->bmRequestType_bit.type == TUSB_REQ_TYPE_VENDOR &&
+        request->bRequest == USB_VENDOR_REQUEST_MICROSOFT &&
+        request->wIndex == MS_OS_20_DESCRIPTOR_INDEX) {
+        return tud_control_xfer(
+            rhport,
+            request,
+            (void *)(uintptr_t)g_DESC_MS_OS_20,
+            sizeof(g_DESC_MS_OS_20)
+        );
+    }
+
+    return false;
+}
 uint16_t const *tud_descriptor_string_cb(uint8_t index, uint16_t langid)
 {
     if (index >= IDX_TOT) {
@@ -83,6 +247,10 @@ uint16_t const *tud_descriptor_string_cb(uint8_t index, uint16_t langid)
     static_assert(sizeof(LANG) == 2, "LANG id must be exactly two bytes");
     static_assert(sizeof(MANU) <= MAX_DESC_LEN, "MANU str too long");
     static_assert(sizeof(PROD) <= MAX_DESC_LEN, "PROD str too long");
+    static_assert(sizeof(ICDC) <= MAX_DESC_LEN, "ICDC str too long");
+    static_assert(sizeof(ICON) <= MAX_DESC_LEN, "ICON str too long");
+    static_assert(sizeof(IVEN) <= MAX_DESC_LEN, "IVEN str too long");
+    static_assert(sizeof(ITMC) <= MAX_DESC_LEN, "ITMC str too long");
     static_assert(USB_UUID_LEN <= MAX_DESC_LEN, "SERI str too long");
 
     size_t len = 0;
@@ -0,0 +1,57 @@
+/**
+ * @file usb_descriptors.h
+ * @brief USB interface and endpoint numbers of the PSLab composite device
+ *
+ * The device presents two CDC ACM interface pairs, one for SCPI and one for
+ * the console, a USBTMC/USB488 interface for SCPI control, and a vendor class
+ * interface with a bulk IN/OUT endpoint pair for streaming. These numbers are
+ * shared by the descriptors and the driver, which addresses the endpoints
+ * directly.
+ *
+ * The controller has eight endpoint registers, each serving the IN and OUT
+ * endpoints of one number and transfer type. Bulk endpoints are therefore
+ * used in pairs of the same number, and every interrupt endpoint takes a
+ * register of its own: control, two CDC notifications, three CDC/vendor bulk
+ * pairs, the USBTMC bulk pair and the USBTMC interrupt endpoint fill all
+ * eight.
+ */
+
+#ifndef PSLAB_USB_DESCRIPTORS_H
+#define PSLAB_USB_DESCRIPTORS_H
+
+/**
+ * @brief Interface numbers
+ */
+enum {
+    USB_ITF_CDC = 0,
+    USB_ITF_CDC_DATA,
+    USB_ITF_CONSOLE,
+    USB_ITF_CONSOLE_DATA,
+    USB_ITF_VENDOR,
+    USB_ITF_TMC,
+    USB_ITF_COUNT,
+};
+
+/**
+ * @brief Endpoint addresses
+ */
+enum {
+    USB_EP_CDC_NOTIF = 0x81,
+    USB_EP_CDC_OUT = 0x02,
+    USB_EP_CDC_IN = 0x82,
+    USB_EP_VENDOR_OUT = 0x03,
+    USB_EP_VENDOR_IN = 0x83,
+    USB_EP_TMC_OUT = 0x04,
+    USB_EP_TMC_IN = 0x84,
+    USB_EP_TMC_INT = 0x85,
+    USB_EP_CONSOLE_NOTIF = 0x86,
+    USB_EP_CONSOLE_OUT = 0x07,
+    USB_EP_CONSOLE_IN = 0x87,
+};
+
+/**
+ * @brief Vendor request code the host uses to fetch the MS OS 2.0 descriptors
+ */
+enum { USB_VENDOR_REQUEST_MICROSOFT = 0x01 };
+
+#endif /* PSLAB_USB_DESCRIPTORS_H */
@@ -4,20 +4,36 @@
  *
  * This module handles initialization and operation of the USB peripheral of
  * the STM32H5 microcontroller. It configures the hardware and dispatches USB
- * interrupts to the TinyUSB stack. The implementation supports multiple bus
- * instances (though current hardware has only one USB controller).
+ * interrupts to the TinyUSB stack. Each bus instance is one CDC interface of
+ * the composite device; the buses share the single USB controller, which is
+ * set up by the first bus to be initialized and shut down with the last.
+ *
+ * The USB stack is serviced from interrupts: the USB interrupt hands events
+ * to TinyUSB and pends PendSV, whose handler runs tud_task at the lowest
+ * priority. Endpoint transfers complete and the class FIFOs drain and refill
+ * while the main loop is busy, e.g. in a long SCPI command. Thread-context
+ * calls into TinyUSB mask PendSV while they run.
+ *
+ * The TinyUSB USBTMC and CDC line state callbacks are implemented here. They
+ * run from PendSV, so they queue events that USB_LL_task forwards to the
+ * callbacks registered with USB_LL_tmc_set_callbacks and
+ * USB_LL_set_line_state_callback in thread context.
  */
 
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+#include "lib/tinyusb/src/device/usbd_pvt.h"
 #include "lib/tinyusb/src/tusb.h"
 #include "lib/tinyusb/src/tusb_config.h"
 #include "stm32h5xx_hal.h"
 
+#include "cycle_ll.h"
+#include "usb_descriptors.h"
 #include "usb_ll.h"
 #include "util/error.h"
+#include "util/perf.h"
 
 // USB clock, 48 MHz
 enum { USB_CRS_FRQ_TARGET = 48000000 };
@@ -30,16 +46,237 @@ enum { USB_CRS_TRIM_STEP = 14 };
 enum { USB_CRS_TRIM_DEFAULT = 32 };
 
 enum { USB_IRQ_PRIO = 5 }; // USB DRD FS IRQ priority
+enum { USB_DEFERRED_IRQ_PRIO = 15 }; // PendSV priority, the lowest
+
+// Room for the USBTMC events raised between two USB_LL_task calls. The class
+// raises at most one data and one bulk IN event before it is answered, and a
+// few clears per abort; must be a power of 2
+enum { USB_EVENT_QUEUE_SIZE = 16 };
+
+// Largest direct transfer: TinyUSB transfer lengths are 16-bit, and every
+// transfer but the last should end on a full 64-byte packet
+enum { USB_DIRECT_XFER_MAX = 0xFFC0 };
+
+// TinyUSB has a single USBTMC instance, which belongs to this bus
+#define USB_TMC_BUS (USB_BUS_0)
 
 /* USB instance state tracking */
 typedef struct {
     bool initialized;
     USB_LL_LineStateCallback line_state_callback;
+    USB_LL_TmcCallbacks tmc_callbacks;
+    bool line_state_changed; // Line state not yet forwarded
+    bool dtr;
+    bool rts;
 } USBInstance;
 
-/* Instance array for future multi-controller support */
+/* USBTMC event raised by the USB stack */
+typedef enum {
+    USB_EVENT_TMC_DATA = 0,
+    USB_EVENT_TMC_IN_REQUEST,
+    USB_EVENT_TMC_IN_COMPLETE,
+    USB_EVENT_TMC_CLEAR,
+} USBEventType;
+
+typedef struct {
+    USBEventType type;
+    uint8_t const *data; // TMC_DATA: message bytes in the endpoint buffer
+    uint32_t size; // TMC_DATA: number of bytes, TMC_IN_REQUEST: maximum
+    bool end_of_message; // TMC_DATA
+    bool input; // TMC_CLEAR
+    bool output; // TMC_CLEAR
+} USBEvent;
+
+/* One instance per CDC interface */
 static USBInstance g_usb_instances[USB_BUS_COUNT] = { 0 };
 
+/* Bulk IN endpoint of the CDC interface of each bus */
+static uint8_t const g_CDC_IN_EP[USB_BUS_COUNT] = {
+    [USB_BUS_0] = USB_EP_CDC_IN,
+    [USB_BUS_1] = USB_EP_CONSOLE_IN,
+};
+
+/* Events queued by PendSV, taken by USB_LL_task with PendSV masked */
+static USBEvent g_events[USB_EVENT_QUEUE_SIZE];
+static uint32_t g_event_head = 0;
+static uint32_t g_event_tail = 0;
+
+/* End-of-message flag of the USBTMC transfer being received */
+static bool g_tmc_end_of_message = false;
+
+/* USB488 service request notification, read by the controller */
+static uint8_t g_tmc_srq[2] = { USB488_bNOTIFY1_SRQ, 0 };
+
+/* USBTMC capabilities: a USB488.2 device that understands SCPI and can
+ * request service, without trigger, remote/local or indicator pulse */
+static usbtmc_response_capabilities_488_t const g_TMC_CAPABILITIES = {
+    .USBTMC_status = USBTMC_STATUS_SUCCESS,
+    .bcdUSBTMC = USBTMC_VERSION,
+    .bmIntfcCapabilities = {
+        .listenOnly = 0,
+        .talkOnly = 0,
+        .supportsIndicatorPulse = 0,
+    },
+    .bmDevCapabilities = { .canEndBulkInOnTermChar = 0 },
+    .bcdUSB488 = USBTMC_488_VERSION,
+    .bmIntfcCapabilities488 = {
+        .supportsTrigger = 0,
+        .supportsREN_GTL_LLO = 0,
+        .is488_2 = 1,
+    },
+    .bmDevCapabilities488 = {
+        .SCPI = 1,
+        .SR1 = 1,
+        .RL1 = 0,
+        .DT1 = 0,
+    },
+};
+
+/**
+ * @brief Mask the deferred USB work
+ *
+ * Keeps PendSV, and with it tud_task, from running until deferred_unlock.
+ * Higher priority interrupts, including the USB interrupt itself, are not
+ * affected. Calls nest.
+ *
+ * @return State to pass to deferred_unlock
+ */
+static uint32_t deferred_lock(void)
+{
+    uint32_t const state = __get_BASEPRI();
+    uint32_t const priority = NVIC_EncodePriority(
+        NVIC_GetPriorityGrouping(), USB_DEFERRED_IRQ_PRIO, 0
+    );
+    __set_BASEPRI_MAX(priority << (8U - __NVIC_PRIO_BITS));
+    return state;
+}
+
+/**
+ * @brief Restore the deferred USB work mask
+ *
+ * @param state Value returned by deferred_lock
+ */
+static void deferred_unlock(uint32_t state) { __set_BASEPRI(state); }
+
+/**
+ * @brief Run the USB stack as soon as no other interrupt is active
+ */
+static void deferred_request(void) { SCB->ICSR = SCB_ICSR_PENDSVSET_Msk; }
+
+/**
+ * @brief Queue an event for USB_LL_task
+ *
+ * Runs in PendSV. The event is dropped if the queue is full.
+ *
+ * @param event Event to copy
+ */
+static void event_put(USBEvent const *event)
+{
+    if (g_event_head - g_event_tail >= USB_EVENT_QUEUE_SIZE) {
+        return;
+    }
+
+    g_events[g_event_head & (USB_EVENT_QUEUE_SIZE - 1)] = *event;
+    g_event_head++;
+}
+
+/**
+ * @brief Take the oldest queued event
+ *
+ * @param event Receives the event
+ * @return true if an event was taken, false if the queue is empty
+ */
+static bool event_get(USBEvent *event)
+{
+    uint32_t const state = deferred_lock();
+    bool const available = g_event_tail != g_event_head;
+    if (available) {
+        *event = g_events[g_event_tail & (USB_EVENT_QUEUE_SIZE - 1)];
+        g_event_tail++;
+    }
+    deferred_unlock(state);
+    return available;
+}
+
+/**
+ * @brief Forward a USBTMC event to the registered callbacks
+ *
+ * @param event Event to forward
+ */
+static void event_dispatch(USBEvent const *event)
+{
+    USB_LL_TmcCallbacks const *callbacks =
+        &g_usb_instances[USB_TMC_BUS].tmc_callbacks;
+
+    switch (event->type) {
+    case USB_EVENT_TMC_DATA:
+        if (callbacks->message_data) {
+            callbacks->message_data(
+                USB_TMC_BUS, event->data, event->size, event->end_of_message
+            );
+        } else {
+            // Nobody listens; keep the host from stalling on the endpoint
+            USB_LL_tmc_start_read(USB_TMC_BUS);
+        }
+        break;
+    case USB_EVENT_TMC_IN_REQUEST:
+        if (callbacks->bulk_in_request) {
+            callbacks->bulk_in_request(USB_TMC_BUS, event->size);
+        }
+        break;
+    case USB_EVENT_TMC_IN_COMPLETE:
+        if (callbacks->bulk_in_complete) {
+            callbacks->bulk_in_complete(USB_TMC_BUS);
+        } else {
+            USB_LL_tmc_start_read(USB_TMC_BUS);
+        }
+        break;
+    case USB_EVENT_TMC_CLEAR:
+        if (callbacks->clear) {
+            callbacks->clear(USB_TMC_BUS, event->input, event->output);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Forward a changed CDC line state to the registered callback
+ *
+ * @param bus USB bus instance
+ */
+static void line_state_dispatch(USB_Bus bus)
+{
+    USBInstance *instance = &g_usb_instances[bus];
+
+    uint32_t const state = deferred_lock();
+    bool const changed = instance->line_state_changed;
+    bool const dtr = instance->dtr;
+    bool const rts = instance->rts;
+    instance->line_state_changed = false;
+    deferred_unlock(state);
+
+    if (changed && instance->initialized && instance->line_state_callback) {
+        instance->line_state_callback(bus, dtr, rts);
+    }
+}
+
+/**
+ * @brief Check if any bus keeps the USB controller running
+ *
+ * @return true if at least one bus is initialized
+ */
+static bool hardware_in_use(void)
+{
+    for (size_t i = 0; i < USB_BUS_COUNT; ++i) {
+        if (g_usb_instances[i].initialized) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * @brief Enable USB clock recovery system
  *
@@ -75,6 +312,12 @@ void USB_LL_init(USB_Bus bus)
         THROW(ERROR_RESOURCE_BUSY);
     }
 
+    if (hardware_in_use()) {
+        // Another CDC interface of the same device has started the controller
+        g_usb_instances[bus].initialized = true;
+        return;
+    }
+
     HAL_PWREx_EnableVddUSB();
 
     // Initialize USB clock.
@@ -102,6 +345,9 @@ void USB_LL_init(USB_Bus bus)
     HAL_GPIO_Init(GPIOA, &gpio_init);
 
     HAL_NVIC_SetPriority(USB_DRD_FS_IRQn, USB_IRQ_PRIO, 0);
+    HAL_NVIC_SetPriority(PendSV_IRQn, USB_DEFERRED_IRQ_PRIO, 0);
+    g_event_head = 0;
+    g_event_tail = 0;
 
     // TinyUSB owns the pins and ISR from this point.
     // Because AI reviewers keep commenting on it:
@@ -129,6 +375,11 @@ void USB_LL_deinit(USB_Bus bus)
         return;
     }
 
+    g_usb_instances[bus].initialized = false;
+    if (hardware_in_use()) {
+        return;
+    }
+
     // Disable USB interrupt
     HAL_NVIC_DisableIRQ(USB_DRD_FS_IRQn);
 
@@ -140,8 +391,6 @@ void USB_LL_deinit(USB_Bus bus)
 
     // Disable USB power
     HAL_PWREx_DisableVddUSB();
-
-    g_usb_instances[bus].initialized = false;
 }
 
 static size_t get_unique_id(uint8_t id[])
@@ -184,23 +433,55 @@ size_t USB_LL_get_serial(uint16_t desc_str1[], size_t const max_chars)
  * @brief USB FS dual-role device interrupt handler.
  *
  * Dispatches the USB DRD FS interrupt to the TinyUSB device controller
- * driver. Called by the NVIC when USB_DRD_FS_IRQn is triggered.
+ * driver, which queues the events for tud_task, and pends PendSV to run it.
+ * Called by the NVIC when USB_DRD_FS_IRQn is triggered.
+ */
+void USB_DRD_FS_IRQHandler(void)
+{
+    uint32_t start = CYCLE_LL_get_count();
+    tud_int_handler(0);
+    if (tud_task_event_ready()) {
+        deferred_request();
+    }
+    PERF_record(PERF_SOURCE_USB, CYCLE_LL_get_count() - start);
+}
+
+/**
+ * @brief Deferred USB work
+ *
+ * Runs tud_task once no other interrupt is active: completes transfers,
+ * moves class FIFO data between packet memory and the class buffers, and
+ * answers control requests.
  */
-void USB_DRD_FS_IRQHandler(void) { tud_int_handler(0); }
+void PendSV_Handler(void)
+{
+    uint32_t start = CYCLE_LL_get_count();
+    tud_task();
+    PERF_record(PERF_SOURCE_USB_DEFERRED, CYCLE_LL_get_count() - start);
+}
 
 uint32_t USB_LL_rx_available(USB_Bus const interface_id)
 {
-    return tud_cdc_n_available(interface_id);
+    uint32_t const state = deferred_lock();
+    uint32_t const available = tud_cdc_n_available(interface_id);
+    deferred_unlock(state);
+    return available;
 }
 
 uint32_t USB_LL_tx_available(USB_Bus const interface_id)
 {
-    return tud_cdc_n_write_available(interface_id);
+    uint32_t const state = deferred_lock();
+    uint32_t const available = tud_cdc_n_write_available(interface_id);
+    deferred_unlock(state);
+    return available;
 }
 
 uint32_t USB_LL_read(USB_Bus const interface_id, uint8_t *buf, uint32_t bufsize)
 {
-    return tud_cdc_n_read(interface_id, buf, bufsize);
+    uint32_t const state = deferred_lock();
+    uint32_t const count = tud_cdc_n_read(interface_id, buf, bufsize);
+    deferred_unlock(state);
+    return count;
 }
 
 uint32_t USB_LL_write(
@@ -209,7 +490,57 @@ uint32_t USB_LL_write(
     uint32_t bufsize
 )
 {
-    return tud_cdc_n_write(interface_id, buf, bufsize);
+    uint32_t const state = deferred_lock();
+    uint32_t const count = tud_cdc_n_write(interface_id, buf, bufsize);
+    deferred_unlock(state);
+    return count;
+}
+
+uint32_t USB_LL_write_direct(
+    USB_Bus const interface_id,
+    uint8_t const *buf,
+    uint32_t bufsize
+)
+{
+    if (interface_id >= USB_BUS_COUNT) {
+        return 0;
+    }
+
+    uint8_t const ep = g_CDC_IN_EP[interface_id];
+    uint32_t const state = deferred_lock();
+
+    // Anything already in the CDC FIFO must reach the host first
+    if (!tud_ready() ||
+        tud_cdc_n_write_available(interface_id) < CFG_TUD_CDC_TX_BUFSIZE ||
+        !usbd_edpt_claim(0, ep)) {
+        deferred_unlock(state);
+        return 0;
+    }
+
+    uint16_t len =
+        bufsize > USB_DIRECT_XFER_MAX ? USB_DIRECT_XFER_MAX : bufsize;
+
+    // The controller copies each packet from buf into packet memory as the
+    // host polls the endpoint; TinyUSB never writes to the buffer
+    if (!usbd_edpt_xfer(0, ep, (uint8_t *)(uintptr_t)buf, len)) {
+        usbd_edpt_release(0, ep);
+        len = 0;
+    }
+
+    deferred_unlock(state);
+    return len;
+}
+
+bool USB_LL_tx_in_flight(USB_Bus const interface_id)
+{
+    if (interface_id >= USB_BUS_COUNT) {
+        return false;
+    }
+
+    uint32_t const state = deferred_lock();
+    bool const busy = usbd_edpt_busy(0, g_CDC_IN_EP[interface_id]);
+    deferred_unlock(state);
+    return busy;
 }
 
 uint32_t USB_LL_tx_bufsize(USB_Bus const interface_id)
@@ -220,18 +551,143 @@ uint32_t USB_LL_tx_bufsize(USB_Bus const interface_id)
 
 uint32_t USB_LL_tx_flush(USB_Bus const interface_id)
 {
-    return tud_cdc_n_write_flush(interface_id);
+    uint32_t const state = deferred_lock();
+    uint32_t const count = tud_cdc_n_write_flush(interface_id);
+    deferred_unlock(state);
+    return count;
 }
 
 void USB_LL_task(USB_Bus const interface_id)
 {
-    (void)interface_id;
-    tud_task();
+    if (interface_id >= USB_BUS_COUNT) {
+        return;
+    }
+
+    // Catch up on anything queued from thread context, e.g. by
+    // usbd_defer_func; the USB interrupt requests the rest itself
+    deferred_request();
+
+    line_state_dispatch(interface_id);
+
+    if (interface_id == USB_TMC_BUS) {
+        USBEvent event;
+        while (event_get(&event)) {
+            event_dispatch(&event);
+        }
+    }
 }
 
 bool USB_LL_connected(USB_Bus const interface_id)
 {
-    return tud_cdc_n_connected(interface_id);
+    uint32_t const state = deferred_lock();
+    bool const connected = tud_cdc_n_connected(interface_id);
+    deferred_unlock(state);
+    return connected;
+}
+
+bool USB_LL_mounted(void) { return tud_mounted(); }
+
+bool USB_LL_vendor_mounted(USB_Bus const interface_id)
+{
+    return tud_vendor_n_mounted(interface_id);
+}
+
+uint32_t USB_LL_vendor_tx_available(USB_Bus const interface_id)
+{
+    uint32_t const state = deferred_lock();
+    uint32_t const available = tud_vendor_n_write_available(interface_id);
+    deferred_unlock(state);
+    return available;
+}
+
+uint32_t USB_LL_vendor_write(
+    USB_Bus const interface_id,
+    uint8_t const *buf,
+    uint32_t bufsize
+)
+{
+    uint32_t const state = deferred_lock();
+    uint32_t const count = tud_vendor_n_write(interface_id, buf, bufsize);
+    deferred_unlock(state);
+    return count;
+}
+
+uint32_t USB_LL_vendor_tx_flush(USB_Bus const interface_id)
+{
+    uint32_t const state = deferred_lock();
+    uint32_t const count = tud_vendor_n_write_flush(interface_id);
+    deferred_unlock(state);
+    return count;
+}
+
+void USB_LL_tmc_set_callbacks(
+    USB_Bus const interface_id,
+    USB_LL_TmcCallbacks const *callbacks
+)
+{
+    if (interface_id >= USB_BUS_COUNT) {
+        return;
+    }
+
+    uint32_t const state = deferred_lock();
+    g_usb_instances[interface_id].tmc_callbacks =
+        callbacks ? *callbacks : (USB_LL_TmcCallbacks){ 0 };
+    deferred_unlock(state);
+}
+
+bool USB_LL_tmc_start_read(USB_Bus const interface_id)
+{
+    if (interface_id != USB_TMC_BUS || !tud_mounted()) {
+        return false;
+    }
+
+    uint32_t const state = deferred_lock();
+    bool const armed = tud_usbtmc_start_bus_read();
+    deferred_unlock(state);
+    return armed;
+}
+
+bool USB_LL_tmc_transmit(
+    USB_Bus const interface_id,
+    uint8_t const *buf,
+    uint32_t bufsize,
+    bool end_of_message
+)
+{
+    if (interface_id != USB_TMC_BUS || bufsize == 0) {
+        return false;
+    }
+
+    uint32_t const state = deferred_lock();
+    bool const started = tud_usbtmc_transmit_dev_msg_data(
+        buf, bufsize, end_of_message, false
+    );
+    deferred_unlock(state);
+    return started;
+}
+
+bool USB_LL_tmc_notify_srq(USB_Bus const interface_id, uint8_t status_byte)
+{
+    if (interface_id != USB_TMC_BUS || !tud_mounted()) {
+        return false;
+    }
+
+    uint32_t const state = deferred_lock();
+    bool queued = false;
+
+    // tud_usbtmc_transmit_notification_data in TinyUSB 0.18 only sends while
+    // the endpoint is busy, i.e. never; queue the notification directly
+    if (usbd_edpt_claim(0, USB_EP_TMC_INT)) {
+        g_tmc_srq[1] = status_byte;
+        queued =
+            usbd_edpt_xfer(0, USB_EP_TMC_INT, g_tmc_srq, sizeof(g_tmc_srq));
+        if (!queued) {
+            usbd_edpt_release(0, USB_EP_TMC_INT);
+        }
+    }
+
+    deferred_unlock(state);
+    return queued;
 }
 
 void USB_LL_set_line_state_callback(
@@ -240,7 +696,9 @@ void USB_LL_set_line_state_callback(
 )
 {
     if (interface_id < USB_BUS_COUNT) {
+        uint32_t const state = deferred_lock();
         g_usb_instances[interface_id].line_state_callback = callback;
+        deferred_unlock(state);
     }
 }
 
@@ -248,7 +706,7 @@ void USB_LL_set_line_state_callback(
  * @brief TinyUSB CDC line state change callback
  *
  * This function is called by the TinyUSB stack when the USB CDC line state
- * changes.
+ * changes. The latest state is forwarded by USB_LL_task.
  *
  * @param itf USB interface number
  * @param dtr Data Terminal Ready state
@@ -257,14 +715,129 @@ void USB_LL_set_line_state_callback(
 void tud_cdc_line_state_cb(uint8_t itf, bool dtr, bool rts)
 {
     if (itf < USB_BUS_COUNT) {
-        USBInstance instance = g_usb_instances[itf];
+        USBInstance *instance = &g_usb_instances[itf];
+        instance->dtr = dtr;
+        instance->rts = rts;
+        instance->line_state_changed = true;
+    }
+}
 
-        if (!instance.initialized) {
-            return;
-        }
+/**
+ * @brief Queue a USBTMC clear or abort for the registered callback
+ */
+static void tmc_clear(bool input, bool output)
+{
+    event_put(&(USBEvent){
+        .type = USB_EVENT_TMC_CLEAR,
+        .input = input,
+        .output = output,
+    });
+}
 
-        if (instance.line_state_callback) {
-            instance.line_state_callback(itf, dtr, rts);
-        }
-    }
+usbtmc_response_capabilities_488_t const *tud_usbtmc_get_capabilities_cb(void)
+{
+    return &g_TMC_CAPABILITIES;
+}
+
+void tud_usbtmc_open_cb(uint8_t interface_id)
+{
+    (void)interface_id;
+    tud_usbtmc_start_bus_read();
+}
+
+bool tud_usbtmc_msgBulkOut_start_cb(
+    usbtmc_msg_request_dev_dep_out const *msgHeader
+)
+{
+    g_tmc_end_of_message = msgHeader->bmTransferAttributes.EOM;
+    return true;
+}
+
+bool tud_usbtmc_msg_data_cb(void *data, size_t len, bool transfer_complete)
+{
+    // The class does not receive into its endpoint buffer again until
+    // USB_LL_tmc_start_read, so the data stays valid until it is forwarded
+    event_put(&(USBEvent){
+        .type = USB_EVENT_TMC_DATA,
+        .data = (uint8_t const *)data,
+        .size = (uint32_t)len,
+        .end_of_message = transfer_complete && g_tmc_end_of_message,
+    });
+    return true;
+}
+
+bool tud_usbtmc_msgBulkIn_request_cb(
+    usbtmc_msg_request_dev_dep_in const *request
+)
+{
+    event_put(&(USBEvent){
+        .type = USB_EVENT_TMC_IN_REQUEST,
+        .size = request->TransferSize,
+    });
+    return true;
+}
+
+bool tud_usbtmc_msgBulkIn_complete_cb(void)
+{
+    event_put(&(USBEvent){ .type = USB_EVENT_TMC_IN_COMPLETE });
+    return true;
+}
+
+void tud_usbtmc_bulkOut_clearFeature_cb(void)
+{
+    tmc_clear(true, false);
+    tud_usbtmc_start_bus_read();
+}
+
+void tud_usbtmc_bulkIn_clearFeature_cb(void) { tmc_clear(false, true); }
+
+bool tud_usbtmc_initiate_abort_bulk_in_cb(uint8_t *tmcResult)
+{
+    tmc_clear(false, true);
+    *tmcResult = USBTMC_STATUS_SUCCESS;
+    return true;
+}
+
+bool tud_usbtmc_initiate_abort_bulk_out_cb(uint8_t *tmcResult)
+{
+    tmc_clear(true, false);
+    *tmcResult = USBTMC_STATUS_SUCCESS;
+    return true;
+}
+
+bool tud_usbtmc_initiate_clear_cb(uint8_t *tmcResult)
+{
+    tmc_clear(true, true);
+    *tmcResult = USBTMC_STATUS_SUCCESS;
+    return true;
+}
+
+bool tud_usbtmc_check_abort_bulk_in_cb(usbtmc_check_abort_bulk_rsp_t *rsp)
+{
+    (void)rsp;
+    tud_usbtmc_start_bus_read();
+    return true;
+}
+
+bool tud_usbtmc_check_abort_bulk_out_cb(usbtmc_check_abort_bulk_rsp_t *rsp)
+{
+    (void)rsp;
+    tud_usbtmc_start_bus_read();
+    return true;
+}
+
+bool tud_usbtmc_check_clear_cb(usbtmc_get_clear_status_rsp_t *rsp)
+{
+    rsp->USBTMC_status = USBTMC_STATUS_SUCCESS;
+    rsp->bmClear.BulkInFifoBytes = 0;
+    return true;
+}
+
+uint8_t tud_usbtmc_get_stb_cb(uint8_t *tmcResult)
+{
+    USB_LL_TmcCallbacks const *callbacks =
+        &g_usb_instances[USB_TMC_BUS].tmc_callbacks;
+
+    *tmcResult = USBTMC_STATUS_SUCCESS;
+    return callbacks->status_byte ? callbacks->status_byte(USB_TMC_BUS) : 0;
 }
@@ -60,6 +60,7 @@ typedef enum {
     PLATFORM_CLOCK_TIMER8 = 9,
     PLATFORM_CLOCK_TIMER16 = 10,
     PLATFORM_CLOCK_TIMER17 = 11,
+    PLATFORM_CLOCK_TIMER15 = 12,
     PLATFORM_CLOCK_INVALID = 0xFFFF
 } PLATFORM_PeripheralClock;
 
@@ -0,0 +1,42 @@
+/**
+ * @file power_ll.h
+ * @brief Low-level power mode interface for PSLab Mini
+ *
+ * This module puts the core into Sleep mode until an interrupt arrives and
+ * reports which interrupt class woke it up. Peripherals, DMA and USB keep
+ * running in Sleep mode.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef PSLAB_LL_POWER_H
+#define PSLAB_LL_POWER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Wake-up source classes
+ */
+typedef enum {
+    POWER_LL_WAKE_USB = 0, /**< USB device controller */
+    POWER_LL_WAKE_DMA, /**< ADC DMA channels */
+    POWER_LL_WAKE_UART, /**< UART, including RX idle, and its DMA channels */
+    POWER_LL_WAKE_TIMER, /**< SysTick and general-purpose timers */
+    POWER_LL_WAKE_OTHER, /**< Any other interrupt */
+    POWER_LL_WAKE_COUNT
+} POWER_LL_WakeSource;
+
+/**
+ * @brief Sleep until an interrupt is pending
+ *
+ * Must be called with interrupts masked (see CYCLE_LL_enter_critical). A
+ * pending interrupt still wakes the core, but its handler only runs once the
+ * caller unmasks interrupts, so no wake-up is lost between checking for work
+ * and going to sleep.
+ *
+ * @return Bit mask of pending wake-up sources, (1U << POWER_LL_WakeSource)
+ */
+uint32_t POWER_LL_sleep(void);
+
+#endif // PSLAB_LL_POWER_H
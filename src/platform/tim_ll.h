@@ -18,14 +18,38 @@
 
 /*
  * @brief TIM instance enumeration
+ *
+ * All timers that can trigger the ADC, plus TIM7. TIM2 and TIM5 have 32-bit
+ * counters, the others 16-bit counters.
  */
-typedef enum { TIM_NUM_6 = 0, TIM_NUM_7 = 1, TIM_NUM_COUNT = 2 } TIM_Num;
+typedef enum {
+    TIM_NUM_6 = 0,
+    TIM_NUM_7 = 1,
+    TIM_NUM_1,
+    TIM_NUM_2,
+    TIM_NUM_3,
+    TIM_NUM_4,
+    TIM_NUM_5,
+    TIM_NUM_8,
+    TIM_NUM_15,
+    TIM_NUM_COUNT
+} TIM_Num;
 
 /**
  * @brief Initialize the Timer Module
  *
+ * The prescaler and auto-reload values are chosen by TIMER_SOLVER_solve to
+ * minimize the difference between the requested and the achieved update
+ * frequency. The last solution is kept per timer and reused when the timer is
+ * initialized again at the same frequency. The timer drives its TRGO output,
+ * and TRGO2 on TIM1 and TIM8, on every update event.
+ *
  * @param tim Timer instance
  * @param freq Frequency for the timer
+ *
+ * @throws ERROR_INVALID_ARGUMENT if tim is invalid or freq is out of range
+ * @throws ERROR_RESOURCE_BUSY if the timer is already initialized
+ * @throws ERROR_HARDWARE_FAULT if the timer could not be configured
  */
 void TIM_LL_init(TIM_Num tim, uint32_t freq);
 
@@ -50,4 +74,18 @@ void TIM_LL_start(TIM_Num tim);
  */
 void TIM_LL_stop(TIM_Num tim);
 
+/**
+ * @brief Get the frequency a timer achieves for a requested frequency
+ *
+ * Runs the same prescaler and auto-reload search as TIM_LL_init without
+ * touching the hardware.
+ *
+ * @param tim TIM instance
+ * @param freq Requested frequency in Hz
+ * @return Achieved frequency in Hz, rounded to the nearest integer
+ *
+ * @throws ERROR_INVALID_ARGUMENT if tim is invalid or freq is out of range
+ */
+uint32_t TIM_LL_get_achievable_frequency(TIM_Num tim, uint32_t freq);
+
 #endif // PSLAB_TIM_LL_H
\ No newline at end of file
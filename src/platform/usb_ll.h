@@ -9,7 +9,13 @@
  * derived from the MCU's unique ID registers.
  *
  * The USB driver is built on top of the TinyUSB stack and supports multiple
- * interface instances.
+ * interface instances. Besides the CDC interfaces, the device has a vendor
+ * class interface with a bulk endpoint pair, used for streaming, and a
+ * USBTMC/USB488 interface, which test and measurement hosts use through VISA.
+ *
+ * The USB stack is serviced from interrupts, so endpoint transfers continue
+ * while the main loop is busy. The functions below may be called from thread
+ * context only; callbacks are called from USB_LL_task, except where noted.
  */
 
 #ifndef PSLAB_USB_LL_H
@@ -23,13 +29,21 @@
 
 /**
  * @brief USB bus instance enumeration
+ *
+ * Each bus is one CDC ACM interface of the composite device. All buses share
+ * the USB controller, which is powered while any of them is initialized.
  */
-typedef enum { USB_BUS_0 = 0, USB_BUS_COUNT = 1 } USB_Bus;
+typedef enum {
+    USB_BUS_0 = 0, /**< SCPI; also owns the vendor and USBTMC interfaces */
+    USB_BUS_1 = 1, /**< Console */
+    USB_BUS_COUNT = 2
+} USB_Bus;
 
 /**
  * @brief USB line state change callback
  *
- * This function is called when the USB line state changes (DTR/RTS).
+ * This function is called from USB_LL_task after the USB line state has
+ * changed (DTR/RTS), with the latest state.
  *
  * @param interface_id USB bus instance
  * @param dtr Data Terminal Ready state
@@ -41,11 +55,73 @@ typedef void (*USB_LL_LineStateCallback)(
     bool rts
 );
 
+/**
+ * @brief USBTMC event callbacks
+ *
+ * These functions are called from USB_LL_task when the host sends a message,
+ * asks for a response, or resets the USBTMC interface. After message_data,
+ * bulk_in_complete, clear and abort the endpoint does not receive further
+ * messages until USB_LL_tmc_start_read is called.
+ */
+typedef struct {
+    /**
+     * @brief Message bytes arrived on the bulk OUT endpoint
+     *
+     * @param interface_id USB bus instance
+     * @param data Message bytes, without the USBTMC header
+     * @param len Number of bytes, at most one 64-byte packet
+     * @param end_of_message true on the last bytes of a message
+     */
+    void (*message_data)(
+        USB_Bus interface_id,
+        uint8_t const *data,
+        uint32_t len,
+        bool end_of_message
+    );
+
+    /**
+     * @brief The host asks for response data on the bulk IN endpoint
+     *
+     * Answer with USB_LL_tmc_transmit, now or later.
+     *
+     * @param interface_id USB bus instance
+     * @param max_size Largest number of bytes the host accepts
+     */
+    void (*bulk_in_request)(USB_Bus interface_id, uint32_t max_size);
+
+    /**
+     * @brief The host has read the data passed to USB_LL_tmc_transmit
+     *
+     * @param interface_id USB bus instance
+     */
+    void (*bulk_in_complete)(USB_Bus interface_id);
+
+    /**
+     * @brief The host has cleared the interface or aborted a transfer
+     *
+     * @param interface_id USB bus instance
+     * @param input Discard partial input messages
+     * @param output Discard pending responses
+     */
+    void (*clear)(USB_Bus interface_id, bool input, bool output);
+
+    /**
+     * @brief The host reads the USB488 status byte
+     *
+     * Called from the USB deferred interrupt rather than USB_LL_task, since
+     * the control request is answered right away. Must only read state.
+     *
+     * @param interface_id USB bus instance
+     * @return IEEE 488.2 status byte
+     */
+    uint8_t (*status_byte)(USB_Bus interface_id);
+} USB_LL_TmcCallbacks;
+
 /**
  * @brief Initialize the USB hardware and TinyUSB stack
  *
  * Sets up the MCU's USB hardware and initializes the TinyUSB stack for device
- * operation.
+ * operation, unless another bus has already done so.
  *
  * @param bus USB bus instance to initialize
  */
@@ -54,6 +130,8 @@ void USB_LL_init(USB_Bus bus);
 /**
  * @brief Deinitialize the USB peripheral
  *
+ * The USB hardware is turned off once no bus is initialized.
+ *
  * @param bus USB bus instance to deinitialize
  */
 void USB_LL_deinit(USB_Bus bus);
@@ -110,6 +188,37 @@ uint32_t USB_LL_write(
     uint32_t bufsize
 );
 
+/**
+ * @brief Transmit directly from memory on the USB CDC IN endpoint
+ *
+ * Starts a bulk transfer that the USB controller feeds straight from buf,
+ * bypassing the CDC transmit buffer. This is only possible while the transmit
+ * buffer is empty and no other transfer is in flight on the endpoint. Long
+ * data is sent in several transfers; call again with the remainder once
+ * USB_LL_tx_in_flight returns false.
+ *
+ * The memory must stay valid and unchanged until USB_LL_tx_in_flight returns
+ * false.
+ *
+ * @param interface_id USB CDC interface instance
+ * @param buf Data to send
+ * @param bufsize Number of bytes to send
+ * @return Number of bytes handed to the endpoint, 0 if it is not free
+ */
+uint32_t USB_LL_write_direct(
+    USB_Bus interface_id,
+    uint8_t const *buf,
+    uint32_t bufsize
+);
+
+/**
+ * @brief Check if a transfer is in flight on the USB CDC IN endpoint
+ *
+ * @param interface_id USB CDC interface instance
+ * @return true until the host has read the last transfer, or the bus is reset
+ */
+bool USB_LL_tx_in_flight(USB_Bus interface_id);
+
 /**
  * @brief Get the size of the USB CDC transmit buffer
  *
@@ -119,10 +228,11 @@ uint32_t USB_LL_write(
 uint32_t USB_LL_tx_bufsize(USB_Bus interface_id);
 
 /**
- * @brief Process USB tasks and handle pending operations
+ * @brief Forward pending USB events to the registered callbacks
  *
- * This function should be called periodically to handle USB operations
- * and maintain communication with the host.
+ * The USB stack itself runs from interrupts. This function calls the line
+ * state and USBTMC callbacks for the events raised since the last call, and
+ * should be called periodically.
  *
  * @param interface_id USB CDC interface instance
  */
@@ -136,6 +246,14 @@ void USB_LL_task(USB_Bus interface_id);
  */
 bool USB_LL_connected(USB_Bus interface_id);
 
+/**
+ * @brief Check if the host has enumerated and configured the USB device
+ *
+ * @return true once the device is configured, false before or after a reset
+ *         or disconnect
+ */
+bool USB_LL_mounted(void);
+
 /**
  * @brief Flush the USB CDC transmit buffer
  *
@@ -146,6 +264,101 @@ bool USB_LL_connected(USB_Bus interface_id);
  */
 uint32_t USB_LL_tx_flush(USB_Bus interface_id);
 
+/**
+ * @brief Check if the host has configured the vendor bulk interface
+ *
+ * @param interface_id USB vendor interface instance
+ * @return true once the device is configured, false before or after a reset
+ *         or disconnect
+ */
+bool USB_LL_vendor_mounted(USB_Bus interface_id);
+
+/**
+ * @brief Get number of bytes available for writing to the vendor interface
+ *
+ * @param interface_id USB vendor interface instance
+ * @return Number of bytes that can be written to the TX buffer
+ */
+uint32_t USB_LL_vendor_tx_available(USB_Bus interface_id);
+
+/**
+ * @brief Write data to the vendor bulk IN endpoint
+ *
+ * Data is queued in the vendor TX buffer. A transfer starts as soon as a
+ * full packet is buffered, and is refilled from the buffer as it completes.
+ *
+ * @param interface_id USB vendor interface instance
+ * @param buf Buffer containing data to write
+ * @param bufsize Number of bytes to write
+ * @return Number of bytes actually written
+ */
+uint32_t USB_LL_vendor_write(
+    USB_Bus interface_id,
+    uint8_t const *buf,
+    uint32_t bufsize
+);
+
+/**
+ * @brief Flush the vendor TX buffer
+ *
+ * Starts a transfer of any buffered data that does not fill a packet.
+ *
+ * @param interface_id USB vendor interface instance
+ * @return Number of bytes flushed
+ */
+uint32_t USB_LL_vendor_tx_flush(USB_Bus interface_id);
+
+/**
+ * @brief Set the USBTMC event callbacks
+ *
+ * @param interface_id USB bus instance
+ * @param callbacks Callbacks to copy, or nullptr to ignore USBTMC events
+ */
+void USB_LL_tmc_set_callbacks(
+    USB_Bus interface_id,
+    USB_LL_TmcCallbacks const *callbacks
+);
+
+/**
+ * @brief Let the USBTMC bulk OUT endpoint receive the next packet
+ *
+ * Does nothing while a response is being sent, or before the host has
+ * configured the device.
+ *
+ * @param interface_id USB bus instance
+ * @return true if the endpoint was armed
+ */
+bool USB_LL_tmc_start_read(USB_Bus interface_id);
+
+/**
+ * @brief Answer a bulk IN request with response data
+ *
+ * The USB stack keeps reading from buf until the bulk_in_complete callback
+ * runs, so the memory must stay valid and unchanged until then.
+ *
+ * @param interface_id USB bus instance
+ * @param buf Response bytes
+ * @param bufsize Number of bytes, from 1 up to the requested maximum
+ * @param end_of_message true if buf ends the response message
+ * @return true if the transfer was started
+ */
+bool USB_LL_tmc_transmit(
+    USB_Bus interface_id,
+    uint8_t const *buf,
+    uint32_t bufsize,
+    bool end_of_message
+);
+
+/**
+ * @brief Send a USB488 service request on the interrupt IN endpoint
+ *
+ * @param interface_id USB bus instance
+ * @param status_byte IEEE 488.2 status byte sent along with the request
+ * @return true if the notification was queued, false if the endpoint is
+ *         busy or the device is not configured
+ */
+bool USB_LL_tmc_notify_srq(USB_Bus interface_id, uint8_t status_byte);
+
 /**
  * @brief Set the USB line state change callback
  *
@@ -0,0 +1,471 @@
+/**
+ * @file adc_arbiter.c
+ * @brief ADC resource arbiter implementation for PSLab firmware
+ *
+ * This file implements a priority-based, time-sliced arbiter for the regular
+ * ADC sequence and its trigger timer. Sessions are kept in a fixed pool; the
+ * queue order among sessions of equal priority is tracked with a sequence
+ * number that is renewed every time a session is (re)queued. The trigger
+ * timers are kept in a second fixed pool.
+ *
+ * Every switch stops and deinitializes the ADC and the trigger timer of the
+ * outgoing session and initializes them for the incoming one. The ADC keeps
+ * its calibration factors and the timer its prescaler solution across the
+ * switch, so a switch costs the register setup, not a recalibration. The
+ * duration of each switch, including the grant callback, is recorded under
+ * PERF_SOURCE_ADC_SWITCH and reported by SYSTem:PERFormance?.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform/adc_ll.h"
+#include "platform/cycle_ll.h"
+#include "platform/platform.h"
+#include "platform/tim_ll.h"
+#include "util/error.h"
+#include "util/logging.h"
+#include "util/perf.h"
+
+#include "adc_arbiter.h"
+
+/**
+ * @brief ADC session structure
+ */
+struct ADC_ARB_Session {
+    ADC_ARB_Request request;
+    ADC_ARB_State state;
+    uint32_t sequence; // Queue position among sessions of equal priority
+    uint32_t granted_at; // Tick when the ADC was last granted
+    bool volatile finished; // ADC completion callback has fired
+    bool in_use;
+};
+
+// Session pool
+static ADC_ARB_Session g_sessions[ADC_ARB_MAX_SESSIONS] = { 0 };
+
+// Session currently owning the ADC
+static ADC_ARB_Session *g_active_session = nullptr;
+
+// Next queue sequence number
+static uint32_t g_next_sequence = 0;
+
+// Trigger timer pool, in the order the timers are handed out: the basic timer
+// first, then general-purpose and advanced timers, and the 32-bit TIM2 last
+static ADC_ARB_Trigger const g_TRIGGERS[] = {
+    { TIM_NUM_6, ADC_TRIGGER_TIMER6 },
+    { TIM_NUM_15, ADC_TRIGGER_TIMER15 },
+    { TIM_NUM_3, ADC_TRIGGER_TIMER3 },
+    { TIM_NUM_4, ADC_TRIGGER_TIMER4 },
+    { TIM_NUM_1, ADC_TRIGGER_TIMER1 },
+    { TIM_NUM_8, ADC_TRIGGER_TIMER8 },
+    { TIM_NUM_2, ADC_TRIGGER_TIMER2 },
+};
+
+enum { ADC_ARB_TRIGGER_COUNT = sizeof(g_TRIGGERS) / sizeof(g_TRIGGERS[0]) };
+
+// Trigger timers taken from the pool
+static bool g_trigger_in_use[ADC_ARB_TRIGGER_COUNT] = { false };
+
+/**
+ * @brief ADC completion callback
+ *
+ * Forwards the event to the active session and marks it as finished so the
+ * ADC is handed on at the next call into the arbiter.
+ */
+static void arbiter_adc_complete_callback(
+    uint16_t *buffer,
+    uint32_t total_samples
+)
+{
+    ADC_ARB_Session *session = g_active_session;
+
+    if (session == nullptr) {
+        return;
+    }
+
+    session->finished = true;
+    if (session->request.complete_callback != nullptr) {
+        session->request.complete_callback(buffer, total_samples);
+    }
+}
+
+/**
+ * @brief Get the timer whose TRGO output drives an ADC trigger source
+ *
+ * @return Timer, or TIM_NUM_COUNT if the source is not a timer TRGO
+ */
+static TIM_Num arbiter_trigger_timer(ADC_LL_TriggerSource source)
+{
+    switch (source) {
+    case ADC_TRIGGER_TIMER1:
+    case ADC_TRIGGER_TIMER1_TRGO2:
+        return TIM_NUM_1;
+    case ADC_TRIGGER_TIMER2:
+        return TIM_NUM_2;
+    case ADC_TRIGGER_TIMER3:
+        return TIM_NUM_3;
+    case ADC_TRIGGER_TIMER4:
+        return TIM_NUM_4;
+    case ADC_TRIGGER_TIMER6:
+        return TIM_NUM_6;
+    case ADC_TRIGGER_TIMER8:
+    case ADC_TRIGGER_TIMER8_TRGO2:
+        return TIM_NUM_8;
+    case ADC_TRIGGER_TIMER15:
+        return TIM_NUM_15;
+    default:
+        return TIM_NUM_COUNT;
+    }
+}
+
+/**
+ * @brief Validate a session request
+ */
+static bool arbiter_validate_request(ADC_ARB_Request const *request)
+{
+    if (request == nullptr) {
+        LOG_ERROR("ADC_ARB: Request is NULL");
+        return false;
+    }
+
+    if (request->timer >= TIM_NUM_COUNT) {
+        LOG_ERROR("ADC_ARB: Invalid timer: %d", request->timer);
+        return false;
+    }
+
+    if (arbiter_trigger_timer(request->adc_config.trigger_source) !=
+        request->timer) {
+        LOG_ERROR(
+            "ADC_ARB: Trigger source %d is not driven by timer %d",
+            request->adc_config.trigger_source,
+            request->timer
+        );
+        return false;
+    }
+
+    if (request->trigger_frequency == 0) {
+        LOG_ERROR("ADC_ARB: Invalid trigger frequency");
+        return false;
+    }
+
+    if (request->priority > ADC_ARB_PRIORITY_HIGH) {
+        LOG_ERROR("ADC_ARB: Invalid priority: %d", request->priority);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Put a session at the back of the queue for its priority
+ */
+static void arbiter_enqueue(ADC_ARB_Session *session)
+{
+    session->state = ADC_ARB_STATE_WAITING;
+    session->sequence = g_next_sequence++;
+}
+
+/**
+ * @brief Find the waiting session that should be granted next
+ *
+ * @return Highest priority, longest waiting session, or nullptr if none
+ */
+static ADC_ARB_Session *arbiter_next_waiting(void)
+{
+    ADC_ARB_Session *next = nullptr;
+
+    for (size_t i = 0; i < ADC_ARB_MAX_SESSIONS; i++) {
+        ADC_ARB_Session *session = &g_sessions[i];
+        if (!session->in_use || session->state != ADC_ARB_STATE_WAITING) {
+            continue;
+        }
+        if (next == nullptr ||
+            session->request.priority > next->request.priority ||
+            (session->request.priority == next->request.priority &&
+             (int32_t)(session->sequence - next->sequence) < 0)) {
+            next = session;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief Stop and deinitialize the hardware owned by the active session
+ */
+static void arbiter_teardown(ADC_ARB_Session *session)
+{
+    Error error = ERROR_NONE;
+    TRY
+    {
+        TIM_LL_stop(session->request.timer);
+        ADC_LL_stop();
+        ADC_LL_deinit();
+        TIM_LL_deinit(session->request.timer);
+    }
+    CATCH(error)
+    {
+        LOG_ERROR("ADC_ARB: Teardown failed, error %d", error);
+        // Don't throw, the ADC must be handed over regardless
+    }
+
+    ADC_LL_set_complete_callback(nullptr);
+    ADC_LL_set_half_complete_callback(nullptr);
+    ADC_LL_set_segment_callback(nullptr);
+    g_active_session = nullptr;
+}
+
+/**
+ * @brief Grant the ADC to a session
+ *
+ * Applies the saved configuration of the session and calls its grant
+ * callback. If the hardware cannot be configured or the grant callback throws,
+ * the session is marked as failed and stays out of the queue.
+ */
+static void arbiter_grant(ADC_ARB_Session *session)
+{
+    ADC_ARB_Request const *request = &session->request;
+
+    Error error = ERROR_NONE;
+    TRY
+    {
+        ADC_LL_init(&request->adc_config);
+        TRY { TIM_LL_init(request->timer, request->trigger_frequency); }
+        CATCH(error)
+        {
+            ADC_LL_deinit();
+            THROW(error);
+        }
+    }
+    CATCH(error)
+    {
+        LOG_ERROR("ADC_ARB: Grant failed, error %d", error);
+        session->state = ADC_ARB_STATE_FAILED;
+        return;
+    }
+
+    ADC_LL_set_complete_callback(arbiter_adc_complete_callback);
+    ADC_LL_set_half_complete_callback(request->half_complete_callback);
+    ADC_LL_set_segment_callback(request->segment_callback);
+    session->state = ADC_ARB_STATE_ACTIVE;
+    session->finished = false;
+    session->granted_at = PLATFORM_get_tick();
+    g_active_session = session;
+
+    LOG_DEBUG(
+        "ADC_ARB: Granted session %p, priority %d",
+        (void *)session,
+        request->priority
+    );
+
+    if (request->on_grant == nullptr) {
+        return;
+    }
+
+    TRY { request->on_grant(request->context); }
+    CATCH(error)
+    {
+        LOG_ERROR("ADC_ARB: Session start failed, error %d", error);
+        arbiter_teardown(session);
+        session->state = ADC_ARB_STATE_FAILED;
+    }
+}
+
+/**
+ * @brief Take the ADC away from the active session and requeue it
+ */
+static void arbiter_suspend(ADC_ARB_Session *session)
+{
+    LOG_DEBUG("ADC_ARB: Suspending session %p", (void *)session);
+
+    arbiter_teardown(session);
+    arbiter_enqueue(session);
+
+    if (session->request.on_suspend != nullptr) {
+        session->request.on_suspend(session->request.context);
+    }
+}
+
+/**
+ * @brief Return a session to the pool
+ */
+static void arbiter_free(ADC_ARB_Session *session)
+{
+    if (session == g_active_session) {
+        arbiter_teardown(session);
+    }
+
+    session->in_use = false;
+    session->finished = false;
+}
+
+/**
+ * @brief Check whether the active session must give up the ADC
+ */
+static bool arbiter_should_preempt(
+    ADC_ARB_Session const *active,
+    ADC_ARB_Session const *next
+)
+{
+    if (next->request.priority > active->request.priority) {
+        return true;
+    }
+
+    if (next->request.priority < active->request.priority ||
+        active->request.slice_ms == 0) {
+        return false;
+    }
+
+    return PLATFORM_get_tick() - active->granted_at >= active->request.slice_ms;
+}
+
+/**
+ * @brief Run one arbitration pass
+ */
+static void arbiter_schedule(void)
+{
+    // Hand the ADC on from a session that finished its acquisition. The
+    // session keeps its slot until its owner releases it, so the owner's
+    // handle cannot end up pointing at a slot reused by another client.
+    if (g_active_session != nullptr && g_active_session->finished) {
+        ADC_ARB_Session *session = g_active_session;
+        LOG_DEBUG("ADC_ARB: Session %p finished", (void *)session);
+        arbiter_teardown(session);
+        session->state = ADC_ARB_STATE_FINISHED;
+    }
+
+    ADC_ARB_Session *next = arbiter_next_waiting();
+    if (next == nullptr) {
+        return;
+    }
+
+    if (g_active_session != nullptr &&
+        !arbiter_should_preempt(g_active_session, next)) {
+        return;
+    }
+
+    uint32_t const start = CYCLE_LL_get_count();
+
+    if (g_active_session != nullptr) {
+        arbiter_suspend(g_active_session);
+        next = arbiter_next_waiting();
+    }
+
+    arbiter_grant(next);
+
+    PERF_record(PERF_SOURCE_ADC_SWITCH, CYCLE_LL_get_count() - start);
+}
+
+ADC_ARB_Session *ADC_ARB_request(ADC_ARB_Request const *request)
+{
+    LOG_FUNCTION_ENTRY();
+
+    if (!arbiter_validate_request(request)) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    ADC_ARB_Session *session = nullptr;
+    for (size_t i = 0; i < ADC_ARB_MAX_SESSIONS; i++) {
+        if (!g_sessions[i].in_use) {
+            session = &g_sessions[i];
+            break;
+        }
+    }
+
+    if (session == nullptr) {
+        LOG_ERROR("ADC_ARB: No free session");
+        THROW(ERROR_OUT_OF_MEMORY);
+    }
+
+    session->request = *request;
+    session->finished = false;
+    session->in_use = true;
+    arbiter_enqueue(session);
+
+    LOG_DEBUG(
+        "ADC_ARB: Queued session %p, priority %d",
+        (void *)session,
+        request->priority
+    );
+
+    arbiter_schedule();
+
+    LOG_FUNCTION_EXIT();
+    return session;
+}
+
+void ADC_ARB_release(ADC_ARB_Session *session)
+{
+    LOG_FUNCTION_ENTRY();
+
+    if (session == nullptr || !session->in_use) {
+        LOG_WARN("ADC_ARB: Attempt to release invalid session");
+        return;
+    }
+
+    arbiter_free(session);
+    arbiter_schedule();
+
+    LOG_FUNCTION_EXIT();
+}
+
+ADC_ARB_State ADC_ARB_get_state(ADC_ARB_Session const *session)
+{
+    if (session == nullptr || !session->in_use) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    // Completion is flagged from interrupt context before the arbiter runs
+    if (session->state == ADC_ARB_STATE_ACTIVE && session->finished) {
+        return ADC_ARB_STATE_FINISHED;
+    }
+
+    return session->state;
+}
+
+size_t ADC_ARB_get_queue_length(void)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < ADC_ARB_MAX_SESSIONS; i++) {
+        if (g_sessions[i].in_use &&
+            g_sessions[i].state == ADC_ARB_STATE_WAITING) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+ADC_ARB_Trigger ADC_ARB_acquire_trigger(void)
+{
+    for (size_t i = 0; i < ADC_ARB_TRIGGER_COUNT; i++) {
+        if (!g_trigger_in_use[i]) {
+            g_trigger_in_use[i] = true;
+            LOG_DEBUG(
+                "ADC_ARB: Acquired trigger timer %d", g_TRIGGERS[i].timer
+            );
+            return g_TRIGGERS[i];
+        }
+    }
+
+    LOG_ERROR("ADC_ARB: No free trigger timer");
+    THROW(ERROR_RESOURCE_BUSY);
+}
+
+void ADC_ARB_release_trigger(TIM_Num timer)
+{
+    for (size_t i = 0; i < ADC_ARB_TRIGGER_COUNT; i++) {
+        if (g_TRIGGERS[i].timer == timer) {
+            g_trigger_in_use[i] = false;
+            return;
+        }
+    }
+}
+
+void ADC_ARB_task(void) { arbiter_schedule(); }
@@ -0,0 +1,202 @@
+/**
+ * @file adc_arbiter.h
+ * @brief ADC resource arbiter for PSLab firmware
+ *
+ * This header provides an arbiter that owns the regular ADC sequence and its
+ * trigger timer on behalf of the instruments. Instruments request sessions
+ * with a priority and an optional time slice. The arbiter grants the ADC to
+ * one session at a time, queues the rest instead of failing with
+ * ERROR_RESOURCE_BUSY, preempts lower-priority sessions and rotates sessions
+ * of equal priority when their time slice expires.
+ *
+ * Each session keeps its own ADC and timer configuration, which the arbiter
+ * applies whenever the session is granted the ADC.
+ *
+ * The arbiter also owns the pool of timers that can trigger the ADC. An
+ * instrument takes a timer from the pool, together with the ADC trigger
+ * source that matches it, and uses it in its session requests until it gives
+ * the timer back.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef PSLAB_ADC_ARBITER_H
+#define PSLAB_ADC_ARBITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform/adc_ll.h"
+#include "platform/tim_ll.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of sessions that can be requested at the same time
+ */
+#define ADC_ARB_MAX_SESSIONS 4
+
+/**
+ * @brief ADC session handle (opaque)
+ */
+typedef struct ADC_ARB_Session ADC_ARB_Session;
+
+/**
+ * @brief ADC session priority
+ *
+ * A waiting session preempts an active session of strictly lower priority.
+ */
+typedef enum {
+    ADC_ARB_PRIORITY_LOW = 0,
+    ADC_ARB_PRIORITY_NORMAL,
+    ADC_ARB_PRIORITY_HIGH,
+} ADC_ARB_Priority;
+
+/**
+ * @brief ADC session state
+ */
+typedef enum {
+    ADC_ARB_STATE_WAITING, /**< Queued, waiting for the ADC */
+    ADC_ARB_STATE_ACTIVE, /**< Owns the ADC and trigger timer */
+    ADC_ARB_STATE_FINISHED, /**< Acquisition complete, ADC handed on */
+    ADC_ARB_STATE_FAILED, /**< Hardware setup failed when granted */
+} ADC_ARB_State;
+
+/**
+ * @brief Session event callback type
+ *
+ * @param context User context from the session request
+ */
+typedef void (*ADC_ARB_SessionCallback)(void *context);
+
+/**
+ * @brief Trigger timer taken from the pool
+ */
+typedef struct {
+    TIM_Num timer; /**< Trigger timer */
+    ADC_LL_TriggerSource trigger_source; /**< ADC trigger on its TRGO */
+} ADC_ARB_Trigger;
+
+/**
+ * @brief ADC session request
+ */
+typedef struct {
+    ADC_LL_Config adc_config; /**< ADC configuration for this session */
+    ADC_LL_CompleteCallback complete_callback; /**< ADC completion callback */
+    ADC_LL_HalfCompleteCallback
+        half_complete_callback; /**< ADC half-transfer callback, optional */
+    ADC_LL_SegmentCallback
+        segment_callback; /**< ADC segment callback, optional */
+    TIM_Num timer; /**< Trigger timer, matching adc_config.trigger_source */
+    uint32_t trigger_frequency; /**< Trigger timer frequency in Hz */
+    ADC_ARB_Priority priority; /**< Session priority */
+    uint32_t slice_ms; /**< Time slice in ms, 0 to run until released */
+    ADC_ARB_SessionCallback on_grant; /**< Called when the ADC is granted */
+    ADC_ARB_SessionCallback on_suspend; /**< Called when the ADC is taken */
+    void *context; /**< User context passed to the callbacks */
+} ADC_ARB_Request;
+
+/**
+ * @brief Request an ADC session
+ *
+ * The session is queued and granted the ADC as soon as no session of equal
+ * or higher priority is ahead of it. If the ADC is free, the session is
+ * granted before this function returns.
+ *
+ * When granted, the arbiter initializes the ADC and trigger timer with the
+ * session configuration and calls on_grant. The session is expected to start
+ * its acquisition from on_grant. If the hardware cannot be configured or
+ * on_grant throws, the session is marked as failed and keeps its pool slot
+ * until it is released. When the session is suspended, the hardware
+ * is stopped and deinitialized, on_suspend is called and the session is put
+ * back in the queue.
+ *
+ * The DMA position and converted samples are not saved across a suspension.
+ * When a preempted session is granted the ADC again, on_grant starts its
+ * acquisition over from the first sample, and the partial buffer it had
+ * filled before it was suspended is lost.
+ *
+ * A session whose ADC completion callback fires is finished. On the next
+ * call into the arbiter its hardware is stopped and the ADC is handed on, but
+ * the session keeps its pool slot in ADC_ARB_STATE_FINISHED until its owner
+ * releases it. Only ADC_ARB_release frees a session, so a handle stays valid
+ * until its owner gives it up. Half-transfer and segment events are passed to
+ * the session callbacks directly, so a circular acquisition streams until the
+ * session is released.
+ *
+ * @param request Pointer to session request
+ * @return Pointer to session handle
+ *
+ * @throws ERROR_INVALID_ARGUMENT if request is NULL or contains invalid values,
+ *         such as a trigger source that does not belong to the timer
+ * @throws ERROR_OUT_OF_MEMORY if all ADC_ARB_MAX_SESSIONS are in use
+ */
+ADC_ARB_Session *ADC_ARB_request(ADC_ARB_Request const *request);
+
+/**
+ * @brief Release an ADC session
+ *
+ * Stops and deinitializes the hardware if the session is active, removes the
+ * session from the queue and grants the ADC to the next waiting session. The
+ * handle becomes invalid after this call.
+ *
+ * @param session Pointer to session handle
+ */
+void ADC_ARB_release(ADC_ARB_Session *session);
+
+/**
+ * @brief Get the state of an ADC session
+ *
+ * @param session Pointer to session handle
+ * @return Current session state
+ *
+ * @throws ERROR_INVALID_ARGUMENT if session is NULL or not in use
+ */
+ADC_ARB_State ADC_ARB_get_state(ADC_ARB_Session const *session);
+
+/**
+ * @brief Get the number of sessions waiting for the ADC
+ *
+ * @return Number of queued sessions
+ */
+size_t ADC_ARB_get_queue_length(void);
+
+/**
+ * @brief Take a trigger timer from the pool
+ *
+ * The timer stays taken until it is given back with ADC_ARB_release_trigger.
+ * Timers without output pins are handed out first, and the 32-bit TIM2 last.
+ *
+ * @return Timer and matching ADC trigger source
+ *
+ * @throws ERROR_RESOURCE_BUSY if all trigger timers are taken
+ */
+ADC_ARB_Trigger ADC_ARB_acquire_trigger(void);
+
+/**
+ * @brief Give a trigger timer back to the pool
+ *
+ * Sessions using the timer must have been released. Timers that are not
+ * taken are ignored.
+ *
+ * @param timer Timer returned by ADC_ARB_acquire_trigger
+ */
+void ADC_ARB_release_trigger(TIM_Num timer);
+
+/**
+ * @brief Service the arbiter
+ *
+ * Hands the ADC on from finished sessions and rotates sessions whose time
+ * slice has expired. Must be called periodically from the main loop.
+ */
+void ADC_ARB_task(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSLAB_ADC_ARBITER_H
@@ -0,0 +1,114 @@
+/**
+ * @file boot.c
+ * @brief Boot sequencing and boot-time profiling for the PSLab Mini firmware.
+ *
+ * SYSTEM_init only brings up what is needed to start USB. Everything else is
+ * deferred until the host has configured the device, so that enumeration is
+ * not delayed by peripherals the host cannot see. If the host does not
+ * enumerate the device within a timeout, for example when powered from a
+ * charger, the deferred init runs anyway.
+ *
+ * Boot phases are timestamped in microseconds since reset. Until the cycle
+ * counter starts, right after the clock setup, only the 1 ms HAL tick runs,
+ * so the first phase has millisecond resolution.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform/platform.h"
+#include "platform/usb_ll.h"
+#include "util/logging.h"
+#include "util/si_prefix.h"
+
+#include "system.h"
+
+// Run the deferred init even if the host has not enumerated the device
+enum { BOOT_DEFER_TIMEOUT_US = 1000000 };
+
+// Implemented in system.c
+void system_init_deferred(void);
+
+// Time since reset at which the timebase started
+static uint64_t g_boot_offset_us = 0;
+static SYSTEM_BootTiming g_boot_timing = { 0 };
+static bool g_boot_deferred_done = false;
+
+/**
+ * @brief Start boot profiling
+ *
+ * Called from SYSTEM_init right after the timebase has started.
+ */
+void boot_init(void)
+{
+    g_boot_offset_us = (uint64_t)PLATFORM_get_tick() * SI_MILLI_DIV -
+                       SYSTEM_get_time_us();
+    g_boot_timing = (SYSTEM_BootTiming){ 0 };
+    g_boot_deferred_done = false;
+
+    SYSTEM_boot_mark(SYSTEM_BOOT_CLOCKS);
+}
+
+void SYSTEM_boot_mark(SYSTEM_BootPhase phase)
+{
+    if (phase >= SYSTEM_BOOT_PHASE_COUNT ||
+        g_boot_timing.phase_us[phase] != 0) {
+        return;
+    }
+
+    g_boot_timing.phase_us[phase] = g_boot_offset_us + SYSTEM_get_time_us();
+}
+
+/**
+ * @brief Run the deferred init and mark the boot as complete
+ */
+static void boot_finish(bool mounted)
+{
+    system_init_deferred();
+    g_boot_deferred_done = true;
+    SYSTEM_boot_mark(SYSTEM_BOOT_COMPLETE);
+
+    if (!mounted) {
+        LOG_WARN("USB not enumerated, finished boot without it");
+    }
+    LOG_INFO(
+        "Boot complete after %lu us",
+        (unsigned long)g_boot_timing.phase_us[SYSTEM_BOOT_COMPLETE]
+    );
+}
+
+bool SYSTEM_boot_task(void)
+{
+    bool mounted = USB_LL_mounted();
+
+    if (mounted) {
+        SYSTEM_boot_mark(SYSTEM_BOOT_USB_ENUMERATED);
+    }
+
+    if (g_boot_deferred_done) {
+        return true;
+    }
+
+    if (!mounted &&
+        g_boot_offset_us + SYSTEM_get_time_us() < BOOT_DEFER_TIMEOUT_US) {
+        return false;
+    }
+
+    boot_finish(mounted);
+    return true;
+}
+
+void SYSTEM_boot_finish(void)
+{
+    if (g_boot_deferred_done) {
+        return;
+    }
+
+    boot_finish(false);
+}
+
+SYSTEM_BootTiming SYSTEM_get_boot_timing(void) { return g_boot_timing; }
@@ -452,6 +452,13 @@ bool UART_tx_busy(UART_Handle *handle)
     return UART_LL_tx_busy(handle->bus_id);
 }
 
+/**
+ * @brief Start sending data that another driver put in the TX buffer.
+ *
+ * @param handle Pointer to UART handle structure.
+ */
+void UART_tx_start(UART_Handle *handle) { start_transmission(handle); }
+
 /**
  * @brief Set RX callback to be triggered when threshold bytes are available.
  *
@@ -192,6 +192,18 @@ uint32_t UART_tx_free_space(UART_Handle *handle);
  */
 bool UART_tx_busy(UART_Handle *handle);
 
+/**
+ * @brief Start sending data that another driver put in the TX buffer.
+ *
+ * For buffers shared with another driver, e.g. the RX buffer of a USB
+ * interface bridged to this bus, which writes into the buffer directly.
+ * Does nothing while a transmission is in progress; the rest of the buffer
+ * follows when it completes.
+ *
+ * @param handle Pointer to UART handle structure.
+ */
+void UART_tx_start(UART_Handle *handle);
+
 /**
  * @brief Enable UART passthrough mode.
  *
@@ -4,15 +4,19 @@
  *
  * This module provides a handle-based CDC USB API on top of the TinyUSB stack,
  * mirroring the UART API functionality to provide a consistent interface
- * for different communication methods. While the current hardware only supports
- * a single USB interface, the handle-based design keeps the API consistent
- * with UART and makes it future-proof for potential multi-interface support.
+ * for different communication methods. Each handle drives one of the CDC
+ * interfaces of the composite device.
  *
  * Features:
  * - Handle-based API for consistency with UART driver
  * - Non-blocking read/write operations
+ * - Blocking write with back-pressure for responses larger than the buffers
+ * - Latency-aware flushing: message ends are sent right away, other data
+ *   within a millisecond
+ * - Zero-copy transmission of large blocks straight from caller memory
  * - Configurable RX callback for protocol implementations
  * - Buffer status inquiry functions
+ * - Buffers that can be shared with a UART to bridge it to the host
  * - Circular buffers for reliable USB data reception and transmission
  *
  * @author Alexander Bessman
@@ -25,6 +29,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "platform/platform.h"
 #include "platform/usb_ll.h"
 #include "util/error.h"
 #include "util/util.h"
@@ -34,8 +39,11 @@
 /* Maximum number of USB interfaces */
 #define USB_INTERFACE_COUNT USB_BUS_COUNT
 
-/* Timeout for flushing TX buffer (roughly 100 calls to USB_task) */
-enum { USB_TX_FLUSH_TIMEOUT = 100 };
+/*
+ * Time a partial packet may wait in the endpoint FIFO for more data before it
+ * is sent without a message end, in ms (one USB frame)
+ */
+enum { USB_TX_FLUSH_DELAY_MS = 1 };
 
 /**
  * @brief USB interface handle structure
@@ -46,7 +54,16 @@ struct USB_Handle {
     CircularBuffer *tx_buffer;
     USB_RxCallback rx_callback;
     uint32_t rx_threshold;
-    uint32_t tx_timeout_counter;
+    uint32_t tx_flush_lead; // Buffered bytes up to the last message end
+    uint32_t tx_unflushed_since; // Tick of the oldest unflushed FIFO data
+    bool tx_flush_pending;
+    bool tx_unflushed; // Data went to the FIFO since its last flush
+    USB_TxBlock tx_block;
+    uint32_t tx_block_lead; // Buffered bytes to send before the block
+    uint32_t tx_block_sent; // Block bytes handed to the endpoint
+    bool tx_block_pending;
+    bool tx_block_aborted;
+    bool shared_buffers; // Another driver moves the buffer positions
     bool initialized;
 };
 
@@ -77,6 +94,9 @@ static USB_Handle *get_handle_from_interface(uint8_t interface_id)
 /**
  * @brief Move data from TinyUSB CDC RX buffer to our circular buffer
  *
+ * Reads straight into the free space of the circular buffer, one contiguous
+ * span per USB_LL_read call.
+ *
  * @param handle Pointer to USB handle structure
  *
  * @return Number of bytes transferred
@@ -87,16 +107,22 @@ static uint32_t transfer_rx(USB_Handle *handle)
         return 0;
     }
 
-    uint32_t available = USB_LL_rx_available(handle->interface_id);
     uint32_t transferred = 0;
-    uint8_t temp = 0;
-
-    while (available > 0 && !circular_buffer_is_full(handle->rx_buffer)) {
-        if (USB_LL_read(handle->interface_id, &temp, 1) == 1) {
-            circular_buffer_put(handle->rx_buffer, temp);
-            transferred++;
-            available--;
-        } else {
+
+    // At most two spans: up to the end of the buffer, then from its start
+    while (true) {
+        uint8_t *span = nullptr;
+        uint32_t const len =
+            circular_buffer_reserve_span(handle->rx_buffer, &span);
+        if (len == 0) {
+            break;
+        }
+
+        uint32_t const count = USB_LL_read(handle->interface_id, span, len);
+        circular_buffer_commit(handle->rx_buffer, count);
+        transferred += count;
+
+        if (count < len) {
             break;
         }
     }
@@ -107,6 +133,9 @@ static uint32_t transfer_rx(USB_Handle *handle)
 /**
  * @brief Move data from TX circular buffer to USB TX endpoint
  *
+ * Writes straight from the circular buffer, one contiguous span per
+ * USB_LL_write call.
+ *
  * @param handle Pointer to USB handle structure
  *
  * @return Number of bytes transferred
@@ -120,20 +149,150 @@ static uint32_t transfer_tx(USB_Handle *handle)
     uint32_t to_send = circular_buffer_available(handle->tx_buffer);
     uint32_t transferred = 0;
 
-    while (to_send > 0 && USB_LL_tx_available(handle->interface_id)) {
-        uint8_t temp = 0;
-        circular_buffer_get(handle->tx_buffer, &temp);
-        if (USB_LL_write(handle->interface_id, &temp, 1) == 1) {
-            transferred++;
-            to_send--;
-        } else {
+    // Data written after a queued block waits until the block is out
+    if (handle->tx_block_pending && to_send > handle->tx_block_lead) {
+        to_send = handle->tx_block_lead;
+    }
+
+    while (to_send > 0) {
+        uint8_t const *span = nullptr;
+        uint32_t len = circular_buffer_peek_span(handle->tx_buffer, &span);
+        if (len > to_send) {
+            len = to_send;
+        }
+
+        uint32_t const written = USB_LL_write(handle->interface_id, span, len);
+        circular_buffer_consume(handle->tx_buffer, written);
+        if (written > 0 && !handle->tx_unflushed) {
+            handle->tx_unflushed = true;
+            handle->tx_unflushed_since = PLATFORM_get_tick();
+        }
+        transferred += written;
+        to_send -= written;
+
+        // The CDC FIFO is full
+        if (written < len) {
             break;
         }
     }
 
+    if (handle->tx_block_pending) {
+        handle->tx_block_lead -= transferred;
+    }
+    if (handle->tx_flush_pending) {
+        // Data written after the message end may have gone out with it
+        handle->tx_flush_lead = transferred >= handle->tx_flush_lead
+                                    ? 0
+                                    : handle->tx_flush_lead - transferred;
+    }
+
     return transferred;
 }
 
+/**
+ * @brief Send the endpoint FIFO without waiting for a full packet
+ *
+ * @param handle Pointer to USB handle structure
+ */
+static void flush_fifo(USB_Handle *handle)
+{
+    handle->tx_unflushed = false;
+    USB_LL_tx_flush((USB_Bus)handle->interface_id);
+}
+
+/**
+ * @brief Decide whether to send the partial packet in the endpoint FIFO
+ *
+ * Full packets leave the FIFO on their own; a partial packet waits for more
+ * data unless it is flushed. It is flushed as soon as the end of a message
+ * has reached the FIFO. Otherwise it is flushed once it has waited for
+ * USB_TX_FLUSH_DELAY_MS, unless more data is on its way: bytes still in the
+ * TX buffer, or a queued block, which flushes the FIFO itself before it
+ * starts. A transfer that ends on a packet boundary is terminated with a
+ * zero-length packet by the CDC class driver.
+ *
+ * @param handle Pointer to USB handle structure
+ */
+static void transfer_flush(USB_Handle *handle)
+{
+    if (handle->tx_flush_pending && handle->tx_flush_lead == 0) {
+        handle->tx_flush_pending = false;
+        if (handle->tx_unflushed) {
+            flush_fifo(handle);
+        }
+        return;
+    }
+
+    if (!handle->tx_unflushed || handle->tx_block_pending ||
+        !circular_buffer_is_empty(handle->tx_buffer)) {
+        return;
+    }
+
+    if (PLATFORM_get_tick() - handle->tx_unflushed_since >=
+        USB_TX_FLUSH_DELAY_MS) {
+        flush_fifo(handle);
+    }
+}
+
+/**
+ * @brief Feed the queued block to the USB TX endpoint
+ *
+ * Once the data written before the block has left the CDC FIFO, the block is
+ * handed to the endpoint directly. Its callback is called when the endpoint
+ * no longer reads from it.
+ *
+ * @param handle Pointer to USB handle structure
+ */
+static void transfer_block(USB_Handle *handle)
+{
+    if (!handle->tx_block_pending || handle->tx_block_lead > 0) {
+        return;
+    }
+
+    USB_Bus const id = (USB_Bus)handle->interface_id;
+    USB_TxBlock const *block = &handle->tx_block;
+
+    if (!handle->tx_block_aborted && handle->tx_block_sent < block->size) {
+        // The endpoint only takes the block once the FIFO has been sent
+        if (USB_LL_tx_available(id) < USB_LL_tx_bufsize(id)) {
+            flush_fifo(handle);
+            return;
+        }
+
+        handle->tx_block_sent += USB_LL_write_direct(
+            id,
+            block->data + handle->tx_block_sent,
+            block->size - handle->tx_block_sent
+        );
+        return;
+    }
+
+    // The endpoint reads the block until the host has taken the last packet
+    if (USB_LL_tx_in_flight(id)) {
+        return;
+    }
+
+    handle->tx_block_pending = false;
+    if (block->callback) {
+        block->callback(block->context, !handle->tx_block_aborted);
+    }
+}
+
+/**
+ * @brief Give up on sending the queued block
+ *
+ * The block callback is still deferred until the endpoint lets go of it.
+ *
+ * @param handle Pointer to USB handle structure
+ */
+static void abort_block(USB_Handle *handle)
+{
+    if (handle->tx_block_pending) {
+        handle->tx_block_aborted = true;
+        handle->tx_block_lead = 0;
+    }
+}
+
 /**
  * @brief Check if RX callback condition is met and call if needed
  *
@@ -181,12 +340,18 @@ static void line_state_callback(USB_Bus itf, bool dtr, bool rts)
 
     // When DTR is de-asserted (goes low), the host has disconnected
     if (!dtr) {
-        // Reset the circular buffers to clear any pending data
-        circular_buffer_reset(handle->rx_buffer);
-        circular_buffer_reset(handle->tx_buffer);
+        // Reset the circular buffers to clear any pending data, unless they
+        // belong to another driver as well
+        if (!handle->shared_buffers) {
+            circular_buffer_reset(handle->rx_buffer);
+            circular_buffer_reset(handle->tx_buffer);
+        }
+        abort_block(handle);
 
-        // Reset the TX timeout counter
-        handle->tx_timeout_counter = 0;
+        // Forget the pending flush
+        handle->tx_flush_lead = 0;
+        handle->tx_flush_pending = false;
+        handle->tx_unflushed = false;
     }
 }
 
@@ -230,7 +395,16 @@ USB_Handle *USB_init(
     handle->tx_buffer = tx_buffer;
     handle->rx_callback = nullptr;
     handle->rx_threshold = 0;
-    handle->tx_timeout_counter = 0;
+    handle->tx_flush_lead = 0;
+    handle->tx_unflushed_since = 0;
+    handle->tx_flush_pending = false;
+    handle->tx_unflushed = false;
+    handle->tx_block = (USB_TxBlock){ 0 };
+    handle->tx_block_lead = 0;
+    handle->tx_block_sent = 0;
+    handle->tx_block_pending = false;
+    handle->tx_block_aborted = false;
+    handle->shared_buffers = false;
     handle->initialized = true;
 
     /* Store handle in global array */
@@ -253,10 +427,8 @@ void USB_deinit(USB_Handle *handle)
         return;
     }
 
-    /* Deinitialize USB hardware if this is interface 0 */
-    if (handle->interface_id == 0) {
-        USB_LL_deinit((USB_Bus)handle->interface_id);
-    }
+    /* The USB hardware is turned off along with the last interface */
+    USB_LL_deinit((USB_Bus)handle->interface_id);
 
     /* Clear from global array */
     if (handle->interface_id < USB_INTERFACE_COUNT) {
@@ -285,8 +457,10 @@ void USB_task(USB_Handle *handle)
 
     USB_LL_task(handle->interface_id);
 
-    // Nothing to do if not connected
+    // Nothing to do if not connected, except to release a queued block
     if (!USB_LL_connected(handle->interface_id)) {
+        abort_block(handle);
+        transfer_block(handle);
         return;
     }
 
@@ -298,25 +472,17 @@ void USB_task(USB_Handle *handle)
     // Check for RX callbacks after processing USB tasks
     check_rx_callback(handle);
 
+    // Send the queued block once the data ahead of it is out, and release it
+    // first so that the data behind it follows in the same call
+    transfer_block(handle);
+
     // Transfer data from our TX buffer to the USB hardware
     if (!circular_buffer_is_empty(handle->tx_buffer)) {
         transfer_tx(handle);
     }
 
-    // Check if there's data in the hardware TX buffer and flush if timeout
-    if (USB_LL_tx_available(handle->interface_id) <
-        USB_LL_tx_bufsize(handle->interface_id)) {
-        handle->tx_timeout_counter++;
-        if (handle->tx_timeout_counter >= USB_TX_FLUSH_TIMEOUT) {
-            USB_LL_tx_flush(handle->interface_id);
-            handle->tx_timeout_counter = 0;
-        }
-    } else {
-        // No data in hardware buffer, reset counter if our buffer is also empty
-        if (circular_buffer_is_empty(handle->tx_buffer)) {
-            handle->tx_timeout_counter = 0;
-        }
-    }
+    // Send a partial packet left in the FIFO when it is due
+    transfer_flush(handle);
 }
 
 /**
@@ -401,6 +567,123 @@ uint32_t USB_write(USB_Handle *handle, uint8_t const *buf, uint32_t sz)
     return written;
 }
 
+/**
+ * @brief Write all data to USB interface, waiting for the host to read it
+ *
+ * @param handle Pointer to USB handle structure
+ * @param buf Pointer to the data buffer to send
+ * @param sz  Number of bytes to write
+ * @param timeout Maximum time in ms without progress, 0 to wait forever
+ * @return Number of bytes written, always sz
+ */
+uint32_t USB_write_all(
+    USB_Handle *handle,
+    uint8_t const *buf,
+    uint32_t sz,
+    uint32_t timeout
+)
+{
+    if (!handle || !handle->initialized || (buf == nullptr && sz > 0)) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    uint32_t written = 0;
+    uint32_t last_progress = PLATFORM_get_tick();
+
+    while (written < sz) {
+        if (!USB_LL_connected(handle->interface_id)) {
+            THROW(ERROR_DEVICE_NOT_READY);
+        }
+
+        uint32_t const chunk = circular_buffer_write(
+            handle->tx_buffer, buf + written, sz - written
+        );
+        written += chunk;
+
+        if (chunk > 0) {
+            last_progress = PLATFORM_get_tick();
+        } else if (timeout &&
+                   (PLATFORM_get_tick() - last_progress) > timeout) {
+            THROW(ERROR_TIMEOUT);
+        }
+
+        // Move buffered data to the endpoint and let the stack send it
+        USB_task(handle);
+    }
+
+    return written;
+}
+
+/**
+ * @brief Mark the end of a message, to be sent without waiting for more data
+ *
+ * @param handle Pointer to USB handle structure
+ */
+void USB_tx_flush(USB_Handle *handle)
+{
+    if (!handle || !handle->initialized) {
+        return;
+    }
+
+    handle->tx_flush_lead = circular_buffer_available(handle->tx_buffer);
+    handle->tx_flush_pending = true;
+
+    if (!USB_LL_connected(handle->interface_id)) {
+        return;
+    }
+
+    // Usually the whole message fits in the FIFO and leaves right away
+    if (handle->tx_flush_lead > 0) {
+        transfer_tx(handle);
+    }
+    transfer_flush(handle);
+}
+
+/**
+ * @brief Queue a block to be sent without copying it
+ *
+ * @param handle Pointer to USB handle structure
+ * @param block Pointer to block descriptor, copied by the call
+ */
+void USB_write_block(USB_Handle *handle, USB_TxBlock const *block)
+{
+    if (!handle || !handle->initialized || !block || !block->data ||
+        block->size == 0) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    if (handle->tx_block_pending) {
+        THROW(ERROR_RESOURCE_BUSY);
+    }
+
+    if (!USB_LL_connected(handle->interface_id)) {
+        THROW(ERROR_DEVICE_NOT_READY);
+    }
+
+    handle->tx_block = *block;
+    handle->tx_block_lead = circular_buffer_available(handle->tx_buffer);
+    handle->tx_block_sent = 0;
+    handle->tx_block_aborted = false;
+    handle->tx_block_pending = true;
+
+    // Start right away if nothing is queued ahead of the block
+    transfer_block(handle);
+}
+
+/**
+ * @brief Check if a block queued by USB_write_block is still held.
+ *
+ * @param handle Pointer to USB handle structure
+ * @return true until the block callback has been called
+ */
+bool USB_tx_block_pending(USB_Handle *handle)
+{
+    if (!handle || !handle->initialized) {
+        return false;
+    }
+    return handle->tx_block_pending;
+}
+
 /**
  * @brief Set RX callback to be triggered when threshold bytes are available.
  *
@@ -426,6 +709,21 @@ void USB_set_rx_callback(
     check_rx_callback(handle);
 }
 
+/**
+ * @brief Let another driver work on the buffers directly.
+ *
+ * @param handle Pointer to USB handle structure
+ * @param shared true if another driver works on the buffers
+ */
+void USB_set_shared_buffers(USB_Handle *handle, bool shared)
+{
+    if (!handle || !handle->initialized) {
+        return;
+    }
+
+    handle->shared_buffers = shared;
+}
+
 /**
  * @brief Get TX buffer free space.
  *
@@ -457,8 +755,10 @@ bool USB_tx_busy(USB_Handle *handle)
     if (!handle || !handle->initialized) {
         return false;
     }
-    // Check if either our TX buffer or the hardware TX buffer has data
+    // Check if our TX buffer, a queued block or the hardware TX buffer has
+    // data
     return !circular_buffer_is_empty(handle->tx_buffer) ||
+           handle->tx_block_pending ||
            (USB_LL_tx_available(handle->interface_id) <
             USB_LL_tx_bufsize(handle->interface_id));
 }
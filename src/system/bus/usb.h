@@ -3,14 +3,18 @@
  * @brief USB interface
  *
  * This module exposes a handle-based, CDC‐based USB API on top of the
- * TinyUSB stack. It provides a consistent interface with the UART driver
- * and allows for future expansion to support multiple USB interfaces.
+ * TinyUSB stack. It provides a consistent interface with the UART driver.
+ * Each handle drives one CDC interface of the composite device: interface 0
+ * carries SCPI, interface 1 the console.
  *
  * Features:
  * - Handle-based API for consistency with UART driver
  * - Non-blocking read/write operations
  * - Configurable RX callback for protocol implementations
+ * - Zero-copy transmission of large blocks straight from caller memory
+ * - Message ends sent right away with USB_tx_flush
  * - Buffer status inquiry functions
+ * - Buffers that can be shared with a UART to bridge it to the host
  * - Circular buffers for reliable USB data reception and transmission
  *
  * Basic Usage:
@@ -71,10 +75,29 @@ typedef struct USB_Handle USB_Handle;
  */
 typedef void (*USB_RxCallback)(USB_Handle *handle, uint32_t bytes_available);
 
+/**
+ * @brief Callback function type for USB TX block completion.
+ *
+ * @param context User context from the block descriptor
+ * @param completed true if the whole block was sent, false if the host
+ *                  disconnected first
+ */
+typedef void (*USB_TxBlockCallback)(void *context, bool completed);
+
+/**
+ * @brief Descriptor of a block to send without copying
+ */
+typedef struct {
+    uint8_t const *data; /**< First byte of the block */
+    uint32_t size; /**< Number of bytes */
+    USB_TxBlockCallback callback; /**< Called once the memory is released */
+    void *context; /**< User context passed to the callback */
+} USB_TxBlock;
+
 /**
  * @brief Get the number of available USB interfaces.
  *
- * @return Number of USB interfaces supported by this platform (currently 1)
+ * @return Number of USB interfaces supported by this platform
  */
 size_t USB_get_interface_count(void);
 
@@ -84,8 +107,7 @@ size_t USB_get_interface_count(void);
  * Configures the USB hardware and initializes the TinyUSB stack for device
  * operation. Allocates and returns a new USB handle.
  *
- * @param interface USB interface to initialize (0-based index, currently only 0
- * is supported)
+ * @param interface USB interface to initialize (0-based index)
  * @param rx_buffer Pointer to pre-allocated RX circular buffer
  * @param tx_buffer Pointer to pre-allocated TX circular buffer
  * @return Pointer to USB handle on success, nullptr on failure (including
@@ -149,6 +171,75 @@ uint32_t USB_read(USB_Handle *handle, uint8_t *buf, uint32_t sz);
  */
 uint32_t USB_write(USB_Handle *handle, uint8_t const *buf, uint32_t sz);
 
+/**
+ * @brief Write all data to USB interface, waiting for the host to read it
+ *
+ * Unlike USB_write, which only queues what fits in the TX buffer, this keeps
+ * stepping the USB stack while the buffer is full, until every byte has been
+ * queued. The tail of the data may still be in the TX buffer on return; it is
+ * sent by subsequent calls to USB_task.
+ *
+ * Must not be called from interrupt context.
+ *
+ * @param handle Pointer to USB handle structure
+ * @param buf Pointer to the data buffer to send
+ * @param sz  Number of bytes to write
+ * @param timeout Maximum time in ms without progress, 0 to wait forever
+ * @return Number of bytes written, always sz
+ *
+ * @throws ERROR_INVALID_ARGUMENT if handle or buf is invalid
+ * @throws ERROR_DEVICE_NOT_READY if the host is or becomes disconnected
+ * @throws ERROR_TIMEOUT if the host stops reading for longer than timeout
+ */
+uint32_t USB_write_all(
+    USB_Handle *handle,
+    uint8_t const *buf,
+    uint32_t sz,
+    uint32_t timeout
+);
+
+/**
+ * @brief Mark the end of a message, to be sent without waiting for more data
+ *
+ * Written data is sent in full packets as soon as possible, but a partial
+ * packet at the end is held back for up to a millisecond in case more data
+ * follows. Call this after the last byte of a reply, such as the terminator
+ * of a SCPI response, to send it right away. If a block or other data are
+ * still ahead of the message end, it is sent as soon as they are out.
+ *
+ * @param handle Pointer to USB handle structure
+ */
+void USB_tx_flush(USB_Handle *handle);
+
+/**
+ * @brief Queue a block to be sent without copying it
+ *
+ * The block is sent after any data already written and before any data
+ * written later. Its endpoint packets are read straight from block->data,
+ * rather than being copied into the TX buffer first, so the memory must stay
+ * valid and unchanged until the callback runs. The callback is called from
+ * USB_task once the host has read the block, or once the endpoint has let go
+ * of the memory after the host disconnected.
+ *
+ * Only one block can be queued at a time.
+ *
+ * @param handle Pointer to USB handle structure
+ * @param block Pointer to block descriptor, copied by the call
+ *
+ * @throws ERROR_INVALID_ARGUMENT if handle or block is invalid
+ * @throws ERROR_RESOURCE_BUSY if a block is already queued
+ * @throws ERROR_DEVICE_NOT_READY if the host is disconnected
+ */
+void USB_write_block(USB_Handle *handle, USB_TxBlock const *block);
+
+/**
+ * @brief Check if a block queued by USB_write_block is still held.
+ *
+ * @param handle Pointer to USB handle structure
+ * @return true until the block callback has been called
+ */
+bool USB_tx_block_pending(USB_Handle *handle);
+
 /**
  * @brief Set RX callback to be triggered when threshold bytes are available.
  *
@@ -163,6 +254,19 @@ void USB_set_rx_callback(
     uint32_t threshold
 );
 
+/**
+ * @brief Let another driver work on the buffers directly.
+ *
+ * Data left in the buffers is normally dropped when the host closes the port.
+ * Buffers shared with another producer or consumer, such as a UART whose DMA
+ * reads the RX buffer and fills the TX buffer, are left alone instead, as
+ * only their owners may move the read and write positions.
+ *
+ * @param handle Pointer to USB handle structure
+ * @param shared true if another driver works on the buffers
+ */
+void USB_set_shared_buffers(USB_Handle *handle, bool shared);
+
 /**
  * @brief Get TX buffer free space.
  *
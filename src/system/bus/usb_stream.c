@@ -0,0 +1,117 @@
+/**
+ * @file usb_stream.c
+ * @brief Framed streaming over the USB vendor bulk interface
+ *
+ * Frames are written into the TinyUSB vendor TX buffer, from which the stack
+ * starts multi-packet bulk transfers on its own. This module only adds the
+ * framing and waits for buffer space.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform/platform.h"
+#include "platform/usb_ll.h"
+#include "util/error.h"
+
+#include "usb_stream.h"
+
+/* Vendor interface carrying the stream */
+#define USB_STREAM_BUS (USB_BUS_0)
+
+/* Sequence number of the next frame */
+static uint32_t g_sequence = 0;
+
+/**
+ * @brief Store a 16-bit value little-endian
+ */
+static void put_le16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief Store a 32-bit value little-endian
+ */
+static void put_le32(uint8_t *dst, uint32_t value)
+{
+    put_le16(dst, (uint16_t)value);
+    put_le16(dst + 2, (uint16_t)(value >> 16));
+}
+
+/**
+ * @brief Write bytes to the bulk pipe, waiting for buffer space
+ *
+ * @param buf Bytes to write
+ * @param size Number of bytes
+ * @param timeout Maximum time in ms without progress, 0 to wait forever
+ */
+static void write_all(uint8_t const *buf, uint32_t size, uint32_t timeout)
+{
+    uint32_t written = 0;
+    uint32_t last_progress = PLATFORM_get_tick();
+
+    while (written < size) {
+        if (!USB_LL_vendor_mounted(USB_STREAM_BUS)) {
+            THROW(ERROR_DEVICE_NOT_READY);
+        }
+
+        uint32_t const chunk = USB_LL_vendor_write(
+            USB_STREAM_BUS, buf + written, size - written
+        );
+        written += chunk;
+
+        if (chunk > 0) {
+            last_progress = PLATFORM_get_tick();
+        } else if (timeout &&
+                   (PLATFORM_get_tick() - last_progress) > timeout) {
+            THROW(ERROR_TIMEOUT);
+        }
+
+        if (written < size) {
+            // Let the stack complete transfers and refill the endpoint
+            USB_LL_task(USB_STREAM_BUS);
+        }
+    }
+}
+
+bool USB_STREAM_ready(void) { return USB_LL_vendor_mounted(USB_STREAM_BUS); }
+
+uint32_t USB_STREAM_write_frame(
+    USB_StreamType const type,
+    void const *payload,
+    uint32_t const size,
+    uint32_t const timeout
+)
+{
+    if (payload == nullptr && size > 0) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    if (!USB_LL_vendor_mounted(USB_STREAM_BUS)) {
+        THROW(ERROR_DEVICE_NOT_READY);
+    }
+
+    // Taken before sending, so that a frame cut short leaves a gap
+    uint32_t const sequence = g_sequence++;
+
+    uint8_t header[USB_STREAM_HEADER_SIZE] = { 0 };
+    put_le16(&header[0], USB_STREAM_MAGIC);
+    header[2] = (uint8_t)type;
+    header[3] = 0; // Flags
+    put_le32(&header[4], sequence);
+    put_le32(&header[8], size);
+
+    write_all(header, sizeof(header), timeout);
+    write_all(payload, size, timeout);
+
+    // Send a trailing partial packet now rather than with the next frame
+    USB_LL_vendor_tx_flush(USB_STREAM_BUS);
+
+    return sequence;
+}
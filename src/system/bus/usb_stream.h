@@ -0,0 +1,93 @@
+/**
+ * @file usb_stream.h
+ * @brief Framed streaming over the USB vendor bulk interface
+ *
+ * The CDC interface carries SCPI, which suits short commands and replies.
+ * Sample streams and large records go over a separate vendor class bulk
+ * interface instead, where the host reads long multi-packet transfers
+ * without the CDC buffering in between.
+ *
+ * Everything sent on the bulk pipe is split into frames, so the host can
+ * find record boundaries and notice lost data. Each frame is a fixed-size
+ * header followed by the payload. All header fields are little-endian:
+ *
+ * | Offset | Size | Field                                    |
+ * |--------|------|------------------------------------------|
+ * | 0      | 2    | Magic, USB_STREAM_MAGIC                  |
+ * | 2      | 1    | Frame type, USB_StreamType               |
+ * | 3      | 1    | Flags, reserved, 0                       |
+ * | 4      | 4    | Sequence number, +1 per frame, wraps     |
+ * | 8      | 4    | Payload length in bytes                  |
+ *
+ * A frame cut short by a timeout or a disconnect leaves the stream out of
+ * step. The host gets back in step by scanning for the magic, and the
+ * sequence numbers tell it how many frames were lost.
+ *
+ * The OUT endpoint of the interface is not used yet.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef PSLAB_USB_STREAM_H
+#define PSLAB_USB_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    USB_STREAM_MAGIC = 0x5350, // "PS" on the wire
+    USB_STREAM_HEADER_SIZE = 12,
+};
+
+/**
+ * @brief Frame payload types
+ */
+typedef enum {
+    USB_STREAM_TYPE_DATA = 0, /**< Unspecified data */
+    USB_STREAM_TYPE_DSO_RECORD = 1, /**< Oscilloscope record, 16-bit samples */
+} USB_StreamType;
+
+/**
+ * @brief Check if the host has configured the bulk interface
+ *
+ * @return true if frames can be sent
+ */
+bool USB_STREAM_ready(void);
+
+/**
+ * @brief Send one frame on the bulk pipe
+ *
+ * Waits for the host to read as long as the vendor TX buffer is full,
+ * stepping the USB stack meanwhile. The payload is copied, so the caller may
+ * reuse it on return. The tail of the frame may still be buffered on return;
+ * it is sent by the USB stack without further calls.
+ *
+ * Must not be called from interrupt context.
+ *
+ * @param type Frame type
+ * @param payload Payload bytes, may be nullptr if size is 0
+ * @param size Payload length in bytes
+ * @param timeout Maximum time in ms without progress, 0 to wait forever
+ * @return Sequence number of the frame
+ *
+ * @throws ERROR_INVALID_ARGUMENT if payload is nullptr and size is not 0
+ * @throws ERROR_DEVICE_NOT_READY if the interface is or becomes unconfigured
+ * @throws ERROR_TIMEOUT if the host stops reading for longer than timeout
+ */
+uint32_t USB_STREAM_write_frame(
+    USB_StreamType type,
+    void const *payload,
+    uint32_t size,
+    uint32_t timeout
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSLAB_USB_STREAM_H
@@ -0,0 +1,362 @@
+/**
+ * @file usbtmc.c
+ * @brief SCPI transport over the USBTMC/USB488 interface
+ *
+ * The TinyUSB USBTMC class handles the USBTMC message headers and control
+ * requests; this module sits between its callbacks, forwarded by the USB
+ * driver, and the circular buffers of the SCPI parser.
+ *
+ * Reception is flow controlled: the bulk OUT endpoint is only armed while
+ * the RX buffer can take a full packet plus the newline that may be added at
+ * the end of a message. Transmission answers each bulk IN request straight
+ * from the TX buffer, without copying; the bytes are consumed once the host
+ * has read them.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform/platform.h"
+#include "platform/usb_ll.h"
+#include "util/error.h"
+#include "util/logging.h"
+#include "util/util.h"
+
+#include "usbtmc.h"
+
+/* USB bus with the USBTMC interface */
+#define USBTMC_BUS (USB_BUS_0)
+
+enum {
+    USBTMC_PACKET_SIZE = 64, // Full-speed bulk packet
+    // Room needed to arm the OUT endpoint: a packet and a newline
+    USBTMC_RX_RESERVE = USBTMC_PACKET_SIZE + 1,
+};
+
+/* Transport state */
+typedef struct {
+    CircularBuffer *rx_buffer;
+    CircularBuffer *tx_buffer;
+    USBTMC_StatusCallback status_callback;
+    uint32_t in_requested; // Size of the pending bulk IN request, 0 if none
+    uint32_t in_flight; // Bytes handed to the endpoint, not yet read
+    uint32_t tx_message_bytes; // Bytes up to the end of the last response
+    uint8_t rx_last; // Last message byte received
+    uint8_t srq_status; // Status byte of a service request not yet sent
+    bool srq_pending;
+    bool response_open; // A response is being written
+    bool discard_output; // Drop the rest of a response cleared by the host
+    bool mounted;
+    bool initialized;
+} TmcState;
+
+static TmcState g_tmc = { 0 };
+
+/**
+ * @brief Arm the bulk OUT endpoint if the RX buffer has room for a packet
+ */
+static void tmc_start_read(void)
+{
+    if (circular_buffer_free_space(g_tmc.rx_buffer) >= USBTMC_RX_RESERVE) {
+        USB_LL_tmc_start_read(USBTMC_BUS);
+    }
+}
+
+/**
+ * @brief Answer a pending bulk IN request from the TX buffer
+ *
+ * Only complete responses are sent, unless the TX buffer is full, in which
+ * case the response being written is sent in part so that it can continue.
+ */
+static void tmc_send_response(void)
+{
+    if (g_tmc.in_requested == 0 || g_tmc.in_flight > 0) {
+        return;
+    }
+
+    bool const partial = circular_buffer_is_full(g_tmc.tx_buffer);
+    if (g_tmc.tx_message_bytes == 0 && !partial) {
+        return;
+    }
+
+    uint8_t const *span = nullptr;
+    uint32_t len = circular_buffer_peek_span(g_tmc.tx_buffer, &span);
+    bool end_of_message = false;
+
+    if (g_tmc.tx_message_bytes > 0 && len >= g_tmc.tx_message_bytes) {
+        len = g_tmc.tx_message_bytes;
+        end_of_message = true;
+    }
+    if (len > g_tmc.in_requested) {
+        len = g_tmc.in_requested;
+        end_of_message = false;
+    }
+    if (len == 0) {
+        return;
+    }
+
+    if (USB_LL_tmc_transmit(USBTMC_BUS, span, len, end_of_message)) {
+        g_tmc.in_requested = 0;
+        g_tmc.in_flight = len;
+    }
+}
+
+/**
+ * @brief Forget all transfers and buffered data
+ */
+static void tmc_reset(bool input, bool output)
+{
+    if (input) {
+        circular_buffer_reset(g_tmc.rx_buffer);
+        g_tmc.rx_last = '\n';
+    }
+
+    if (output) {
+        circular_buffer_reset(g_tmc.tx_buffer);
+        g_tmc.in_requested = 0;
+        g_tmc.in_flight = 0;
+        g_tmc.tx_message_bytes = 0;
+        g_tmc.discard_output = g_tmc.response_open;
+    }
+}
+
+static void tmc_message_data(
+    USB_Bus const interface_id,
+    uint8_t const *data,
+    uint32_t len,
+    bool end_of_message
+)
+{
+    (void)interface_id;
+
+    uint32_t const written = circular_buffer_write(g_tmc.rx_buffer, data, len);
+    if (written < len) {
+        LOG_WARN(
+            "USBTMC: RX overflow, %u bytes lost", (unsigned)(len - written)
+        );
+    }
+    if (len > 0) {
+        g_tmc.rx_last = data[len - 1];
+    }
+
+    if (end_of_message && g_tmc.rx_last != '\n') {
+        circular_buffer_put(g_tmc.rx_buffer, '\n');
+        g_tmc.rx_last = '\n';
+    }
+
+    tmc_start_read();
+}
+
+static void tmc_bulk_in_request(USB_Bus const interface_id, uint32_t max_size)
+{
+    (void)interface_id;
+    g_tmc.in_requested = max_size;
+    tmc_send_response();
+}
+
+static void tmc_bulk_in_complete(USB_Bus const interface_id)
+{
+    (void)interface_id;
+
+    circular_buffer_consume(g_tmc.tx_buffer, g_tmc.in_flight);
+    g_tmc.tx_message_bytes = g_tmc.tx_message_bytes > g_tmc.in_flight
+                                 ? g_tmc.tx_message_bytes - g_tmc.in_flight
+                                 : 0;
+    g_tmc.in_flight = 0;
+
+    // The host sends its next request on the OUT endpoint
+    tmc_start_read();
+}
+
+static void tmc_clear(USB_Bus const interface_id, bool input, bool output)
+{
+    (void)interface_id;
+    tmc_reset(input, output);
+}
+
+static uint8_t tmc_status_byte(USB_Bus const interface_id)
+{
+    (void)interface_id;
+
+    uint8_t status = g_tmc.status_callback ? g_tmc.status_callback() : 0;
+    if (!circular_buffer_is_empty(g_tmc.tx_buffer)) {
+        status |= USBTMC_STB_MAV;
+    }
+    return status;
+}
+
+static USB_LL_TmcCallbacks const g_TMC_CALLBACKS = {
+    .message_data = tmc_message_data,
+    .bulk_in_request = tmc_bulk_in_request,
+    .bulk_in_complete = tmc_bulk_in_complete,
+    .clear = tmc_clear,
+    .status_byte = tmc_status_byte,
+};
+
+void USBTMC_init(
+    CircularBuffer *rx_buffer,
+    CircularBuffer *tx_buffer,
+    USBTMC_StatusCallback status_callback
+)
+{
+    if (rx_buffer == nullptr || tx_buffer == nullptr ||
+        rx_buffer->size < 2 * USBTMC_RX_RESERVE) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    if (g_tmc.initialized) {
+        THROW(ERROR_RESOURCE_BUSY);
+    }
+
+    g_tmc = (TmcState){
+        .rx_buffer = rx_buffer,
+        .tx_buffer = tx_buffer,
+        .status_callback = status_callback,
+        .rx_last = '\n',
+        .mounted = USB_LL_mounted(),
+        .initialized = true,
+    };
+    circular_buffer_reset(rx_buffer);
+    circular_buffer_reset(tx_buffer);
+
+    USB_LL_tmc_set_callbacks(USBTMC_BUS, &g_TMC_CALLBACKS);
+    tmc_start_read();
+}
+
+void USBTMC_deinit(void)
+{
+    if (!g_tmc.initialized) {
+        return;
+    }
+
+    USB_LL_tmc_set_callbacks(USBTMC_BUS, nullptr);
+    g_tmc = (TmcState){ 0 };
+}
+
+void USBTMC_task(void)
+{
+    if (!g_tmc.initialized) {
+        return;
+    }
+
+    bool const mounted = USB_LL_mounted();
+    if (mounted != g_tmc.mounted) {
+        // A bus reset ends all transfers without completion callbacks
+        g_tmc.mounted = mounted;
+        tmc_reset(true, true);
+        g_tmc.srq_pending = false;
+    }
+
+    if (!mounted) {
+        return;
+    }
+
+    tmc_start_read();
+    tmc_send_response();
+
+    if (g_tmc.srq_pending &&
+        USB_LL_tmc_notify_srq(USBTMC_BUS, g_tmc.srq_status)) {
+        g_tmc.srq_pending = false;
+    }
+}
+
+uint32_t USBTMC_rx_available(void)
+{
+    if (!g_tmc.initialized) {
+        return 0;
+    }
+
+    return circular_buffer_available(g_tmc.rx_buffer);
+}
+
+uint32_t USBTMC_read(uint8_t *buf, uint32_t size)
+{
+    if (!g_tmc.initialized || buf == nullptr) {
+        return 0;
+    }
+
+    return circular_buffer_read(g_tmc.rx_buffer, buf, size);
+}
+
+void USBTMC_write_all(uint8_t const *buf, uint32_t size, uint32_t timeout)
+{
+    if (buf == nullptr && size > 0) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    if (!g_tmc.initialized) {
+        THROW(ERROR_DEVICE_NOT_READY);
+    }
+
+    if (g_tmc.discard_output) {
+        // The host has cleared this response
+        return;
+    }
+
+    g_tmc.response_open = true;
+
+    uint32_t written = 0;
+    uint32_t last_progress = PLATFORM_get_tick();
+
+    while (written < size) {
+        if (!USB_LL_mounted()) {
+            THROW(ERROR_DEVICE_NOT_READY);
+        }
+
+        uint32_t const chunk = circular_buffer_write(
+            g_tmc.tx_buffer, buf + written, size - written
+        );
+        written += chunk;
+
+        if (chunk > 0) {
+            last_progress = PLATFORM_get_tick();
+        } else if (timeout &&
+                   (PLATFORM_get_tick() - last_progress) > timeout) {
+            THROW(ERROR_TIMEOUT);
+        }
+
+        if (written < size) {
+            // Send what fits while the host asks for more
+            USB_LL_task(USBTMC_BUS);
+            USBTMC_task();
+            if (g_tmc.discard_output) {
+                return;
+            }
+        }
+    }
+}
+
+void USBTMC_end_message(void)
+{
+    if (!g_tmc.initialized) {
+        return;
+    }
+
+    if (!g_tmc.discard_output) {
+        g_tmc.tx_message_bytes = circular_buffer_available(g_tmc.tx_buffer);
+    }
+    g_tmc.response_open = false;
+    g_tmc.discard_output = false;
+
+    tmc_send_response();
+}
+
+void USBTMC_request_service(uint8_t status_byte)
+{
+    if (!g_tmc.initialized) {
+        return;
+    }
+
+    if (!circular_buffer_is_empty(g_tmc.tx_buffer)) {
+        status_byte |= USBTMC_STB_MAV;
+    }
+
+    if (!USB_LL_tmc_notify_srq(USBTMC_BUS, status_byte)) {
+        g_tmc.srq_status = status_byte;
+        g_tmc.srq_pending = true;
+    }
+}
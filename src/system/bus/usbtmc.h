@@ -0,0 +1,142 @@
+/**
+ * @file usbtmc.h
+ * @brief SCPI transport over the USBTMC/USB488 interface
+ *
+ * Test and measurement software talks to instruments through VISA, which
+ * speaks USBTMC natively. This module carries SCPI messages over the USBTMC
+ * interface of the device, next to the CDC virtual serial port:
+ *
+ * - Host messages are written into an RX circular buffer. A newline is
+ *   appended to messages that do not end with one, so that the SCPI parser
+ *   sees every message end.
+ * - Responses are written into a TX circular buffer and sent when the host
+ *   asks for them. The last transfer of a response, as marked by
+ *   USBTMC_end_message, carries the USBTMC end-of-message (EOM) flag.
+ *   Responses longer than the TX buffer, such as large binary blocks, are
+ *   sent in several transfers without EOM while they are being written.
+ * - The host reads the IEEE 488.2 status byte with the USB488
+ *   READ_STATUS_BYTE request, and is notified of service requests on the
+ *   interrupt IN endpoint. The MAV bit is set while a response is queued.
+ * - A device clear from the host empties both buffers.
+ *
+ * The module has a single instance, as the device has a single USBTMC
+ * interface. Buffers are only accessed from USB_LL_task, which runs in thread
+ * context, so no locking is needed.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef PSLAB_USBTMC_H
+#define PSLAB_USBTMC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "util/util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    USBTMC_STB_MAV = 0x10, /**< Message available bit of the status byte */
+};
+
+/**
+ * @brief Status byte callback
+ *
+ * @return IEEE 488.2 status byte, without the MAV bit
+ */
+typedef uint8_t (*USBTMC_StatusCallback)(void);
+
+/**
+ * @brief Initialize the USBTMC transport
+ *
+ * @param rx_buffer Pre-allocated buffer for host messages, at least two
+ *                  packets long
+ * @param tx_buffer Pre-allocated buffer for responses
+ * @param status_callback Provides the status byte, may be nullptr
+ *
+ * @throws ERROR_INVALID_ARGUMENT if a buffer is nullptr or too small
+ * @throws ERROR_RESOURCE_BUSY if already initialized
+ */
+void USBTMC_init(
+    CircularBuffer *rx_buffer,
+    CircularBuffer *tx_buffer,
+    USBTMC_StatusCallback status_callback
+);
+
+/**
+ * @brief Deinitialize the USBTMC transport
+ *
+ * The USBTMC interface stays visible to the host, but ignores messages.
+ */
+void USBTMC_deinit(void);
+
+/**
+ * @brief Service the USBTMC transport
+ *
+ * Resumes reception once buffer space is available, sends queued responses
+ * and retries a service request that could not be sent. Call after stepping
+ * the USB stack.
+ */
+void USBTMC_task(void);
+
+/**
+ * @brief Get number of message bytes available for reading
+ *
+ * @return Number of bytes in the RX buffer
+ */
+uint32_t USBTMC_rx_available(void);
+
+/**
+ * @brief Read message bytes
+ *
+ * @param buf Buffer to store the bytes
+ * @param size Maximum number of bytes to read
+ * @return Number of bytes read
+ */
+uint32_t USBTMC_read(uint8_t *buf, uint32_t size);
+
+/**
+ * @brief Write response bytes, waiting for the host to read them
+ *
+ * Keeps stepping the USB stack while the TX buffer is full. Responses longer
+ * than the buffer are sent in parts as the host asks for them.
+ *
+ * Must not be called from interrupt context.
+ *
+ * @param buf Bytes to write
+ * @param size Number of bytes
+ * @param timeout Maximum time in ms without progress, 0 to wait forever
+ *
+ * @throws ERROR_INVALID_ARGUMENT if buf is nullptr and size is not 0
+ * @throws ERROR_DEVICE_NOT_READY if not initialized, or if the device is or
+ *         becomes unconfigured
+ * @throws ERROR_TIMEOUT if the host stops reading for longer than timeout
+ */
+void USBTMC_write_all(uint8_t const *buf, uint32_t size, uint32_t timeout);
+
+/**
+ * @brief Mark the end of the response being written
+ *
+ * The transfer that ends with the last byte written so far carries EOM.
+ */
+void USBTMC_end_message(void);
+
+/**
+ * @brief Send a USB488 service request to the host
+ *
+ * If the interrupt endpoint is busy, the request is sent by a later call to
+ * USBTMC_task.
+ *
+ * @param status_byte IEEE 488.2 status byte, without the MAV bit
+ */
+void USBTMC_request_service(uint8_t status_byte);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSLAB_USBTMC_H
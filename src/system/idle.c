@@ -0,0 +1,114 @@
+/**
+ * @file idle.c
+ * @brief Sleep-on-idle policy for the PSLab Mini firmware.
+ *
+ * When the scheduler has nothing to run, the CPU sleeps until the next
+ * interrupt instead of polling. Interrupts are masked while the scheduler is
+ * asked once more whether a task is ready, so an interrupt that signals a
+ * task right before the sleep still wakes the CPU at once. The wake-up is
+ * reported to the scheduler, which measures the time until the next task
+ * starts.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform/cycle_ll.h"
+#include "platform/power_ll.h"
+#include "util/perf.h"
+
+#include "scheduler.h"
+#include "system.h"
+
+enum {
+    // Do not sleep when the next release is closer than this
+    IDLE_MIN_SLEEP_US = 20,
+};
+
+static POWER_LL_WakeSource const g_WAKE_MAPPING[SYSTEM_WAKE_COUNT] = {
+    [SYSTEM_WAKE_USB] = POWER_LL_WAKE_USB,
+    [SYSTEM_WAKE_DMA] = POWER_LL_WAKE_DMA,
+    [SYSTEM_WAKE_UART] = POWER_LL_WAKE_UART,
+    [SYSTEM_WAKE_TIMER] = POWER_LL_WAKE_TIMER,
+    [SYSTEM_WAKE_OTHER] = POWER_LL_WAKE_OTHER,
+};
+
+static SCHED_Task *g_wake_tasks[SYSTEM_WAKE_COUNT] = { nullptr };
+static SYSTEM_IdleStats g_idle_stats = { 0 };
+static uint64_t g_sleep_cycles = 0;
+
+void SYSTEM_idle(uint64_t next_release_us)
+{
+    uint64_t now = SYSTEM_get_time_us();
+    if (next_release_us != UINT64_MAX &&
+        next_release_us < now + IDLE_MIN_SLEEP_US) {
+        return;
+    }
+
+    uint32_t state = CYCLE_LL_enter_critical();
+
+    if (SCHED_has_ready_task()) {
+        // An interrupt signalled a task after the scheduler decided to idle
+        CYCLE_LL_exit_critical(state);
+        return;
+    }
+
+    uint64_t sleep_start = SYSTEM_get_cycles();
+    uint32_t sources = POWER_LL_sleep();
+    uint64_t wake = SYSTEM_get_cycles();
+
+    // Pending interrupt handlers run here
+    CYCLE_LL_exit_critical(state);
+
+    g_idle_stats.sleep_count++;
+    g_sleep_cycles += wake - sleep_start;
+    PERF_record(PERF_SOURCE_IDLE, (uint32_t)(wake - sleep_start));
+
+    for (size_t i = 0; i < SYSTEM_WAKE_COUNT; i++) {
+        if ((sources & (1U << g_WAKE_MAPPING[i])) == 0) {
+            continue;
+        }
+        g_idle_stats.wake_count[i]++;
+        if (g_wake_tasks[i] != nullptr) {
+            SCHED_signal(g_wake_tasks[i]);
+        }
+    }
+
+    SCHED_notify_wake(SYSTEM_cycles_to_us(wake));
+}
+
+void SYSTEM_set_wake_task(SYSTEM_WakeSource source, SCHED_Task *task)
+{
+    if (source >= SYSTEM_WAKE_COUNT) {
+        return;
+    }
+    g_wake_tasks[source] = task;
+}
+
+SYSTEM_IdleStats SYSTEM_get_idle_stats(void)
+{
+    SYSTEM_IdleStats stats = g_idle_stats;
+    SCHED_WakeStats wake_stats = SCHED_get_wake_stats();
+
+    stats.serviced_count = wake_stats.serviced_count;
+    stats.max_latency_us = wake_stats.max_latency_us;
+    if (wake_stats.serviced_count > 0) {
+        stats.avg_latency_us = (uint32_t)(
+            wake_stats.total_latency_us / wake_stats.serviced_count
+        );
+    }
+    stats.sleep_time_us = SYSTEM_cycles_to_us(g_sleep_cycles);
+
+    return stats;
+}
+
+void SYSTEM_reset_idle_stats(void)
+{
+    g_idle_stats = (SYSTEM_IdleStats){ 0 };
+    g_sleep_cycles = 0;
+    SCHED_reset_stats();
+}
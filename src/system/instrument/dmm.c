@@ -2,9 +2,11 @@
  * @file dmm.c
  * @brief Digital Multimeter implementation for PSLab firmware
  *
- * This file implements a simple digital multimeter using the ADC_LL API
- * in single sample mode. It provides voltage measurement functionality with
- * proper error handling and logging.
+ * This file implements a simple digital multimeter using ADC_LL injected
+ * conversions. Injected conversions preempt the regular sequence, so
+ * readings can be taken while an oscilloscope acquisition is running. It
+ * provides voltage measurement functionality with proper error handling and
+ * logging.
  *
  * @author PSLab Team
  * @date 2025-07-18
@@ -15,7 +17,6 @@
 #include <stdlib.h>
 
 #include "platform/adc_ll.h"
-#include "platform/tim_ll.h"
 #include "util/error.h"
 #include "util/fixed_point.h"
 #include "util/logging.h"
@@ -28,7 +29,8 @@
  */
 struct DMM_Handle {
     DMM_Config config;
-    uint16_t adc_value; // Single value buffer for single sample mode
+    uint16_t volatile adc_value; // Most recent injected conversion result
+    uint32_t full_scale; // Raw value corresponding to the reference voltage
     bool volatile conversion_complete;
     bool initialized;
 };
@@ -82,21 +84,40 @@ static ADC_LL_Channel dmm_channel_to_adc_ll(DMM_Channel channel)
 }
 
 /**
- * @brief ADC completion callback.
+ * @brief ADC injected conversion completion callback.
  *
- * Called when an ADC conversion is complete.
+ * Called when an oversampled injected conversion is complete.
  */
-// NOLINTNEXTLINE(readability-non-const-parameter)
-void dmm_adc_complete_callback(uint16_t *buffer, uint32_t total_samples)
+void dmm_adc_complete_callback(uint16_t value)
 {
-    (void)buffer;
-    (void)total_samples;
-
     if (g_dmm_handle != nullptr) {
+        g_dmm_handle->adc_value = value;
         g_dmm_handle->conversion_complete = true;
     }
 }
 
+/**
+ * @brief Get the full-scale raw ADC value for a DMM configuration
+ *
+ * In normal mode the oversampler shifts out all extra bits, so readings stay
+ * 12-bit. In high-resolution mode each doubling of the oversampling ratio
+ * adds one bit, up to the maximum oversampled resolution.
+ */
+static uint32_t dmm_get_full_scale(DMM_Config const *config)
+{
+    uint32_t bits = ADC_LL_NATIVE_RESOLUTION_BITS;
+
+    if (config->high_resolution) {
+        for (uint32_t ratio = config->oversampling_ratio;
+             ratio > 1 && bits < ADC_LL_MAX_OVERSAMPLED_RESOLUTION_BITS;
+             ratio >>= 1) {
+            bits++;
+        }
+    }
+
+    return (1U << bits) - 1U;
+}
+
 /**
  * @brief Allocate and initialize DMM handle
  */
@@ -120,31 +141,30 @@ static DMM_Handle *dmm_create_handle(DMM_Config const *config)
     // Initialize handle
     handle->config = *config;
     handle->adc_value = 0;
+    handle->full_scale = dmm_get_full_scale(config);
     handle->conversion_complete = false;
     handle->initialized = true;
     g_dmm_handle = handle;
 
     LOG_INFO(
-        "DMM: Init channel %d, oversampling %u",
+        "DMM: Init channel %d, oversampling %u, full scale %u",
         config->channel,
-        config->oversampling_ratio
+        config->oversampling_ratio,
+        handle->full_scale
     );
 
     return handle;
 }
 
 /**
- * @brief Create ADC configuration for DMM
+ * @brief Create ADC injected configuration for DMM
  */
-static ADC_LL_Config dmm_create_adc_config(DMM_Handle *handle)
+static ADC_LL_InjectedConfig dmm_create_adc_config(DMM_Handle *handle)
 {
-    ADC_LL_Config adc_config = {
-        .channels = { dmm_channel_to_adc_ll(handle->config.channel) },
-        .mode = ADC_LL_MODE_SINGLE,
-        .trigger_source = ADC_TRIGGER_TIMER6,
-        .output_buffer = &handle->adc_value,
-        .buffer_size = 1, // Single sample
-        .oversampling_ratio = handle->config.oversampling_ratio
+    ADC_LL_InjectedConfig adc_config = {
+        .channel = dmm_channel_to_adc_ll(handle->config.channel),
+        .oversampling_ratio = handle->config.oversampling_ratio,
+        .high_resolution = handle->config.high_resolution
     };
     return adc_config;
 }
@@ -157,15 +177,15 @@ static void dmm_init_adc(DMM_Handle *handle)
     LOG_FUNCTION_ENTRY();
 
     LOG_DEBUG("DMM: Configuring ADC");
-    // Initialize ADC with the configured channel
-    ADC_LL_Config adc_config = dmm_create_adc_config(handle);
+    // Initialize injected conversions on the configured channel
+    ADC_LL_InjectedConfig adc_config = dmm_create_adc_config(handle);
 
     LOG_DEBUG("DMM: Initializing ADC");
     Error error = ERROR_NONE;
     TRY
     {
-        LOG_DEBUG("DMM: ADC_LL_init called");
-        ADC_LL_init(&adc_config);
+        LOG_DEBUG("DMM: ADC_LL_injected_init called");
+        ADC_LL_injected_init(&adc_config);
         LOG_DEBUG("DMM: ADC initialized");
     }
     CATCH(error)
@@ -177,49 +197,22 @@ static void dmm_init_adc(DMM_Handle *handle)
     }
 
     // Set up ADC callback
-    ADC_LL_set_complete_callback(dmm_adc_complete_callback);
-
-    LOG_FUNCTION_EXIT();
-}
-
-/**
- * @brief Initialize timer for ADC triggering
- */
-static void dmm_init_timer(DMM_Handle *handle)
-{
-    LOG_FUNCTION_ENTRY();
+    ADC_LL_set_injected_complete_callback(dmm_adc_complete_callback);
 
-    Error error = ERROR_NONE;
-    TRY { TIM_LL_init(TIM_NUM_6, ADC_LL_get_sample_rate()); }
-    CATCH(error)
-    {
-        LOG_ERROR("DMM: Timer init failed, error %d", error);
-        ADC_LL_deinit();
-        g_dmm_handle = nullptr;
-        free(handle);
-        THROW(error);
-    }
-    LOG_DEBUG("DMM: Timer init, freq %u Hz", ADC_LL_get_sample_rate());
     LOG_FUNCTION_EXIT();
 }
 
 /**
- * @brief Start ADC and timer for continuous operation
+ * @brief Start the first injected conversion
  */
 static void dmm_start_conversion(DMM_Handle *handle)
 {
     Error error = ERROR_NONE;
-    TRY
-    {
-        TIM_LL_start(TIM_NUM_6); // Start timer for ADC triggering
-        ADC_LL_start();
-    }
+    TRY { ADC_LL_injected_start(); }
     CATCH(error)
     {
         LOG_ERROR("DMM: Failed to start conversion, error %d", error);
-        TIM_LL_stop(TIM_NUM_6);
-        ADC_LL_deinit();
-        TIM_LL_deinit(TIM_NUM_6);
+        ADC_LL_injected_deinit();
         g_dmm_handle = nullptr;
         free(handle);
         THROW(error);
@@ -263,7 +256,6 @@ DMM_Handle *DMM_init(DMM_Config const *config)
 
     DMM_Handle *handle = dmm_create_handle(config);
     dmm_init_adc(handle);
-    dmm_init_timer(handle);
     dmm_start_conversion(handle);
 
     LOG_INFO("DMM: Ready, conversion started");
@@ -288,13 +280,8 @@ void DMM_deinit(DMM_Handle *handle)
 
     LOG_INFO("DMM: Deinitializing");
 
-    // Stop ADC and timer
-    ADC_LL_stop();
-    TIM_LL_stop(TIM_NUM_6);
-
-    // Deinitialize peripherals
-    ADC_LL_deinit();
-    TIM_LL_deinit(TIM_NUM_6);
+    // Stop injected conversions, leaving any regular acquisition running
+    ADC_LL_injected_deinit();
 
     // Clear global handle
     g_dmm_handle = nullptr;
@@ -330,14 +317,13 @@ bool DMM_read_voltage(DMM_Handle *handle, FIXED_Q1616 *voltage_out)
 
     if (conversion_ready) {
         // Get reference voltage from ADC driver
-        uint32_t ref_voltage_mv = ADC_LL_get_reference_voltage();
+        uint32_t ref_voltage_mv = ADC_LL_get_reference_voltage(nullptr);
         FIXED_Q1616 reference_voltage =
             FIXED_from_fraction((int32_t)ref_voltage_mv, SI_MILLI_DIV);
 
         // Convert raw ADC value to voltage using fixed-point arithmetic
-        // ADC is 12-bit with oversampling and 4-bit right shift,
-        // so max value is back to 12-bit range (4095)
-        uint32_t max_value = 4095U;
+        // Full scale is 12-bit, or up to 16-bit in high-resolution mode
+        uint32_t max_value = handle->full_scale;
 
         // voltage = (raw_value * reference_voltage) / max_value
         *voltage_out = FIXED_div(
@@ -355,14 +341,13 @@ bool DMM_read_voltage(DMM_Handle *handle, FIXED_Q1616 *voltage_out)
             max_value
         );
 
-        // Reset flag and restart ADC for next conversion
-        // Timer remains running continuously
+        // Reset flag and start the next injected conversion
         handle->conversion_complete = false;
 
         Error error = ERROR_NONE;
         TRY
         {
-            ADC_LL_start(); // Restart ADC/DMA for next conversion
+            ADC_LL_injected_start(); // Start next conversion
         }
         CATCH(error)
         {
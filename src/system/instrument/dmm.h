@@ -3,8 +3,9 @@
  * @brief Digital Multimeter interface for PSLab firmware
  *
  * This header provides a simple digital multimeter implementation using
- * the ADC_LL API in single sample mode. It allows reading voltage values from
- * ADC channels with proper error handling and logging.
+ * ADC_LL injected conversions. It allows reading voltage values from ADC
+ * channels with proper error handling and logging, including while an
+ * oscilloscope acquisition is running.
  *
  * @author PSLab Team
  * @date 2025-07-18
@@ -13,6 +14,7 @@
 #ifndef PSLAB_DMM_H
 #define PSLAB_DMM_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "util/fixed_point.h"
@@ -58,6 +60,7 @@ typedef struct {
     DMM_Channel channel; // ADC channel to use for measurements
     uint32_t oversampling_ratio; // Oversampling ratio (1, 2, 4, 8, 16, 32, 64,
                                  // 128, 256)
+    bool high_resolution; // Keep oversampling gain (up to 16-bit readings)
 } DMM_Config;
 
 /**
@@ -66,14 +69,16 @@ typedef struct {
 #define DMM_CONFIG_DEFAULT                                                     \
     {                                                                          \
         .channel = DMM_CHANNEL_0, .oversampling_ratio = 16,                    \
+        .high_resolution = false,                                              \
     }
 
 /**
  * @brief Initialize the Digital Multimeter
  *
  * This function initializes the DMM subsystem with the given configuration.
- * It sets up the ADC in single sample mode for continuous voltage measurements
- * and starts the first conversion.
+ * It sets up an injected ADC conversion for voltage measurements and starts
+ * the first conversion. No trigger timer is used, so the DMM can run
+ * alongside the DSO.
  *
  * @param config Pointer to DMM configuration structure
  * @return Pointer to DMM handle on success, NULL on failure
@@ -4,7 +4,9 @@
  *
  * This file implements a digital storage oscilloscope using the ADC_LL API
  * in continuous sampling mode, supporting both single-channel and dual-channel
- * modes for high-speed data acquisition.
+ * modes for high-speed data acquisition. The trigger timer is taken from the
+ * arbiter's pool for the lifetime of the handle, and the ADC is obtained from
+ * the arbiter for the duration of each acquisition.
  *
  * @author PSLab Team
  * @date 2025-09-29
@@ -19,6 +21,7 @@
 #include "util/error.h"
 #include "util/logging.h"
 
+#include "adc_arbiter.h"
 #include "dso.h"
 
 /**
@@ -26,7 +29,9 @@
  */
 struct DSO_Handle {
     DSO_Config config;
-    bool running;
+    ADC_ARB_Trigger trigger;
+    ADC_ARB_Session *session;
+    bool volatile running;
 };
 
 // Static instance for callback context
@@ -67,6 +72,53 @@ static ADC_LL_Mode dso_mode_to_adc_ll(DSO_Mode mode)
     }
 }
 
+/**
+ * @brief Convert DSO resolution to ADC_LL_Resolution
+ *
+ * @param resolution DSO resolution.
+ * @return Corresponding ADC_LL_Resolution.
+ */
+static ADC_LL_Resolution dso_resolution_to_adc_ll(DSO_Resolution resolution)
+{
+    switch (resolution) {
+    case DSO_RESOLUTION_10BIT:
+        return ADC_LL_RESOLUTION_10BIT;
+    case DSO_RESOLUTION_8BIT:
+        return ADC_LL_RESOLUTION_8BIT;
+    case DSO_RESOLUTION_6BIT:
+        return ADC_LL_RESOLUTION_6BIT;
+    case DSO_RESOLUTION_12BIT:
+    default:
+        return ADC_LL_RESOLUTION_12BIT;
+    }
+}
+
+/**
+ * @brief Select the ADC sampling time for a DSO configuration
+ *
+ * Picks the longest sampling time whose maximum sample rate still reaches the
+ * configured sample rate.
+ *
+ * @param config DSO configuration.
+ * @return ADC sampling time, the shortest one if none reaches the rate.
+ */
+static ADC_LL_SamplingTime dso_select_sampling_time(DSO_Config const *config)
+{
+    ADC_LL_Mode adc_mode = dso_mode_to_adc_ll(config->mode);
+    ADC_LL_Resolution resolution = dso_resolution_to_adc_ll(config->resolution);
+
+    for (ADC_LL_SamplingTime sampling_time = ADC_LL_SAMPLING_TIME_640CYCLES_5;
+         sampling_time > ADC_LL_SAMPLING_TIME_2CYCLES_5;
+         sampling_time--) {
+        if (ADC_LL_get_max_sample_rate(adc_mode, resolution, sampling_time) >=
+            config->sample_rate) {
+            return sampling_time;
+        }
+    }
+
+    return ADC_LL_SAMPLING_TIME_2CYCLES_5;
+}
+
 /**
  * @brief ADC completion callback for DSO
  *
@@ -78,14 +130,40 @@ static void dso_adc_complete_callback(uint16_t *buffer, uint32_t total_samples)
     (void)buffer;
     (void)total_samples;
 
-    if (g_dso_handle != nullptr &&
-        g_dso_handle->config.complete_callback != nullptr) {
-        g_dso_handle->running = false;
-        TIM_LL_stop(TIM_NUM_6);
+    if (g_dso_handle == nullptr) {
+        return;
+    }
+
+    // The session stays with the handle until DSO_start, DSO_stop or
+    // DSO_deinit gives it back, so only the running flag changes here
+    g_dso_handle->running = false;
+    TIM_LL_stop(g_dso_handle->trigger.timer);
+
+    if (g_dso_handle->config.complete_callback != nullptr) {
         g_dso_handle->config.complete_callback();
     }
 }
 
+/**
+ * @brief Arbiter grant callback for DSO
+ *
+ * Called when the ADC is granted to the DSO session, with ADC and timer
+ * already configured. Acquisition restarts from the beginning of the buffer
+ * every time the session is granted.
+ */
+static void dso_session_grant_callback(void *context)
+{
+    DSO_Handle const *handle = context;
+
+    // Start ADC conversion first (DMA ready but not triggered)
+    ADC_LL_start();
+
+    // Start timer to trigger ADC (must be after ADC is ready)
+    TIM_LL_start(handle->trigger.timer);
+
+    LOG_DEBUG("DSO: Session granted, acquisition running");
+}
+
 /**
  * @brief Validate DSO configuration
  */
@@ -123,9 +201,17 @@ static bool dso_validate_config(DSO_Config const *config)
         }
     }
 
+    if (config->resolution != DSO_RESOLUTION_12BIT &&
+        config->resolution != DSO_RESOLUTION_10BIT &&
+        config->resolution != DSO_RESOLUTION_8BIT &&
+        config->resolution != DSO_RESOLUTION_6BIT) {
+        LOG_ERROR("DSO: Invalid resolution: %d", config->resolution);
+        return false;
+    }
+
     // Validate sample rate (basic range check)
     uint32_t max_sample_rate =
-        ADC_LL_get_max_sample_rate(dso_mode_to_adc_ll(config->mode));
+        DSO_get_max_sample_rate(config->mode, config->resolution);
     if (config->sample_rate == 0 || config->sample_rate > max_sample_rate) {
         LOG_ERROR("DSO: Invalid sample rate: %u", config->sample_rate);
         return false;
@@ -139,7 +225,9 @@ static bool dso_validate_config(DSO_Config const *config)
  */
 static ADC_LL_Config dso_create_adc_config(DSO_Handle *handle)
 {
-    ADC_LL_Config adc_config = { .trigger_source = ADC_TRIGGER_TIMER6 };
+    ADC_LL_Config adc_config = {
+        .trigger_source = handle->trigger.trigger_source,
+    };
 
     switch (handle->config.mode) {
     case DSO_MODE_SINGLE_CHANNEL:
@@ -163,10 +251,11 @@ static ADC_LL_Config dso_create_adc_config(DSO_Handle *handle)
         break;
     }
 
-    adc_config.trigger_source = ADC_TRIGGER_TIMER6;
     adc_config.output_buffer = handle->config.buffer;
     adc_config.buffer_size = handle->config.buffer_size;
     adc_config.oversampling_ratio = 1; // No oversampling for oscilloscope
+    adc_config.resolution = dso_resolution_to_adc_ll(handle->config.resolution);
+    adc_config.sampling_time = dso_select_sampling_time(&handle->config);
 
     return adc_config;
 }
@@ -182,10 +271,14 @@ static DSO_Handle *dso_create_handle(DSO_Config const *config)
         THROW(ERROR_RESOURCE_BUSY);
     }
 
+    // Take a trigger timer, kept until the handle is deinitialized
+    ADC_ARB_Trigger const trigger = ADC_ARB_acquire_trigger();
+
     // Allocate handle
     DSO_Handle *handle = (DSO_Handle *)malloc(sizeof(DSO_Handle));
     if (handle == nullptr) {
         LOG_ERROR("DSO: Memory allocation failed");
+        ADC_ARB_release_trigger(trigger.timer);
         THROW(ERROR_OUT_OF_MEMORY);
     }
 
@@ -193,6 +286,8 @@ static DSO_Handle *dso_create_handle(DSO_Config const *config)
 
     // Initialize handle
     handle->config = *config;
+    handle->trigger = trigger;
+    handle->session = nullptr;
     handle->running = false;
     g_dso_handle = handle;
 
@@ -207,55 +302,60 @@ static DSO_Handle *dso_create_handle(DSO_Config const *config)
 }
 
 /**
- * @brief Initialize ADC for DSO operation
+ * @brief Give the ADC session back to the arbiter
  */
-static void dso_init_adc(DSO_Handle *handle)
+static void dso_release_session(DSO_Handle *handle)
 {
-    LOG_FUNCTION_ENTRY();
+    ADC_ARB_Session *session = handle->session;
 
-    // Set up ADC callback
-    ADC_LL_set_complete_callback(dso_adc_complete_callback);
-
-    LOG_DEBUG("DSO: Configuring ADC");
-    ADC_LL_Config adc_config = dso_create_adc_config(handle);
+    handle->session = nullptr;
+    handle->running = false;
 
-    LOG_DEBUG("DSO: Initializing ADC");
-    Error error = ERROR_NONE;
-    TRY
-    {
-        LOG_DEBUG("DSO: ADC_LL_init called");
-        ADC_LL_init(&adc_config);
-        LOG_DEBUG("DSO: ADC initialized");
+    if (session != nullptr) {
+        ADC_ARB_release(session);
     }
-    CATCH(error)
-    {
-        LOG_ERROR("DSO: ADC init failed, error %d", error);
-        g_dso_handle = nullptr;
-        free(handle);
-        THROW(error);
-    }
-    LOG_FUNCTION_EXIT();
 }
 
 /**
- * @brief Initialize timer for ADC triggering
+ * @brief Request an ADC session for the next acquisition
  */
-static void dso_init_timer(DSO_Handle *handle)
+static void dso_request_session(DSO_Handle *handle)
 {
-    LOG_FUNCTION_ENTRY();
+    // Give back the session of the previous, finished acquisition
+    dso_release_session(handle);
+
+    ADC_ARB_Request request = {
+        .adc_config = dso_create_adc_config(handle),
+        .complete_callback = dso_adc_complete_callback,
+        .timer = handle->trigger.timer,
+        .trigger_frequency = handle->config.sample_rate,
+        .priority = ADC_ARB_PRIORITY_NORMAL,
+        .slice_ms = 0, // Keep the ADC until the buffer is full
+        .on_grant = dso_session_grant_callback,
+        .on_suspend = nullptr,
+        .context = handle,
+    };
+
+    // The session may be granted, and even complete, before request returns
+    handle->running = true;
+    ADC_ARB_Session *session = nullptr;
 
     Error error = ERROR_NONE;
-    TRY { TIM_LL_init(TIM_NUM_6, handle->config.sample_rate); }
+    TRY { session = ADC_ARB_request(&request); }
     CATCH(error)
     {
-        LOG_ERROR("DSO: Timer init failed, error %d", error);
-        ADC_LL_deinit();
-        g_dso_handle = nullptr;
-        free(handle);
+        handle->running = false;
         THROW(error);
     }
-    LOG_DEBUG("DSO: Timer init, freq %u Hz", handle->config.sample_rate);
-    LOG_FUNCTION_EXIT();
+
+    if (ADC_ARB_get_state(session) == ADC_ARB_STATE_FAILED) {
+        LOG_ERROR("DSO: Failed to set up acquisition hardware");
+        ADC_ARB_release(session);
+        handle->running = false;
+        THROW(ERROR_HARDWARE_FAULT);
+    }
+
+    handle->session = session;
 }
 
 // Public API Functions
@@ -270,15 +370,10 @@ DSO_Handle *DSO_init(DSO_Config const *config)
         THROW(ERROR_INVALID_ARGUMENT);
     }
 
-    // Create and initialize handle
+    // Create and initialize handle. The ADC and timer are configured by the
+    // arbiter when an acquisition is granted.
     DSO_Handle *handle = dso_create_handle(config);
 
-    // Initialize ADC
-    dso_init_adc(handle);
-
-    // Initialize timer
-    dso_init_timer(handle);
-
     LOG_INFO("DSO: Successfully initialized");
     LOG_FUNCTION_EXIT();
     return handle;
@@ -298,27 +393,9 @@ void DSO_deinit(DSO_Handle *handle)
         THROW(ERROR_INVALID_ARGUMENT);
     }
 
-    Error error = ERROR_NONE;
-
-    TRY
-    {
-        // Stop if running
-        if (handle->running) {
-            DSO_stop(handle);
-        }
-
-        // Deinitialize hardware
-        LOG_DEBUG("DSO: Deinitializing ADC");
-        ADC_LL_deinit();
-
-        LOG_DEBUG("DSO: Deinitializing Timer");
-        TIM_LL_deinit(TIM_NUM_6);
-    }
-    CATCH(error)
-    {
-        LOG_ERROR("DSO: Deinitialization failed, error %d", error);
-        // Don't throw, continue with handle cleanup
-    }
+    // Stop if running; the arbiter deinitializes the hardware
+    dso_release_session(handle);
+    ADC_ARB_release_trigger(handle->trigger.timer);
 
     // Free memory
     LOG_DEBUG("DSO: Freeing handle at %p", (void *)handle);
@@ -349,33 +426,18 @@ void DSO_start(DSO_Handle *handle)
         return;
     }
 
-    LOG_DEBUG("DSO: Starting data acquisition");
+    LOG_DEBUG("DSO: Requesting ADC session");
 
     Error error = ERROR_NONE;
-    TRY
-    {
-        // Start ADC conversion first (DMA ready but not triggered)
-        LOG_DEBUG("DSO: Starting ADC...");
-        ADC_LL_start();
-        LOG_DEBUG("DSO: ADC started successfully");
-
-        // Start timer to trigger ADC (must be after ADC is ready)
-        LOG_DEBUG("DSO: Starting Timer...");
-        TIM_LL_start(TIM_NUM_6);
-        LOG_DEBUG("DSO: Timer started successfully");
-
-        handle->running = true;
-        LOG_INFO("DSO: Data acquisition started");
-    }
+    TRY { dso_request_session(handle); }
     CATCH(error)
     {
         LOG_ERROR("DSO: Failed to start, error %d", error);
-        // Clean up partial state
-        TIM_LL_stop(TIM_NUM_6);
-        ADC_LL_stop();
         THROW(error);
     }
 
+    LOG_INFO("DSO: Data acquisition started");
+
     LOG_FUNCTION_EXIT();
 }
 
@@ -399,11 +461,8 @@ void DSO_stop(DSO_Handle *handle)
 
     LOG_DEBUG("DSO: Stopping data acquisition");
 
-    // Stop ADC and timer
-    ADC_LL_stop();
-    TIM_LL_stop(TIM_NUM_6);
-
-    handle->running = false;
+    // Stop ADC and timer, or leave the arbiter queue
+    dso_release_session(handle);
 
     LOG_INFO("DSO: Data acquisition stopped");
     LOG_FUNCTION_EXIT();
@@ -423,9 +482,23 @@ DSO_Config DSO_get_config(DSO_Handle *handle)
         THROW(ERROR_INVALID_ARGUMENT);
     }
 
+    // Report the rate the trigger timer actually produces
+    DSO_Config config = handle->config;
+    Error error = ERROR_NONE;
+    TRY
+    {
+        config.sample_rate = TIM_LL_get_achievable_frequency(
+            handle->trigger.timer, handle->config.sample_rate
+        );
+    }
+    CATCH(error)
+    {
+        LOG_WARN("DSO: Sample rate not achievable by trigger timer");
+    }
+
     LOG_DEBUG("DSO: Returning current configuration");
     LOG_FUNCTION_EXIT();
-    return handle->config;
+    return config;
 }
 
 void DSO_set_config(DSO_Handle *handle, DSO_Config const *config)
@@ -453,43 +526,30 @@ void DSO_set_config(DSO_Handle *handle, DSO_Config const *config)
         THROW(ERROR_INVALID_ARGUMENT);
     }
 
-    LOG_DEBUG("DSO: Updating configuration");
-
-    Error error = ERROR_NONE;
-    TRY
-    {
-        // Deinitialize current hardware configuration
-        LOG_DEBUG("DSO: Deinitializing current hardware");
-        ADC_LL_deinit();
-        TIM_LL_deinit(TIM_NUM_6);
-
-        // Update configuration
-        handle->config = *config;
+    // The new configuration is applied when the next acquisition is granted
+    handle->config = *config;
 
-        // Reinitialize hardware with new configuration
-        LOG_DEBUG("DSO: Reinitializing hardware with new config");
-        dso_init_adc(handle);
-        dso_init_timer(handle);
-
-        LOG_INFO("DSO: Configuration updated successfully");
-    }
-    CATCH(error)
-    {
-        LOG_ERROR("DSO: Failed to update configuration, error %d", error);
-        THROW(error);
-    }
+    LOG_INFO("DSO: Configuration updated successfully");
 
     LOG_FUNCTION_EXIT();
 }
 
-uint32_t DSO_get_max_sample_rate(DSO_Mode mode)
+uint32_t DSO_get_max_sample_rate(DSO_Mode mode, DSO_Resolution resolution)
 {
     LOG_FUNCTION_ENTRY();
 
-    ADC_LL_Mode adc_mode = dso_mode_to_adc_ll(mode);
-    uint32_t max_rate = ADC_LL_get_max_sample_rate(adc_mode);
+    uint32_t max_rate = ADC_LL_get_max_sample_rate(
+        dso_mode_to_adc_ll(mode),
+        dso_resolution_to_adc_ll(resolution),
+        ADC_LL_SAMPLING_TIME_2CYCLES_5
+    );
 
-    LOG_DEBUG("DSO: Max sample rate for mode %d: %u Hz", mode, max_rate);
+    LOG_DEBUG(
+        "DSO: Max sample rate for mode %d, resolution %d: %u Hz",
+        mode,
+        resolution,
+        max_rate
+    );
     LOG_FUNCTION_EXIT();
 
     return max_rate;
@@ -43,6 +43,19 @@ typedef enum {
     DSO_MODE_DUAL_CHANNEL,
 } DSO_Mode;
 
+/**
+ * @brief DSO sample resolution
+ *
+ * Lower resolutions trade amplitude resolution for a higher maximum sample
+ * rate. Samples are right-aligned, so an 8-bit sample ranges from 0 to 255.
+ */
+typedef enum {
+    DSO_RESOLUTION_12BIT = 0,
+    DSO_RESOLUTION_10BIT,
+    DSO_RESOLUTION_8BIT,
+    DSO_RESOLUTION_6BIT,
+} DSO_Resolution;
+
 /**
  * @brief DSO completion callback type
  *
@@ -59,6 +72,7 @@ typedef struct {
     uint32_t sample_rate; /**< Sample rate in Hz */
     uint16_t *buffer; /**< Pointer to the buffer for storing samples */
     uint32_t buffer_size; /**< Size of the buffer */
+    DSO_Resolution resolution; /**< Sample resolution */
     DSO_CompleteCallback
         complete_callback; /**< Callback invoked on completion */
 } DSO_Config;
@@ -70,22 +84,29 @@ typedef struct {
     {                                                                          \
         .mode = DSO_MODE_SINGLE_CHANNEL, .channel = DSO_CHANNEL_0,             \
         .sample_rate = 1000000, .buffer = nullptr, .buffer_size = 256,         \
-        .complete_callback = nullptr,                                          \
+        .resolution = DSO_RESOLUTION_12BIT, .complete_callback = nullptr,      \
     }
 
 /**
  * @brief Initialize the Oscilloscope
  *
  * This function initializes the DSO subsystem with the given configuration.
- * It validates the configuration parameters and sets up the ADC for the
- * specified mode and channel.
+ * It validates the configuration parameters and takes a trigger timer from
+ * the ADC arbiter's pool. The ADC is not claimed until an acquisition is
+ * started.
+ *
+ * The ADC sampling time is chosen automatically: the DSO uses the longest
+ * sampling time that still reaches the configured sample rate at the
+ * configured resolution, to give high-impedance sources the most time to
+ * settle.
  *
  * @param config Pointer to DSO configuration structure
  * @return Pointer to DSO handle on success, NULL on failure
  *
  * @throws ERROR_INVALID_ARGUMENT if config is NULL or contains invalid values
  * @throws ERROR_OUT_OF_MEMORY if memory allocation fails
- * @throws ERROR_HARDWARE_FAULT if ADC initialization fails
+ * @throws ERROR_RESOURCE_BUSY if the DSO is already initialized, or no trigger
+ *         timer is free
  */
 DSO_Handle *DSO_init(DSO_Config const *config);
 
@@ -103,14 +124,18 @@ void DSO_deinit(DSO_Handle *handle);
 /**
  * @brief Start the Oscilloscope
  *
- * This function starts the DSO data acquisition process. It starts the timer
- * with the configured sample rate, triggering the ADC to capture data until
- * the buffer is full.
+ * This function starts the DSO data acquisition process. It requests the ADC
+ * from the ADC arbiter; if another session owns the ADC, the acquisition is
+ * queued. Once granted, the ADC and timer are configured for the current
+ * configuration and the timer triggers the ADC to capture data until the
+ * buffer is full.
  *
  * @param handle Pointer to DSO handle
  *
  * @throws ERROR_INVALID_ARGUMENT if handle is NULL
  * @throws ERROR_DEVICE_NOT_READY if DSO is not initialized
+ * @throws ERROR_OUT_OF_MEMORY if the arbiter has no free session
+ * @throws ERROR_HARDWARE_FAULT if ADC or timer initialization fails
  */
 void DSO_start(DSO_Handle *handle);
 
@@ -118,7 +143,8 @@ void DSO_start(DSO_Handle *handle);
  * @brief Stop the Oscilloscope
  *
  * This function stops the DSO data acquisition process without deinitializing
- * it. It stops the timer and the ADC, preventing any further data capture.
+ * it. It stops the timer and the ADC, preventing any further data capture, and
+ * hands the ADC back to the arbiter. A queued acquisition is cancelled.
  *
  * @param handle Pointer to DSO handle
  *
@@ -131,6 +157,9 @@ void DSO_stop(DSO_Handle *handle);
  * @brief Get current DSO configuration
  *
  * This function returns the currently applied configuration of the DSO.
+ * The sample rate is the rate the trigger timer achieves, which may differ
+ * slightly from the requested rate when the timer clock is not an integer
+ * multiple of it.
  *
  * @param handle Pointer to DSO handle
  * @return Copy of the current DSO configuration
@@ -157,20 +186,23 @@ DSO_Config DSO_get_config(DSO_Handle *handle);
 void DSO_set_config(DSO_Handle *handle, DSO_Config const *config);
 
 /**
- * @brief Get maximum sample rate for a given DSO mode
+ * @brief Get maximum sample rate for a given DSO mode and resolution
  *
  * This function returns the maximum achievable sample rate for the specified
- * DSO mode, which depends on the underlying ADC capabilities.
+ * DSO mode and resolution, which depends on the underlying ADC capabilities.
+ * The rate is reached with the shortest ADC sampling time.
  *
  * @param mode DSO mode (single or dual channel)
- * @return Maximum sample rate in Hz for the specified mode
+ * @param resolution Sample resolution
+ * @return Maximum sample rate in Hz for the specified mode and resolution
  */
-uint32_t DSO_get_max_sample_rate(DSO_Mode mode);
+uint32_t DSO_get_max_sample_rate(DSO_Mode mode, DSO_Resolution resolution);
 
 /**
  * @brief Check if DSO acquisition is in progress
  *
- * This function checks if the DSO is currently acquiring data.
+ * This function checks if the DSO is currently acquiring data or waiting for
+ * the ADC to be granted.
  *
  * @param handle Pointer to DSO handle
  * @return true if acquisition is in progress, false otherwise
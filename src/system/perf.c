@@ -0,0 +1,65 @@
+/**
+ * @file perf.c
+ * @brief CPU load and interrupt service time windows for the PSLab Mini
+ *        firmware.
+ *
+ * The samples that interrupt handlers and the idle hook record with
+ * PERF_record are collected into fixed windows. Closing a window takes all
+ * accumulators at once with interrupts masked, so the published window is
+ * consistent. The CPU load is the part of the window not spent asleep.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform/cycle_ll.h"
+#include "util/perf.h"
+
+#include "system.h"
+
+enum { PERMILLE = 1000 };
+
+static SYSTEM_PerfStats g_perf_window = { 0 };
+static uint64_t g_window_start = 0;
+
+void SYSTEM_perf_task(void)
+{
+    SYSTEM_PerfStats window = { 0 };
+
+    uint32_t state = CYCLE_LL_enter_critical();
+    uint64_t now = SYSTEM_get_cycles();
+    for (size_t i = 0; i < PERF_SOURCE_COUNT; i++) {
+        window.sources[i] = PERF_take((PERF_Source)i);
+    }
+    CYCLE_LL_exit_critical(state);
+
+    window.cycle_frequency = SYSTEM_get_cycle_frequency();
+    window.window_cycles = now - g_window_start;
+    g_window_start = now;
+
+    uint64_t idle = window.sources[PERF_SOURCE_IDLE].total_cycles;
+    if (window.window_cycles > 0 && idle <= window.window_cycles) {
+        window.load_permille = (uint32_t)(
+            PERMILLE - idle * PERMILLE / window.window_cycles
+        );
+    }
+
+    g_perf_window = window;
+}
+
+SYSTEM_PerfStats SYSTEM_get_perf_stats(void) { return g_perf_window; }
+
+void SYSTEM_reset_perf_stats(void)
+{
+    uint32_t state = CYCLE_LL_enter_critical();
+    g_window_start = SYSTEM_get_cycles();
+    for (size_t i = 0; i < PERF_SOURCE_COUNT; i++) {
+        (void)PERF_take((PERF_Source)i);
+    }
+    CYCLE_LL_exit_critical(state);
+
+    g_perf_window = (SYSTEM_PerfStats){ 0 };
+}
@@ -0,0 +1,312 @@
+/**
+ * @file scheduler.c
+ * @brief Cooperative task scheduler implementation for PSLab firmware
+ *
+ * Tasks are kept in a fixed pool. Each task tracks the time of its next
+ * periodic release and, separately, whether it has been signalled and when.
+ * The earlier of the two is the time the task became ready, which orders
+ * tasks of equal priority and is the start of its latency measurement.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform/cycle_ll.h"
+#include "util/error.h"
+#include "util/logging.h"
+
+#include "scheduler.h"
+#include "system.h"
+
+/**
+ * @brief Task structure
+ */
+struct SCHED_Task {
+    SCHED_TaskConfig config;
+    SCHED_TaskStats stats;
+    uint64_t next_release_us; // Next periodic release
+    uint64_t volatile signalled_at_us; // Time of the first pending signal
+    bool volatile signalled;
+    bool in_use;
+};
+
+// Task pool
+static SCHED_Task g_tasks[SCHED_MAX_TASKS] = { 0 };
+
+// Called when no task is ready
+static SCHED_IdleHook g_idle_hook = nullptr;
+
+// Wake-up latency bookkeeping
+static SCHED_WakeStats g_wake_stats = { 0 };
+static uint64_t g_wake_us = 0;
+static bool g_wake_pending = false;
+
+/**
+ * @brief Get the time a task became ready
+ *
+ * @param task Pointer to task
+ * @param now Current time in us
+ * @param ready_at Set to the time the task became ready
+ * @return true if the task is ready
+ */
+static bool sched_get_ready_time(
+    SCHED_Task const *task,
+    uint64_t now,
+    uint64_t *ready_at
+)
+{
+    bool ready = false;
+    uint64_t earliest = UINT64_MAX;
+
+    if (task->config.period_us > 0 && task->next_release_us <= now) {
+        ready = true;
+        earliest = task->next_release_us;
+    }
+
+    uint32_t state = CYCLE_LL_enter_critical();
+    if (task->signalled) {
+        ready = true;
+        if (task->signalled_at_us < earliest) {
+            earliest = task->signalled_at_us;
+        }
+    }
+    CYCLE_LL_exit_critical(state);
+
+    *ready_at = earliest;
+    return ready;
+}
+
+/**
+ * @brief Pick the ready task to run next
+ *
+ * @param now Current time in us
+ * @param ready_at Set to the time the picked task became ready
+ * @return Pointer to task, or nullptr if no task is ready
+ */
+static SCHED_Task *sched_pick_task(uint64_t now, uint64_t *ready_at)
+{
+    SCHED_Task *best = nullptr;
+    uint64_t best_ready_at = UINT64_MAX;
+
+    for (size_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        SCHED_Task *task = &g_tasks[i];
+        uint64_t task_ready_at = 0;
+
+        if (!task->in_use || !sched_get_ready_time(task, now, &task_ready_at)) {
+            continue;
+        }
+
+        if (best == nullptr ||
+            task->config.priority > best->config.priority ||
+            (task->config.priority == best->config.priority &&
+             task_ready_at < best_ready_at)) {
+            best = task;
+            best_ready_at = task_ready_at;
+        }
+    }
+
+    *ready_at = best_ready_at;
+    return best;
+}
+
+/**
+ * @brief Get the earliest periodic release among all tasks
+ */
+static uint64_t sched_get_next_release(void)
+{
+    uint64_t next = UINT64_MAX;
+
+    for (size_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        SCHED_Task const *task = &g_tasks[i];
+        if (task->in_use && task->config.period_us > 0 &&
+            task->next_release_us < next) {
+            next = task->next_release_us;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief Saturate a 64-bit duration to 32 bits
+ */
+static uint32_t sched_clamp_us(uint64_t us)
+{
+    return us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+}
+
+/**
+ * @brief Run a ready task and update its statistics
+ */
+static void sched_run_task(SCHED_Task *task, uint64_t ready_at)
+{
+    uint32_t state = CYCLE_LL_enter_critical();
+    task->signalled = false;
+    CYCLE_LL_exit_critical(state);
+
+    uint64_t start = SYSTEM_get_time_us();
+    uint64_t latency = start - ready_at;
+
+    if (g_wake_pending) {
+        uint64_t wake_latency = start - g_wake_us;
+        g_wake_pending = false;
+        g_wake_stats.serviced_count++;
+        g_wake_stats.total_latency_us += wake_latency;
+        if (sched_clamp_us(wake_latency) > g_wake_stats.max_latency_us) {
+            g_wake_stats.max_latency_us = sched_clamp_us(wake_latency);
+        }
+    }
+
+    if (task->config.period_us > 0 && task->next_release_us <= start) {
+        task->next_release_us += task->config.period_us;
+        if (task->next_release_us <= start) {
+            // Fell behind by more than a period; drop the missed releases
+            task->next_release_us = start + task->config.period_us;
+        }
+    }
+
+    task->config.function(task->config.context);
+
+    uint64_t end = SYSTEM_get_time_us();
+
+    if (!task->in_use) {
+        // The task removed itself
+        return;
+    }
+
+    task->stats.run_count++;
+    if (task->config.deadline_us > 0 && latency > task->config.deadline_us) {
+        task->stats.deadline_misses++;
+    }
+    if (sched_clamp_us(latency) > task->stats.max_latency_us) {
+        task->stats.max_latency_us = sched_clamp_us(latency);
+    }
+    if (sched_clamp_us(end - start) > task->stats.max_runtime_us) {
+        task->stats.max_runtime_us = sched_clamp_us(end - start);
+    }
+}
+
+void SCHED_init(void)
+{
+    for (size_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        g_tasks[i] = (SCHED_Task){ 0 };
+    }
+    g_idle_hook = nullptr;
+    g_wake_stats = (SCHED_WakeStats){ 0 };
+    g_wake_pending = false;
+}
+
+SCHED_Task *SCHED_add_task(SCHED_TaskConfig const *config)
+{
+    if (config == nullptr || config->function == nullptr) {
+        LOG_ERROR("SCHED: Invalid task configuration");
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    SCHED_Task *task = nullptr;
+    for (size_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        if (!g_tasks[i].in_use) {
+            task = &g_tasks[i];
+            break;
+        }
+    }
+
+    if (task == nullptr) {
+        LOG_ERROR("SCHED: No free task slots");
+        THROW(ERROR_OUT_OF_MEMORY);
+    }
+
+    *task = (SCHED_Task){ 0 };
+    task->config = *config;
+    task->next_release_us = SYSTEM_get_time_us() + config->period_us;
+    task->in_use = true;
+    return task;
+}
+
+void SCHED_remove_task(SCHED_Task *task)
+{
+    if (task == nullptr || !task->in_use) {
+        return;
+    }
+
+    *task = (SCHED_Task){ 0 };
+}
+
+void SCHED_signal(SCHED_Task *task)
+{
+    if (task == nullptr || !task->in_use) {
+        return;
+    }
+
+    uint32_t state = CYCLE_LL_enter_critical();
+    if (!task->signalled) {
+        task->signalled_at_us = SYSTEM_get_time_us();
+        task->signalled = true;
+    }
+    CYCLE_LL_exit_critical(state);
+}
+
+void SCHED_set_idle_hook(SCHED_IdleHook hook) { g_idle_hook = hook; }
+
+bool SCHED_has_ready_task(void)
+{
+    uint64_t ready_at = 0;
+    return sched_pick_task(SYSTEM_get_time_us(), &ready_at) != nullptr;
+}
+
+void SCHED_notify_wake(uint64_t wake_us)
+{
+    g_wake_stats.wake_count++;
+    g_wake_us = wake_us;
+    g_wake_pending = true;
+}
+
+bool SCHED_run_once(void)
+{
+    uint64_t ready_at = 0;
+    SCHED_Task *task = sched_pick_task(SYSTEM_get_time_us(), &ready_at);
+
+    if (task != nullptr) {
+        sched_run_task(task, ready_at);
+        return true;
+    }
+
+    // A wake-up that made no task ready is not serviced
+    g_wake_pending = false;
+
+    if (g_idle_hook != nullptr) {
+        g_idle_hook(sched_get_next_release());
+    }
+    return false;
+}
+
+__attribute__((noreturn)) void SCHED_run(void)
+{
+    while (1) {
+        SCHED_run_once();
+    }
+}
+
+SCHED_TaskStats SCHED_get_stats(SCHED_Task const *task)
+{
+    if (task == nullptr || !task->in_use) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    return task->stats;
+}
+
+SCHED_WakeStats SCHED_get_wake_stats(void) { return g_wake_stats; }
+
+void SCHED_reset_stats(void)
+{
+    for (size_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        g_tasks[i].stats = (SCHED_TaskStats){ 0 };
+    }
+    g_wake_stats = (SCHED_WakeStats){ 0 };
+    g_wake_pending = false;
+}
@@ -0,0 +1,210 @@
+/**
+ * @file scheduler.h
+ * @brief Cooperative task scheduler for PSLab firmware
+ *
+ * This header provides a small run-to-completion scheduler that replaces the
+ * free-running main loop. Tasks are either periodic, event-triggered, or
+ * both: a periodic task becomes ready when its period elapses, and any task
+ * becomes ready when it is signalled, for example from an interrupt handler.
+ *
+ * The scheduler always runs the ready task with the highest priority; among
+ * tasks of equal priority, the one that has been ready the longest runs
+ * first. Tasks are never preempted, so each task must return quickly to keep
+ * the latency of the others bounded. When no task is ready, the idle hook is
+ * called.
+ *
+ * For every task the scheduler records how long it waited after becoming
+ * ready and how long it ran. A task that waits longer than its deadline is
+ * counted as a deadline miss. When the idle hook puts the CPU to sleep, it
+ * reports the wake-up time, and the scheduler measures how long it takes
+ * from the wake-up until the next task starts.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef PSLAB_SCHEDULER_H
+#define PSLAB_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of tasks
+ */
+#define SCHED_MAX_TASKS 8
+
+/**
+ * @brief Task handle (opaque)
+ */
+typedef struct SCHED_Task SCHED_Task;
+
+/**
+ * @brief Task priority
+ */
+typedef enum {
+    SCHED_PRIORITY_LOW = 0,
+    SCHED_PRIORITY_NORMAL,
+    SCHED_PRIORITY_HIGH,
+} SCHED_Priority;
+
+/**
+ * @brief Task function type
+ *
+ * @param context User context from the task configuration
+ */
+typedef void (*SCHED_TaskFunction)(void *context);
+
+/**
+ * @brief Idle hook type
+ *
+ * Called when no task is ready. The hook may wait for an interrupt, but
+ * should return by the time the next periodic task becomes ready.
+ *
+ * @param next_release_us Time in microseconds at which the next periodic task
+ *                        becomes ready, or UINT64_MAX if there is none
+ */
+typedef void (*SCHED_IdleHook)(uint64_t next_release_us);
+
+/**
+ * @brief Task configuration
+ */
+typedef struct {
+    char const *name; /**< Task name for diagnostics */
+    SCHED_TaskFunction function; /**< Task function */
+    void *context; /**< User context passed to the function */
+    SCHED_Priority priority; /**< Task priority */
+    uint32_t period_us; /**< Period in us, 0 for an event-only task */
+    uint32_t deadline_us; /**< Allowed wait once ready, 0 for no deadline */
+} SCHED_TaskConfig;
+
+/**
+ * @brief Task statistics
+ */
+typedef struct {
+    uint32_t run_count; /**< Number of times the task ran */
+    uint32_t deadline_misses; /**< Runs that started after the deadline */
+    uint32_t max_latency_us; /**< Longest wait from ready to start */
+    uint32_t max_runtime_us; /**< Longest single run */
+} SCHED_TaskStats;
+
+/**
+ * @brief Wake-up statistics
+ */
+typedef struct {
+    uint32_t wake_count; /**< Wake-ups reported by the idle hook */
+    uint32_t serviced_count; /**< Wake-ups followed by a task run */
+    uint32_t max_latency_us; /**< Longest wake-up to task start */
+    uint64_t total_latency_us; /**< Sum over serviced wake-ups */
+} SCHED_WakeStats;
+
+/**
+ * @brief Initialize the scheduler
+ *
+ * Removes all tasks and the idle hook.
+ */
+void SCHED_init(void);
+
+/**
+ * @brief Add a task
+ *
+ * A periodic task first becomes ready one period after it is added.
+ *
+ * @param config Pointer to task configuration
+ * @return Pointer to task handle
+ *
+ * @throws ERROR_INVALID_ARGUMENT if config is NULL or has no function
+ * @throws ERROR_OUT_OF_MEMORY if all SCHED_MAX_TASKS are in use
+ */
+SCHED_Task *SCHED_add_task(SCHED_TaskConfig const *config);
+
+/**
+ * @brief Remove a task
+ *
+ * The handle becomes invalid after this call. A task may remove itself from
+ * its own function. Must not be called from interrupt context.
+ *
+ * @param task Pointer to task handle
+ */
+void SCHED_remove_task(SCHED_Task *task);
+
+/**
+ * @brief Make a task ready
+ *
+ * Signals received before the task runs are merged into a single run. Safe
+ * to call from interrupt context.
+ *
+ * @param task Pointer to task handle
+ */
+void SCHED_signal(SCHED_Task *task);
+
+/**
+ * @brief Set the idle hook
+ *
+ * @param hook Function to call when no task is ready, or nullptr
+ */
+void SCHED_set_idle_hook(SCHED_IdleHook hook);
+
+/**
+ * @brief Check whether any task is ready
+ *
+ * Lets the idle hook confirm, with interrupts masked, that no interrupt has
+ * signalled a task since the scheduler decided to idle.
+ *
+ * @return true if a task is ready to run
+ */
+bool SCHED_has_ready_task(void);
+
+/**
+ * @brief Report that the CPU woke up from sleep
+ *
+ * Called by the idle hook. If a task runs before the scheduler idles again,
+ * the time from wake_us to the task start is recorded as wake-up latency.
+ *
+ * @param wake_us Wake-up time in microseconds
+ */
+void SCHED_notify_wake(uint64_t wake_us);
+
+/**
+ * @brief Run the highest-priority ready task, or the idle hook
+ *
+ * @return true if a task ran, false if the scheduler was idle
+ */
+bool SCHED_run_once(void);
+
+/**
+ * @brief Run the scheduler forever
+ */
+__attribute__((noreturn)) void SCHED_run(void);
+
+/**
+ * @brief Get task statistics
+ *
+ * @param task Pointer to task handle
+ * @return Copy of the task statistics
+ *
+ * @throws ERROR_INVALID_ARGUMENT if task is NULL or not in use
+ */
+SCHED_TaskStats SCHED_get_stats(SCHED_Task const *task);
+
+/**
+ * @brief Get wake-up statistics
+ *
+ * @return Copy of the wake-up statistics
+ */
+SCHED_WakeStats SCHED_get_wake_stats(void);
+
+/**
+ * @brief Reset the statistics of all tasks and the wake-up statistics
+ */
+void SCHED_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSLAB_SCHEDULER_H
@@ -1,23 +1,24 @@
 /**
  * @file syscalls.c
- * @brief System call implementations for newlib using UART (write-only)
+ * @brief System call implementations for newlib using UART or USB (write-only)
  *
  * This file provides implementations for system calls that newlib requires
- * for stdio functionality, using the UART API for write-only I/O operations.
- * Writes are non-blocking.
+ * for stdio functionality, using the UART or USB API for write-only I/O
+ * operations. Writes are non-blocking.
  *
  * Implemented syscalls:
  * - _read_r: Stub that returns ENOSYS (reads not supported)
- * - _write_r: Write to stdout/stderr via UART
+ * - _write_r: Write to stdout/stderr via UART or USB
  * - _fstat_r: File status (stub - identifies stdout/stderr as character
  *   devices, stdin as invalid)
  * - _isatty_r: Terminal check (stub - treats stdout/stderr as terminals,
  *   stdin as not a terminal)
  *
  * Usage:
- * Call syscalls_init() with an initialized UART_Handle pointer to enable
- * stdout/stderr output. Until syscalls_init() is called, _write_r will
- * return EBADF.
+ * Call syscalls_init() with an initialized UART_Handle pointer, or
+ * syscalls_init_usb() with an initialized USB_Handle pointer, to enable
+ * stdout/stderr output. Until then, _write_r will return EIO. Each write to
+ * USB is sent as a message of its own, since stdout is line buffered.
  *
  * Note: RX functionality is not implemented as this is designed for
  * write-only logging and debugging output. Reads will always return ENOSYS.
@@ -29,14 +30,17 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include "platform/platform.h"
 #include "util/error.h"
 #include "util/util.h"
 
-// Include UART headers for handle type
+// Include UART and USB headers for handle types
 #include "system/bus/uart.h"
+#include "system/bus/usb.h"
 
-// Static handle for UART I/O
+// Static handles for UART or USB I/O, at most one of which is set
 static UART_Handle *g_uart_handle = nullptr;
+static USB_Handle *g_usb_handle = nullptr;
 
 static int check_args(struct _reent *r, void const *buf, size_t cnt)
 {
@@ -61,7 +65,7 @@ static int check_args(struct _reent *r, void const *buf, size_t cnt)
  */
 void syscalls_init(UART_Handle *handle)
 {
-    if (g_uart_handle != nullptr) {
+    if (g_uart_handle != nullptr || g_usb_handle != nullptr) {
         THROW(ERROR_RESOURCE_BUSY);
     }
     g_uart_handle = handle;
@@ -83,6 +87,52 @@ void syscalls_deinit(UART_Handle *handle)
     g_uart_handle = nullptr;
 }
 
+/**
+ * @brief Initialize syscalls with a USB handle
+ *
+ * @param handle Pointer to an initialized USB handle to use for stdout/stderr
+ * @throws ERROR_RESOURCE_BUSY if syscalls is already initialized
+ */
+void syscalls_init_usb(USB_Handle *handle)
+{
+    if (g_uart_handle != nullptr || g_usb_handle != nullptr) {
+        THROW(ERROR_RESOURCE_BUSY);
+    }
+    g_usb_handle = handle;
+}
+
+/**
+ * @brief Deinitialize syscalls initialized with a USB handle
+ *
+ * @param handle Pointer to the USB handle that was used to initialize syscalls
+ * @throws ERROR_INVALID_ARGUMENT if handle doesn't match the initialized handle
+ */
+void syscalls_deinit_usb(USB_Handle *handle)
+{
+    if (g_usb_handle != handle) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+    g_usb_handle = nullptr;
+}
+
+bool syscalls_usb_flush(uint32_t timeout)
+{
+    if (g_usb_handle == nullptr) {
+        return false;
+    }
+
+    // Keep the USB stack going until the host has read the output
+    uint32_t start_time = PLATFORM_get_tick();
+    while (USB_tx_busy(g_usb_handle)) {
+        USB_task(g_usb_handle);
+        if (timeout && (PLATFORM_get_tick() - start_time) > timeout) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool syscalls_uart_flush(uint32_t timeout)
 {
     if (g_uart_handle == nullptr) {
@@ -122,8 +172,8 @@ _ssize_t _read_r(struct _reent *r, int fd, void *buf, size_t cnt)
 /**
  * @brief Write data to file descriptor
  *
- * For stdout/stderr (fd 1/2), writes to UART if enabled, otherwise returns
- * error. For other file descriptors, returns error.
+ * For stdout/stderr (fd 1/2), writes to UART or USB if enabled, otherwise
+ * returns error. For other file descriptors, returns error.
  */
 _ssize_t _write_r(struct _reent *r, int fd, void const *buf, size_t cnt)
 {
@@ -134,15 +184,21 @@ _ssize_t _write_r(struct _reent *r, int fd, void const *buf, size_t cnt)
     }
 
     if (fd == STDOUT_FILENO || fd == STDERR_FILENO) {
-        if (g_uart_handle == nullptr) {
+        uint32_t bytes_written = 0;
+
+        if (g_uart_handle != nullptr) {
+            // Write to UART
+            bytes_written =
+                UART_write(g_uart_handle, (uint8_t const *)buf, cnt);
+        } else if (g_usb_handle != nullptr) {
+            // Write to USB, sending the line without waiting for more
+            bytes_written = USB_write(g_usb_handle, (uint8_t const *)buf, cnt);
+            USB_tx_flush(g_usb_handle);
+        } else {
             r->_errno = EIO;
             return -1;
         }
 
-        // Write to UART
-        uint32_t bytes_written =
-            UART_write(g_uart_handle, (uint8_t const *)buf, cnt);
-
         // If no bytes were written, it likely means the buffer is full
         if (bytes_written == 0 && cnt > 0) {
             r->_errno = EAGAIN;
@@ -4,23 +4,44 @@
  *
  * This module provides the SYSTEM_init() function, which initializes all core
  * hardware peripherals and must be called immediately after reset, before any
- * other hardware access.
+ * other hardware access. Peripherals that USB enumeration does not depend on
+ * are brought up later by the boot task.
+ *
+ * The log goes out on the USB console interface, so that it does not compete
+ * with UART traffic and needs no second cable. Built with PSLAB_USB_CONSOLE
+ * set to UART, the console bridges the host to a UART instead, and the log
+ * stays on its own UART.
  */
 
 #include <stddef.h>
 #include <stdint.h>
 
+#include "platform/adc_ll.h"
 #include "platform/platform.h"
 #include "platform/uart_ll.h"
+#include "platform/usb_ll.h"
 #include "util/error.h"
 #include "util/logging.h"
 #include "util/si_prefix.h"
 #include "util/util.h"
 
 #include "bus/uart.h"
+#include "bus/usb.h"
 #include "led.h"
 #include "system.h"
 
+#ifndef PSLAB_USB_CONSOLE_UART
+#define PSLAB_USB_CONSOLE_UART 0
+#endif
+
+enum {
+    LOG_UART_BUS = 2,
+    // UART bridged to the USB console (USART1, PA9/PA10)
+    CONSOLE_BRIDGE_UART_BUS = 0,
+    // Bridge buffers, one per direction; enough for several ms at 115200 baud
+    CONSOLE_BRIDGE_BUFFER_SIZE = 512,
+};
+
 // Global variables for logging
 static UART_Handle *g_logging_uart_handle = nullptr;
 static uint8_t g_log_buf[1024];
@@ -28,23 +49,111 @@ static uint8_t g_log_rx_buf[1];
 static CircularBuffer g_log_cb;
 static CircularBuffer g_log_rx_cb;
 
+// USB console, carrying the log or bridged to a UART
+static USB_Handle *g_console_handle = nullptr;
+
+#if PSLAB_USB_CONSOLE_UART
+// Bridge buffers, each written by one bus and read by the other
+static UART_Handle *g_bridge_uart_handle = nullptr;
+static uint8_t g_bridge_to_uart_buf[CONSOLE_BRIDGE_BUFFER_SIZE];
+static uint8_t g_bridge_to_usb_buf[CONSOLE_BRIDGE_BUFFER_SIZE];
+static CircularBuffer g_bridge_to_uart_cb;
+static CircularBuffer g_bridge_to_usb_cb;
+
+/**
+ * @brief Send what the host wrote to the console on the bridged UART
+ */
+static void console_bridge_rx_callback(USB_Handle *handle, uint32_t available)
+{
+    (void)handle;
+    (void)available;
+    UART_tx_start(g_bridge_uart_handle);
+}
+
+/**
+ * @brief Bridge the USB console to a UART
+ *
+ * As with UART_enable_passthrough, the buses share their buffers rather than
+ * copying between them: the UART sends from the buffer USB receives into,
+ * and receives by DMA into the buffer USB sends from.
+ */
+static void console_bridge_init(void)
+{
+    circular_buffer_init(
+        &g_bridge_to_uart_cb, g_bridge_to_uart_buf, sizeof(g_bridge_to_uart_buf)
+    );
+    circular_buffer_init(
+        &g_bridge_to_usb_cb, g_bridge_to_usb_buf, sizeof(g_bridge_to_usb_buf)
+    );
+
+    g_bridge_uart_handle = UART_init(
+        CONSOLE_BRIDGE_UART_BUS, &g_bridge_to_usb_cb, &g_bridge_to_uart_cb
+    );
+    g_console_handle =
+        USB_init(USB_BUS_1, &g_bridge_to_uart_cb, &g_bridge_to_usb_cb);
+    USB_set_shared_buffers(g_console_handle, true);
+    USB_set_rx_callback(g_console_handle, console_bridge_rx_callback, 1);
+}
+#endif
+
 void SYSTEM_init(void)
 {
     // Initialize logging early to capture any log messages during startup
     LOG_init();
     PLATFORM_init();
+    extern void timebase_init(void);
+    timebase_init();
+    extern void boot_init(void);
+    boot_init();
+}
 
+/**
+ * @brief Bring up the peripherals that SYSTEM_init leaves for later
+ *
+ * Called once by SYSTEM_boot_task after USB is up.
+ */
+void system_init_deferred(void)
+{
     // Set up log output
     circular_buffer_init(&g_log_cb, g_log_buf, sizeof(g_log_buf));
     circular_buffer_init(&g_log_rx_cb, g_log_rx_buf, sizeof(g_log_rx_buf));
-    uint8_t log_bus = 2;
-    g_logging_uart_handle = UART_init(log_bus, &g_log_rx_cb, &g_log_cb);
+#if PSLAB_USB_CONSOLE_UART
+    g_logging_uart_handle = UART_init(LOG_UART_BUS, &g_log_rx_cb, &g_log_cb);
     extern void syscalls_init(UART_Handle * handle);
     syscalls_init(g_logging_uart_handle);
+    console_bridge_init();
+#else
+    // The console ignores input: its one-byte RX buffer never takes any
+    g_console_handle = USB_init(USB_BUS_1, &g_log_rx_cb, &g_log_cb);
+    extern void syscalls_init_usb(USB_Handle * handle);
+    syscalls_init_usb(g_console_handle);
+#endif
     // Buffered log messages can now be output with LOG_task
     LOG_task(0xFF);
 
     LED_init();
+    SYSTEM_boot_mark(SYSTEM_BOOT_LOGGING);
+
+    // Calibrate the ADC and measure VDDA now rather than on first use
+    Error error = ERROR_NONE;
+    TRY { ADC_LL_prepare(); }
+    CATCH(error)
+    {
+        LOG_WARN("ADC preparation failed: %s", error_to_string(error));
+    }
+}
+
+void SYSTEM_console_task(void)
+{
+    if (g_console_handle == nullptr) {
+        return;
+    }
+
+#if PSLAB_USB_CONSOLE_UART
+    // Pick up bytes received since the last idle line or DMA wrap
+    UART_rx_available(g_bridge_uart_handle);
+#endif
+    USB_task(g_console_handle);
 }
 
 uint32_t SYSTEM_get_tick(void) { return PLATFORM_get_tick(); }
@@ -66,7 +175,13 @@ __attribute__((noreturn)) void SYSTEM_reset(void)
     timeout = timeout > SI_MILLI_DIV ? SI_MILLI_DIV : timeout;
 
     extern bool syscalls_uart_flush(uint32_t timeout);
+    extern bool syscalls_usb_flush(uint32_t timeout);
     syscalls_uart_flush(timeout);
+    // Nobody reads the USB console until the host opens it; waiting for it
+    // would only delay the reset by the full timeout
+    if (USB_LL_connected(USB_BUS_1)) {
+        syscalls_usb_flush(timeout);
+    }
     PLATFORM_reset();
 }
 
@@ -11,6 +11,9 @@
 #define SYSTEM_H
 
 #include "util/fixed_point.h"
+#include "util/perf.h"
+
+#include "scheduler.h"
 
 #define SYSTEM_VDD (FIXED_FROM_FLOAT(3.3F)) // NOLINT(readability-magic-numbers)
 
@@ -18,11 +21,76 @@
  * @brief Initialize all core hardware peripherals.
  *
  * This function must be called immediately after reset, before any other
- * hardware access is performed. It initializes the platform, LED, UART, and USB
- * subsystems.
+ * hardware access is performed. It initializes the platform clocks and the
+ * timebase. Log messages are buffered until SYSTEM_boot_task brings up the
+ * log output and the LEDs.
  */
 void SYSTEM_init(void);
 
+/**
+ * @brief Boot phases, in the order they are reached
+ */
+typedef enum {
+    SYSTEM_BOOT_CLOCKS = 0, /**< Clocks configured, timebase running */
+    SYSTEM_BOOT_USB_INIT, /**< USB stack started */
+    SYSTEM_BOOT_USB_ENUMERATED, /**< Device configured by the host */
+    SYSTEM_BOOT_LOGGING, /**< Log output and LEDs up */
+    SYSTEM_BOOT_COMPLETE, /**< Deferred init, including ADC prep, done */
+    SYSTEM_BOOT_PHASE_COUNT
+} SYSTEM_BootPhase;
+
+/**
+ * @brief Boot phase timestamps
+ */
+typedef struct {
+    /** Time since reset in us at which each phase was reached, 0 if not yet */
+    uint64_t phase_us[SYSTEM_BOOT_PHASE_COUNT];
+} SYSTEM_BootTiming;
+
+/**
+ * @brief Record that a boot phase has been reached
+ *
+ * Only the first call for each phase is recorded.
+ *
+ * @param phase Boot phase
+ */
+void SYSTEM_boot_mark(SYSTEM_BootPhase phase);
+
+/**
+ * @brief Finish booting once USB is up
+ *
+ * Call periodically after USB has been initialized. Once the host has
+ * configured the device, or after a timeout if it does not, brings up the
+ * log output, the USB console and the LEDs and prepares the ADC.
+ *
+ * @return true once the deferred init has completed
+ */
+bool SYSTEM_boot_task(void);
+
+/**
+ * @brief Finish booting without waiting for USB
+ *
+ * Runs the deferred init right away if SYSTEM_boot_task has not done so yet.
+ * Use when USB could not be started, so that log output still comes up.
+ */
+void SYSTEM_boot_finish(void);
+
+/**
+ * @brief Service the USB console
+ *
+ * Sends buffered log output to the host, or moves data across the UART
+ * bridge. Call periodically once SYSTEM_boot_task has completed; does
+ * nothing before.
+ */
+void SYSTEM_console_task(void);
+
+/**
+ * @brief Get the boot phase timestamps
+ *
+ * @return Copy of the timestamps
+ */
+SYSTEM_BootTiming SYSTEM_get_boot_timing(void);
+
 /**
  * @brief Get the current system tick count
  *
@@ -30,6 +98,141 @@ void SYSTEM_init(void);
  */
 uint32_t SYSTEM_get_tick(void);
 
+/**
+ * @brief Get the monotonic time since startup in microseconds
+ *
+ * Safe to call from interrupt context.
+ *
+ * @return Time in microseconds
+ */
+uint64_t SYSTEM_get_time_us(void);
+
+/**
+ * @brief Get the monotonic CPU cycle count since startup
+ *
+ * The 32-bit hardware cycle counter is extended to 64 bits, so the count
+ * never wraps in practice. Safe to call from interrupt context.
+ *
+ * @return Cycle count
+ */
+uint64_t SYSTEM_get_cycles(void);
+
+/**
+ * @brief Get the raw 32-bit CPU cycle count
+ *
+ * Cheaper than SYSTEM_get_cycles for measuring short intervals; the
+ * difference of two readings is correct across a single wrap. Safe to call
+ * from interrupt context.
+ *
+ * @return Cycle count, wrapping at 2^32
+ */
+uint32_t SYSTEM_get_cycles32(void);
+
+/**
+ * @brief Get the CPU cycle counter frequency
+ *
+ * @return Cycles per second
+ */
+uint32_t SYSTEM_get_cycle_frequency(void);
+
+/**
+ * @brief Convert a CPU cycle count to microseconds
+ *
+ * @param cycles Cycle count
+ * @return Time in microseconds, rounded down
+ */
+uint64_t SYSTEM_cycles_to_us(uint64_t cycles);
+
+/**
+ * @brief Wake-up sources of the idle sleep
+ */
+typedef enum {
+    SYSTEM_WAKE_USB = 0,
+    SYSTEM_WAKE_DMA,
+    SYSTEM_WAKE_UART,
+    SYSTEM_WAKE_TIMER,
+    SYSTEM_WAKE_OTHER,
+    SYSTEM_WAKE_COUNT
+} SYSTEM_WakeSource;
+
+/**
+ * @brief Idle statistics
+ */
+typedef struct {
+    uint32_t sleep_count; /**< Times the CPU entered sleep */
+    uint32_t wake_count[SYSTEM_WAKE_COUNT]; /**< Wake-ups per source */
+    uint32_t serviced_count; /**< Wake-ups followed by a task run */
+    uint32_t avg_latency_us; /**< Average wake-up to task start */
+    uint32_t max_latency_us; /**< Longest wake-up to task start */
+    uint64_t sleep_time_us; /**< Total time spent asleep */
+} SYSTEM_IdleStats;
+
+/**
+ * @brief Scheduler idle hook that sleeps until the next interrupt
+ *
+ * Enters Sleep mode unless a task became ready in the meantime or the next
+ * periodic release is too close to be worth it. Peripherals, DMA and USB
+ * keep running; any interrupt wakes the CPU, and SysTick bounds the sleep to
+ * 1 ms. After waking, the tasks registered for the wake-up sources are
+ * signalled.
+ *
+ * @param next_release_us Next periodic release in us, or UINT64_MAX
+ */
+void SYSTEM_idle(uint64_t next_release_us);
+
+/**
+ * @brief Register a task to signal when a source wakes the CPU
+ *
+ * @param source Wake-up source
+ * @param task Task to signal, or nullptr to signal none
+ */
+void SYSTEM_set_wake_task(SYSTEM_WakeSource source, SCHED_Task *task);
+
+/**
+ * @brief Get idle statistics
+ *
+ * @return Copy of the idle statistics
+ */
+SYSTEM_IdleStats SYSTEM_get_idle_stats(void);
+
+/**
+ * @brief Reset idle statistics
+ *
+ * The wake-up latency is kept by the scheduler, so this also resets the
+ * scheduler statistics.
+ */
+void SYSTEM_reset_idle_stats(void);
+
+/**
+ * @brief CPU load and service time statistics over one window
+ */
+typedef struct {
+    uint32_t cycle_frequency; /**< CPU cycles per second */
+    uint64_t window_cycles; /**< Length of the window in CPU cycles */
+    uint32_t load_permille; /**< Share of the window the CPU was awake */
+    PERF_Stats sources[PERF_SOURCE_COUNT]; /**< Samples per source */
+} SYSTEM_PerfStats;
+
+/**
+ * @brief Close the current accounting window
+ *
+ * The samples recorded since the previous call become the published window.
+ * Call periodically; the period sets the window length.
+ */
+void SYSTEM_perf_task(void);
+
+/**
+ * @brief Get the statistics of the last completed accounting window
+ *
+ * @return Copy of the window statistics, all zero before the first window
+ */
+SYSTEM_PerfStats SYSTEM_get_perf_stats(void);
+
+/**
+ * @brief Discard all samples and start a new accounting window
+ */
+void SYSTEM_reset_perf_stats(void);
+
 /**
  * @brief Reset system
  *
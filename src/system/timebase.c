@@ -0,0 +1,81 @@
+/**
+ * @file timebase.c
+ * @brief Monotonic microsecond timebase for the PSLab Mini firmware.
+ *
+ * The 32-bit hardware cycle counter is extended to 64 bits in software. Every
+ * reading compares the counter with the previous reading and counts a wrap
+ * when it went backwards. The cycle LL tick hook takes a reading every
+ * millisecond, so no wrap is missed even when nothing else asks for the time.
+ * Readings run with interrupts masked, which makes them safe to take from
+ * any context.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdint.h>
+
+#include "platform/cycle_ll.h"
+#include "util/si_prefix.h"
+
+#include "system.h"
+
+static uint32_t volatile g_cycles_high = 0;
+static uint32_t volatile g_cycles_last = 0;
+
+/**
+ * @brief Sample the cycle counter to keep the wrap count current
+ */
+static void timebase_tick(void) { (void)SYSTEM_get_cycles(); }
+
+/**
+ * @brief Initialize the timebase
+ *
+ * Called from SYSTEM_init once the core clock is configured. Time starts at
+ * zero.
+ */
+void timebase_init(void)
+{
+    CYCLE_LL_set_tick_callback(nullptr);
+    g_cycles_high = 0;
+    g_cycles_last = 0;
+    CYCLE_LL_init();
+    CYCLE_LL_set_tick_callback(timebase_tick);
+}
+
+uint64_t SYSTEM_get_cycles(void)
+{
+    uint32_t state = CYCLE_LL_enter_critical();
+
+    uint32_t now = CYCLE_LL_get_count();
+    if (now < g_cycles_last) {
+        g_cycles_high = g_cycles_high + 1;
+    }
+    g_cycles_last = now;
+    uint64_t cycles = ((uint64_t)g_cycles_high << 32) | now;
+
+    CYCLE_LL_exit_critical(state);
+    return cycles;
+}
+
+uint32_t SYSTEM_get_cycles32(void) { return CYCLE_LL_get_count(); }
+
+uint32_t SYSTEM_get_cycle_frequency(void) { return CYCLE_LL_get_frequency(); }
+
+uint64_t SYSTEM_cycles_to_us(uint64_t cycles)
+{
+    uint32_t freq = CYCLE_LL_get_frequency();
+    if (freq == 0) {
+        return 0;
+    }
+
+    // Split to keep cycles * 10^6 from overflowing after ~20 h at 250 MHz
+    uint64_t whole = cycles / freq;
+    uint64_t rest = cycles % freq;
+    return whole * SI_MICRO_DIV + rest * SI_MICRO_DIV / freq;
+}
+
+uint64_t SYSTEM_get_time_us(void)
+{
+    return SYSTEM_cycles_to_us(SYSTEM_get_cycles());
+}
@@ -4,12 +4,16 @@
  *
  * This module provides a circular buffer implementation for the PSLab firmware,
  * allowing for efficient data storage and retrieval in a fixed-size buffer.
+ * The accessors run from SRAM since UART, USB and logging call them from
+ * interrupt handlers and per-byte loops.
  */
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "error.h"
+#include "ramfunc.h"
 #include "util.h"
 
 /**
@@ -42,7 +46,7 @@ void circular_buffer_init(CircularBuffer *cb, uint8_t *buffer, uint32_t size)
  * @param cb Pointer to circular buffer structure
  * @return true if buffer is empty, false otherwise
  */
-bool circular_buffer_is_empty(CircularBuffer *cb)
+RAMFUNC bool circular_buffer_is_empty(CircularBuffer *cb)
 {
     if (!cb) {
         THROW(ERROR_INVALID_ARGUMENT);
@@ -56,7 +60,7 @@ bool circular_buffer_is_empty(CircularBuffer *cb)
  * @param cb Pointer to circular buffer structure
  * @return true if buffer is full, false otherwise
  */
-bool circular_buffer_is_full(CircularBuffer *cb)
+RAMFUNC bool circular_buffer_is_full(CircularBuffer *cb)
 {
     if (!cb) {
         THROW(ERROR_INVALID_ARGUMENT);
@@ -70,7 +74,7 @@ bool circular_buffer_is_full(CircularBuffer *cb)
  * @param cb Pointer to circular buffer structure
  * @return Number of bytes available
  */
-uint32_t circular_buffer_available(CircularBuffer *cb)
+RAMFUNC uint32_t circular_buffer_available(CircularBuffer *cb)
 {
     if (!cb) {
         THROW(ERROR_INVALID_ARGUMENT);
@@ -85,7 +89,7 @@ uint32_t circular_buffer_available(CircularBuffer *cb)
  * @param data Byte to put into buffer
  * @return true if successful, false if buffer is full
  */
-bool circular_buffer_put(CircularBuffer *cb, uint8_t data)
+RAMFUNC bool circular_buffer_put(CircularBuffer *cb, uint8_t data)
 {
     if (!cb) {
         THROW(ERROR_INVALID_ARGUMENT);
@@ -107,7 +111,7 @@ bool circular_buffer_put(CircularBuffer *cb, uint8_t data)
  * @param data Pointer to store the read byte
  * @return true if successful, false if buffer is empty
  */
-bool circular_buffer_get(CircularBuffer *cb, uint8_t *data)
+RAMFUNC bool circular_buffer_get(CircularBuffer *cb, uint8_t *data)
 {
     if (!cb || !data) {
         THROW(ERROR_INVALID_ARGUMENT);
@@ -143,7 +147,7 @@ void circular_buffer_reset(CircularBuffer *cb)
  * @param len Number of bytes to write
  * @return Number of bytes actually written
  */
-uint32_t circular_buffer_write(
+RAMFUNC uint32_t circular_buffer_write(
     CircularBuffer *cb,
     uint8_t const *data,
     uint32_t len
@@ -155,12 +159,19 @@ uint32_t circular_buffer_write(
 
     uint32_t bytes_written = 0;
 
-    while (bytes_written < len && !circular_buffer_is_full(cb)) {
-        if (circular_buffer_put(cb, data[bytes_written])) {
-            bytes_written++;
-        } else {
+    // At most two spans: up to the end of the memory, then from its start
+    while (bytes_written < len) {
+        uint8_t *span = nullptr;
+        uint32_t chunk = circular_buffer_reserve_span(cb, &span);
+        if (chunk == 0) {
             break;
         }
+        if (chunk > len - bytes_written) {
+            chunk = len - bytes_written;
+        }
+        memcpy(span, &data[bytes_written], chunk);
+        circular_buffer_commit(cb, chunk);
+        bytes_written += chunk;
     }
 
     return bytes_written;
@@ -174,7 +185,11 @@ uint32_t circular_buffer_write(
  * @param len Maximum number of bytes to read
  * @return Number of bytes actually read
  */
-uint32_t circular_buffer_read(CircularBuffer *cb, uint8_t *data, uint32_t len)
+RAMFUNC uint32_t circular_buffer_read(
+    CircularBuffer *cb,
+    uint8_t *data,
+    uint32_t len
+)
 {
     if (!cb || !data) {
         THROW(ERROR_INVALID_ARGUMENT);
@@ -182,24 +197,106 @@ uint32_t circular_buffer_read(CircularBuffer *cb, uint8_t *data, uint32_t len)
 
     uint32_t bytes_read = 0;
 
-    while (bytes_read < len && !circular_buffer_is_empty(cb)) {
-        if (circular_buffer_get(cb, &data[bytes_read])) {
-            bytes_read++;
-        } else {
+    while (bytes_read < len) {
+        uint8_t const *span = nullptr;
+        uint32_t chunk = circular_buffer_peek_span(cb, &span);
+        if (chunk == 0) {
             break;
         }
+        if (chunk > len - bytes_read) {
+            chunk = len - bytes_read;
+        }
+        memcpy(&data[bytes_read], span, chunk);
+        circular_buffer_consume(cb, chunk);
+        bytes_read += chunk;
     }
 
     return bytes_read;
 }
 
+/**
+ * @brief Get the contiguous run of bytes at the read end of a circular buffer
+ *
+ * @param cb Pointer to circular buffer structure
+ * @param span Set to the first readable byte
+ * @return Number of contiguous bytes readable at *span
+ */
+RAMFUNC uint32_t circular_buffer_peek_span(
+    CircularBuffer *cb,
+    uint8_t const **span
+)
+{
+    if (!cb || !span) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    uint32_t const tail = cb->tail;
+    uint32_t const available = (cb->head - tail) & cb->mask;
+    uint32_t const to_end = cb->size - tail;
+
+    *span = &cb->buffer[tail];
+    return available < to_end ? available : to_end;
+}
+
+/**
+ * @brief Remove bytes from the read end of a circular buffer
+ *
+ * @param cb Pointer to circular buffer structure
+ * @param len Number of bytes to remove
+ */
+RAMFUNC void circular_buffer_consume(CircularBuffer *cb, uint32_t len)
+{
+    if (!cb || len > circular_buffer_available(cb)) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+    cb->tail = (cb->tail + len) & cb->mask;
+}
+
+/**
+ * @brief Get the contiguous free run at the write end of a circular buffer
+ *
+ * @param cb Pointer to circular buffer structure
+ * @param span Set to the first writable byte
+ * @return Number of contiguous bytes writable at *span
+ */
+RAMFUNC uint32_t circular_buffer_reserve_span(
+    CircularBuffer *cb,
+    uint8_t **span
+)
+{
+    if (!cb || !span) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    uint32_t const head = cb->head;
+    uint32_t const free_space = circular_buffer_free_space(cb);
+    uint32_t const to_end = cb->size - head;
+
+    *span = &cb->buffer[head];
+    return free_space < to_end ? free_space : to_end;
+}
+
+/**
+ * @brief Make bytes written to a reserved span readable
+ *
+ * @param cb Pointer to circular buffer structure
+ * @param len Number of bytes written
+ */
+RAMFUNC void circular_buffer_commit(CircularBuffer *cb, uint32_t len)
+{
+    if (!cb || len > circular_buffer_free_space(cb)) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+    cb->head = (cb->head + len) & cb->mask;
+}
+
 /**
  * @brief Get free space in circular buffer
  *
  * @param cb Pointer to circular buffer structure
  * @return Number of bytes free in the buffer
  */
-uint32_t circular_buffer_free_space(CircularBuffer *cb)
+RAMFUNC uint32_t circular_buffer_free_space(CircularBuffer *cb)
 {
     if (!cb) {
         THROW(ERROR_INVALID_ARGUMENT);
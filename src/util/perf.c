@@ -0,0 +1,51 @@
+/**
+ * @file perf.c
+ * @brief Cycle accounting for CPU load and interrupt service time
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdint.h>
+
+#include "perf.h"
+
+static PERF_Stats volatile g_perf_stats[PERF_SOURCE_COUNT];
+
+void PERF_record(PERF_Source source, uint32_t cycles)
+{
+    if (source >= PERF_SOURCE_COUNT) {
+        return;
+    }
+
+    PERF_Stats volatile *stats = &g_perf_stats[source];
+
+    if (stats->count == 0 || cycles < stats->min_cycles) {
+        stats->min_cycles = cycles;
+    }
+    if (cycles > stats->max_cycles) {
+        stats->max_cycles = cycles;
+    }
+    stats->total_cycles += cycles;
+    stats->count++;
+}
+
+PERF_Stats PERF_take(PERF_Source source)
+{
+    if (source >= PERF_SOURCE_COUNT) {
+        return (PERF_Stats){ 0 };
+    }
+
+    PERF_Stats stats = {
+        .count = g_perf_stats[source].count,
+        .min_cycles = g_perf_stats[source].min_cycles,
+        .max_cycles = g_perf_stats[source].max_cycles,
+        .total_cycles = g_perf_stats[source].total_cycles,
+    };
+    g_perf_stats[source].count = 0;
+    g_perf_stats[source].min_cycles = 0;
+    g_perf_stats[source].max_cycles = 0;
+    g_perf_stats[source].total_cycles = 0;
+
+    return stats;
+}
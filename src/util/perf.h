@@ -0,0 +1,73 @@
+/**
+ * @file perf.h
+ * @brief Cycle accounting for CPU load and interrupt service time
+ *
+ * Code paths such as interrupt handlers measure their own duration in CPU
+ * cycles and record it here under a source. For every source, the number of
+ * samples, the shortest, the longest and the total duration are accumulated
+ * until they are taken, which lets the caller report them over rolling
+ * windows.
+ *
+ * Each source must only be recorded from contexts that cannot preempt each
+ * other. Taking samples while interrupts may record them must be done with
+ * interrupts masked.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef PSLAB_PERF_H
+#define PSLAB_PERF_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Accounted code paths
+ */
+typedef enum {
+    PERF_SOURCE_IDLE = 0, /**< Main loop asleep */
+    PERF_SOURCE_ADC_DMA, /**< GPDMA channel 6/7 ADC interrupts */
+    PERF_SOURCE_UART_DMA, /**< GPDMA channel 0-5 USART interrupts */
+    PERF_SOURCE_USB, /**< USB DRD interrupt */
+    PERF_SOURCE_USB_DEFERRED, /**< USB stack run from PendSV */
+    PERF_SOURCE_ADC_SWITCH, /**< ADC arbiter handing the ADC over */
+    PERF_SOURCE_COUNT
+} PERF_Source;
+
+/**
+ * @brief Accumulated samples of a source
+ */
+typedef struct {
+    uint32_t count; /**< Number of samples */
+    uint32_t min_cycles; /**< Shortest sample, 0 if there are none */
+    uint32_t max_cycles; /**< Longest sample */
+    uint64_t total_cycles; /**< Sum of all samples */
+} PERF_Stats;
+
+/**
+ * @brief Record a sample
+ *
+ * @param source Accounted code path
+ * @param cycles Duration in CPU cycles
+ */
+void PERF_record(PERF_Source source, uint32_t cycles);
+
+/**
+ * @brief Take the accumulated samples of a source
+ *
+ * The accumulator of the source is cleared.
+ *
+ * @param source Accounted code path
+ * @return Samples accumulated since the last take
+ */
+PERF_Stats PERF_take(PERF_Source source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSLAB_PERF_H
@@ -0,0 +1,31 @@
+/**
+ * @file ramfunc.h
+ * @brief Placement of hot code paths in SRAM
+ *
+ * Functions marked with RAMFUNC are linked into the .ramfunc section, which
+ * the startup code copies from flash to SRAM before main(). Code executing
+ * from SRAM does not compete with flash wait states or instruction cache
+ * misses, which keeps interrupt handlers and tight loops at a predictable
+ * cycle count.
+ *
+ * Calls between flash and SRAM are out of direct branch range and go through
+ * veneers inserted by the linker, so only functions that do most of their
+ * work locally benefit from being relocated.
+ *
+ * On host builds the macro expands to nothing.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef PSLAB_RAMFUNC_H
+#define PSLAB_RAMFUNC_H
+
+#if defined(__arm__)
+// noinline keeps the function body in SRAM instead of copying it into callers
+#define RAMFUNC __attribute__((section(".ramfunc"), noinline))
+#else
+#define RAMFUNC
+#endif
+
+#endif // PSLAB_RAMFUNC_H
@@ -0,0 +1,93 @@
+/**
+ * @file timer_solver.c
+ * @brief Prescaler and auto-reload solver for hardware timers
+ *
+ * Products are computed in 64 bits, so that 32-bit auto-reload values and
+ * timer clocks up to 4 GHz cannot overflow.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdint.h>
+
+#include "error.h"
+#include "timer_solver.h"
+
+TIMER_SOLVER_Values TIMER_SOLVER_solve(
+    uint32_t clock,
+    uint32_t freq,
+    uint32_t max_period
+)
+{
+    if (clock == 0 || freq == 0 || freq > clock / TIMER_SOLVER_MIN_COUNTS) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    uint64_t const max_counts = (uint64_t)max_period + 1;
+    uint64_t const divider = ((uint64_t)clock + freq / 2) / freq;
+    uint64_t const min_prescaler = (divider + max_counts - 1) / max_counts - 1;
+
+    if (min_prescaler > TIMER_SOLVER_MAX_PRESCALER) {
+        // Frequency too low for this timer
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    uint64_t last_prescaler = min_prescaler + TIMER_SOLVER_MAX_STEPS;
+    if (last_prescaler > TIMER_SOLVER_MAX_PRESCALER) {
+        last_prescaler = TIMER_SOLVER_MAX_PRESCALER;
+    }
+
+    TIMER_SOLVER_Values best = { 0 };
+    uint64_t best_error = UINT64_MAX;
+
+    for (uint64_t psc = min_prescaler; psc <= last_prescaler; psc++) {
+        uint64_t const step = (uint64_t)freq * (psc + 1);
+        uint64_t counts = ((uint64_t)clock + step / 2) / step;
+
+        if (counts > max_counts) {
+            counts = max_counts;
+        }
+        if (counts < TIMER_SOLVER_MIN_COUNTS) {
+            // Larger prescalers only get coarser from here
+            break;
+        }
+
+        uint64_t const actual = step * counts;
+        uint64_t const error = actual > clock ? actual - clock : clock - actual;
+
+        if (error < best_error) {
+            best_error = error;
+            best.prescaler = (uint32_t)psc;
+            best.period = (uint32_t)(counts - 1);
+        }
+        if (error == 0) {
+            break;
+        }
+    }
+
+    if (best_error == UINT64_MAX) {
+        THROW(ERROR_INVALID_ARGUMENT);
+    }
+
+    return best;
+}
+
+uint32_t TIMER_SOLVER_get_frequency(uint32_t clock, TIMER_SOLVER_Values values)
+{
+    uint64_t const divider =
+        ((uint64_t)values.prescaler + 1) * ((uint64_t)values.period + 1);
+
+    return (uint32_t)(((uint64_t)clock + divider / 2) / divider);
+}
+
+uint32_t TIMER_SOLVER_get_achievable_frequency(
+    uint32_t clock,
+    uint32_t freq,
+    uint32_t max_period
+)
+{
+    return TIMER_SOLVER_get_frequency(
+        clock, TIMER_SOLVER_solve(clock, freq, max_period)
+    );
+}
@@ -0,0 +1,90 @@
+/**
+ * @file timer_solver.h
+ * @brief Prescaler and auto-reload solver for hardware timers
+ *
+ * A timer counting at clock Hz produces update events at
+ * clock / ((PSC + 1) * (ARR + 1)). The solver picks the prescaler (PSC) and
+ * auto-reload (ARR) pair whose update frequency is closest to a requested
+ * frequency. It is pure integer arithmetic, independent of the timer hardware.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef PSLAB_TIMER_SOLVER_H
+#define PSLAB_TIMER_SOLVER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    TIMER_SOLVER_MAX_PRESCALER = 0xFFFF, /**< PSC is 16 bits on all timers */
+    TIMER_SOLVER_MIN_COUNTS = 2, /**< ARR = 0 stops the counter */
+    TIMER_SOLVER_MAX_STEPS = 1024, /**< Prescalers tried above the minimum */
+};
+
+/**
+ * @brief Prescaler and auto-reload pair
+ */
+typedef struct {
+    uint32_t prescaler; /**< PSC register value */
+    uint32_t period; /**< ARR register value */
+} TIMER_SOLVER_Values;
+
+/**
+ * @brief Find the prescaler and auto-reload pair closest to a frequency
+ *
+ * Starting from the smallest prescaler that lets ARR reach the requested
+ * division, up to TIMER_SOLVER_MAX_STEPS larger prescalers are tried. For each
+ * prescaler the nearest ARR is taken, rounding halves to the longer period,
+ * and the pair whose period is closest to the requested one wins. Ties keep
+ * the smaller prescaler, which gives the finer counter resolution.
+ *
+ * @param clock Timer counter clock in Hz
+ * @param freq Requested update frequency in Hz
+ * @param max_period Largest ARR value, 0xFFFF or 0xFFFFFFFF
+ * @return Prescaler and auto-reload values
+ *
+ * @throws ERROR_INVALID_ARGUMENT if clock or freq is 0, freq is above
+ *         clock / TIMER_SOLVER_MIN_COUNTS, or too low for the timer
+ */
+TIMER_SOLVER_Values TIMER_SOLVER_solve(
+    uint32_t clock,
+    uint32_t freq,
+    uint32_t max_period
+);
+
+/**
+ * @brief Get the update frequency of a prescaler and auto-reload pair
+ *
+ * @param clock Timer counter clock in Hz
+ * @param values Prescaler and auto-reload values
+ * @return Frequency in Hz, rounded to the nearest integer
+ */
+uint32_t TIMER_SOLVER_get_frequency(uint32_t clock, TIMER_SOLVER_Values values);
+
+/**
+ * @brief Get the update frequency the solver achieves for a frequency
+ *
+ * @param clock Timer counter clock in Hz
+ * @param freq Requested update frequency in Hz
+ * @param max_period Largest ARR value, 0xFFFF or 0xFFFFFFFF
+ * @return Achieved frequency in Hz, rounded to the nearest integer
+ *
+ * @throws ERROR_INVALID_ARGUMENT under the same conditions as
+ *         TIMER_SOLVER_solve
+ */
+uint32_t TIMER_SOLVER_get_achievable_frequency(
+    uint32_t clock,
+    uint32_t freq,
+    uint32_t max_period
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSLAB_TIMER_SOLVER_H
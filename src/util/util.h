@@ -111,6 +111,47 @@ uint32_t circular_buffer_write(
  */
 uint32_t circular_buffer_read(CircularBuffer *cb, uint8_t *data, uint32_t len);
 
+/**
+ * @brief Get the contiguous run of bytes at the read end of a circular buffer
+ *
+ * Lets a consumer hand buffered data to another API without copying it out
+ * first. The run ends at the end of the backing memory, so a second call
+ * after circular_buffer_consume may return the rest.
+ *
+ * @param cb Pointer to circular buffer structure
+ * @param span Set to the first readable byte
+ * @return Number of contiguous bytes readable at *span
+ */
+uint32_t circular_buffer_peek_span(CircularBuffer *cb, uint8_t const **span);
+
+/**
+ * @brief Remove bytes from the read end of a circular buffer
+ *
+ * @param cb Pointer to circular buffer structure
+ * @param len Number of bytes to remove, at most circular_buffer_available
+ */
+void circular_buffer_consume(CircularBuffer *cb, uint32_t len);
+
+/**
+ * @brief Get the contiguous free run at the write end of a circular buffer
+ *
+ * Lets a producer fill the buffer directly from another API. The data only
+ * becomes readable once circular_buffer_commit is called.
+ *
+ * @param cb Pointer to circular buffer structure
+ * @param span Set to the first writable byte
+ * @return Number of contiguous bytes writable at *span
+ */
+uint32_t circular_buffer_reserve_span(CircularBuffer *cb, uint8_t **span);
+
+/**
+ * @brief Make bytes written to a reserved span readable
+ *
+ * @param cb Pointer to circular buffer structure
+ * @param len Number of bytes written, at most the reserved span length
+ */
+void circular_buffer_commit(CircularBuffer *cb, uint32_t len);
+
 /**
  * @brief Get free space in circular buffer
  *
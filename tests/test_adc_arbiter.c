@@ -0,0 +1,712 @@
+/**
+ * @file test_adc_arbiter.c
+ * @brief Unit tests for the ADC resource arbiter
+ *
+ * This file contains unit tests for the ADC arbiter, including queueing,
+ * priority preemption, time slicing, completion handling, error handling and
+ * the trigger timer pool.
+ * The ADC and timer low-level drivers and the platform tick are mocked using
+ * CMock; the cycle counter that times session switches is faked.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "unity.h"
+#include "fake_clock.h"
+#include "mock_adc_ll.h"
+#include "mock_platform.h"
+#include "mock_tim_ll.h"
+
+#include "util/error.h"
+#include "util/perf.h"
+
+#include "adc_arbiter.h"
+
+// Per-session callback bookkeeping
+typedef struct {
+    int grants;
+    int suspends;
+    int completions;
+} SessionEvents;
+
+// Test fixtures
+static ADC_ARB_Session *g_sessions[ADC_ARB_MAX_SESSIONS];
+static SessionEvents g_events[ADC_ARB_MAX_SESSIONS];
+static uint32_t g_tick;
+static ADC_LL_CompleteCallback g_adc_callback;
+static ADC_LL_HalfCompleteCallback g_adc_half_callback;
+static ADC_LL_Config g_last_adc_config;
+static uint32_t g_last_trigger_frequency;
+static int g_adc_init_count;
+static int g_adc_deinit_count;
+static int g_grant_order[8];
+static size_t g_grant_count;
+
+uint32_t get_tick_stub(int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    return g_tick;
+}
+
+void set_complete_callback_stub(
+    ADC_LL_CompleteCallback callback,
+    int cmock_num_calls
+)
+{
+    (void)cmock_num_calls;
+    g_adc_callback = callback;
+}
+
+void set_half_complete_callback_stub(
+    ADC_LL_HalfCompleteCallback callback,
+    int cmock_num_calls
+)
+{
+    (void)cmock_num_calls;
+    g_adc_half_callback = callback;
+}
+
+void adc_init_stub(ADC_LL_Config const *config, int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    g_last_adc_config = *config;
+    g_adc_init_count++;
+}
+
+void adc_init_fail_stub(ADC_LL_Config const *config, int cmock_num_calls)
+{
+    (void)config;
+    (void)cmock_num_calls;
+    THROW(ERROR_HARDWARE_FAULT);
+}
+
+void adc_deinit_stub(int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    g_adc_deinit_count++;
+}
+
+// Simulated duration of ADC setup and teardown in CPU cycles
+enum { ADC_INIT_CYCLES = 3000, ADC_DEINIT_CYCLES = 1000 };
+
+void adc_init_slow_stub(ADC_LL_Config const *config, int cmock_num_calls)
+{
+    adc_init_stub(config, cmock_num_calls);
+    FAKE_CLOCK_advance_cycles(ADC_INIT_CYCLES);
+}
+
+void adc_deinit_slow_stub(int cmock_num_calls)
+{
+    adc_deinit_stub(cmock_num_calls);
+    FAKE_CLOCK_advance_cycles(ADC_DEINIT_CYCLES);
+}
+
+void tim_init_stub(TIM_Num tim, uint32_t freq, int cmock_num_calls)
+{
+    (void)tim;
+    (void)cmock_num_calls;
+    g_last_trigger_frequency = freq;
+}
+
+void on_grant(void *context)
+{
+    int index = *(int *)context;
+    g_events[index].grants++;
+    if (g_grant_count < sizeof(g_grant_order) / sizeof(g_grant_order[0])) {
+        g_grant_order[g_grant_count++] = index;
+    }
+}
+
+void on_grant_fail(void *context)
+{
+    (void)context;
+    THROW(ERROR_HARDWARE_FAULT);
+}
+
+void on_suspend(void *context)
+{
+    int index = *(int *)context;
+    g_events[index].suspends++;
+}
+
+void on_complete(uint16_t *buffer, uint32_t total_samples)
+{
+    (void)buffer;
+    (void)total_samples;
+    g_events[0].completions++;
+}
+
+void on_half_complete(
+    uint16_t *buffer,
+    uint32_t half,
+    uint32_t total_samples,
+    uint32_t block
+)
+{
+    (void)buffer;
+    (void)half;
+    (void)total_samples;
+    (void)block;
+}
+
+static int g_indices[ADC_ARB_MAX_SESSIONS] = { 0, 1, 2, 3 };
+
+void setUp(void)
+{
+    memset(g_sessions, 0, sizeof(g_sessions));
+    memset(g_events, 0, sizeof(g_events));
+    memset(&g_last_adc_config, 0, sizeof(g_last_adc_config));
+    g_tick = 0;
+    g_adc_callback = NULL;
+    g_adc_half_callback = NULL;
+    g_last_trigger_frequency = 0;
+    g_adc_init_count = 0;
+    g_adc_deinit_count = 0;
+    g_grant_count = 0;
+
+    FAKE_CLOCK_reset();
+    (void)PERF_take(PERF_SOURCE_ADC_SWITCH);
+
+    mock_adc_ll_Init();
+    mock_tim_ll_Init();
+    mock_platform_Init();
+
+    PLATFORM_get_tick_StubWithCallback(get_tick_stub);
+    ADC_LL_set_complete_callback_StubWithCallback(set_complete_callback_stub);
+    ADC_LL_set_half_complete_callback_StubWithCallback(
+        set_half_complete_callback_stub
+    );
+    ADC_LL_set_segment_callback_Ignore();
+    ADC_LL_init_StubWithCallback(adc_init_stub);
+    ADC_LL_deinit_StubWithCallback(adc_deinit_stub);
+    TIM_LL_init_StubWithCallback(tim_init_stub);
+    ADC_LL_stop_Ignore();
+    TIM_LL_stop_Ignore();
+    TIM_LL_deinit_Ignore();
+}
+
+void tearDown(void)
+{
+    // Return every session to the pool so tests stay independent
+    for (size_t i = 0; i < ADC_ARB_MAX_SESSIONS; i++) {
+        if (g_sessions[i] != NULL) {
+            ADC_ARB_release(g_sessions[i]);
+            g_sessions[i] = NULL;
+        }
+    }
+
+    mock_adc_ll_Destroy();
+    mock_tim_ll_Destroy();
+    mock_platform_Destroy();
+}
+
+// Helper function to build a session request
+static ADC_ARB_Request make_request(int index, ADC_ARB_Priority priority)
+{
+    ADC_ARB_Request request = {
+        .adc_config = {
+            .channels = { ADC_LL_CHANNEL_0, ADC_LL_CHANNEL_0 },
+            .mode = ADC_LL_MODE_SINGLE,
+            .trigger_source = ADC_TRIGGER_TIMER6,
+            .buffer_size = 16,
+            .oversampling_ratio = 1,
+        },
+        .complete_callback = on_complete,
+        .timer = TIM_NUM_6,
+        .trigger_frequency = 1000U * (uint32_t)(index + 1),
+        .priority = priority,
+        .slice_ms = 0,
+        .on_grant = on_grant,
+        .on_suspend = on_suspend,
+        .context = &g_indices[index],
+    };
+    return request;
+}
+
+// Helper function to request a session and track it for cleanup
+static ADC_ARB_Session *request_session(ADC_ARB_Request const *request)
+{
+    int index = *(int *)request->context;
+    g_sessions[index] = ADC_ARB_request(request);
+    return g_sessions[index];
+}
+
+// Helper function to release a tracked session
+static void release_session(int index)
+{
+    ADC_ARB_release(g_sessions[index]);
+    g_sessions[index] = NULL;
+}
+
+void test_ADC_ARB_request_grants_free_adc(void)
+{
+    // Arrange
+    ADC_ARB_Request request = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+
+    // Act
+    ADC_ARB_Session *session = request_session(&request);
+
+    // Assert
+    TEST_ASSERT_NOT_NULL(session);
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(session));
+    TEST_ASSERT_EQUAL_INT(1, g_events[0].grants);
+    TEST_ASSERT_EQUAL_INT(1, g_adc_init_count);
+    TEST_ASSERT_EQUAL_UINT32(1000, g_last_trigger_frequency);
+    TEST_ASSERT_NOT_NULL(g_adc_callback);
+    TEST_ASSERT_EQUAL_UINT32(0, ADC_ARB_get_queue_length());
+}
+
+void test_ADC_ARB_request_queues_when_busy(void)
+{
+    // Arrange
+    ADC_ARB_Request first = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    ADC_ARB_Request second = make_request(1, ADC_ARB_PRIORITY_NORMAL);
+    request_session(&first);
+
+    // Act
+    ADC_ARB_Session *session = request_session(&second);
+
+    // Assert
+    TEST_ASSERT_NOT_NULL(session);
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_WAITING, ADC_ARB_get_state(session));
+    TEST_ASSERT_EQUAL_INT(0, g_events[1].grants);
+    TEST_ASSERT_EQUAL_UINT32(1, ADC_ARB_get_queue_length());
+}
+
+void test_ADC_ARB_release_grants_next_session(void)
+{
+    // Arrange
+    ADC_ARB_Request first = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    ADC_ARB_Request second = make_request(1, ADC_ARB_PRIORITY_NORMAL);
+    request_session(&first);
+    request_session(&second);
+
+    // Act
+    release_session(0);
+
+    // Assert
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(g_sessions[1]));
+    TEST_ASSERT_EQUAL_INT(1, g_events[1].grants);
+    TEST_ASSERT_EQUAL_INT(1, g_adc_deinit_count);
+    TEST_ASSERT_EQUAL_UINT32(2000, g_last_trigger_frequency);
+    TEST_ASSERT_EQUAL_UINT32(0, ADC_ARB_get_queue_length());
+}
+
+void test_ADC_ARB_higher_priority_preempts(void)
+{
+    // Arrange
+    ADC_ARB_Request low = make_request(0, ADC_ARB_PRIORITY_LOW);
+    ADC_ARB_Request high = make_request(1, ADC_ARB_PRIORITY_HIGH);
+    request_session(&low);
+
+    // Act
+    request_session(&high);
+
+    // Assert
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_WAITING, ADC_ARB_get_state(g_sessions[0]));
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(g_sessions[1]));
+    TEST_ASSERT_EQUAL_INT(1, g_events[0].suspends);
+    TEST_ASSERT_EQUAL_INT(1, g_events[1].grants);
+}
+
+void test_ADC_ARB_lower_priority_waits_for_slice(void)
+{
+    // Arrange
+    ADC_ARB_Request high = make_request(0, ADC_ARB_PRIORITY_HIGH);
+    ADC_ARB_Request low = make_request(1, ADC_ARB_PRIORITY_LOW);
+    high.slice_ms = 10;
+    request_session(&high);
+    request_session(&low);
+
+    // Act
+    g_tick = 100;
+    ADC_ARB_task();
+
+    // Assert
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(g_sessions[0]));
+    TEST_ASSERT_EQUAL_INT(0, g_events[0].suspends);
+    TEST_ASSERT_EQUAL_INT(0, g_events[1].grants);
+}
+
+void test_ADC_ARB_equal_priority_rotates_on_slice_expiry(void)
+{
+    // Arrange
+    ADC_ARB_Request first = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    ADC_ARB_Request second = make_request(1, ADC_ARB_PRIORITY_NORMAL);
+    first.slice_ms = 10;
+    second.slice_ms = 10;
+    request_session(&first);
+    request_session(&second);
+
+    // Act & Assert: slice not yet expired
+    g_tick = 9;
+    ADC_ARB_task();
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(g_sessions[0]));
+
+    // Act & Assert: first slice expired, second session granted
+    g_tick = 10;
+    ADC_ARB_task();
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_WAITING, ADC_ARB_get_state(g_sessions[0]));
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(g_sessions[1]));
+    TEST_ASSERT_EQUAL_INT(1, g_events[0].suspends);
+
+    // Act & Assert: second slice expired, first session granted again
+    g_tick = 20;
+    ADC_ARB_task();
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(g_sessions[0]));
+    TEST_ASSERT_EQUAL_INT(2, g_events[0].grants);
+    TEST_ASSERT_EQUAL_INT(1000, g_last_trigger_frequency);
+}
+
+void test_ADC_ARB_switch_cost_is_recorded(void)
+{
+    // Arrange
+    ADC_LL_init_StubWithCallback(adc_init_slow_stub);
+    ADC_LL_deinit_StubWithCallback(adc_deinit_slow_stub);
+    ADC_ARB_Request first = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    ADC_ARB_Request second = make_request(1, ADC_ARB_PRIORITY_NORMAL);
+    first.slice_ms = 10;
+    second.slice_ms = 10;
+    request_session(&first);
+    request_session(&second);
+
+    // Act
+    g_tick = 9;
+    ADC_ARB_task();
+    g_tick = 10;
+    ADC_ARB_task();
+
+    // Assert - the first grant only sets up, the rotation also tears down;
+    // queueing and passes without a switch are not recorded
+    PERF_Stats stats = PERF_take(PERF_SOURCE_ADC_SWITCH);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(ADC_INIT_CYCLES, stats.min_cycles);
+    TEST_ASSERT_EQUAL_UINT32(
+        ADC_INIT_CYCLES + ADC_DEINIT_CYCLES, stats.max_cycles
+    );
+    TEST_ASSERT_EQUAL_UINT64(
+        2 * ADC_INIT_CYCLES + ADC_DEINIT_CYCLES, stats.total_cycles
+    );
+}
+
+void test_ADC_ARB_no_rotation_without_slice(void)
+{
+    // Arrange
+    ADC_ARB_Request first = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    ADC_ARB_Request second = make_request(1, ADC_ARB_PRIORITY_NORMAL);
+    request_session(&first);
+    request_session(&second);
+
+    // Act
+    g_tick = 1000000;
+    ADC_ARB_task();
+
+    // Assert
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(g_sessions[0]));
+    TEST_ASSERT_EQUAL_INT(0, g_events[1].grants);
+}
+
+void test_ADC_ARB_equal_priority_is_fifo(void)
+{
+    // Arrange
+    ADC_ARB_Request first = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    ADC_ARB_Request second = make_request(1, ADC_ARB_PRIORITY_NORMAL);
+    ADC_ARB_Request third = make_request(2, ADC_ARB_PRIORITY_NORMAL);
+    request_session(&first);
+    request_session(&second);
+    request_session(&third);
+
+    // Act
+    release_session(0);
+    release_session(1);
+
+    // Assert
+    TEST_ASSERT_EQUAL_size_t(3, g_grant_count);
+    TEST_ASSERT_EQUAL_INT(0, g_grant_order[0]);
+    TEST_ASSERT_EQUAL_INT(1, g_grant_order[1]);
+    TEST_ASSERT_EQUAL_INT(2, g_grant_order[2]);
+}
+
+void test_ADC_ARB_completion_hands_adc_on(void)
+{
+    // Arrange
+    ADC_ARB_Request first = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    ADC_ARB_Request second = make_request(1, ADC_ARB_PRIORITY_NORMAL);
+    request_session(&first);
+    request_session(&second);
+    TEST_ASSERT_NOT_NULL(g_adc_callback);
+
+    // Act & Assert: the DMA transfer completes in interrupt context
+    uint16_t buffer[16] = { 0 };
+    g_adc_callback(buffer, 16);
+    TEST_ASSERT_EQUAL_INT(1, g_events[0].completions);
+    TEST_ASSERT_EQUAL(
+        ADC_ARB_STATE_FINISHED, ADC_ARB_get_state(g_sessions[0])
+    );
+
+    // Act & Assert: servicing the arbiter hands the ADC on, but the finished
+    // session keeps its slot until its owner releases it
+    ADC_ARB_task();
+    TEST_ASSERT_EQUAL(
+        ADC_ARB_STATE_FINISHED, ADC_ARB_get_state(g_sessions[0])
+    );
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(g_sessions[1]));
+    TEST_ASSERT_EQUAL_INT(1, g_adc_deinit_count);
+    TEST_ASSERT_EQUAL_UINT32(0, ADC_ARB_get_queue_length());
+}
+
+void test_ADC_ARB_release_finished_session_keeps_next_running(void)
+{
+    // Arrange
+    ADC_ARB_Request first = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    ADC_ARB_Request second = make_request(1, ADC_ARB_PRIORITY_NORMAL);
+    request_session(&first);
+    request_session(&second);
+    uint16_t buffer[16] = { 0 };
+    g_adc_callback(buffer, 16);
+    ADC_ARB_task();
+
+    // Act: the owner of the finished session releases it late
+    release_session(0);
+
+    // Assert: the acquisition of the next session is left alone
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(g_sessions[1]));
+    TEST_ASSERT_EQUAL_INT(1, g_adc_deinit_count);
+    TEST_ASSERT_EQUAL_INT(1, g_events[1].grants);
+}
+
+void test_ADC_ARB_finished_session_slot_is_not_reused(void)
+{
+    // Arrange: finish one session, then fill the rest of the pool
+    ADC_ARB_Request first = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    request_session(&first);
+    uint16_t buffer[16] = { 0 };
+    g_adc_callback(buffer, 16);
+    ADC_ARB_task();
+
+    for (int i = 1; i < ADC_ARB_MAX_SESSIONS; i++) {
+        ADC_ARB_Request request = make_request(i, ADC_ARB_PRIORITY_NORMAL);
+        TEST_ASSERT_NOT_EQUAL(g_sessions[0], request_session(&request));
+    }
+
+    // Act
+    ADC_ARB_Request extra = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    Error error = ERROR_NONE;
+    TRY { ADC_ARB_request(&extra); }
+    CATCH(error) {}
+
+    // Assert
+    TEST_ASSERT_EQUAL(ERROR_OUT_OF_MEMORY, error);
+    TEST_ASSERT_EQUAL(
+        ADC_ARB_STATE_FINISHED, ADC_ARB_get_state(g_sessions[0])
+    );
+}
+
+void test_ADC_ARB_half_complete_callback_follows_session(void)
+{
+    // Arrange
+    ADC_ARB_Request streaming = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    streaming.adc_config.circular = true;
+    streaming.half_complete_callback = on_half_complete;
+    ADC_ARB_Request other = make_request(1, ADC_ARB_PRIORITY_HIGH);
+
+    // Act & Assert: granted session installs its half-transfer callback
+    request_session(&streaming);
+    TEST_ASSERT_TRUE(g_last_adc_config.circular);
+    TEST_ASSERT_EQUAL_PTR(on_half_complete, g_adc_half_callback);
+
+    // Act & Assert: preempting session without one clears it
+    request_session(&other);
+    TEST_ASSERT_NULL(g_adc_half_callback);
+
+    // Act & Assert: resumed session installs it again
+    release_session(1);
+    TEST_ASSERT_EQUAL_PTR(on_half_complete, g_adc_half_callback);
+}
+
+void test_ADC_ARB_grant_failure_marks_session_failed(void)
+{
+    // Arrange
+    ADC_ARB_Request request = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    ADC_LL_init_StubWithCallback(adc_init_fail_stub);
+
+    // Act
+    ADC_ARB_Session *session = request_session(&request);
+
+    // Assert
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_FAILED, ADC_ARB_get_state(session));
+    TEST_ASSERT_EQUAL_INT(0, g_events[0].grants);
+    TEST_ASSERT_EQUAL_UINT32(0, ADC_ARB_get_queue_length());
+}
+
+void test_ADC_ARB_grant_callback_failure_frees_adc(void)
+{
+    // Arrange
+    ADC_ARB_Request failing = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    ADC_ARB_Request next = make_request(1, ADC_ARB_PRIORITY_NORMAL);
+    failing.on_grant = on_grant_fail;
+
+    // Act
+    request_session(&failing);
+    request_session(&next);
+
+    // Assert
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_FAILED, ADC_ARB_get_state(g_sessions[0]));
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(g_sessions[1]));
+    TEST_ASSERT_EQUAL_INT(1, g_adc_deinit_count);
+}
+
+void test_ADC_ARB_request_null(void)
+{
+    // Act & Assert
+    Error error = ERROR_NONE;
+    TRY { ADC_ARB_request(NULL); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+}
+
+void test_ADC_ARB_request_invalid_arguments(void)
+{
+    ADC_ARB_Request request = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    Error error = ERROR_NONE;
+
+    // Zero trigger frequency
+    request.trigger_frequency = 0;
+    TRY { ADC_ARB_request(&request); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+
+    // Invalid timer
+    request = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    request.timer = TIM_NUM_COUNT;
+    error = ERROR_NONE;
+    TRY { ADC_ARB_request(&request); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+
+    // Trigger source driven by another timer
+    request = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    request.adc_config.trigger_source = ADC_TRIGGER_TIMER3;
+    error = ERROR_NONE;
+    TRY { ADC_ARB_request(&request); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+
+    // Invalid priority
+    request = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    request.priority = (ADC_ARB_Priority)(ADC_ARB_PRIORITY_HIGH + 1);
+    error = ERROR_NONE;
+    TRY { ADC_ARB_request(&request); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+}
+
+void test_ADC_ARB_request_pool_full(void)
+{
+    // Arrange
+    for (int i = 0; i < ADC_ARB_MAX_SESSIONS; i++) {
+        ADC_ARB_Request request = make_request(i, ADC_ARB_PRIORITY_NORMAL);
+        request_session(&request);
+    }
+
+    // Act
+    ADC_ARB_Request extra = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    Error error = ERROR_NONE;
+    TRY { ADC_ARB_request(&extra); }
+    CATCH(error) {}
+
+    // Assert
+    TEST_ASSERT_EQUAL(ERROR_OUT_OF_MEMORY, error);
+    TEST_ASSERT_EQUAL_UINT32(
+        ADC_ARB_MAX_SESSIONS - 1, ADC_ARB_get_queue_length()
+    );
+}
+
+void test_ADC_ARB_get_state_invalid(void)
+{
+    // Act & Assert
+    Error error = ERROR_NONE;
+    TRY { ADC_ARB_get_state(NULL); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+}
+
+void test_ADC_ARB_release_null_is_ignored(void)
+{
+    // Act & Assert: must not crash or throw
+    ADC_ARB_release(NULL);
+    TEST_ASSERT_EQUAL_UINT32(0, ADC_ARB_get_queue_length());
+}
+
+void test_ADC_ARB_acquire_trigger_hands_out_distinct_timers(void)
+{
+    ADC_ARB_Trigger triggers[TIM_NUM_COUNT];
+    size_t count = 0;
+    Error error = ERROR_NONE;
+
+    // Act - take timers until the pool is empty
+    while (error == ERROR_NONE && count < TIM_NUM_COUNT) {
+        TRY { triggers[count++] = ADC_ARB_acquire_trigger(); }
+        CATCH(error) { count--; }
+    }
+
+    // Assert - TIM6 first, TIM2 last, every timer once
+    TEST_ASSERT_EQUAL(ERROR_RESOURCE_BUSY, error);
+    TEST_ASSERT_EQUAL_size_t(7, count);
+    TEST_ASSERT_EQUAL(TIM_NUM_6, triggers[0].timer);
+    TEST_ASSERT_EQUAL(ADC_TRIGGER_TIMER6, triggers[0].trigger_source);
+    TEST_ASSERT_EQUAL(TIM_NUM_2, triggers[count - 1].timer);
+    TEST_ASSERT_EQUAL(ADC_TRIGGER_TIMER2, triggers[count - 1].trigger_source);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count; j++) {
+            TEST_ASSERT_NOT_EQUAL(triggers[i].timer, triggers[j].timer);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        ADC_ARB_release_trigger(triggers[i].timer);
+    }
+}
+
+void test_ADC_ARB_release_trigger_returns_timer_to_pool(void)
+{
+    // Arrange
+    ADC_ARB_Trigger const first = ADC_ARB_acquire_trigger();
+    ADC_ARB_Trigger const second = ADC_ARB_acquire_trigger();
+
+    // Act
+    ADC_ARB_release_trigger(first.timer);
+    ADC_ARB_Trigger const again = ADC_ARB_acquire_trigger();
+
+    // Assert
+    TEST_ASSERT_EQUAL(first.timer, again.timer);
+    TEST_ASSERT_NOT_EQUAL(first.timer, second.timer);
+
+    ADC_ARB_release_trigger(again.timer);
+    ADC_ARB_release_trigger(second.timer);
+}
+
+void test_ADC_ARB_request_with_pooled_trigger(void)
+{
+    // Arrange - a session on the second timer of the pool
+    ADC_ARB_Trigger const first = ADC_ARB_acquire_trigger();
+    ADC_ARB_Trigger const second = ADC_ARB_acquire_trigger();
+    ADC_ARB_Request request = make_request(0, ADC_ARB_PRIORITY_NORMAL);
+    request.timer = second.timer;
+    request.adc_config.trigger_source = second.trigger_source;
+
+    // Act
+    ADC_ARB_Session *session = request_session(&request);
+
+    // Assert
+    TEST_ASSERT_EQUAL(ADC_ARB_STATE_ACTIVE, ADC_ARB_get_state(session));
+
+    release_session(0);
+    ADC_ARB_release_trigger(second.timer);
+    ADC_ARB_release_trigger(first.timer);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file test_boot.c
+ * @brief Unit tests for boot sequencing and boot-time profiling
+ *
+ * This file contains unit tests for the boot phase timestamps and for the
+ * deferred init that waits for USB enumeration. Time is driven by the fake
+ * cycle counter; the HAL tick and the USB state are mocked.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "unity.h"
+#include "fake_clock.h"
+#include "mock_platform.h"
+#include "mock_usb_ll.h"
+
+#include "system.h"
+
+// Implemented in timebase.c and boot.c, called from SYSTEM_init on target
+void timebase_init(void);
+void boot_init(void);
+
+static int g_deferred_calls;
+
+// Stands in for the deferred init in system.c
+void system_init_deferred(void)
+{
+    g_deferred_calls++;
+    SYSTEM_boot_mark(SYSTEM_BOOT_LOGGING);
+}
+
+void setUp(void)
+{
+    FAKE_CLOCK_reset();
+    timebase_init();
+    g_deferred_calls = 0;
+
+    // Clock setup took 5 ms after reset
+    PLATFORM_get_tick_ExpectAndReturn(5);
+    boot_init();
+}
+
+void tearDown(void) {}
+
+void test_boot_init_marks_clocks_from_hal_tick(void)
+{
+    SYSTEM_BootTiming timing = SYSTEM_get_boot_timing();
+
+    TEST_ASSERT_EQUAL_UINT64(5000, timing.phase_us[SYSTEM_BOOT_CLOCKS]);
+    TEST_ASSERT_EQUAL_UINT64(0, timing.phase_us[SYSTEM_BOOT_USB_INIT]);
+}
+
+void test_boot_mark_is_relative_to_reset_and_recorded_once(void)
+{
+    FAKE_CLOCK_advance_us(1500);
+    SYSTEM_boot_mark(SYSTEM_BOOT_USB_INIT);
+    FAKE_CLOCK_advance_us(1000);
+    SYSTEM_boot_mark(SYSTEM_BOOT_USB_INIT);
+
+    SYSTEM_BootTiming timing = SYSTEM_get_boot_timing();
+    TEST_ASSERT_EQUAL_UINT64(6500, timing.phase_us[SYSTEM_BOOT_USB_INIT]);
+}
+
+void test_boot_task_waits_for_enumeration(void)
+{
+    USB_LL_mounted_ExpectAndReturn(false);
+    TEST_ASSERT_FALSE(SYSTEM_boot_task());
+    TEST_ASSERT_EQUAL_INT(0, g_deferred_calls);
+
+    FAKE_CLOCK_advance_us(20000);
+    USB_LL_mounted_ExpectAndReturn(true);
+    TEST_ASSERT_TRUE(SYSTEM_boot_task());
+    TEST_ASSERT_EQUAL_INT(1, g_deferred_calls);
+
+    SYSTEM_BootTiming timing = SYSTEM_get_boot_timing();
+    TEST_ASSERT_EQUAL_UINT64(
+        25000, timing.phase_us[SYSTEM_BOOT_USB_ENUMERATED]
+    );
+    TEST_ASSERT_EQUAL_UINT64(25000, timing.phase_us[SYSTEM_BOOT_LOGGING]);
+    TEST_ASSERT_EQUAL_UINT64(25000, timing.phase_us[SYSTEM_BOOT_COMPLETE]);
+}
+
+void test_boot_task_runs_deferred_init_once(void)
+{
+    USB_LL_mounted_ExpectAndReturn(true);
+    TEST_ASSERT_TRUE(SYSTEM_boot_task());
+    USB_LL_mounted_ExpectAndReturn(true);
+    TEST_ASSERT_TRUE(SYSTEM_boot_task());
+
+    TEST_ASSERT_EQUAL_INT(1, g_deferred_calls);
+}
+
+void test_boot_task_finishes_without_usb_after_timeout(void)
+{
+    // 5 ms already passed at boot_init
+    FAKE_CLOCK_advance_us(994999);
+    USB_LL_mounted_ExpectAndReturn(false);
+    TEST_ASSERT_FALSE(SYSTEM_boot_task());
+
+    FAKE_CLOCK_advance_us(1);
+    USB_LL_mounted_ExpectAndReturn(false);
+    TEST_ASSERT_TRUE(SYSTEM_boot_task());
+    TEST_ASSERT_EQUAL_INT(1, g_deferred_calls);
+
+    SYSTEM_BootTiming timing = SYSTEM_get_boot_timing();
+    TEST_ASSERT_EQUAL_UINT64(0, timing.phase_us[SYSTEM_BOOT_USB_ENUMERATED]);
+    TEST_ASSERT_EQUAL_UINT64(1000000, timing.phase_us[SYSTEM_BOOT_COMPLETE]);
+
+    // Late enumeration is still recorded
+    FAKE_CLOCK_advance_us(300000);
+    USB_LL_mounted_ExpectAndReturn(true);
+    TEST_ASSERT_TRUE(SYSTEM_boot_task());
+    timing = SYSTEM_get_boot_timing();
+    TEST_ASSERT_EQUAL_UINT64(
+        1300000, timing.phase_us[SYSTEM_BOOT_USB_ENUMERATED]
+    );
+}
+
+void test_boot_finish_runs_deferred_init_without_usb(void)
+{
+    FAKE_CLOCK_advance_us(1000);
+    SYSTEM_boot_finish();
+    SYSTEM_boot_finish();
+    TEST_ASSERT_EQUAL_INT(1, g_deferred_calls);
+
+    SYSTEM_BootTiming timing = SYSTEM_get_boot_timing();
+    TEST_ASSERT_EQUAL_UINT64(6000, timing.phase_us[SYSTEM_BOOT_COMPLETE]);
+
+    // The boot task sees the boot as complete
+    USB_LL_mounted_ExpectAndReturn(false);
+    TEST_ASSERT_TRUE(SYSTEM_boot_task());
+    TEST_ASSERT_EQUAL_INT(1, g_deferred_calls);
+}
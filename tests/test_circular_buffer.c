@@ -398,3 +398,56 @@ void test_circular_buffer_boundary_conditions(void)
     // Verify data integrity
     TEST_ASSERT_EQUAL_UINT8_ARRAY(test_data, read_data, sizeof(test_data));
 }
+
+// Test span access up to the end of the backing memory
+void test_circular_buffer_spans_stop_at_wrap(void)
+{
+    uint8_t data[12];
+    uint8_t const *read_span = NULL;
+    uint8_t *write_span = NULL;
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+
+    // Move head and tail to index 12
+    circular_buffer_write(&g_test_buffer, data, 12);
+    circular_buffer_read(&g_test_buffer, data, 12);
+
+    // Free space runs to the end of memory, then restarts at index 0
+    TEST_ASSERT_EQUAL_UINT32(4, circular_buffer_reserve_span(&g_test_buffer, &write_span));
+    TEST_ASSERT_EQUAL_PTR(&g_test_data[12], write_span);
+    memset(write_span, 0xA5, 4);
+    circular_buffer_commit(&g_test_buffer, 4);
+
+    TEST_ASSERT_EQUAL_UINT32(11, circular_buffer_reserve_span(&g_test_buffer, &write_span));
+    TEST_ASSERT_EQUAL_PTR(&g_test_data[0], write_span);
+    write_span[0] = 0x5A;
+    circular_buffer_commit(&g_test_buffer, 1);
+
+    // Readable data is returned in the same two runs
+    TEST_ASSERT_EQUAL_UINT32(4, circular_buffer_peek_span(&g_test_buffer, &read_span));
+    TEST_ASSERT_EQUAL_UINT8(0xA5, read_span[3]);
+    circular_buffer_consume(&g_test_buffer, 4);
+
+    TEST_ASSERT_EQUAL_UINT32(1, circular_buffer_peek_span(&g_test_buffer, &read_span));
+    TEST_ASSERT_EQUAL_UINT8(0x5A, read_span[0]);
+    circular_buffer_consume(&g_test_buffer, 1);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&g_test_buffer));
+}
+
+// Test that spans cannot over-commit or over-consume
+void test_circular_buffer_span_bounds(void)
+{
+    Error exc = ERROR_NONE;
+
+    TRY { circular_buffer_consume(&g_test_buffer, 1); }
+    CATCH(exc) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, exc);
+
+    exc = ERROR_NONE;
+    TRY { circular_buffer_commit(&g_test_buffer, 16); }
+    CATCH(exc) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, exc);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&g_test_buffer));
+}
@@ -4,8 +4,7 @@
  *
  * This file contains comprehensive unit tests for the DMM API, including
  * initialization, configuration validation, voltage measurements, and
- * error handling. The ADC and Timer low-level drivers are mocked using
- * CMock.
+ * error handling. The ADC low-level driver is mocked using CMock.
  *
  * @author PSLab Team
  * @date 2025-08-12
@@ -17,7 +16,6 @@
 
 #include "unity.h"
 #include "mock_adc_ll.h"
-#include "mock_tim_ll.h"
 
 #include "util/error.h"
 #include "util/fixed_point.h"
@@ -26,14 +24,14 @@
 
 // External function declaration for testing
 // This function is intentionally non-static in dmm.c to enable testing
-extern void dmm_adc_complete_callback(uint16_t *buffer, uint32_t total_samples);
+extern void dmm_adc_complete_callback(uint16_t value);
 
 // Test fixtures
 static DMM_Handle *g_test_handle;
 static uint16_t g_mock_adc_value;
 static bool g_adc_callback_called;
-static ADC_LL_CompleteCallback g_stored_callback;
-static uint16_t *g_captured_adc_buffer; // Captured from ADC_LL_init
+static ADC_LL_InjectedCompleteCallback g_stored_callback;
+static ADC_LL_InjectedConfig g_captured_adc_config; // From ADC_LL_injected_init
 
 void setUp(void)
 {
@@ -42,11 +40,10 @@ void setUp(void)
     g_mock_adc_value = 0;
     g_adc_callback_called = false;
     g_stored_callback = NULL;
-    g_captured_adc_buffer = NULL;
+    memset(&g_captured_adc_config, 0, sizeof(g_captured_adc_config));
 
     // Initialize mocks
     mock_adc_ll_Init();
-    mock_tim_ll_Init();
 }
 
 void tearDown(void)
@@ -54,10 +51,7 @@ void tearDown(void)
     // Clean up DMM handle if it exists
     if (g_test_handle != NULL) {
         // Set up expectations for deinit - use Ignore to be flexible
-        ADC_LL_stop_Ignore();
-        TIM_LL_stop_Ignore();
-        ADC_LL_deinit_Ignore();
-        TIM_LL_deinit_Ignore();
+        ADC_LL_injected_deinit_Ignore();
 
         DMM_deinit(g_test_handle);
         g_test_handle = NULL;
@@ -65,11 +59,10 @@ void tearDown(void)
 
     // Clean up mocks after each test
     mock_adc_ll_Destroy();
-    mock_tim_ll_Destroy();
 }
 
 // Helper function to capture ADC callback
-void capture_adc_callback_stub(ADC_LL_CompleteCallback callback, int cmock_num_calls)
+void capture_adc_callback_stub(ADC_LL_InjectedCompleteCallback callback, int cmock_num_calls)
 {
     (void)cmock_num_calls;
     g_stored_callback = callback;
@@ -78,30 +71,22 @@ void capture_adc_callback_stub(ADC_LL_CompleteCallback callback, int cmock_num_c
 // Helper function to simulate ADC conversion with specific value
 void simulate_adc_conversion(uint16_t adc_value)
 {
-    // Set the ADC value in the captured buffer (simulates hardware writing to buffer)
-    if (g_captured_adc_buffer != NULL) {
-        *g_captured_adc_buffer = adc_value;
-    }
-
-    // Call the completion callback to notify DMM
+    // Call the completion callback with the result, as the ADC ISR would
     if (g_stored_callback != NULL) {
-        g_stored_callback(NULL, 0);
+        g_stored_callback(adc_value);
     }
 }
 
 // Stub function to simulate ADC initialization success
-void adc_init_success_stub(ADC_LL_Config const *config, int cmock_num_calls)
+void adc_init_success_stub(ADC_LL_InjectedConfig const *config, int cmock_num_calls)
 {
     (void)cmock_num_calls;
     // Verify config is reasonable
     TEST_ASSERT_NOT_NULL(config);
-    TEST_ASSERT_EQUAL(ADC_LL_MODE_SINGLE, config->mode);
-    TEST_ASSERT_EQUAL(ADC_TRIGGER_TIMER6, config->trigger_source);
-    TEST_ASSERT_NOT_NULL(config->output_buffer);
-    TEST_ASSERT_EQUAL(1, config->buffer_size);
+    TEST_ASSERT_TRUE(config->channel <= ADC_LL_CHANNEL_15);
 
-    // Capture the output buffer for later use
-    g_captured_adc_buffer = config->output_buffer;
+    // Capture the config for later checks
+    g_captured_adc_config = *config;
 }
 
 // Test: Successful DMM initialization with default configuration
@@ -111,13 +96,9 @@ void test_DMM_init_success_default_config(void)
     DMM_Config config = DMM_CONFIG_DEFAULT;
 
     // Set expectations
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_Stub(adc_init_success_stub);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000); // 1 kHz sample rate for timer init
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000); // 1 kHz sample rate for logging
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6); // Expect timer start for initial conversion
-    ADC_LL_start_Expect(); // Expect ADC start for initial conversion
+    ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+    ADC_LL_injected_init_Stub(adc_init_success_stub);
+    ADC_LL_injected_start_Expect(); // Expect ADC start for initial conversion
 
     // Act
     g_test_handle = DMM_init(&config);
@@ -136,13 +117,9 @@ void test_DMM_init_success_custom_config(void)
     };
 
     // Set expectations
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_Ignore();
-    ADC_LL_get_sample_rate_ExpectAndReturn(2000); // 2 kHz sample rate for timer init
-    ADC_LL_get_sample_rate_ExpectAndReturn(2000); // 2 kHz sample rate for logging
-    TIM_LL_init_Expect(TIM_NUM_6, 2000);
-    TIM_LL_start_Expect(TIM_NUM_6); // Expect timer start for initial conversion
-    ADC_LL_start_Expect(); // Expect ADC start for initial conversion
+    ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+    ADC_LL_injected_init_Ignore();
+    ADC_LL_injected_start_Expect(); // Expect ADC start for initial conversion
 
     // Act
     g_test_handle = DMM_init(&config);
@@ -214,13 +191,9 @@ void test_DMM_init_already_initialized(void)
     CEXCEPTION_T exception = CEXCEPTION_NONE;
 
     // First initialization
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_Ignore();
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6);
-    ADC_LL_start_Expect();
+    ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+    ADC_LL_injected_init_Ignore();
+    ADC_LL_injected_start_Expect();
 
     g_test_handle = DMM_init(&config);
     TEST_ASSERT_NOT_NULL(g_test_handle);
@@ -243,9 +216,8 @@ void test_DMM_init_adc_failure(void)
     CEXCEPTION_T exception = CEXCEPTION_NONE;
 
     // Set expectations
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_ExpectAndThrow(NULL, ERROR_HARDWARE_FAULT);
-    ADC_LL_init_IgnoreArg_config(); // Ignore the config parameter
+    ADC_LL_injected_init_ExpectAndThrow(NULL, ERROR_HARDWARE_FAULT);
+    ADC_LL_injected_init_IgnoreArg_config(); // Ignore the config parameter
 
     // Act & Assert
     TRY {
@@ -258,29 +230,30 @@ void test_DMM_init_adc_failure(void)
     }
 }
 
-// Test: DMM initialization with timer failure
-void test_DMM_init_timer_failure(void)
+// Test: DMM initialization passes the configuration to the injected group
+void test_DMM_init_injected_config(void)
 {
     // Arrange
-    DMM_Config config = DMM_CONFIG_DEFAULT;
-    CEXCEPTION_T exception = CEXCEPTION_NONE;
+    DMM_Config config = {
+        .channel = DMM_CHANNEL_7,
+        .oversampling_ratio = 32,
+        .high_resolution = true
+    };
 
-    // Set expectations - ADC init succeeds, but timer init fails
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_Ignore(); // ADC init succeeds
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000); // For timer init
-    TIM_LL_init_ExpectAndThrow(TIM_NUM_6, 1000, ERROR_HARDWARE_FAULT);
-    ADC_LL_deinit_Expect(); // Cleanup after timer failure
+    // Set expectations - only the injected group is touched, so a running
+    // regular (DSO) acquisition is left alone
+    ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+    ADC_LL_injected_init_Stub(adc_init_success_stub);
+    ADC_LL_injected_start_Expect();
 
-    // Act & Assert
-    TRY {
-        g_test_handle = DMM_init(&config);
-        TEST_FAIL_MESSAGE("Expected exception for timer initialization failure");
-    }
-    CATCH(exception) {
-        TEST_ASSERT_EQUAL(ERROR_HARDWARE_FAULT, exception);
-        TEST_ASSERT_NULL(g_test_handle);
-    }
+    // Act
+    g_test_handle = DMM_init(&config);
+
+    // Assert
+    TEST_ASSERT_NOT_NULL(g_test_handle);
+    TEST_ASSERT_EQUAL(ADC_LL_CHANNEL_7, g_captured_adc_config.channel);
+    TEST_ASSERT_EQUAL_UINT32(32, g_captured_adc_config.oversampling_ratio);
+    TEST_ASSERT_TRUE(g_captured_adc_config.high_resolution);
 }
 
 // Test: DMM deinitialization with valid handle
@@ -289,22 +262,15 @@ void test_DMM_deinit_valid_handle(void)
     // Arrange - Initialize DMM first
     DMM_Config config = DMM_CONFIG_DEFAULT;
 
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_Ignore();
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6);
-    ADC_LL_start_Expect();
+    ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+    ADC_LL_injected_init_Ignore();
+    ADC_LL_injected_start_Expect();
 
     g_test_handle = DMM_init(&config);
     TEST_ASSERT_NOT_NULL(g_test_handle);
 
     // Set expectations for deinit
-    ADC_LL_stop_Expect();
-    TIM_LL_stop_Expect(TIM_NUM_6);
-    ADC_LL_deinit_Expect();
-    TIM_LL_deinit_Expect(TIM_NUM_6);
+    ADC_LL_injected_deinit_Expect();
 
     // Act
     DMM_deinit(g_test_handle);
@@ -332,23 +298,19 @@ void test_DMM_read_voltage_success_conversion_ready(void)
     bool result;
 
     // Initialize DMM
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_Ignore();
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6);
-    ADC_LL_start_Expect();
+    ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+    ADC_LL_injected_init_Ignore();
+    ADC_LL_injected_start_Expect();
 
     g_test_handle = DMM_init(&config);
     TEST_ASSERT_NOT_NULL(g_test_handle);
 
     // Simulate a completed conversion by calling the callback directly
-    dmm_adc_complete_callback(NULL, 0);
+    dmm_adc_complete_callback(2048);
 
     // Expect reference voltage query and next conversion to be started
-    ADC_LL_get_reference_voltage_ExpectAndReturn(3300); // 3.3V in mV
-    ADC_LL_start_Expect();
+    ADC_LL_get_reference_voltage_ExpectAndReturn(NULL, 3300); // 3.3V in mV
+    ADC_LL_injected_start_Expect();
 
     // Act
     result = DMM_read_voltage(g_test_handle, &voltage_out);
@@ -366,13 +328,9 @@ void test_DMM_read_voltage_no_conversion_ready(void)
     bool result;
 
     // Initialize DMM
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_Ignore();
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6);
-    ADC_LL_start_Expect();
+    ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+    ADC_LL_injected_init_Ignore();
+    ADC_LL_injected_start_Expect();
 
     g_test_handle = DMM_init(&config);
     TEST_ASSERT_NOT_NULL(g_test_handle);
@@ -412,13 +370,9 @@ void test_DMM_read_voltage_null_output(void)
     CEXCEPTION_T exception = CEXCEPTION_NONE;
 
     // Initialize DMM
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_Ignore();
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6);
-    ADC_LL_start_Expect();
+    ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+    ADC_LL_injected_init_Ignore();
+    ADC_LL_injected_start_Expect();
 
     g_test_handle = DMM_init(&config);
     TEST_ASSERT_NOT_NULL(g_test_handle);
@@ -442,23 +396,19 @@ void test_DMM_read_voltage_adc_start_failure(void)
     bool result;
 
     // Initialize DMM first
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_Ignore();
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6);
-    ADC_LL_start_Expect(); // Initial start succeeds
+    ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+    ADC_LL_injected_init_Ignore();
+    ADC_LL_injected_start_Expect(); // Initial start succeeds
 
     g_test_handle = DMM_init(&config);
     TEST_ASSERT_NOT_NULL(g_test_handle);
 
     // Simulate a completed conversion
-    dmm_adc_complete_callback(NULL, 0);
+    dmm_adc_complete_callback(2048);
 
     // Expect reference voltage query and ADC restart to fail
-    ADC_LL_get_reference_voltage_ExpectAndReturn(3300); // 3.3V in mV
-    ADC_LL_start_ExpectAndThrow(ERROR_HARDWARE_FAULT);
+    ADC_LL_get_reference_voltage_ExpectAndReturn(NULL, 3300); // 3.3V in mV
+    ADC_LL_injected_start_ExpectAndThrow(ERROR_HARDWARE_FAULT);
 
     // Act - this should still return the valid measurement despite restart failure
     result = DMM_read_voltage(g_test_handle, &voltage_out);
@@ -469,23 +419,17 @@ void test_DMM_read_voltage_adc_start_failure(void)
 }
 
 // Test: DMM initialization with ADC start failure
-void test_DMM_read_voltage_timer_start_failure(void)
+void test_DMM_init_adc_start_failure(void)
 {
     // Arrange
     DMM_Config config = DMM_CONFIG_DEFAULT;
     CEXCEPTION_T exception = CEXCEPTION_NONE;
 
-    // Set expectations - ADC and timer init succeed, timer start succeeds, but ADC start fails
-    ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-    ADC_LL_init_Ignore(); // ADC init succeeds
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000); // For timer init
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000); // For logging
-    TIM_LL_init_Expect(TIM_NUM_6, 1000); // Timer init succeeds
-    TIM_LL_start_Expect(TIM_NUM_6); // Timer start succeeds
-    ADC_LL_start_ExpectAndThrow(ERROR_HARDWARE_FAULT); // ADC start fails
-    TIM_LL_stop_Expect(TIM_NUM_6); // Cleanup after start failure
-    ADC_LL_deinit_Expect(); // Cleanup after start failure
-    TIM_LL_deinit_Expect(TIM_NUM_6); // Cleanup after start failure
+    // Set expectations - ADC init succeeds, but the first conversion fails
+    ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+    ADC_LL_injected_init_Ignore(); // ADC init succeeds
+    ADC_LL_injected_start_ExpectAndThrow(ERROR_HARDWARE_FAULT); // ADC start fails
+    ADC_LL_injected_deinit_Expect(); // Cleanup after start failure
 
     // Act & Assert
     TRY {
@@ -508,13 +452,9 @@ void test_DMM_voltage_calculation_zero_adc(void)
     bool result;
 
     // Initialize DMM
-    ADC_LL_set_complete_callback_Stub(capture_adc_callback_stub);
-    ADC_LL_init_Stub(adc_init_success_stub);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6);
-    ADC_LL_start_Expect();
+    ADC_LL_set_injected_complete_callback_Stub(capture_adc_callback_stub);
+    ADC_LL_injected_init_Stub(adc_init_success_stub);
+    ADC_LL_injected_start_Expect();
 
     g_test_handle = DMM_init(&config);
     TEST_ASSERT_NOT_NULL(g_test_handle);
@@ -522,8 +462,8 @@ void test_DMM_voltage_calculation_zero_adc(void)
     // Zero ADC value should give zero voltage
     simulate_adc_conversion(0);
 
-    ADC_LL_get_reference_voltage_ExpectAndReturn(3300); // 3.3V in mV
-    ADC_LL_start_Expect(); // Only expect ADC restart, timer keeps running
+    ADC_LL_get_reference_voltage_ExpectAndReturn(NULL, 3300); // 3.3V in mV
+    ADC_LL_injected_start_Expect(); // Only expect ADC restart, timer keeps running
 
     // Act
     result = DMM_read_voltage(g_test_handle, &voltage_out);
@@ -543,13 +483,9 @@ void test_DMM_voltage_calculation_half_scale_adc(void)
     bool result;
 
     // Initialize DMM
-    ADC_LL_set_complete_callback_Stub(capture_adc_callback_stub);
-    ADC_LL_init_Stub(adc_init_success_stub);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6);
-    ADC_LL_start_Expect();
+    ADC_LL_set_injected_complete_callback_Stub(capture_adc_callback_stub);
+    ADC_LL_injected_init_Stub(adc_init_success_stub);
+    ADC_LL_injected_start_Expect();
 
     g_test_handle = DMM_init(&config);
     TEST_ASSERT_NOT_NULL(g_test_handle);
@@ -559,8 +495,8 @@ void test_DMM_voltage_calculation_half_scale_adc(void)
     // Half-scale = 2047, should give ~1.65V with 3.3V reference
     simulate_adc_conversion(2047);
 
-    ADC_LL_get_reference_voltage_ExpectAndReturn(3300); // 3.3V in mV
-    ADC_LL_start_Expect(); // Only expect ADC restart, timer keeps running
+    ADC_LL_get_reference_voltage_ExpectAndReturn(NULL, 3300); // 3.3V in mV
+    ADC_LL_injected_start_Expect(); // Only expect ADC restart, timer keeps running
 
     // Act
     result = DMM_read_voltage(g_test_handle, &voltage_out);
@@ -585,13 +521,9 @@ void test_DMM_voltage_calculation_full_scale_adc(void)
     bool result;
 
     // Initialize DMM
-    ADC_LL_set_complete_callback_Stub(capture_adc_callback_stub);
-    ADC_LL_init_Stub(adc_init_success_stub);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6);
-    ADC_LL_start_Expect();
+    ADC_LL_set_injected_complete_callback_Stub(capture_adc_callback_stub);
+    ADC_LL_injected_init_Stub(adc_init_success_stub);
+    ADC_LL_injected_start_Expect();
 
     g_test_handle = DMM_init(&config);
     TEST_ASSERT_NOT_NULL(g_test_handle);
@@ -599,8 +531,8 @@ void test_DMM_voltage_calculation_full_scale_adc(void)
     // Full-scale ADC value should give full reference voltage
     simulate_adc_conversion(4095);
 
-    ADC_LL_get_reference_voltage_ExpectAndReturn(3300); // 3.3V in mV
-    ADC_LL_start_Expect(); // Only expect ADC restart, timer keeps running
+    ADC_LL_get_reference_voltage_ExpectAndReturn(NULL, 3300); // 3.3V in mV
+    ADC_LL_injected_start_Expect(); // Only expect ADC restart, timer keeps running
 
     // Act
     result = DMM_read_voltage(g_test_handle, &voltage_out);
@@ -624,13 +556,9 @@ void test_DMM_voltage_calculation_with_oversampling(void)
     bool result;
 
     // Initialize DMM
-    ADC_LL_set_complete_callback_Stub(capture_adc_callback_stub);
-    ADC_LL_init_Stub(adc_init_success_stub);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-    TIM_LL_init_Expect(TIM_NUM_6, 1000);
-    TIM_LL_start_Expect(TIM_NUM_6);
-    ADC_LL_start_Expect();
+    ADC_LL_set_injected_complete_callback_Stub(capture_adc_callback_stub);
+    ADC_LL_injected_init_Stub(adc_init_success_stub);
+    ADC_LL_injected_start_Expect();
 
     g_test_handle = DMM_init(&config);
     TEST_ASSERT_NOT_NULL(g_test_handle);
@@ -639,8 +567,8 @@ void test_DMM_voltage_calculation_with_oversampling(void)
     // Half-scale is still 2047
     simulate_adc_conversion(2047);
 
-    ADC_LL_get_reference_voltage_ExpectAndReturn(3300); // 3.3V in mV
-    ADC_LL_start_Expect(); // Only expect ADC restart, timer keeps running
+    ADC_LL_get_reference_voltage_ExpectAndReturn(NULL, 3300); // 3.3V in mV
+    ADC_LL_injected_start_Expect(); // Only expect ADC restart, timer keeps running
 
     // Act
     result = DMM_read_voltage(g_test_handle, &voltage_out);
@@ -664,21 +592,14 @@ void test_DMM_config_validation_edge_cases(void)
         DMM_Config config = DMM_CONFIG_DEFAULT;
         config.oversampling_ratio = 256; // Maximum valid
 
-        ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-        ADC_LL_init_Ignore();
-        ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-        ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-        TIM_LL_init_Expect(TIM_NUM_6, 1000);
-        TIM_LL_start_Expect(TIM_NUM_6);
-        ADC_LL_start_Expect();
+        ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+        ADC_LL_injected_init_Ignore();
+        ADC_LL_injected_start_Expect();
 
         g_test_handle = DMM_init(&config);
         TEST_ASSERT_NOT_NULL(g_test_handle);
 
-        ADC_LL_stop_Expect();
-        TIM_LL_stop_Expect(TIM_NUM_6);
-        ADC_LL_deinit_Expect();
-        TIM_LL_deinit_Expect(TIM_NUM_6);
+        ADC_LL_injected_deinit_Expect();
         DMM_deinit(g_test_handle);
         g_test_handle = NULL;
     }
@@ -706,22 +627,125 @@ void test_DMM_channel_mapping(void)
         DMM_Config config = DMM_CONFIG_DEFAULT;
         config.channel = (DMM_Channel)i;
 
-        ADC_LL_set_complete_callback_Expect(dmm_adc_complete_callback);
-        ADC_LL_init_Ignore();
-        ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-        ADC_LL_get_sample_rate_ExpectAndReturn(1000);
-        TIM_LL_init_Expect(TIM_NUM_6, 1000);
-        TIM_LL_start_Expect(TIM_NUM_6);
-        ADC_LL_start_Expect();
+        ADC_LL_set_injected_complete_callback_Expect(dmm_adc_complete_callback);
+        ADC_LL_injected_init_Ignore();
+        ADC_LL_injected_start_Expect();
 
         g_test_handle = DMM_init(&config);
         TEST_ASSERT_NOT_NULL(g_test_handle);
 
-        ADC_LL_stop_Expect();
-        TIM_LL_stop_Expect(TIM_NUM_6);
-        ADC_LL_deinit_Expect();
-        TIM_LL_deinit_Expect(TIM_NUM_6);
+        ADC_LL_injected_deinit_Expect();
         DMM_deinit(g_test_handle);
         g_test_handle = NULL;
     }
 }
+
+// Oversampling ratios supported by the ADC
+static uint32_t const g_oversampling_ratios[] = { 1, 2, 4, 8, 16, 32, 64, 128, 256 };
+
+// Helper function to initialize the DMM with a given oversampling setup
+static void init_dmm_with_oversampling(uint32_t ratio, bool high_resolution)
+{
+    DMM_Config config = DMM_CONFIG_DEFAULT;
+    config.oversampling_ratio = ratio;
+    config.high_resolution = high_resolution;
+
+    ADC_LL_set_injected_complete_callback_Stub(capture_adc_callback_stub);
+    ADC_LL_injected_init_Stub(adc_init_success_stub);
+    ADC_LL_injected_start_Expect();
+
+    g_test_handle = DMM_init(&config);
+    TEST_ASSERT_NOT_NULL(g_test_handle);
+    TEST_ASSERT_EQUAL_UINT32(ratio, g_captured_adc_config.oversampling_ratio);
+    TEST_ASSERT_EQUAL(high_resolution, g_captured_adc_config.high_resolution);
+}
+
+// Helper function to read a voltage for a given raw ADC value
+static FIXED_Q1616 read_voltage_for_raw(uint16_t raw)
+{
+    FIXED_Q1616 voltage_out = FIXED_ZERO;
+
+    simulate_adc_conversion(raw);
+    ADC_LL_get_reference_voltage_ExpectAndReturn(NULL, 3300); // 3.3V in mV
+    ADC_LL_injected_start_Expect();
+
+    TEST_ASSERT_TRUE(DMM_read_voltage(g_test_handle, &voltage_out));
+    return voltage_out;
+}
+
+// Helper function to deinitialize the DMM between ratios
+static void deinit_dmm(void)
+{
+    ADC_LL_injected_deinit_Expect();
+    DMM_deinit(g_test_handle);
+    g_test_handle = NULL;
+}
+
+// Test: Normal mode keeps a 12-bit full scale for every oversampling ratio
+void test_DMM_full_scale_all_ratios_normal_mode(void)
+{
+    FIXED_Q1616 tolerance = FIXED_FROM_FLOAT(0.01f);
+
+    for (size_t i = 0; i < sizeof(g_oversampling_ratios) / sizeof(g_oversampling_ratios[0]); i++) {
+        // Arrange
+        init_dmm_with_oversampling(g_oversampling_ratios[i], false);
+
+        // Act
+        FIXED_Q1616 full = read_voltage_for_raw(4095);
+        FIXED_Q1616 half = read_voltage_for_raw(2048);
+
+        // Assert
+        TEST_ASSERT_INT32_WITHIN(tolerance, FIXED_FROM_FLOAT(3.3f), full);
+        TEST_ASSERT_INT32_WITHIN(tolerance, FIXED_FROM_FLOAT(1.65f), half);
+
+        deinit_dmm();
+    }
+}
+
+// Test: High-resolution mode gains one bit per ratio doubling, up to 16 bits
+void test_DMM_full_scale_all_ratios_high_resolution(void)
+{
+    FIXED_Q1616 tolerance = FIXED_FROM_FLOAT(0.01f);
+
+    for (size_t i = 0; i < sizeof(g_oversampling_ratios) / sizeof(g_oversampling_ratios[0]); i++) {
+        // Arrange
+        uint32_t bits = 12 + i; // log2(ratio) extra bits
+        if (bits > 16) {
+            bits = 16;
+        }
+        uint16_t full_scale = (uint16_t)((1U << bits) - 1U);
+        init_dmm_with_oversampling(g_oversampling_ratios[i], true);
+
+        // Act
+        FIXED_Q1616 full = read_voltage_for_raw(full_scale);
+        FIXED_Q1616 half = read_voltage_for_raw((uint16_t)(1U << (bits - 1)));
+        FIXED_Q1616 native_full = read_voltage_for_raw(4095);
+
+        // Assert
+        TEST_ASSERT_INT32_WITHIN(tolerance, FIXED_FROM_FLOAT(3.3f), full);
+        TEST_ASSERT_INT32_WITHIN(tolerance, FIXED_FROM_FLOAT(1.65f), half);
+        // A 12-bit full-scale code is only a fraction of the extended range
+        TEST_ASSERT_INT32_WITHIN(
+            tolerance,
+            FIXED_FROM_FLOAT(3.3f * 4095.0f / (float)full_scale),
+            native_full
+        );
+
+        deinit_dmm();
+    }
+}
+
+// Test: High-resolution mode resolves steps finer than one 12-bit LSB
+void test_DMM_high_resolution_sub_lsb_step(void)
+{
+    // Arrange
+    init_dmm_with_oversampling(256, true);
+
+    // Act - adjacent 16-bit codes within a single 12-bit LSB
+    FIXED_Q1616 low = read_voltage_for_raw(32768);
+    FIXED_Q1616 high = read_voltage_for_raw(32776);
+
+    // Assert - 8 codes at 16-bit is half a 12-bit LSB (~0.4 mV)
+    TEST_ASSERT_GREATER_THAN_INT32(low, high);
+    TEST_ASSERT_LESS_THAN_INT32(FIXED_FROM_FLOAT(0.0008f), high - low);
+}
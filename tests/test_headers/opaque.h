@@ -14,8 +14,10 @@
 #include "platform/uart_ll.h"
 #include "system/bus/uart.h"
 #include "system/bus/usb.h"
+#include "system/adc_arbiter.h"
 #include "system/instrument/dmm.h"
 #include "system/instrument/dso.h"
+#include "system/scheduler.h"
 
 
 #ifdef __cplusplus
@@ -42,7 +44,8 @@ struct UART_Handle {
  */
 struct DMM_Handle {
     DMM_Config config;
-    uint16_t adc_value;
+    uint16_t volatile adc_value;
+    uint32_t full_scale;
     bool volatile conversion_complete;
     bool initialized;
 };
@@ -52,7 +55,8 @@ struct DMM_Handle {
  */
 struct DSO_Handle {
     DSO_Config config;
-    bool running;
+    ADC_ARB_Session *session;
+    bool volatile running;
 };
 
 /**
@@ -67,6 +71,18 @@ struct USB_Handle {
     bool initialized;
 };
 
+/**
+ * @brief Scheduler task structure (concrete definition for testing)
+ */
+struct SCHED_Task {
+    SCHED_TaskConfig config;
+    SCHED_TaskStats stats;
+    uint64_t next_release_us;
+    uint64_t volatile signalled_at_us;
+    bool volatile signalled;
+    bool in_use;
+};
+
 #ifdef __cplusplus
 }
 #endif
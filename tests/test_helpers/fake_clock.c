@@ -0,0 +1,67 @@
+/**
+ * @file fake_clock.c
+ * @brief Controllable cycle counter for host tests
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdint.h>
+
+#include "fake_clock.h"
+
+static uint32_t g_count = 0;
+static uint32_t g_frequency = FAKE_CLOCK_DEFAULT_FREQUENCY;
+static uint32_t g_critical_depth = 0;
+static CYCLE_LL_TickCallback g_tick_callback = nullptr;
+
+void FAKE_CLOCK_reset(void)
+{
+    g_count = 0;
+    g_frequency = FAKE_CLOCK_DEFAULT_FREQUENCY;
+    g_critical_depth = 0;
+    g_tick_callback = nullptr;
+}
+
+void FAKE_CLOCK_set_frequency(uint32_t freq) { g_frequency = freq; }
+
+void FAKE_CLOCK_set_count(uint32_t count) { g_count = count; }
+
+void FAKE_CLOCK_advance_cycles(uint32_t cycles) { g_count += cycles; }
+
+void FAKE_CLOCK_advance_us(uint64_t us)
+{
+    uint64_t const us_per_tick = 1000;
+    uint64_t const cycles_per_tick = (uint64_t)g_frequency / 1000;
+
+    while (us >= us_per_tick) {
+        g_count += (uint32_t)cycles_per_tick;
+        FAKE_CLOCK_tick();
+        us -= us_per_tick;
+    }
+    g_count += (uint32_t)(us * g_frequency / 1000000);
+}
+
+void FAKE_CLOCK_tick(void)
+{
+    if (g_tick_callback) {
+        g_tick_callback();
+    }
+}
+
+uint32_t FAKE_CLOCK_get_critical_depth(void) { return g_critical_depth; }
+
+void CYCLE_LL_init(void) { g_count = 0; }
+
+uint32_t CYCLE_LL_get_count(void) { return g_count; }
+
+uint32_t CYCLE_LL_get_frequency(void) { return g_frequency; }
+
+void CYCLE_LL_set_tick_callback(CYCLE_LL_TickCallback callback)
+{
+    g_tick_callback = callback;
+}
+
+uint32_t CYCLE_LL_enter_critical(void) { return g_critical_depth++; }
+
+void CYCLE_LL_exit_critical(uint32_t state) { g_critical_depth = state; }
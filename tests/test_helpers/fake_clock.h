@@ -0,0 +1,73 @@
+/**
+ * @file fake_clock.h
+ * @brief Controllable cycle counter for host tests
+ *
+ * Implements the cycle LL interface (platform/cycle_ll.h) on the host. Tests
+ * set the counter frequency, move the counter forward and fire the periodic
+ * tick by hand, which makes time-dependent code deterministic.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef FAKE_CLOCK_H
+#define FAKE_CLOCK_H
+
+#include <stdint.h>
+
+#include "platform/cycle_ll.h"
+
+// Default counter frequency, matching the target core clock
+#define FAKE_CLOCK_DEFAULT_FREQUENCY 250000000UL
+
+/**
+ * @brief Reset the fake clock
+ *
+ * Sets the counter to zero, the frequency to FAKE_CLOCK_DEFAULT_FREQUENCY
+ * and clears the tick callback.
+ */
+void FAKE_CLOCK_reset(void);
+
+/**
+ * @brief Set the counter frequency
+ *
+ * @param freq Frequency in Hz
+ */
+void FAKE_CLOCK_set_frequency(uint32_t freq);
+
+/**
+ * @brief Set the raw 32-bit counter value
+ *
+ * @param count New counter value
+ */
+void FAKE_CLOCK_set_count(uint32_t count);
+
+/**
+ * @brief Advance the counter, wrapping at 2^32
+ *
+ * The tick callback is not fired.
+ *
+ * @param cycles Number of cycles to advance
+ */
+void FAKE_CLOCK_advance_cycles(uint32_t cycles);
+
+/**
+ * @brief Advance the counter by a duration, firing the tick every millisecond
+ *
+ * @param us Duration in microseconds
+ */
+void FAKE_CLOCK_advance_us(uint64_t us);
+
+/**
+ * @brief Fire the tick callback once, if one is set
+ */
+void FAKE_CLOCK_tick(void);
+
+/**
+ * @brief Get the number of unbalanced critical sections
+ *
+ * @return Nesting depth of CYCLE_LL_enter_critical calls
+ */
+uint32_t FAKE_CLOCK_get_critical_depth(void);
+
+#endif // FAKE_CLOCK_H
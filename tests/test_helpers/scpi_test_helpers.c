@@ -8,14 +8,17 @@
 
 #include "scpi_test_helpers.h"
 #include <string.h>
+#include "mock_system.h"
+#include "mock_usbtmc.h"
 
 // ============================================================================
 // Mock USB callback functions
 // ============================================================================
 
-uint32_t scpi_mock_usb_write_capture(USB_Handle *handle, uint8_t const *data, uint32_t len, int cmock_num_calls)
+uint32_t scpi_mock_usb_write_capture(USB_Handle *handle, uint8_t const *data, uint32_t len, uint32_t timeout, int cmock_num_calls)
 {
     (void)handle;
+    (void)timeout;
     (void)cmock_num_calls;
 
     if (g_scpi_test_captured_response_len + len < SCPI_TEST_RESPONSE_BUFFER_SIZE) {
@@ -27,6 +30,16 @@ uint32_t scpi_mock_usb_write_capture(USB_Handle *handle, uint8_t const *data, ui
     return len;
 }
 
+void scpi_mock_usb_write_block_capture(USB_Handle *handle, USB_TxBlock const *block, int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+
+    scpi_mock_usb_write_capture(handle, block->data, block->size, 0, 0);
+    if (block->callback) {
+        block->callback(block->context, true);
+    }
+}
+
 uint32_t scpi_mock_usb_read_inject(USB_Handle *handle, uint8_t *buffer, uint32_t max_len, int cmock_num_calls)
 {
     (void)handle;
@@ -82,6 +95,24 @@ void scpi_run_protocol_with_usb_mocks(USB_Handle *usb_handle)
     USB_task_Expect(usb_handle);
     USB_rx_ready_StubWithCallback(scpi_mock_usb_rx_ready_check);
     USB_read_StubWithCallback(scpi_mock_usb_read_inject);
-    USB_write_StubWithCallback(scpi_mock_usb_write_capture);
+    USB_write_all_StubWithCallback(scpi_mock_usb_write_capture);
+    USB_write_block_StubWithCallback(scpi_mock_usb_write_block_capture);
+    USB_tx_block_pending_IgnoreAndReturn(false);
     protocol_task();
+}
+
+void scpi_test_default_ignores(void)
+{
+    // The USBTMC transport stays idle unless a test drives it
+    USBTMC_init_Ignore();
+    USBTMC_deinit_Ignore();
+    USBTMC_task_Ignore();
+    USBTMC_rx_available_IgnoreAndReturn(0);
+
+    // Response ends are flushed; tests look at the written bytes only
+    USB_tx_flush_Ignore();
+
+    // protocol_task times its input drain; time stands still unless a test
+    // moves it
+    SYSTEM_get_time_us_IgnoreAndReturn(0);
 }
\ No newline at end of file
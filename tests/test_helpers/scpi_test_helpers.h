@@ -76,9 +76,16 @@ extern size_t g_scpi_test_injected_data_len;
 // ============================================================================
 
 /**
- * @brief Mock USB_write implementation that captures response data
+ * @brief Mock USB_write_all implementation that captures response data
  */
-uint32_t scpi_mock_usb_write_capture(USB_Handle *handle, uint8_t const *data, uint32_t len, int cmock_num_calls);
+uint32_t scpi_mock_usb_write_capture(USB_Handle *handle, uint8_t const *data, uint32_t len, uint32_t timeout, int cmock_num_calls);
+
+/**
+ * @brief Mock USB_write_block implementation that captures the block data
+ *
+ * The block is released right away, as if the host had read it.
+ */
+void scpi_mock_usb_write_block_capture(USB_Handle *handle, USB_TxBlock const *block, int cmock_num_calls);
 
 /**
  * @brief Mock USB_read implementation that returns injected data
@@ -120,4 +127,13 @@ void scpi_clear_captured_response(void);
  */
 void scpi_run_protocol_with_usb_mocks(USB_Handle *usb_handle);
 
+/**
+ * @brief Helper to set the mock defaults shared by the protocol tests
+ *
+ * Keeps the USBTMC transport idle, ignores response-end flushes and holds
+ * the drain timer at 0. Call from setUp after the mocks are initialized;
+ * tests that drive USBTMC or move time override these defaults.
+ */
+void scpi_test_default_ignores(void);
+
 #endif /* SCPI_TEST_HELPERS_H */
\ No newline at end of file
@@ -0,0 +1,142 @@
+/**
+ * @file stream_host.c
+ * @brief Host-side stand-in for the USB bulk stream reader
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "stream_host.h"
+
+static uint32_t get_le16(uint8_t const *src)
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8);
+}
+
+static uint32_t get_le32(uint8_t const *src)
+{
+    return get_le16(src) | (get_le16(src + 2) << 16);
+}
+
+/**
+ * @brief Check the bytes collected so far against the header format
+ */
+static bool header_plausible(STREAM_HOST_Reader const *reader)
+{
+    uint8_t const *h = reader->header;
+    uint32_t const len = reader->header_len;
+
+    if (len >= 1 && h[0] != (uint8_t)USB_STREAM_MAGIC) {
+        return false;
+    }
+    if (len >= 2 && get_le16(h) != USB_STREAM_MAGIC) {
+        return false;
+    }
+    if (len >= 4 && h[3] != 0) {
+        return false; // Flags are reserved
+    }
+    if (len >= USB_STREAM_HEADER_SIZE &&
+        get_le32(&h[8]) > reader->capacity) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Drop the first collected header byte and re-check the rest
+ */
+static void skip_header_byte(STREAM_HOST_Reader *reader)
+{
+    do {
+        memmove(reader->header, reader->header + 1, --reader->header_len);
+        reader->skipped_bytes++;
+    } while (reader->header_len > 0 && !header_plausible(reader));
+}
+
+static void deliver_frame(STREAM_HOST_Reader *reader)
+{
+    STREAM_HOST_Frame *frame = &reader->frame;
+
+    if (reader->has_sequence) {
+        reader->lost_frames += frame->sequence - reader->next_sequence;
+    }
+    reader->has_sequence = true;
+    reader->next_sequence = frame->sequence + 1;
+    reader->frames++;
+
+    frame->payload = reader->payload;
+    if (reader->callback) {
+        reader->callback(frame, reader->context);
+    }
+
+    reader->in_payload = false;
+    reader->header_len = 0;
+}
+
+static void start_frame(STREAM_HOST_Reader *reader)
+{
+    reader->frame = (STREAM_HOST_Frame){
+        .type = reader->header[2],
+        .sequence = get_le32(&reader->header[4]),
+        .size = get_le32(&reader->header[8]),
+    };
+    reader->payload_len = 0;
+    reader->in_payload = true;
+
+    if (reader->frame.size == 0) {
+        deliver_frame(reader);
+    }
+}
+
+void STREAM_HOST_init(
+    STREAM_HOST_Reader *reader,
+    uint8_t *payload,
+    uint32_t capacity,
+    STREAM_HOST_FrameCallback callback,
+    void *context
+)
+{
+    *reader = (STREAM_HOST_Reader){
+        .payload = payload,
+        .capacity = capacity,
+        .callback = callback,
+        .context = context,
+    };
+}
+
+void STREAM_HOST_feed(
+    STREAM_HOST_Reader *reader,
+    uint8_t const *data,
+    uint32_t len
+)
+{
+    uint32_t pos = 0;
+
+    while (pos < len) {
+        if (reader->in_payload) {
+            uint32_t chunk = reader->frame.size - reader->payload_len;
+            if (chunk > len - pos) {
+                chunk = len - pos;
+            }
+            memcpy(reader->payload + reader->payload_len, data + pos, chunk);
+            reader->payload_len += chunk;
+            pos += chunk;
+
+            if (reader->payload_len == reader->frame.size) {
+                deliver_frame(reader);
+            }
+            continue;
+        }
+
+        reader->header[reader->header_len++] = data[pos++];
+        if (!header_plausible(reader)) {
+            skip_header_byte(reader);
+        } else if (reader->header_len == USB_STREAM_HEADER_SIZE) {
+            start_frame(reader);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file stream_host.h
+ * @brief Host-side stand-in for the USB bulk stream reader
+ *
+ * Splits the bytes read from the bulk pipe back into frames the way a host
+ * application would. Bytes may be fed in pieces of any size. When the stream
+ * is out of step, bytes are skipped until a plausible header is found, and
+ * frames missing from the sequence are counted as lost.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#ifndef STREAM_HOST_H
+#define STREAM_HOST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "system/bus/usb_stream.h"
+
+/**
+ * @brief A received frame
+ */
+typedef struct {
+    uint8_t type;
+    uint32_t sequence;
+    uint32_t size;
+    uint8_t const *payload;
+} STREAM_HOST_Frame;
+
+/**
+ * @brief Called for every complete frame
+ */
+typedef void (*STREAM_HOST_FrameCallback)(
+    STREAM_HOST_Frame const *frame,
+    void *context
+);
+
+/**
+ * @brief Reader state
+ */
+typedef struct {
+    uint8_t header[USB_STREAM_HEADER_SIZE];
+    uint32_t header_len;
+    uint8_t *payload;
+    uint32_t capacity;
+    uint32_t payload_len;
+    STREAM_HOST_Frame frame;
+    bool in_payload;
+    bool has_sequence;
+    uint32_t next_sequence;
+    STREAM_HOST_FrameCallback callback;
+    void *context;
+    uint32_t frames; // Complete frames received
+    uint32_t lost_frames; // Frames missing from the sequence
+    uint32_t skipped_bytes; // Bytes dropped while out of step
+} STREAM_HOST_Reader;
+
+/**
+ * @brief Initialize a reader
+ *
+ * @param reader Reader state
+ * @param payload Buffer for the payload of the frame being received
+ * @param capacity Size of the payload buffer, the largest accepted frame
+ * @param callback Called for every complete frame
+ * @param context Passed to the callback
+ */
+void STREAM_HOST_init(
+    STREAM_HOST_Reader *reader,
+    uint8_t *payload,
+    uint32_t capacity,
+    STREAM_HOST_FrameCallback callback,
+    void *context
+);
+
+/**
+ * @brief Feed bytes read from the bulk pipe
+ *
+ * @param reader Reader state
+ * @param data Bytes in the order they were read
+ * @param len Number of bytes
+ */
+void STREAM_HOST_feed(
+    STREAM_HOST_Reader *reader,
+    uint8_t const *data,
+    uint32_t len
+);
+
+#endif // STREAM_HOST_H
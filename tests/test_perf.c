@@ -0,0 +1,140 @@
+/**
+ * @file test_perf.c
+ * @brief Unit tests for cycle accounting and CPU load windows
+ *
+ * This file contains unit tests for the per-source sample accumulators and
+ * for the accounting windows built on top of them. Time is driven by the
+ * fake cycle counter.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdint.h>
+
+#include "unity.h"
+#include "fake_clock.h"
+
+#include "util/perf.h"
+
+#include "system.h"
+
+// Implemented in timebase.c, called from SYSTEM_init on target
+void timebase_init(void);
+
+void setUp(void)
+{
+    FAKE_CLOCK_reset();
+    timebase_init();
+    SYSTEM_reset_perf_stats();
+}
+
+void tearDown(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0, FAKE_CLOCK_get_critical_depth());
+}
+
+void test_PERF_take_without_samples(void)
+{
+    PERF_Stats stats = PERF_take(PERF_SOURCE_USB);
+
+    TEST_ASSERT_EQUAL_UINT32(0, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.min_cycles);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.max_cycles);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.total_cycles);
+}
+
+void test_PERF_record_accumulates_min_max_total(void)
+{
+    PERF_record(PERF_SOURCE_ADC_DMA, 300);
+    PERF_record(PERF_SOURCE_ADC_DMA, 100);
+    PERF_record(PERF_SOURCE_ADC_DMA, 200);
+
+    PERF_Stats stats = PERF_take(PERF_SOURCE_ADC_DMA);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(100, stats.min_cycles);
+    TEST_ASSERT_EQUAL_UINT32(300, stats.max_cycles);
+    TEST_ASSERT_EQUAL_UINT64(600, stats.total_cycles);
+}
+
+void test_PERF_take_clears_only_its_source(void)
+{
+    PERF_record(PERF_SOURCE_USB, 50);
+    PERF_record(PERF_SOURCE_UART_DMA, 70);
+
+    PERF_take(PERF_SOURCE_USB);
+
+    TEST_ASSERT_EQUAL_UINT32(0, PERF_take(PERF_SOURCE_USB).count);
+    TEST_ASSERT_EQUAL_UINT32(1, PERF_take(PERF_SOURCE_UART_DMA).count);
+}
+
+void test_PERF_record_ignores_invalid_source(void)
+{
+    PERF_record(PERF_SOURCE_COUNT, 10);
+
+    for (int i = 0; i < PERF_SOURCE_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, PERF_take((PERF_Source)i).count);
+    }
+}
+
+void test_SYSTEM_perf_stats_zero_before_first_window(void)
+{
+    PERF_record(PERF_SOURCE_USB, 50);
+
+    SYSTEM_PerfStats stats = SYSTEM_get_perf_stats();
+    TEST_ASSERT_EQUAL_UINT64(0, stats.window_cycles);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.sources[PERF_SOURCE_USB].count);
+}
+
+void test_SYSTEM_perf_task_computes_load_from_idle_time(void)
+{
+    // 1 ms window, asleep for 750 us of it
+    FAKE_CLOCK_advance_us(1000);
+    PERF_record(PERF_SOURCE_IDLE, 750 * 250);
+    PERF_record(PERF_SOURCE_USB, 1000);
+
+    SYSTEM_perf_task();
+
+    SYSTEM_PerfStats stats = SYSTEM_get_perf_stats();
+    TEST_ASSERT_EQUAL_UINT32(250000000, stats.cycle_frequency);
+    TEST_ASSERT_EQUAL_UINT64(250000, stats.window_cycles);
+    TEST_ASSERT_EQUAL_UINT32(250, stats.load_permille);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.sources[PERF_SOURCE_USB].count);
+    TEST_ASSERT_EQUAL_UINT32(1000, stats.sources[PERF_SOURCE_USB].max_cycles);
+}
+
+void test_SYSTEM_perf_task_starts_new_window(void)
+{
+    FAKE_CLOCK_advance_us(1000);
+    PERF_record(PERF_SOURCE_USB, 1000);
+    SYSTEM_perf_task();
+
+    // Second window has no samples and no sleep: fully loaded
+    FAKE_CLOCK_advance_us(2000);
+    SYSTEM_perf_task();
+
+    SYSTEM_PerfStats stats = SYSTEM_get_perf_stats();
+    TEST_ASSERT_EQUAL_UINT64(500000, stats.window_cycles);
+    TEST_ASSERT_EQUAL_UINT32(1000, stats.load_permille);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.sources[PERF_SOURCE_USB].count);
+}
+
+void test_SYSTEM_reset_perf_stats_discards_samples(void)
+{
+    FAKE_CLOCK_advance_us(1000);
+    PERF_record(PERF_SOURCE_IDLE, 1000);
+    SYSTEM_perf_task();
+
+    FAKE_CLOCK_advance_us(500);
+    PERF_record(PERF_SOURCE_ADC_DMA, 10);
+    SYSTEM_reset_perf_stats();
+
+    TEST_ASSERT_EQUAL_UINT64(0, SYSTEM_get_perf_stats().window_cycles);
+
+    FAKE_CLOCK_advance_us(100);
+    SYSTEM_perf_task();
+
+    SYSTEM_PerfStats stats = SYSTEM_get_perf_stats();
+    TEST_ASSERT_EQUAL_UINT64(25000, stats.window_cycles);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.sources[PERF_SOURCE_ADC_DMA].count);
+}
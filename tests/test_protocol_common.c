@@ -6,6 +6,9 @@
  * - Protocol lifecycle management (init/deinit/task)
  * - IEEE 488.2 standard SCPI commands (*IDN?, *RST, *TST?, SYST:ERR?)
  * - USB communication handling and error recovery
+ * - Draining pipelined input within the byte and time budget of a task call,
+ *   with a benchmark of commands per second for pipelined queries
+ * - SCPI over USBTMC: end of message and service requests
  * - State management and reset functionality
  *
  * The protocol module uses USB CDC as transport and implements SCPI commands
@@ -19,12 +22,15 @@
 #include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
 
 #include "unity.h"
 #include "mock_dmm.h"
 #include "mock_dso.h"
 #include "mock_usb.h"
 #include "mock_system.h"
+#include "mock_usb_stream.h"
+#include "mock_usbtmc.h"
 #include "scpi_test_helpers.h"
 
 #include "util/error.h"
@@ -44,6 +50,9 @@ static USB_Handle *g_mock_usb_handle;
 static CircularBuffer g_mock_usb_rx_buffer;
 static uint8_t g_mock_usb_rx_data[SCPI_TEST_USB_BUFFER_SIZE];
 static uint32_t g_mock_system_tick;
+static uint64_t g_mock_time_us;
+static uint32_t g_mock_read_bytes;
+static uint32_t g_mock_response_count;
 
 void setUp(void)
 {
@@ -51,6 +60,9 @@ void setUp(void)
     g_mock_usb_handle = (USB_Handle *)0x12345678; // Mock handle
     g_scpi_test_captured_response_len = 0;
     g_mock_system_tick = 1000; // Start at 1 second
+    g_mock_time_us = 0;
+    g_mock_read_bytes = 0;
+    g_mock_response_count = 0;
     g_scpi_test_injected_data_len = 0;
 
     // Clear buffers
@@ -63,6 +75,9 @@ void setUp(void)
     // Initialize mocks
     mock_usb_Init();
     mock_system_Init();
+    mock_usbtmc_Init();
+
+    scpi_test_default_ignores();
 }
 
 void tearDown(void)
@@ -77,6 +92,7 @@ void tearDown(void)
     // Clean up mocks
     mock_usb_Destroy();
     mock_system_Destroy();
+    mock_usbtmc_Destroy();
 }
 
 // ============================================================================
@@ -84,11 +100,12 @@ void tearDown(void)
 // ============================================================================
 
 /**
- * @brief Mock USB_write implementation that captures response data
+ * @brief Mock USB_write_all implementation that captures response data
  */
-static uint32_t mock_usb_write_capture(USB_Handle *handle, uint8_t const *data, uint32_t len, int cmock_num_calls)
+static uint32_t mock_usb_write_capture(USB_Handle *handle, uint8_t const *data, uint32_t len, uint32_t timeout, int cmock_num_calls)
 {
     (void)handle;
+    (void)timeout;
     (void)cmock_num_calls;
 
     if (g_scpi_test_captured_response_len + len < SCPI_TEST_RESPONSE_BUFFER_SIZE) {
@@ -132,6 +149,49 @@ static bool mock_usb_rx_ready_check(USB_Handle *handle, int cmock_num_calls)
     return g_scpi_test_injected_data_len > 0;
 }
 
+/**
+ * @brief Mock USBTMC_write_all implementation that captures response data
+ */
+static void mock_usbtmc_write_capture(uint8_t const *data, uint32_t len, uint32_t timeout, int cmock_num_calls)
+{
+    mock_usb_write_capture(g_mock_usb_handle, data, len, timeout, cmock_num_calls);
+}
+
+/**
+ * @brief Mock USBTMC_read implementation that returns injected data
+ */
+static uint32_t mock_usbtmc_read_inject(uint8_t *buffer, uint32_t max_len, int cmock_num_calls)
+{
+    return mock_usb_read_inject(g_mock_usb_handle, buffer, max_len, cmock_num_calls);
+}
+
+/**
+ * @brief Mock USBTMC_rx_available that returns the injected data length
+ */
+static uint32_t mock_usbtmc_rx_available_check(int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    return (uint32_t)g_scpi_test_injected_data_len;
+}
+
+/**
+ * @brief Initialize the protocol and route injected data through USBTMC
+ */
+static void setup_usbtmc_transport(void)
+{
+    USB_init_ExpectAndReturn(0, NULL, NULL, g_mock_usb_handle);
+    USB_init_IgnoreArg_rx_buffer();
+    USB_init_IgnoreArg_tx_buffer();
+    USB_set_rx_callback_Ignore();
+    protocol_init();
+
+    USB_task_Ignore();
+    USB_rx_ready_IgnoreAndReturn(false);
+    USBTMC_rx_available_Stub(mock_usbtmc_rx_available_check);
+    USBTMC_read_Stub(mock_usbtmc_read_inject);
+    USBTMC_write_all_Stub(mock_usbtmc_write_capture);
+}
+
 /**
  * @brief Mock SYSTEM_get_tick implementation
  */
@@ -296,7 +356,7 @@ void test_scpi_idn_query(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     // Inject *IDN? command
     scpi_inject_usb_command("*IDN?\n");
@@ -326,7 +386,7 @@ void test_scpi_rst_command(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     // Inject *RST command
     scpi_inject_usb_command("*RST\n");
@@ -351,7 +411,7 @@ void test_scpi_tst_query(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     scpi_inject_usb_command("*TST?\n");
 
@@ -377,7 +437,7 @@ void test_scpi_system_error_query(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     scpi_inject_usb_command("SYST:ERR?\n");
 
@@ -391,6 +451,163 @@ void test_scpi_system_error_query(void)
     TEST_ASSERT_TRUE(strstr(response, "0,") != NULL);
 }
 
+void test_scpi_system_idle_query(void)
+{
+    // Arrange
+    USB_init_ExpectAndReturn(0, NULL, NULL, g_mock_usb_handle);
+    USB_init_IgnoreArg_rx_buffer();
+    USB_init_IgnoreArg_tx_buffer();
+    USB_set_rx_callback_Ignore();
+    protocol_init();
+
+    SYSTEM_IdleStats stats = {
+        .sleep_count = 120,
+        .wake_count = { 10, 20, 30, 40, 5 },
+        .serviced_count = 90,
+        .avg_latency_us = 4,
+        .max_latency_us = 17,
+        .sleep_time_us = 5000000000ULL,
+    };
+    SYSTEM_get_idle_stats_ExpectAndReturn(stats);
+
+    USB_task_Expect(g_mock_usb_handle);
+    USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
+    USB_read_StubWithCallback(mock_usb_read_inject);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
+
+    scpi_inject_usb_command("SYST:IDLE?\n");
+
+    // Act
+    protocol_task();
+
+    // Assert
+    TEST_ASSERT_EQUAL_STRING(
+        "120,90,4,17,5000000000,10,20,30,40,5\r\n",
+        scpi_get_captured_response()
+    );
+}
+
+void test_scpi_system_idle_reset(void)
+{
+    // Arrange
+    USB_init_ExpectAndReturn(0, NULL, NULL, g_mock_usb_handle);
+    USB_init_IgnoreArg_rx_buffer();
+    USB_init_IgnoreArg_tx_buffer();
+    USB_set_rx_callback_Ignore();
+    protocol_init();
+
+    SYSTEM_reset_idle_stats_Expect();
+
+    USB_task_Expect(g_mock_usb_handle);
+    USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
+    USB_read_StubWithCallback(mock_usb_read_inject);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
+
+    scpi_inject_usb_command("SYST:IDLE:RES\n");
+
+    // Act
+    protocol_task();
+
+    // Assert - no response from a command
+    TEST_ASSERT_EQUAL(0, strlen(scpi_get_captured_response()));
+}
+
+void test_scpi_system_performance_query(void)
+{
+    // Arrange
+    USB_init_ExpectAndReturn(0, NULL, NULL, g_mock_usb_handle);
+    USB_init_IgnoreArg_rx_buffer();
+    USB_init_IgnoreArg_tx_buffer();
+    USB_set_rx_callback_Ignore();
+    protocol_init();
+
+    SYSTEM_PerfStats stats = {
+        .cycle_frequency = 250000000,
+        .window_cycles = 250000000,
+        .load_permille = 125,
+        .sources = {
+            [PERF_SOURCE_IDLE] = { 1000, 100, 250000, 218750000 },
+            [PERF_SOURCE_ADC_DMA] = { 4, 300, 500, 1400 },
+            [PERF_SOURCE_USB] = { 2, 800, 1200, 2000 },
+            [PERF_SOURCE_USB_DEFERRED] = { 3, 100, 200, 450 },
+        },
+    };
+    SYSTEM_get_perf_stats_ExpectAndReturn(stats);
+
+    USB_task_Expect(g_mock_usb_handle);
+    USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
+    USB_read_StubWithCallback(mock_usb_read_inject);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
+
+    scpi_inject_usb_command("SYST:PERF?\n");
+
+    // Act
+    protocol_task();
+
+    // Assert - count,min,avg,max per source
+    TEST_ASSERT_EQUAL_STRING(
+        "250000000,250000000,125,"
+        "1000,100,218750,250000,4,300,350,500,0,0,0,0,2,800,1000,1200,"
+        "3,100,150,200,0,0,0,0\r\n",
+        scpi_get_captured_response()
+    );
+}
+
+void test_scpi_system_performance_reset(void)
+{
+    // Arrange
+    USB_init_ExpectAndReturn(0, NULL, NULL, g_mock_usb_handle);
+    USB_init_IgnoreArg_rx_buffer();
+    USB_init_IgnoreArg_tx_buffer();
+    USB_set_rx_callback_Ignore();
+    protocol_init();
+
+    SYSTEM_reset_perf_stats_Expect();
+
+    USB_task_Expect(g_mock_usb_handle);
+    USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
+    USB_read_StubWithCallback(mock_usb_read_inject);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
+
+    scpi_inject_usb_command("SYST:PERF:RES\n");
+
+    // Act
+    protocol_task();
+
+    // Assert - no response from a command
+    TEST_ASSERT_EQUAL(0, strlen(scpi_get_captured_response()));
+}
+
+void test_scpi_system_boot_timing_query(void)
+{
+    // Arrange
+    USB_init_ExpectAndReturn(0, NULL, NULL, g_mock_usb_handle);
+    USB_init_IgnoreArg_rx_buffer();
+    USB_init_IgnoreArg_tx_buffer();
+    USB_set_rx_callback_Ignore();
+    protocol_init();
+
+    SYSTEM_BootTiming timing = {
+        .phase_us = { 12000, 12450, 98000, 98100, 98600 },
+    };
+    SYSTEM_get_boot_timing_ExpectAndReturn(timing);
+
+    USB_task_Expect(g_mock_usb_handle);
+    USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
+    USB_read_StubWithCallback(mock_usb_read_inject);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
+
+    scpi_inject_usb_command("SYST:BOOT:TIM?\n");
+
+    // Act
+    protocol_task();
+
+    // Assert
+    TEST_ASSERT_EQUAL_STRING(
+        "12000,12450,98000,98100,98600\r\n", scpi_get_captured_response()
+    );
+}
+
 // ============================================================================
 // USB Communication and Error Handling Tests
 // ============================================================================
@@ -407,7 +624,7 @@ void test_usb_data_fragmentation(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     // Test fragmented command reception
     scpi_inject_usb_command("*IDN");
@@ -423,7 +640,7 @@ void test_usb_data_fragmentation(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     // Act
     protocol_task();
@@ -446,7 +663,7 @@ void test_invalid_scpi_command(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     scpi_inject_usb_command("INVALID:COMMAND\n");
 
@@ -460,7 +677,7 @@ void test_invalid_scpi_command(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     protocol_task();
 
@@ -483,7 +700,7 @@ void test_multiple_commands_in_sequence(void)
         USB_task_Expect(g_mock_usb_handle);
         USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
         USB_read_StubWithCallback(mock_usb_read_inject);
-        USB_write_StubWithCallback(mock_usb_write_capture);
+        USB_write_all_StubWithCallback(mock_usb_write_capture);
     }
 
     scpi_inject_usb_command("*IDN?\n*TST?\n*IDN?\n");
@@ -498,6 +715,261 @@ void test_multiple_commands_in_sequence(void)
     TEST_ASSERT_TRUE(strlen(response) > 0);
 }
 
+// ============================================================================
+// Input Drain Tests
+// ============================================================================
+
+/**
+ * @brief Mock USB_read implementation that never runs out of *CLS commands
+ */
+static uint32_t mock_usb_read_endless(USB_Handle *handle, uint8_t *buffer, uint32_t max_len, int cmock_num_calls)
+{
+    static char const PATTERN[] = "*CLS\n";
+    (void)handle;
+    (void)cmock_num_calls;
+
+    for (uint32_t i = 0; i < max_len; i++) {
+        buffer[i] = (uint8_t)PATTERN[(g_mock_read_bytes + i) % (sizeof(PATTERN) - 1)];
+    }
+    g_mock_read_bytes += max_len;
+
+    return max_len;
+}
+
+/**
+ * @brief Mock USB_rx_ready for a host that never stops sending
+ */
+static bool mock_usb_rx_ready_always(USB_Handle *handle, int cmock_num_calls)
+{
+    (void)handle;
+    (void)cmock_num_calls;
+    return true;
+}
+
+/**
+ * @brief Mock USB_write_all implementation that counts response lines
+ */
+static uint32_t mock_usb_write_count(USB_Handle *handle, uint8_t const *data, uint32_t len, uint32_t timeout, int cmock_num_calls)
+{
+    (void)handle;
+    (void)timeout;
+    (void)cmock_num_calls;
+
+    for (uint32_t i = 0; i < len; i++) {
+        if (data[i] == '\n') {
+            g_mock_response_count++;
+        }
+    }
+
+    return len;
+}
+
+/**
+ * @brief Mock SYSTEM_get_time_us implementation that advances 100 us per call
+ */
+static uint64_t mock_system_get_time_us_advancing(int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    g_mock_time_us += 100;
+    return g_mock_time_us;
+}
+
+/**
+ * @brief Mock DMM_read_voltage implementation with a ready measurement
+ */
+static bool mock_dmm_read_voltage_ready(DMM_Handle *handle, FIXED_Q1616 *voltage_out, int cmock_num_calls)
+{
+    (void)handle;
+    (void)cmock_num_calls;
+    *voltage_out = FIXED_FROM_FLOAT(2.75f);
+    return true;
+}
+
+/**
+ * @brief Initialize the protocol and count the responses to injected data
+ */
+static void setup_counting_transport(void)
+{
+    USB_init_ExpectAndReturn(0, NULL, NULL, g_mock_usb_handle);
+    USB_init_IgnoreArg_rx_buffer();
+    USB_init_IgnoreArg_tx_buffer();
+    USB_set_rx_callback_Ignore();
+    protocol_init();
+
+    USB_task_Ignore();
+    USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
+    USB_read_StubWithCallback(mock_usb_read_inject);
+    USB_write_all_StubWithCallback(mock_usb_write_count);
+}
+
+void test_protocol_task_drains_pipelined_commands(void)
+{
+    // Arrange - more than one packet of queries
+    setup_counting_transport();
+    for (int i = 0; i < 20; i++) {
+        scpi_inject_usb_command("*TST?\n");
+    }
+
+    // Act
+    protocol_task();
+
+    // Assert - every query is answered in a single call
+    TEST_ASSERT_EQUAL_size_t(0, g_scpi_test_injected_data_len);
+    TEST_ASSERT_EQUAL_UINT32(20, g_mock_response_count);
+}
+
+void test_protocol_task_drain_stops_at_byte_budget(void)
+{
+    // Arrange - the host never stops sending
+    setup_counting_transport();
+    USB_rx_ready_StubWithCallback(mock_usb_rx_ready_always);
+    USB_read_StubWithCallback(mock_usb_read_endless);
+
+    // Act
+    protocol_task();
+
+    // Assert - 512 bytes per call, the rest is left for the next call
+    TEST_ASSERT_EQUAL_UINT32(512, g_mock_read_bytes);
+
+    protocol_task();
+    TEST_ASSERT_EQUAL_UINT32(1024, g_mock_read_bytes);
+}
+
+void test_protocol_task_drain_stops_at_time_budget(void)
+{
+    // Arrange - 240 bytes of queries, each packet takes 100 us to handle
+    setup_counting_transport();
+    SYSTEM_get_time_us_StubWithCallback(mock_system_get_time_us_advancing);
+    for (int i = 0; i < 40; i++) {
+        scpi_inject_usb_command("*TST?\n");
+    }
+
+    // Act
+    protocol_task();
+
+    // Assert - three packets fit in 250 us
+    TEST_ASSERT_EQUAL_size_t(240 - 3 * 64, g_scpi_test_injected_data_len);
+    TEST_ASSERT_EQUAL_UINT32(3 * 64 / 6, g_mock_response_count);
+
+    // The rest is handled by the next call
+    protocol_task();
+    TEST_ASSERT_EQUAL_size_t(0, g_scpi_test_injected_data_len);
+    TEST_ASSERT_EQUAL_UINT32(40, g_mock_response_count);
+}
+
+void test_protocol_task_busy_cdc_does_not_starve_usbtmc(void)
+{
+    // Arrange - the CDC host never stops sending, a VISA host sends a query
+    setup_counting_transport();
+    USB_rx_ready_StubWithCallback(mock_usb_rx_ready_always);
+    USB_read_StubWithCallback(mock_usb_read_endless);
+    USBTMC_rx_available_Stub(mock_usbtmc_rx_available_check);
+    USBTMC_read_Stub(mock_usbtmc_read_inject);
+    USBTMC_write_all_Stub(mock_usbtmc_write_capture);
+    USBTMC_end_message_Ignore();
+    scpi_inject_usb_command("*IDN?\n");
+
+    // Act
+    protocol_task();
+
+    // Assert - both transports made progress in the same call
+    TEST_ASSERT_EQUAL_UINT32(512, g_mock_read_bytes);
+    TEST_ASSERT_EQUAL_size_t(0, g_scpi_test_injected_data_len);
+    TEST_ASSERT_NOT_NULL(strstr(scpi_get_captured_response(), "FOSSASIA"));
+}
+
+void test_protocol_pipelined_query_benchmark(void)
+{
+    enum { ROUNDS = 200, PAIRS = 16 };
+    char report[128];
+
+    // Arrange - DMM readings are ready right away
+    setup_counting_transport();
+    SYSTEM_get_tick_StubWithCallback(mock_system_get_tick_impl);
+    DMM_init_IgnoreAndReturn((DMM_Handle *)0x87654321);
+    DMM_read_voltage_StubWithCallback(mock_dmm_read_voltage_ready);
+    DMM_deinit_Ignore();
+
+    // Act - each round the host sends a burst of pipelined queries
+    uint32_t calls = 0;
+    clock_t const start = clock();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < PAIRS; i++) {
+            scpi_inject_usb_command("*IDN?\nDMM:READ?\n");
+        }
+        while (g_scpi_test_injected_data_len > 0) {
+            protocol_task();
+            calls++;
+        }
+    }
+    double const seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    uint32_t const commands = ROUNDS * PAIRS * 2;
+    snprintf(
+        report,
+        sizeof(report),
+        "%u commands in %u calls, %.0f commands/s",
+        (unsigned)commands,
+        (unsigned)calls,
+        seconds > 0 ? commands / seconds : 0.0
+    );
+    TEST_MESSAGE(report);
+
+    // Assert - every query is answered, each burst in a single call
+    TEST_ASSERT_EQUAL_UINT32(commands, g_mock_response_count);
+    TEST_ASSERT_EQUAL_UINT32(ROUNDS, calls);
+}
+
+// ============================================================================
+// USBTMC Transport Tests
+// ============================================================================
+
+void test_usbtmc_query_ends_message(void)
+{
+    // Arrange
+    setup_usbtmc_transport();
+    USBTMC_end_message_Expect();
+
+    scpi_inject_usb_command("*IDN?\n");
+
+    // Act
+    protocol_task();
+
+    // Assert - response sent on USBTMC only, then the message is ended
+    const char *response = scpi_get_captured_response();
+    TEST_ASSERT_TRUE(strstr(response, "FOSSASIA") != NULL);
+    TEST_ASSERT_EQUAL_STRING("\r\n", response + strlen(response) - 2);
+}
+
+void test_usbtmc_command_without_response_sends_nothing(void)
+{
+    // Arrange
+    setup_usbtmc_transport();
+
+    scpi_inject_usb_command("*CLS\n");
+
+    // Act
+    protocol_task();
+
+    // Assert - no write and no end of message expected
+    TEST_ASSERT_EQUAL(0, strlen(scpi_get_captured_response()));
+}
+
+void test_usbtmc_service_request(void)
+{
+    // Arrange - event status summary enabled as service request source
+    setup_usbtmc_transport();
+    USBTMC_request_service_Expect(0x60); // ESB | RQS
+
+    scpi_inject_usb_command("*ESE 1;*SRE 32;*OPC\n");
+
+    // Act
+    protocol_task();
+
+    // Assert - request verified by mock
+    TEST_PASS();
+}
+
 // ============================================================================
 // State Management and Reset Tests
 // ============================================================================
@@ -516,7 +988,7 @@ void test_protocol_state_reset(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     scpi_inject_usb_command("*RST\n");
 
@@ -532,7 +1004,7 @@ void test_protocol_state_reset(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     scpi_inject_usb_command("SYST:ERR?\n");
     protocol_task();
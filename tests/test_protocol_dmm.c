@@ -24,6 +24,8 @@
 #include "mock_dmm.h"
 #include "mock_dso.h"
 #include "mock_system.h"
+#include "mock_usb_stream.h"
+#include "mock_usbtmc.h"
 #include "scpi_test_helpers.h"
 
 #include "util/error.h"
@@ -65,6 +67,9 @@ void setUp(void)
     mock_usb_Init();
     mock_dmm_Init();
     mock_system_Init();
+    mock_usbtmc_Init();
+
+    scpi_test_default_ignores();
 }
 
 void tearDown(void)
@@ -81,6 +86,7 @@ void tearDown(void)
     mock_usb_Destroy();
     mock_dmm_Destroy();
     mock_system_Destroy();
+    mock_usbtmc_Destroy();
 }
 
 // ============================================================================
@@ -88,11 +94,12 @@ void tearDown(void)
 // ============================================================================
 
 /**
- * @brief Mock USB_write implementation that captures response data
+ * @brief Mock USB_write_all implementation that captures response data
  */
-static uint32_t mock_usb_write_capture(USB_Handle *handle, uint8_t const *data, uint32_t len, int cmock_num_calls)
+static uint32_t mock_usb_write_capture(USB_Handle *handle, uint8_t const *data, uint32_t len, uint32_t timeout, int cmock_num_calls)
 {
     (void)handle;
+    (void)timeout;
     (void)cmock_num_calls;
 
     if (g_scpi_test_captured_response_len + len < SCPI_TEST_RESPONSE_BUFFER_SIZE) {
@@ -178,7 +185,7 @@ static void setup_protocol_for_dmm_test(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(scpi_mock_usb_rx_ready_check);
     USB_read_StubWithCallback(scpi_mock_usb_read_inject);
-    USB_write_StubWithCallback(scpi_mock_usb_write_capture);
+    USB_write_all_StubWithCallback(scpi_mock_usb_write_capture);
 }
 
 // ============================================================================
@@ -291,7 +298,7 @@ void test_scpi_initiate_voltage_dc_dmm_failure(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     protocol_task();
 
@@ -316,7 +323,7 @@ void test_scpi_fetch_voltage_dc_with_cached_value(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
     DMM_deinit_Expect(NULL); DMM_deinit_IgnoreArg_handle();
     DMM_init_ExpectAndReturn(NULL, g_mock_dmm_handle); DMM_init_IgnoreArg_config();
 
@@ -329,7 +336,7 @@ void test_scpi_fetch_voltage_dc_with_cached_value(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     // Mock reading from active DMM handle
     SYSTEM_get_tick_StubWithCallback(mock_system_get_tick_impl);
@@ -368,7 +375,7 @@ void test_scpi_fetch_voltage_dc_no_init(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     protocol_task();
 
@@ -461,7 +468,7 @@ void test_dmm_read_timeout_handling(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     protocol_task();
 
@@ -488,7 +495,7 @@ void test_dmm_configure_with_different_channels(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     DMM_init_ExpectAndReturn(NULL, g_mock_dmm_handle);
     DMM_init_IgnoreArg_config();
@@ -523,7 +530,7 @@ void test_dmm_multiple_measurements_same_channel(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     DMM_deinit_Expect(NULL); DMM_deinit_IgnoreArg_handle();
     DMM_init_ExpectAndReturn(NULL, g_mock_dmm_handle); DMM_init_IgnoreArg_config();
@@ -545,7 +552,7 @@ void test_dmm_multiple_measurements_same_channel(void)
     USB_task_Expect(g_mock_usb_handle);
     USB_rx_ready_StubWithCallback(mock_usb_rx_ready_check);
     USB_read_StubWithCallback(mock_usb_read_inject);
-    USB_write_StubWithCallback(mock_usb_write_capture);
+    USB_write_all_StubWithCallback(mock_usb_write_capture);
 
     DMM_deinit_Expect(NULL); DMM_deinit_IgnoreArg_handle();
     DMM_init_ExpectAndReturn(NULL, g_mock_dmm_handle); DMM_init_IgnoreArg_config();
@@ -4,7 +4,7 @@
  *
  * This file contains unit tests for the DSO protocol functionality covering:
  * - DSO SCPI command processing (OSC:CONF:*, OSC:INIT, OSC:FETC:*, etc.)
- * - DSO configuration validation (channel, timebase, buffer size)
+ * - DSO configuration validation (channel, timebase, buffer size, resolution)
  * - DSO error handling and recovery
  * - DSO state management and acquisition control
  * - DSO data retrieval and format validation
@@ -25,6 +25,8 @@
 #include "mock_dmm.h"
 #include "mock_dso.h"
 #include "mock_system.h"
+#include "mock_usb_stream.h"
+#include "mock_usbtmc.h"
 #include "scpi_test_helpers.h"
 
 #include "util/error.h"
@@ -71,6 +73,10 @@ void setUp(void)
     mock_usb_Init();
     mock_dso_Init();
     mock_system_Init();
+    mock_usb_stream_Init();
+    mock_usbtmc_Init();
+
+    scpi_test_default_ignores();
 }
 
 void tearDown(void)
@@ -88,6 +94,8 @@ void tearDown(void)
     mock_usb_Destroy();
     mock_dso_Destroy();
     mock_system_Destroy();
+    mock_usb_stream_Destroy();
+    mock_usbtmc_Destroy();
 }
 
 // ============================================================================
@@ -135,9 +143,90 @@ static void simulate_dso_acquisition_completion(void)
     dso_complete_callback();
 }
 
+// Zero-copy block held by the mock USB layer until USB_task runs
+static USB_TxBlock g_held_block;
+static bool g_held_block_pending;
+static int g_usb_task_calls;
+
+/**
+ * @brief Mock USB_write_block that holds the block, as if the host were slow
+ */
+static void mock_usb_write_block_hold(
+    USB_Handle *handle,
+    USB_TxBlock const *block,
+    int cmock_num_calls
+)
+{
+    (void)handle;
+    (void)cmock_num_calls;
+    g_held_block = *block;
+    g_held_block_pending = true;
+}
+
+static bool mock_usb_tx_block_pending(USB_Handle *handle, int cmock_num_calls)
+{
+    (void)handle;
+    (void)cmock_num_calls;
+    return g_held_block_pending;
+}
+
+/**
+ * @brief Mock USB_task that lets the host finish reading a held block
+ */
+static void mock_usb_task_release_block(USB_Handle *handle, int cmock_num_calls)
+{
+    (void)handle;
+    (void)cmock_num_calls;
+    g_usb_task_calls++;
+
+    if (g_held_block_pending) {
+        g_held_block_pending = false;
+        g_held_block.callback(g_held_block.context, true);
+    }
+}
+
+/**
+ * @brief Mock DSO_start that checks the acquisition buffer is not being sent
+ */
+static void mock_dso_start_check_unlocked(DSO_Handle *handle, int cmock_num_calls)
+{
+    (void)handle;
+    (void)cmock_num_calls;
+    TEST_ASSERT_FALSE_MESSAGE(g_held_block_pending, "Buffer overwritten while being sent");
+}
+
 /**
  * @brief Helper to initialize protocol for DSO tests
  */
+static DSO_Config g_captured_dso_config;
+
+/**
+ * @brief Mock DSO_init implementation that captures the configuration
+ */
+static DSO_Handle *mock_dso_init_capture(
+    DSO_Config const *config,
+    int cmock_num_calls
+)
+{
+    (void)cmock_num_calls;
+    g_captured_dso_config = *config;
+    return g_mock_dso_handle;
+}
+
+/**
+ * @brief Mock DSO_set_config implementation that captures the configuration
+ */
+static void mock_dso_set_config_capture(
+    DSO_Handle *handle,
+    DSO_Config const *config,
+    int cmock_num_calls
+)
+{
+    (void)handle;
+    (void)cmock_num_calls;
+    g_captured_dso_config = *config;
+}
+
 static void setup_protocol_for_dso_test(void)
 {
     USB_init_ExpectAndReturn(0, NULL, NULL, g_mock_usb_handle);
@@ -159,7 +248,7 @@ void test_scpi_configure_oscilloscope_channel_ch1(void)
     // Mock DSO configuration success
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
 
     // Act
     scpi_inject_usb_command("CONFigure:OSCilloscope:CHANnel CH1\n");
@@ -177,7 +266,7 @@ void test_scpi_configure_oscilloscope_channel_ch2(void)
 
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
 
     // Act
     scpi_inject_usb_command("OSC:CONF:CHAN CH2\n");
@@ -195,7 +284,7 @@ void test_scpi_configure_oscilloscope_channel_dual(void)
 
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_DUAL_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_DUAL_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
 
     // Act
     scpi_inject_usb_command("OSC:CONF:CHAN CH1CH2\n");
@@ -228,7 +317,7 @@ void test_scpi_configure_oscilloscope_channel_query(void)
     // Configure CH1 first
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
 
     // Mock the get_config call to return CH1 configuration
     DSO_Config mock_config = {
@@ -259,7 +348,7 @@ void test_scpi_configure_oscilloscope_timebase(void)
 
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
 
     // Act
     scpi_inject_usb_command("OSC:CONF:TIME 500\n"); // 500 µs/div
@@ -278,7 +367,7 @@ void test_scpi_configure_oscilloscope_timebase_query(void)
     // Configure timebase first
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
 
     // Act
     scpi_inject_usb_command("OSC:CONF:TIME 200\n");
@@ -298,7 +387,7 @@ void test_scpi_configure_oscilloscope_acquire_points(void)
 
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
 
     // Act
     scpi_inject_usb_command("OSC:CONF:ACQ:POIN 1024\n");
@@ -317,7 +406,7 @@ void test_scpi_configure_oscilloscope_acquire_points_query(void)
     // Configure points first
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 3000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 3000000);
 
     // Act
     scpi_inject_usb_command("OSC:CONF:ACQ:POIN 2048\n");
@@ -338,7 +427,7 @@ void test_scpi_configure_oscilloscope_acquire_srate_query(void)
     // Configure DSO first
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
 
     // Mock the get_config call to return sample rate
     DSO_Config mock_config = {
@@ -362,6 +451,156 @@ void test_scpi_configure_oscilloscope_acquire_srate_query(void)
     TEST_ASSERT_TRUE(strstr(response, "1500000") != NULL);
 }
 
+void test_scpi_configure_oscilloscope_resolution(void)
+{
+    // Arrange
+    setup_protocol_for_dso_test();
+
+    DSO_init_StubWithCallback(mock_dso_init_capture);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_8BIT, 4000000);
+
+    // Act
+    scpi_inject_usb_command("OSC:CONF:RES 8\n");
+    scpi_run_protocol_with_usb_mocks(g_mock_usb_handle);
+
+    // Assert
+    char const *response = scpi_get_captured_response();
+    TEST_ASSERT_EQUAL(0, strlen(response)); // OSC:CONF command generates no response
+    TEST_ASSERT_EQUAL(DSO_RESOLUTION_8BIT, g_captured_dso_config.resolution);
+    TEST_ASSERT_EQUAL(DSO_MODE_SINGLE_CHANNEL, g_captured_dso_config.mode);
+    TEST_ASSERT_EQUAL_UINT32(512, g_captured_dso_config.buffer_size);
+}
+
+void test_scpi_configure_oscilloscope_resolution_invalid(void)
+{
+    // Arrange
+    setup_protocol_for_dso_test();
+
+    // Act
+    scpi_inject_usb_command("OSC:CONF:RES 9\n");
+    scpi_inject_usb_command("SYST:ERR?\n");
+    scpi_run_protocol_with_usb_mocks(g_mock_usb_handle);
+
+    // Assert - Should generate SCPI error
+    TEST_ASSERT_SCPI_ERROR(scpi_get_captured_response());
+}
+
+void test_scpi_configure_oscilloscope_resolution_too_fast(void)
+{
+    // Arrange
+    setup_protocol_for_dso_test();
+
+    // 512 points over 10 us/div is 5.12 MSPS, above the 12-bit maximum
+    DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
+    DSO_init_IgnoreArg_config();
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_6BIT, 6000000);
+    DSO_Config mock_config = {
+        .mode = DSO_MODE_SINGLE_CHANNEL,
+        .channel = DSO_CHANNEL_0,
+        .resolution = DSO_RESOLUTION_6BIT,
+        .sample_rate = 5120000,
+        .buffer = NULL,
+        .buffer_size = 512,
+        .complete_callback = NULL
+    };
+    DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, false);
+    DSO_get_config_ExpectAndReturn(g_mock_dso_handle, mock_config);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_6BIT, 6000000);
+    DSO_set_config_Ignore();
+    DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, false);
+    DSO_get_config_ExpectAndReturn(g_mock_dso_handle, mock_config);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
+
+    // Act
+    scpi_inject_usb_command("OSC:CONF:RES 6\n");
+    scpi_inject_usb_command("OSC:CONF:TIME 10\n");
+    scpi_inject_usb_command("OSC:CONF:RES 12\n");
+    scpi_inject_usb_command("SYST:ERR?\n");
+    scpi_run_protocol_with_usb_mocks(g_mock_usb_handle);
+
+    // Assert - Should generate SCPI error
+    TEST_ASSERT_SCPI_ERROR(scpi_get_captured_response());
+}
+
+void test_scpi_configure_oscilloscope_resolution_query(void)
+{
+    // Arrange
+    setup_protocol_for_dso_test();
+
+    DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
+    DSO_init_IgnoreArg_config();
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_10BIT, 2500000);
+
+    // Mock the get_config call to return the configured resolution
+    DSO_Config mock_config = {
+        .mode = DSO_MODE_SINGLE_CHANNEL,
+        .channel = DSO_CHANNEL_0,
+        .resolution = DSO_RESOLUTION_10BIT,
+        .sample_rate = 512000,
+        .buffer = NULL,
+        .buffer_size = 512,
+        .complete_callback = NULL
+    };
+    DSO_get_config_ExpectAndReturn(g_mock_dso_handle, mock_config);
+
+    // Act
+    scpi_inject_usb_command("OSC:CONF:RES 10\n");
+    scpi_inject_usb_command("OSC:CONF:RES?\n");
+    scpi_run_protocol_with_usb_mocks(g_mock_usb_handle);
+
+    // Assert
+    TEST_ASSERT_EQUAL_STRING("10\r\n", scpi_get_captured_response());
+}
+
+void test_scpi_configure_oscilloscope_resolution_query_default(void)
+{
+    // Arrange
+    setup_protocol_for_dso_test();
+
+    // Act
+    scpi_inject_usb_command("OSC:CONF:RES?\n");
+    scpi_run_protocol_with_usb_mocks(g_mock_usb_handle);
+
+    // Assert
+    TEST_ASSERT_EQUAL_STRING("12\r\n", scpi_get_captured_response());
+}
+
+void test_scpi_configure_oscilloscope_resolution_kept_by_other_settings(void)
+{
+    // Arrange
+    setup_protocol_for_dso_test();
+
+    DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
+    DSO_init_IgnoreArg_config();
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_8BIT, 4000000);
+
+    // The points change starts from the stored 8-bit configuration
+    DSO_Config mock_config = {
+        .mode = DSO_MODE_SINGLE_CHANNEL,
+        .channel = DSO_CHANNEL_0,
+        .resolution = DSO_RESOLUTION_8BIT,
+        .sample_rate = 512000,
+        .buffer = NULL,
+        .buffer_size = 512,
+        .complete_callback = NULL
+    };
+    DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, false);
+    DSO_get_config_ExpectAndReturn(g_mock_dso_handle, mock_config);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_8BIT, 4000000);
+    DSO_set_config_StubWithCallback(mock_dso_set_config_capture);
+
+    // Act
+    scpi_inject_usb_command("OSC:CONF:RES 8\n");
+    scpi_inject_usb_command("OSC:CONF:ACQ:POIN 1024\n");
+    scpi_run_protocol_with_usb_mocks(g_mock_usb_handle);
+
+    // Assert - 1024 points over 1 ms
+    TEST_ASSERT_EQUAL(0, strlen(scpi_get_captured_response()));
+    TEST_ASSERT_EQUAL(DSO_RESOLUTION_8BIT, g_captured_dso_config.resolution);
+    TEST_ASSERT_EQUAL_UINT32(1024, g_captured_dso_config.buffer_size);
+    TEST_ASSERT_EQUAL_UINT32(1024000, g_captured_dso_config.sample_rate);
+}
+
 // ============================================================================
 // SCPI Command Tests - DSO Operation Commands
 // ============================================================================
@@ -374,7 +613,7 @@ void test_scpi_initiate_oscilloscope_success(void)
     // Configure DSO first
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
     DSO_start_Expect(g_mock_dso_handle);
 
     // Act
@@ -391,7 +630,7 @@ void test_scpi_initiate_oscilloscope_not_configured(void)
 {
     // Arrange
     setup_protocol_for_dso_test();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
     DSO_start_Expect(g_mock_dso_handle);
@@ -411,7 +650,7 @@ void test_scpi_fetch_oscilloscope_data_success(void)
     setup_protocol_for_dso_test();
 
     // Configure and initiate DSO first
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
     DSO_start_Expect(g_mock_dso_handle);
@@ -453,13 +692,108 @@ void test_scpi_fetch_oscilloscope_data_not_initiated(void)
     TEST_ASSERT_SCPI_ERROR(scpi_get_captured_response());
 }
 
+void test_scpi_fetch_oscilloscope_data_zero_copy(void)
+{
+    // Arrange
+    setup_protocol_for_dso_test();
+    g_held_block_pending = false;
+    g_usb_task_calls = 0;
+
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
+    DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
+    DSO_init_IgnoreArg_config();
+    DSO_start_StubWithCallback(mock_dso_start_check_unlocked);
+    DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, true);
+    DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, false);
+    DSO_stop_Expect(g_mock_dso_handle);
+    SYSTEM_get_tick_StubWithCallback(mock_system_get_tick_immediate_completion);
+
+    USB_task_StubWithCallback(mock_usb_task_release_block);
+    USB_rx_ready_StubWithCallback(scpi_mock_usb_rx_ready_check);
+    USB_read_StubWithCallback(scpi_mock_usb_read_inject);
+    USB_write_all_StubWithCallback(scpi_mock_usb_write_capture);
+    USB_write_block_StubWithCallback(mock_usb_write_block_hold);
+    USB_tx_block_pending_StubWithCallback(mock_usb_tx_block_pending);
+
+    // Act - the second INIT arrives while the record is still being sent
+    scpi_inject_usb_command("OSC:CONF:CHAN CH1\n");
+    scpi_inject_usb_command("OSC:INIT\n");
+    scpi_inject_usb_command("OSC:FETCH:DATA?\n");
+    scpi_inject_usb_command("OSC:INIT\n");
+    protocol_task();
+
+    // Assert - only the block header went through the TX buffer
+    TEST_ASSERT_EQUAL_STRING("#41024\r\n", scpi_get_captured_response());
+    TEST_ASSERT_NOT_NULL(g_held_block.data);
+    TEST_ASSERT_EQUAL_UINT32(512 * sizeof(uint16_t), g_held_block.size);
+
+    // The second INIT waited for the host to read the buffer
+    TEST_ASSERT_FALSE(g_held_block_pending);
+    TEST_ASSERT_TRUE(g_usb_task_calls > 1);
+}
+
+void test_scpi_fetch_oscilloscope_bulk(void)
+{
+    // Arrange
+    setup_protocol_for_dso_test();
+
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
+    DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
+    DSO_init_IgnoreArg_config();
+    DSO_start_Expect(g_mock_dso_handle);
+    DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, true);
+    DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, false);
+    DSO_stop_Expect(g_mock_dso_handle);
+    SYSTEM_get_tick_StubWithCallback(mock_system_get_tick_immediate_completion);
+
+    USB_STREAM_ready_ExpectAndReturn(true);
+    USB_STREAM_write_frame_ExpectAndReturn(USB_STREAM_TYPE_DSO_RECORD, NULL, 512 * sizeof(uint16_t), 1000, 42);
+    USB_STREAM_write_frame_IgnoreArg_payload();
+
+    // Act
+    scpi_inject_usb_command("OSC:CONF:CHAN CH1\n");
+    scpi_inject_usb_command("OSC:INIT\n");
+    scpi_inject_usb_command("OSC:FETC:BULK?\n");
+    scpi_run_protocol_with_usb_mocks(g_mock_usb_handle);
+
+    // Assert - the record went over the bulk pipe, only its number over SCPI
+    TEST_ASSERT_EQUAL_STRING("42\r\n", scpi_get_captured_response());
+}
+
+void test_scpi_fetch_oscilloscope_bulk_not_connected(void)
+{
+    // Arrange
+    setup_protocol_for_dso_test();
+
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
+    DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
+    DSO_init_IgnoreArg_config();
+    DSO_start_Expect(g_mock_dso_handle);
+    DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, true);
+    DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, false);
+    DSO_stop_Expect(g_mock_dso_handle);
+    SYSTEM_get_tick_StubWithCallback(mock_system_get_tick_immediate_completion);
+
+    USB_STREAM_ready_ExpectAndReturn(false);
+
+    // Act
+    scpi_inject_usb_command("OSC:CONF:CHAN CH1\n");
+    scpi_inject_usb_command("OSC:INIT\n");
+    scpi_inject_usb_command("OSC:FETC:BULK?\n");
+    scpi_inject_usb_command("SYST:ERR?\n");
+    scpi_run_protocol_with_usb_mocks(g_mock_usb_handle);
+
+    // Assert
+    TEST_ASSERT_SCPI_ERROR(scpi_get_captured_response());
+}
+
 void test_scpi_read_oscilloscope_complete_flow(void)
 {
     // Arrange
     setup_protocol_for_dso_test();
 
     // Mock the complete READ flow (INIT + FETCH)
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
     // READ checks for acquisition in progress and aborts if true
     DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, false);
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
@@ -494,7 +828,7 @@ void test_scpi_measure_oscilloscope_complete_flow(void)
     setup_protocol_for_dso_test();
 
     // Mock the complete MEASURE flow (CONF + READ)
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_DUAL_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_DUAL_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
     DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, false);
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
@@ -528,7 +862,7 @@ void test_scpi_abort_oscilloscope(void)
     // Configure and start acquisition first
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
     DSO_start_Expect(g_mock_dso_handle);
     DSO_stop_Expect(g_mock_dso_handle);
     DSO_deinit_Expect(g_mock_dso_handle);
@@ -567,7 +901,7 @@ void test_scpi_status_oscilloscope_acquisition_query_running_complete(void)
     // Configure and start acquisition
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
     DSO_start_Expect(g_mock_dso_handle);
     DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, true);
 
@@ -608,7 +942,7 @@ void test_dso_configuration_invalid_sample_rate(void)
     // Mock sample rate validation failure
     DSO_init_ExpectAndThrow(NULL, ERROR_INVALID_ARGUMENT);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 1000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 1000000);
 
     // Act
     scpi_inject_usb_command("OSC:CONF:TIME 1\n"); // Very fast timebase causing invalid sample rate
@@ -627,7 +961,7 @@ void test_dso_start_failure(void)
     // Configure DSO first
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
 
     // Mock DSO start failure
     DSO_start_ExpectAndThrow(g_mock_dso_handle, ERROR_HARDWARE_FAULT);
@@ -650,7 +984,7 @@ void test_dso_configuration_during_acquisition(void)
     // Configure and start acquisition
     DSO_init_ExpectAndReturn(NULL, g_mock_dso_handle);
     DSO_init_IgnoreArg_config();
-    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, 2000000);
+    DSO_get_max_sample_rate_ExpectAndReturn(DSO_MODE_SINGLE_CHANNEL, DSO_RESOLUTION_12BIT, 2000000);
     DSO_start_Expect(g_mock_dso_handle);
     DSO_is_acquisition_in_progress_ExpectAndReturn(g_mock_dso_handle, true);
 
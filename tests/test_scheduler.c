@@ -0,0 +1,321 @@
+/**
+ * @file test_scheduler.c
+ * @brief Unit tests for the cooperative task scheduler
+ *
+ * This file contains unit tests for the scheduler, including periodic and
+ * signalled releases, priority ordering, deadline accounting and the idle
+ * hook. Time is driven by the fake cycle counter.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "unity.h"
+#include "fake_clock.h"
+
+#include "util/error.h"
+
+#include "scheduler.h"
+
+// Implemented in timebase.c, called from SYSTEM_init on target
+void timebase_init(void);
+
+// Task run bookkeeping
+static int g_runs[SCHED_MAX_TASKS];
+static int g_run_order[16];
+static int g_run_order_count;
+static uint32_t g_task_runtime_us;
+static uint64_t g_idle_next_release;
+static int g_idle_calls;
+
+static void record_task(void *context)
+{
+    int id = (int)(intptr_t)context;
+    g_runs[id]++;
+    if (g_run_order_count < (int)(sizeof(g_run_order) / sizeof(int))) {
+        g_run_order[g_run_order_count++] = id;
+    }
+    if (g_task_runtime_us > 0) {
+        FAKE_CLOCK_advance_us(g_task_runtime_us);
+    }
+}
+
+static void idle_hook(uint64_t next_release_us)
+{
+    g_idle_calls++;
+    g_idle_next_release = next_release_us;
+}
+
+static SCHED_Task *add_task(
+    int id,
+    SCHED_Priority priority,
+    uint32_t period_us,
+    uint32_t deadline_us
+)
+{
+    SCHED_TaskConfig config = {
+        .name = "test",
+        .function = record_task,
+        .context = (void *)(intptr_t)id,
+        .priority = priority,
+        .period_us = period_us,
+        .deadline_us = deadline_us,
+    };
+    return SCHED_add_task(&config);
+}
+
+void setUp(void)
+{
+    FAKE_CLOCK_reset();
+    timebase_init();
+    SCHED_init();
+
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        g_runs[i] = 0;
+    }
+    g_run_order_count = 0;
+    g_task_runtime_us = 0;
+    g_idle_next_release = 0;
+    g_idle_calls = 0;
+}
+
+void tearDown(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0, FAKE_CLOCK_get_critical_depth());
+}
+
+void test_SCHED_periodic_task_runs_once_per_period(void)
+{
+    add_task(0, SCHED_PRIORITY_NORMAL, 1000, 0);
+
+    TEST_ASSERT_FALSE(SCHED_run_once());
+    FAKE_CLOCK_advance_us(999);
+    TEST_ASSERT_FALSE(SCHED_run_once());
+
+    FAKE_CLOCK_advance_us(1);
+    TEST_ASSERT_TRUE(SCHED_run_once());
+    TEST_ASSERT_FALSE(SCHED_run_once());
+
+    FAKE_CLOCK_advance_us(1000);
+    TEST_ASSERT_TRUE(SCHED_run_once());
+    TEST_ASSERT_EQUAL_INT(2, g_runs[0]);
+}
+
+void test_SCHED_event_task_runs_only_when_signalled(void)
+{
+    SCHED_Task *task = add_task(0, SCHED_PRIORITY_NORMAL, 0, 0);
+
+    FAKE_CLOCK_advance_us(10000);
+    TEST_ASSERT_FALSE(SCHED_run_once());
+
+    // Signals before the task runs are merged
+    SCHED_signal(task);
+    SCHED_signal(task);
+    TEST_ASSERT_TRUE(SCHED_run_once());
+    TEST_ASSERT_FALSE(SCHED_run_once());
+    TEST_ASSERT_EQUAL_INT(1, g_runs[0]);
+}
+
+void test_SCHED_higher_priority_runs_first(void)
+{
+    SCHED_Task *low = add_task(0, SCHED_PRIORITY_LOW, 0, 0);
+    SCHED_Task *high = add_task(1, SCHED_PRIORITY_HIGH, 0, 0);
+
+    SCHED_signal(low);
+    FAKE_CLOCK_advance_us(10);
+    SCHED_signal(high);
+
+    TEST_ASSERT_TRUE(SCHED_run_once());
+    TEST_ASSERT_TRUE(SCHED_run_once());
+    TEST_ASSERT_EQUAL_INT(2, g_run_order_count);
+    TEST_ASSERT_EQUAL_INT(1, g_run_order[0]);
+    TEST_ASSERT_EQUAL_INT(0, g_run_order[1]);
+}
+
+void test_SCHED_equal_priority_runs_longest_waiting_first(void)
+{
+    SCHED_Task *first = add_task(0, SCHED_PRIORITY_NORMAL, 0, 0);
+    SCHED_Task *second = add_task(1, SCHED_PRIORITY_NORMAL, 0, 0);
+
+    SCHED_signal(second);
+    FAKE_CLOCK_advance_us(10);
+    SCHED_signal(first);
+
+    SCHED_run_once();
+    SCHED_run_once();
+    TEST_ASSERT_EQUAL_INT(1, g_run_order[0]);
+    TEST_ASSERT_EQUAL_INT(0, g_run_order[1]);
+}
+
+void test_SCHED_counts_deadline_misses_and_latency(void)
+{
+    SCHED_Task *task = add_task(0, SCHED_PRIORITY_NORMAL, 1000, 200);
+
+    // Started 100 us after release: within deadline
+    FAKE_CLOCK_advance_us(1100);
+    SCHED_run_once();
+
+    // Started 500 us after release: missed
+    FAKE_CLOCK_advance_us(1400);
+    SCHED_run_once();
+
+    SCHED_TaskStats stats = SCHED_get_stats(task);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.run_count);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.deadline_misses);
+    TEST_ASSERT_EQUAL_UINT32(500, stats.max_latency_us);
+
+    SCHED_reset_stats();
+    stats = SCHED_get_stats(task);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.run_count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.deadline_misses);
+}
+
+void test_SCHED_records_task_runtime(void)
+{
+    SCHED_Task *task = add_task(0, SCHED_PRIORITY_NORMAL, 0, 0);
+    g_task_runtime_us = 300;
+
+    SCHED_signal(task);
+    SCHED_run_once();
+
+    TEST_ASSERT_EQUAL_UINT32(300, SCHED_get_stats(task).max_runtime_us);
+}
+
+void test_SCHED_drops_releases_missed_by_more_than_a_period(void)
+{
+    add_task(0, SCHED_PRIORITY_NORMAL, 1000, 0);
+
+    FAKE_CLOCK_advance_us(10500);
+    TEST_ASSERT_TRUE(SCHED_run_once());
+    TEST_ASSERT_FALSE(SCHED_run_once());
+
+    FAKE_CLOCK_advance_us(1000);
+    TEST_ASSERT_TRUE(SCHED_run_once());
+    TEST_ASSERT_EQUAL_INT(2, g_runs[0]);
+}
+
+void test_SCHED_idle_hook_gets_next_release(void)
+{
+    SCHED_set_idle_hook(idle_hook);
+    add_task(0, SCHED_PRIORITY_NORMAL, 5000, 0);
+    add_task(1, SCHED_PRIORITY_NORMAL, 2000, 0);
+
+    TEST_ASSERT_FALSE(SCHED_run_once());
+    TEST_ASSERT_EQUAL_INT(1, g_idle_calls);
+    TEST_ASSERT_EQUAL_UINT64(2000, g_idle_next_release);
+}
+
+void test_SCHED_idle_hook_without_periodic_tasks(void)
+{
+    SCHED_set_idle_hook(idle_hook);
+    add_task(0, SCHED_PRIORITY_NORMAL, 0, 0);
+
+    SCHED_run_once();
+    TEST_ASSERT_EQUAL_UINT64(UINT64_MAX, g_idle_next_release);
+}
+
+void test_SCHED_removed_task_does_not_run(void)
+{
+    SCHED_Task *task = add_task(0, SCHED_PRIORITY_NORMAL, 0, 0);
+
+    SCHED_signal(task);
+    SCHED_remove_task(task);
+
+    TEST_ASSERT_FALSE(SCHED_run_once());
+    TEST_ASSERT_EQUAL_INT(0, g_runs[0]);
+}
+
+static SCHED_Task *g_self_removing_task;
+
+static void remove_self_task(void *context)
+{
+    record_task(context);
+    SCHED_remove_task(g_self_removing_task);
+}
+
+void test_SCHED_task_can_remove_itself(void)
+{
+    g_self_removing_task = SCHED_add_task(&(SCHED_TaskConfig){
+        .name = "test",
+        .function = remove_self_task,
+        .context = (void *)(intptr_t)0,
+        .priority = SCHED_PRIORITY_NORMAL,
+        .period_us = 1000,
+    });
+
+    FAKE_CLOCK_advance_us(1000);
+    TEST_ASSERT_TRUE(SCHED_run_once());
+    FAKE_CLOCK_advance_us(1000);
+    TEST_ASSERT_FALSE(SCHED_run_once());
+    TEST_ASSERT_EQUAL_INT(1, g_runs[0]);
+
+    // The freed slot is handed out again with clean statistics
+    SCHED_Task *task = add_task(1, SCHED_PRIORITY_NORMAL, 0, 0);
+    TEST_ASSERT_EQUAL_PTR(g_self_removing_task, task);
+    TEST_ASSERT_EQUAL_UINT32(0, SCHED_get_stats(task).run_count);
+}
+
+void test_SCHED_add_task_pool_exhausted(void)
+{
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        add_task(i, SCHED_PRIORITY_NORMAL, 0, 0);
+    }
+
+    Error error = ERROR_NONE;
+    TRY { add_task(0, SCHED_PRIORITY_NORMAL, 0, 0); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_OUT_OF_MEMORY, error);
+}
+
+void test_SCHED_add_task_invalid_config(void)
+{
+    SCHED_TaskConfig config = { .name = "test" };
+
+    Error error = ERROR_NONE;
+    TRY { SCHED_add_task(&config); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+
+    error = ERROR_NONE;
+    TRY { SCHED_add_task(NULL); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+}
+
+void test_SCHED_measures_wake_to_service_latency(void)
+{
+    SCHED_Task *task = add_task(0, SCHED_PRIORITY_NORMAL, 0, 0);
+
+    FAKE_CLOCK_advance_us(1000);
+    SCHED_notify_wake(1000);
+    SCHED_signal(task);
+    FAKE_CLOCK_advance_us(7);
+    TEST_ASSERT_TRUE(SCHED_run_once());
+
+    SCHED_WakeStats stats = SCHED_get_wake_stats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.wake_count);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.serviced_count);
+    TEST_ASSERT_EQUAL_UINT32(7, stats.max_latency_us);
+    TEST_ASSERT_EQUAL_UINT64(7, stats.total_latency_us);
+}
+
+void test_SCHED_wake_without_ready_task_is_not_serviced(void)
+{
+    SCHED_Task *task = add_task(0, SCHED_PRIORITY_NORMAL, 0, 0);
+
+    SCHED_notify_wake(0);
+    TEST_ASSERT_FALSE(SCHED_has_ready_task());
+    TEST_ASSERT_FALSE(SCHED_run_once());
+
+    // A later run is not attributed to the earlier wake-up
+    SCHED_signal(task);
+    TEST_ASSERT_TRUE(SCHED_has_ready_task());
+    SCHED_run_once();
+
+    SCHED_WakeStats stats = SCHED_get_wake_stats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.wake_count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.serviced_count);
+}
@@ -9,6 +9,7 @@
 #include "unity.h"
 #include "mock_platform.h"
 #include "mock_uart_ll.h"
+#include "mock_usb.h"
 
 #include "util/error.h"
 #include "uart.h"
@@ -25,6 +26,8 @@ int _fstat_r(struct _reent *r, int fd, struct stat *st);
 int _isatty_r(struct _reent *r, int fd);
 void syscalls_init(UART_Handle *handle);
 void syscalls_deinit(UART_Handle *handle);
+void syscalls_init_usb(USB_Handle *handle);
+void syscalls_deinit_usb(USB_Handle *handle);
 
 // Test fixtures
 static struct _reent test_reent;
@@ -41,6 +44,7 @@ void setUp(void)
 
     // Initialize mocks
     mock_uart_ll_Init();
+    mock_usb_Init();
 
     // Set up default ignores for all UART_LL functions to avoid argument validation issues
     UART_LL_init_Ignore();
@@ -69,6 +73,7 @@ void tearDown(void)
 
     // Clean up mocks
     mock_uart_ll_Destroy();
+    mock_usb_Destroy();
 }
 
 // Test _write_r function for stdout
@@ -431,3 +436,57 @@ void test_syscalls_deinit_wrong_handle(void)
     // Clean up
     UART_deinit(wrong_handle);
 }
+
+// Test _write_r on the USB console: each write is sent as a message
+void test_write_r_usb_console(void)
+{
+    // Arrange - move output from UART to a USB handle
+    static int usb_handle_storage;
+    USB_Handle *usb_handle = (USB_Handle *)&usb_handle_storage;
+    syscalls_deinit(test_uart_handle);
+    syscalls_init_usb(usb_handle);
+
+    char test_data[] = "[INFO] USB console\r\n";
+    size_t data_len = strlen(test_data);
+    USB_write_ExpectAndReturn(
+        usb_handle, (uint8_t const *)test_data, data_len, data_len
+    );
+    USB_tx_flush_Expect(usb_handle);
+
+    // Act
+    _ssize_t result = _write_r(&test_reent, STDOUT_FILENO, test_data, data_len);
+
+    // Assert
+    TEST_ASSERT_EQUAL(data_len, result);
+
+    // A full TX buffer is reported as for UART
+    USB_write_ExpectAndReturn(
+        usb_handle, (uint8_t const *)test_data, data_len, 0
+    );
+    USB_tx_flush_Expect(usb_handle);
+    result = _write_r(&test_reent, STDERR_FILENO, test_data, data_len);
+    TEST_ASSERT_EQUAL(-1, result);
+    TEST_ASSERT_EQUAL(EAGAIN, test_reent._errno);
+
+    // Re-initialize for tearDown
+    syscalls_deinit_usb(usb_handle);
+    syscalls_init(test_uart_handle);
+}
+
+// Test syscalls_init_usb while UART output is set (should throw)
+void test_syscalls_init_usb_already_initialized(void)
+{
+    // Arrange - syscalls is already initialized with UART in setUp
+    static int usb_handle_storage;
+    USB_Handle *usb_handle = (USB_Handle *)&usb_handle_storage;
+
+    Error caught_error = ERROR_NONE;
+
+    // Act & Assert
+    TRY {
+        syscalls_init_usb(usb_handle);
+        TEST_FAIL_MESSAGE("Expected ERROR_RESOURCE_BUSY to be thrown");
+    } CATCH(caught_error) {
+        TEST_ASSERT_EQUAL(ERROR_RESOURCE_BUSY, caught_error);
+    }
+}
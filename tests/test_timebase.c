@@ -0,0 +1,104 @@
+/**
+ * @file test_timebase.c
+ * @brief Unit tests for the monotonic timebase
+ *
+ * This file contains unit tests for the 64-bit timebase, including counter
+ * wrap extension and cycle to microsecond conversion. The cycle counter is
+ * replaced by the fake clock.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdint.h>
+
+#include "unity.h"
+#include "fake_clock.h"
+
+#include "system.h"
+
+// Implemented in timebase.c, called from SYSTEM_init on target
+void timebase_init(void);
+
+void setUp(void)
+{
+    FAKE_CLOCK_reset();
+    timebase_init();
+}
+
+void tearDown(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0, FAKE_CLOCK_get_critical_depth());
+}
+
+void test_timebase_starts_at_zero(void)
+{
+    TEST_ASSERT_EQUAL_UINT64(0, SYSTEM_get_cycles());
+    TEST_ASSERT_EQUAL_UINT64(0, SYSTEM_get_time_us());
+}
+
+void test_timebase_time_follows_cycle_counter(void)
+{
+    FAKE_CLOCK_advance_us(1500);
+
+    TEST_ASSERT_EQUAL_UINT64(375000, SYSTEM_get_cycles());
+    TEST_ASSERT_EQUAL_UINT64(1500, SYSTEM_get_time_us());
+}
+
+void test_timebase_extends_counter_across_wrap(void)
+{
+    FAKE_CLOCK_set_count(0xFFFFFFF0);
+    TEST_ASSERT_EQUAL_UINT64(0xFFFFFFF0, SYSTEM_get_cycles());
+
+    FAKE_CLOCK_advance_cycles(0x20);
+
+    TEST_ASSERT_EQUAL_UINT64(0x100000010, SYSTEM_get_cycles());
+    TEST_ASSERT_EQUAL_UINT32(0x10, SYSTEM_get_cycles32());
+}
+
+void test_timebase_tick_tracks_wraps_without_readers(void)
+{
+    // 60 s at 250 MHz wraps the 32-bit counter three times
+    uint64_t const duration_us = 60000000;
+
+    FAKE_CLOCK_advance_us(duration_us);
+
+    TEST_ASSERT_EQUAL_UINT64(duration_us, SYSTEM_get_time_us());
+}
+
+void test_timebase_is_monotonic(void)
+{
+    uint64_t previous = SYSTEM_get_time_us();
+
+    for (int i = 0; i < 100; i++) {
+        FAKE_CLOCK_advance_us(250);
+        uint64_t now = SYSTEM_get_time_us();
+        TEST_ASSERT_TRUE(now >= previous);
+        previous = now;
+    }
+}
+
+void test_timebase_cycles_to_us_does_not_overflow(void)
+{
+    // 100000 s worth of cycles overflows a plain cycles * 10^6
+    uint64_t const cycles = (uint64_t)FAKE_CLOCK_DEFAULT_FREQUENCY * 100000;
+
+    TEST_ASSERT_EQUAL_UINT64(100000000000ULL, SYSTEM_cycles_to_us(cycles));
+}
+
+void test_timebase_follows_cycle_frequency(void)
+{
+    FAKE_CLOCK_set_frequency(64000000);
+    FAKE_CLOCK_advance_cycles(64000);
+
+    TEST_ASSERT_EQUAL_UINT32(64000000, SYSTEM_get_cycle_frequency());
+    TEST_ASSERT_EQUAL_UINT64(1000, SYSTEM_get_time_us());
+}
+
+void test_timebase_zero_frequency_reports_zero_time(void)
+{
+    FAKE_CLOCK_set_frequency(0);
+    FAKE_CLOCK_advance_cycles(1000);
+
+    TEST_ASSERT_EQUAL_UINT64(0, SYSTEM_get_time_us());
+}
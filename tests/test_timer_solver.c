@@ -0,0 +1,253 @@
+/**
+ * @file test_timer_solver.c
+ * @brief Unit tests for the timer prescaler and auto-reload solver
+ *
+ * Tests cover exact divisions, the 16-bit auto-reload limit at low rates,
+ * 32-bit timers, rounding ties, the bound on the prescaler search and the
+ * achieved frequency. The rate error is checked against a brute-force search
+ * over the same prescaler range.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdint.h>
+
+#include "unity.h"
+
+#include "util/error.h"
+#include "util/timer_solver.h"
+
+enum {
+    TIMER_CLOCK = 250000000, // Timer clock of the target
+    MAX_PERIOD_16 = 0xFFFF,
+};
+
+#define MAX_PERIOD_32 0xFFFFFFFFU
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+/**
+ * @brief Distance between the clock and the divided update period
+ */
+static uint64_t period_error(uint32_t clock, uint32_t freq, uint64_t divider)
+{
+    uint64_t const actual = (uint64_t)freq * divider;
+    return actual > clock ? actual - clock : clock - actual;
+}
+
+/**
+ * @brief Smallest error of any pair in the solver's prescaler range
+ */
+static uint64_t best_error(uint32_t clock, uint32_t freq, uint32_t max_period)
+{
+    uint64_t const max_counts = (uint64_t)max_period + 1;
+    uint64_t const divider = ((uint64_t)clock + freq / 2) / freq;
+    uint64_t const first = (divider + max_counts - 1) / max_counts;
+    uint64_t best = UINT64_MAX;
+
+    for (uint64_t psc = first; psc <= first + TIMER_SOLVER_MAX_STEPS; psc++) {
+        uint64_t const counts = clock / ((uint64_t)freq * psc);
+        for (uint64_t c = counts; c <= counts + 1; c++) {
+            if (c < TIMER_SOLVER_MIN_COUNTS || c > max_counts) {
+                continue;
+            }
+            uint64_t const error = period_error(clock, freq, psc * c);
+            if (error < best) {
+                best = error;
+            }
+        }
+    }
+
+    return best;
+}
+
+static uint64_t values_divider(TIMER_SOLVER_Values values)
+{
+    return ((uint64_t)values.prescaler + 1) * ((uint64_t)values.period + 1);
+}
+
+static Error solve_error(uint32_t clock, uint32_t freq, uint32_t max_period)
+{
+    Error error = ERROR_NONE;
+    TRY { TIMER_SOLVER_solve(clock, freq, max_period); }
+    CATCH(error) {}
+    return error;
+}
+
+void test_TIMER_SOLVER_exact_division_uses_no_prescaler(void)
+{
+    TIMER_SOLVER_Values const values =
+        TIMER_SOLVER_solve(TIMER_CLOCK, 1000000, MAX_PERIOD_16);
+
+    TEST_ASSERT_EQUAL_UINT32(0, values.prescaler);
+    TEST_ASSERT_EQUAL_UINT32(249, values.period);
+    TEST_ASSERT_EQUAL_UINT32(
+        1000000, TIMER_SOLVER_get_frequency(TIMER_CLOCK, values)
+    );
+}
+
+void test_TIMER_SOLVER_low_rate_fits_16_bit_period(void)
+{
+    // 10 Hz needs a division of 25e6, far beyond a 16-bit ARR
+    TIMER_SOLVER_Values const values =
+        TIMER_SOLVER_solve(TIMER_CLOCK, 10, MAX_PERIOD_16);
+
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(MAX_PERIOD_16, values.period);
+    TEST_ASSERT_EQUAL_UINT64(25000000, values_divider(values));
+    TEST_ASSERT_EQUAL_UINT32(
+        10, TIMER_SOLVER_get_frequency(TIMER_CLOCK, values)
+    );
+}
+
+void test_TIMER_SOLVER_lowest_rate_on_16_bit_timer(void)
+{
+    // 1 Hz: PSC is at least 3814, as 250e6 / 3814 > 65536 counts
+    TIMER_SOLVER_Values const values =
+        TIMER_SOLVER_solve(TIMER_CLOCK, 1, MAX_PERIOD_16);
+
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(3814, values.prescaler);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(MAX_PERIOD_16, values.period);
+    TEST_ASSERT_EQUAL_UINT64(250000000, values_divider(values));
+}
+
+void test_TIMER_SOLVER_32_bit_timer_needs_no_prescaler(void)
+{
+    TIMER_SOLVER_Values values =
+        TIMER_SOLVER_solve(TIMER_CLOCK, 10, MAX_PERIOD_32);
+    TEST_ASSERT_EQUAL_UINT32(0, values.prescaler);
+    TEST_ASSERT_EQUAL_UINT32(24999999, values.period);
+
+    values = TIMER_SOLVER_solve(TIMER_CLOCK, 1, MAX_PERIOD_32);
+    TEST_ASSERT_EQUAL_UINT32(0, values.prescaler);
+    TEST_ASSERT_EQUAL_UINT32(249999999, values.period);
+}
+
+void test_TIMER_SOLVER_32_bit_period_does_not_overflow(void)
+{
+    // The largest clock divides into 1 Hz with an ARR of 2^32 - 2
+    TIMER_SOLVER_Values const values =
+        TIMER_SOLVER_solve(0xFFFFFFFFU, 1, MAX_PERIOD_32);
+
+    TEST_ASSERT_EQUAL_UINT64(0xFFFFFFFFU, values_divider(values));
+    TEST_ASSERT_EQUAL_UINT32(
+        1, TIMER_SOLVER_get_frequency(0xFFFFFFFFU, values)
+    );
+}
+
+void test_TIMER_SOLVER_period_tie_rounds_to_longer_period(void)
+{
+    // 1000 / 400 = 2.5 counts; 2 and 3 counts are equally far off
+    TIMER_SOLVER_Values const values = TIMER_SOLVER_solve(1000, 400, 0xFFFF);
+
+    TEST_ASSERT_EQUAL_UINT32(0, values.prescaler);
+    TEST_ASSERT_EQUAL_UINT32(2, values.period);
+}
+
+void test_TIMER_SOLVER_prescaler_tie_keeps_smaller_prescaler(void)
+{
+    // 100 / 3: 1 x 33 and 3 x 11 counts are both one clock short
+    TIMER_SOLVER_Values const values = TIMER_SOLVER_solve(100, 3, 0xFFFF);
+
+    TEST_ASSERT_EQUAL_UINT32(0, values.prescaler);
+    TEST_ASSERT_EQUAL_UINT32(32, values.period);
+}
+
+void test_TIMER_SOLVER_search_is_bounded(void)
+{
+    // A prime clock has no exact division, so the search runs to its cap
+    uint32_t const clock = 249999991;
+    uint32_t const freq = 1;
+    TIMER_SOLVER_Values const values =
+        TIMER_SOLVER_solve(clock, freq, MAX_PERIOD_16);
+
+    uint32_t const min_prescaler = clock / (MAX_PERIOD_16 + 1);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(min_prescaler, values.prescaler);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(
+        min_prescaler + TIMER_SOLVER_MAX_STEPS, values.prescaler
+    );
+    TEST_ASSERT_EQUAL_UINT64(
+        best_error(clock, freq, MAX_PERIOD_16),
+        period_error(clock, freq, values_divider(values))
+    );
+}
+
+void test_TIMER_SOLVER_minimizes_rate_error(void)
+{
+    static uint32_t const FREQS[] = {
+        1,      7,      333,     1000,    44100,    96001,
+        123457, 999999, 3000000, 7000000, 41666666, 125000000,
+    };
+    static uint32_t const MAX_PERIODS[] = { MAX_PERIOD_16, MAX_PERIOD_32 };
+
+    for (size_t p = 0; p < sizeof(MAX_PERIODS) / sizeof(MAX_PERIODS[0]); p++) {
+        for (size_t f = 0; f < sizeof(FREQS) / sizeof(FREQS[0]); f++) {
+            uint32_t const freq = FREQS[f];
+            TIMER_SOLVER_Values const values =
+                TIMER_SOLVER_solve(TIMER_CLOCK, freq, MAX_PERIODS[p]);
+
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(MAX_PERIODS[p], values.period);
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(
+                TIMER_SOLVER_MAX_PRESCALER, values.prescaler
+            );
+            TEST_ASSERT_GREATER_OR_EQUAL_UINT32(
+                TIMER_SOLVER_MIN_COUNTS - 1, values.period
+            );
+            TEST_ASSERT_EQUAL_UINT64(
+                best_error(TIMER_CLOCK, freq, MAX_PERIODS[p]),
+                period_error(TIMER_CLOCK, freq, values_divider(values))
+            );
+        }
+    }
+}
+
+void test_TIMER_SOLVER_invalid_arguments(void)
+{
+    TEST_ASSERT_EQUAL(
+        ERROR_INVALID_ARGUMENT, solve_error(TIMER_CLOCK, 0, 0xFFFF)
+    );
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, solve_error(0, 1000, 0xFFFF));
+
+    // At least two counts per period
+    TEST_ASSERT_EQUAL(
+        ERROR_NONE, solve_error(TIMER_CLOCK, TIMER_CLOCK / 2, 0xFFFF)
+    );
+    TEST_ASSERT_EQUAL(
+        ERROR_INVALID_ARGUMENT,
+        solve_error(TIMER_CLOCK, TIMER_CLOCK / 2 + 1, 0xFFFF)
+    );
+}
+
+void test_TIMER_SOLVER_rate_too_low_for_timer(void)
+{
+    // An 8-bit period and 16-bit prescaler divide by at most 2^24
+    TEST_ASSERT_EQUAL(ERROR_NONE, solve_error(1U << 24, 1, 0xFF));
+    TEST_ASSERT_EQUAL(
+        ERROR_INVALID_ARGUMENT, solve_error((1U << 24) + 256, 1, 0xFF)
+    );
+}
+
+void test_TIMER_SOLVER_get_achievable_frequency(void)
+{
+    // 250 MHz / 3 MHz = 83.3 counts, the nearest period is 83 counts
+    TEST_ASSERT_EQUAL_UINT32(
+        3012048,
+        TIMER_SOLVER_get_achievable_frequency(TIMER_CLOCK, 3000000, 0xFFFF)
+    );
+    // 250 MHz / 44.1 kHz = 5668.9 counts, no pair divides by exactly that
+    TEST_ASSERT_EQUAL_UINT32(
+        44099,
+        TIMER_SOLVER_get_achievable_frequency(TIMER_CLOCK, 44100, 0xFFFF)
+    );
+    TEST_ASSERT_EQUAL_UINT32(
+        125000000,
+        TIMER_SOLVER_get_achievable_frequency(TIMER_CLOCK, 125000000, 0xFFFF)
+    );
+
+    Error error = ERROR_NONE;
+    TRY { TIMER_SOLVER_get_achievable_frequency(TIMER_CLOCK, 0, 0xFFFF); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+}
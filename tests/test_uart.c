@@ -457,6 +457,30 @@ void test_UART_flush_with_null_handle(void)
 // UART Passthrough Tests
 // ============================================================================
 
+void test_UART_tx_start_sends_data_written_by_another_driver(void)
+{
+    // Arrange
+    uint8_t test_data[] = {0x05, 0x06, 0x07};
+
+    UART_LL_init_Expect(UART_BUS_0, g_rx_data, sizeof(g_rx_data));
+    UART_LL_set_idle_callback_Ignore();
+    UART_LL_set_rx_complete_callback_Ignore();
+    UART_LL_set_tx_complete_callback_Ignore();
+
+    g_test_handle = UART_init(0, &g_rx_buffer, &g_tx_buffer);
+    TEST_ASSERT_NOT_NULL(g_test_handle);
+
+    // A bridged USB interface fills the TX buffer without UART_write
+    circular_buffer_write(&g_tx_buffer, test_data, sizeof(test_data));
+
+    // Expect the buffered bytes to be sent
+    UART_LL_tx_busy_ExpectAndReturn(UART_BUS_0, false);
+    UART_LL_start_dma_tx_Expect(UART_BUS_0, test_data, sizeof(test_data));
+
+    // Act
+    UART_tx_start(g_test_handle);
+}
+
 void test_UART_enable_passthrough_success(void)
 {
     // Arrange - Initialize two UART buses with separate buffers
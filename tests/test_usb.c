@@ -0,0 +1,689 @@
+/**
+ * @file test_usb.c
+ * @brief Unit tests for the USB CDC bus driver
+ *
+ * This file contains unit tests for the handle-based USB API, focusing on the
+ * blocking and zero-copy write paths and the flush policy. The USB_LL
+ * endpoint is simulated by a small TX FIFO, or a direct transfer from caller
+ * memory, from which the host reads one full-speed bulk packet per USB frame.
+ * A partial packet stays in the FIFO until it is flushed. In the other
+ * direction the host adds one packet per frame to a small RX FIFO. Each
+ * USB_LL_task call advances time by one loop period, one frame unless a test
+ * spins the loop faster.
+ *
+ * Reply latency tests report the loop iterations and microseconds from the
+ * end of a reply to its arrival at the host. A micro-benchmark at the end
+ * reports how many bytes each USB_LL call moves and the host throughput of
+ * the driver.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "unity.h"
+#include "mock_platform.h"
+#include "mock_usb_ll.h"
+
+#include "util/error.h"
+#include "util/util.h"
+
+#include "usb.h"
+
+enum {
+    FAKE_PACKET_SIZE = 64, // Full-speed bulk packet
+    FAKE_FIFO_SIZE = 256, // Endpoint TX FIFO
+    RX_BUFFER_SIZE = 512,
+    TX_BUFFER_SIZE = 512,
+    BLOCK_SIZE = 100 * 1024,
+    WRITE_TIMEOUT_MS = 100,
+    DIRECT_XFER_MAX = 0xFFC0, // Largest direct transfer
+    FRAME_US = 1000, // Full-speed frame
+    FAST_LOOP_US = 100, // Main loop period in the latency tests
+};
+
+// Simulated endpoint and host
+static uint8_t g_fifo[FAKE_FIFO_SIZE];
+static uint32_t g_fifo_count;
+static uint32_t g_fifo_flushed; // FIFO bytes the host may read short
+static uint32_t g_flush_calls;
+static uint32_t g_rx_sent; // Bytes the host has put in the RX FIFO
+static uint32_t g_rx_taken; // Bytes read from the RX FIFO
+static uint32_t g_rx_total; // Bytes the host has to send
+static uint32_t g_write_calls;
+static uint32_t g_read_calls;
+static uint8_t const *g_direct_data;
+static uint32_t g_direct_remaining;
+static uint32_t g_fifo_bytes_written;
+static uint8_t g_host_data[BLOCK_SIZE + 16];
+static uint32_t g_host_count;
+static bool g_host_reading;
+static bool g_connected;
+static uint32_t g_tick;
+static uint32_t g_time_us;
+static uint32_t g_loop_us; // Time per USB_LL_task call
+static uint32_t g_task_calls;
+
+// Driver fixtures
+static uint8_t g_rx_data[RX_BUFFER_SIZE];
+static uint8_t g_tx_data[TX_BUFFER_SIZE];
+static CircularBuffer g_rx_buffer;
+static CircularBuffer g_tx_buffer;
+static USB_Handle *g_handle;
+static uint8_t g_block[BLOCK_SIZE];
+static int g_block_callbacks;
+static bool g_block_completed;
+static uint32_t g_block_released_at;
+
+static void fake_task(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+
+    g_task_calls++;
+    uint32_t const frame = g_time_us / FRAME_US;
+    g_time_us += g_loop_us;
+    g_tick = g_time_us / FRAME_US;
+
+    // The host polls the endpoints once per frame
+    if (g_tick == frame) {
+        return;
+    }
+
+    uint32_t rx_packet = g_rx_total - g_rx_sent;
+    if (rx_packet > FAKE_PACKET_SIZE) {
+        rx_packet = FAKE_PACKET_SIZE;
+    }
+    if (g_rx_sent - g_rx_taken + rx_packet <= FAKE_FIFO_SIZE) {
+        g_rx_sent += rx_packet;
+    }
+
+    if (!g_host_reading) {
+        return;
+    }
+
+    if (g_direct_remaining > 0) {
+        uint32_t packet = g_direct_remaining < FAKE_PACKET_SIZE
+                              ? g_direct_remaining
+                              : FAKE_PACKET_SIZE;
+        TEST_ASSERT_TRUE(g_host_count + packet <= sizeof(g_host_data));
+        memcpy(&g_host_data[g_host_count], g_direct_data, packet);
+        g_host_count += packet;
+        g_direct_data += packet;
+        g_direct_remaining -= packet;
+        return;
+    }
+
+    uint32_t packet =
+        g_fifo_count < FAKE_PACKET_SIZE ? g_fifo_count : FAKE_PACKET_SIZE;
+    if (packet < FAKE_PACKET_SIZE && g_fifo_flushed == 0) {
+        // A partial packet waits for more data
+        return;
+    }
+    TEST_ASSERT_TRUE(g_host_count + packet <= sizeof(g_host_data));
+    memcpy(&g_host_data[g_host_count], g_fifo, packet);
+    g_host_count += packet;
+    memmove(g_fifo, &g_fifo[packet], g_fifo_count - packet);
+    g_fifo_count -= packet;
+    g_fifo_flushed = g_fifo_flushed > packet ? g_fifo_flushed - packet : 0;
+}
+
+static uint32_t fake_flush(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+
+    g_flush_calls++;
+    g_fifo_flushed = g_fifo_count;
+    return g_fifo_count;
+}
+
+static uint32_t fake_write(
+    USB_Bus interface_id,
+    uint8_t const *buf,
+    uint32_t size,
+    int cmock_num_calls
+)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+
+    g_write_calls++;
+    uint32_t free_space = FAKE_FIFO_SIZE - g_fifo_count;
+    uint32_t count = size < free_space ? size : free_space;
+    memcpy(&g_fifo[g_fifo_count], buf, count);
+    g_fifo_count += count;
+    g_fifo_bytes_written += count;
+    return count;
+}
+
+static uint32_t fake_rx_available(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+    return g_rx_sent - g_rx_taken;
+}
+
+static uint32_t fake_read(
+    USB_Bus interface_id,
+    uint8_t *buf,
+    uint32_t size,
+    int cmock_num_calls
+)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+
+    g_read_calls++;
+    uint32_t available = g_rx_sent - g_rx_taken;
+    uint32_t count = size < available ? size : available;
+    memcpy(buf, &g_block[g_rx_taken], count);
+    g_rx_taken += count;
+    return count;
+}
+
+static uint32_t fake_write_direct(
+    USB_Bus interface_id,
+    uint8_t const *buf,
+    uint32_t size,
+    int cmock_num_calls
+)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+
+    // The endpoint is only free once the FIFO and the last transfer are out
+    if (g_fifo_count > 0 || g_direct_remaining > 0) {
+        return 0;
+    }
+
+    g_direct_data = buf;
+    g_direct_remaining = size < DIRECT_XFER_MAX ? size : DIRECT_XFER_MAX;
+    return g_direct_remaining;
+}
+
+static bool fake_in_flight(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+    return g_direct_remaining > 0;
+}
+
+static void block_callback(void *context, bool completed)
+{
+    TEST_ASSERT_EQUAL_PTR(g_block, context);
+    g_block_callbacks++;
+    g_block_completed = completed;
+    g_block_released_at = g_host_count;
+}
+
+static void queue_block(void)
+{
+    USB_write_block(
+        g_handle,
+        &(USB_TxBlock){
+            .data = g_block,
+            .size = BLOCK_SIZE,
+            .callback = block_callback,
+            .context = g_block,
+        }
+    );
+}
+
+static uint32_t fake_tx_available(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+    return FAKE_FIFO_SIZE - g_fifo_count;
+}
+
+static bool fake_connected(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+    return g_connected;
+}
+
+static uint32_t fake_get_tick(int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    return g_tick;
+}
+
+void setUp(void)
+{
+    mock_platform_Init();
+    mock_usb_ll_Init();
+
+    g_fifo_count = 0;
+    g_fifo_flushed = 0;
+    g_flush_calls = 0;
+    g_rx_sent = 0;
+    g_rx_taken = 0;
+    g_rx_total = 0;
+    g_write_calls = 0;
+    g_read_calls = 0;
+    g_direct_data = nullptr;
+    g_direct_remaining = 0;
+    g_fifo_bytes_written = 0;
+    g_host_count = 0;
+    g_block_callbacks = 0;
+    g_block_completed = false;
+    g_block_released_at = 0;
+    g_host_reading = true;
+    g_connected = true;
+    g_tick = 0;
+    g_time_us = 0;
+    g_loop_us = FRAME_US;
+    g_task_calls = 0;
+
+    for (uint32_t i = 0; i < BLOCK_SIZE; i++) {
+        g_block[i] = (uint8_t)((i * 31U) ^ (i >> 8));
+    }
+
+    circular_buffer_init(&g_rx_buffer, g_rx_data, sizeof(g_rx_data));
+    circular_buffer_init(&g_tx_buffer, g_tx_data, sizeof(g_tx_data));
+
+    USB_LL_init_Ignore();
+    USB_LL_set_line_state_callback_Ignore();
+    g_handle = USB_init(0, &g_rx_buffer, &g_tx_buffer);
+
+    USB_LL_task_StubWithCallback(fake_task);
+    USB_LL_write_StubWithCallback(fake_write);
+    USB_LL_write_direct_StubWithCallback(fake_write_direct);
+    USB_LL_tx_in_flight_StubWithCallback(fake_in_flight);
+    USB_LL_tx_available_StubWithCallback(fake_tx_available);
+    USB_LL_connected_StubWithCallback(fake_connected);
+    USB_LL_rx_available_StubWithCallback(fake_rx_available);
+    USB_LL_read_StubWithCallback(fake_read);
+    USB_LL_tx_bufsize_IgnoreAndReturn(FAKE_FIFO_SIZE);
+    USB_LL_tx_flush_StubWithCallback(fake_flush);
+    PLATFORM_get_tick_StubWithCallback(fake_get_tick);
+}
+
+void tearDown(void)
+{
+    USB_LL_deinit_Ignore();
+    USB_deinit(g_handle);
+    g_handle = nullptr;
+
+    mock_usb_ll_Destroy();
+    mock_platform_Destroy();
+}
+
+void test_USB_write_queues_only_what_fits(void)
+{
+    uint32_t written = USB_write(g_handle, g_block, BLOCK_SIZE);
+
+    // The circular buffer keeps one slot free
+    TEST_ASSERT_EQUAL_UINT32(TX_BUFFER_SIZE - 1, written);
+}
+
+void test_USB_write_all_streams_100k_block_intact(void)
+{
+    uint32_t written =
+        USB_write_all(g_handle, g_block, BLOCK_SIZE, WRITE_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL_UINT32(BLOCK_SIZE, written);
+
+    // Drain the tail that is still buffered on return
+    while (g_host_count < BLOCK_SIZE && g_task_calls < 2 * BLOCK_SIZE) {
+        USB_task(g_handle);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(BLOCK_SIZE, g_host_count);
+    TEST_ASSERT_EQUAL_MEMORY(g_block, g_host_data, BLOCK_SIZE);
+
+    // Every frame but the first, which comes before any data reached the
+    // endpoint, carries a full packet: the endpoint never starves
+    TEST_ASSERT_EQUAL_UINT32(BLOCK_SIZE / FAKE_PACKET_SIZE + 1, g_task_calls);
+}
+
+void test_USB_write_all_times_out_when_host_stops_reading(void)
+{
+    g_host_reading = false;
+
+    Error error = ERROR_NONE;
+    TRY { USB_write_all(g_handle, g_block, BLOCK_SIZE, WRITE_TIMEOUT_MS); }
+    CATCH(error) {}
+
+    TEST_ASSERT_EQUAL(ERROR_TIMEOUT, error);
+    // Gives up right after the timeout since the buffers filled up
+    TEST_ASSERT_UINT32_WITHIN(2, WRITE_TIMEOUT_MS, g_tick);
+}
+
+void test_USB_write_all_reports_disconnect(void)
+{
+    g_connected = false;
+
+    Error error = ERROR_NONE;
+    TRY { USB_write_all(g_handle, g_block, BLOCK_SIZE, WRITE_TIMEOUT_MS); }
+    CATCH(error) {}
+
+    TEST_ASSERT_EQUAL(ERROR_DEVICE_NOT_READY, error);
+    TEST_ASSERT_EQUAL_UINT32(0, g_host_count);
+}
+
+void test_USB_write_all_invalid_arguments(void)
+{
+    Error error = ERROR_NONE;
+    TRY { USB_write_all(nullptr, g_block, 1, WRITE_TIMEOUT_MS); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+
+    error = ERROR_NONE;
+    TRY { USB_write_all(g_handle, nullptr, 1, WRITE_TIMEOUT_MS); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+}
+
+void test_USB_write_all_empty_write(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(
+        0, USB_write_all(g_handle, g_block, 0, WRITE_TIMEOUT_MS)
+    );
+    TEST_ASSERT_EQUAL_UINT32(0, g_task_calls);
+}
+
+void test_USB_write_block_sends_in_order_without_copying(void)
+{
+    USB_write(g_handle, (uint8_t const *)"HDR", 3);
+    queue_block();
+    USB_write(g_handle, (uint8_t const *)"\r\n", 2);
+
+    while (g_block_callbacks == 0 && g_task_calls < 2 * BLOCK_SIZE) {
+        USB_task(g_handle);
+    }
+    while (g_host_count < BLOCK_SIZE + 5 && g_task_calls < 2 * BLOCK_SIZE) {
+        USB_task(g_handle);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(BLOCK_SIZE + 5, g_host_count);
+    TEST_ASSERT_EQUAL_MEMORY("HDR", g_host_data, 3);
+    TEST_ASSERT_EQUAL_MEMORY(g_block, &g_host_data[3], BLOCK_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY("\r\n", &g_host_data[3 + BLOCK_SIZE], 2);
+
+    // Only the bytes around the block went through the FIFO
+    TEST_ASSERT_EQUAL_UINT32(5, g_fifo_bytes_written);
+
+    // Released once, after the host had read the whole block
+    TEST_ASSERT_EQUAL_INT(1, g_block_callbacks);
+    TEST_ASSERT_TRUE(g_block_completed);
+    TEST_ASSERT_EQUAL_UINT32(3 + BLOCK_SIZE, g_block_released_at);
+    TEST_ASSERT_FALSE(USB_tx_block_pending(g_handle));
+}
+
+void test_USB_write_block_held_until_endpoint_lets_go(void)
+{
+    g_host_reading = false;
+    queue_block();
+    USB_task(g_handle);
+    TEST_ASSERT_TRUE(g_direct_remaining > 0);
+
+    // The endpoint still reads the block after the host has gone away
+    g_connected = false;
+    USB_task(g_handle);
+    TEST_ASSERT_EQUAL_INT(0, g_block_callbacks);
+    TEST_ASSERT_TRUE(USB_tx_block_pending(g_handle));
+
+    // Bus reset
+    g_direct_remaining = 0;
+    USB_task(g_handle);
+    TEST_ASSERT_EQUAL_INT(1, g_block_callbacks);
+    TEST_ASSERT_FALSE(g_block_completed);
+    TEST_ASSERT_FALSE(USB_tx_block_pending(g_handle));
+}
+
+void test_USB_write_block_errors(void)
+{
+    Error error = ERROR_NONE;
+    TRY { USB_write_block(g_handle, nullptr); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+
+    g_connected = false;
+    error = ERROR_NONE;
+    TRY { queue_block(); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_DEVICE_NOT_READY, error);
+
+    g_connected = true;
+    queue_block();
+    error = ERROR_NONE;
+    TRY { queue_block(); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_RESOURCE_BUSY, error);
+}
+
+static USB_LL_LineStateCallback g_line_state_callback;
+
+static void capture_line_state_callback(
+    USB_Bus interface_id,
+    USB_LL_LineStateCallback callback,
+    int cmock_num_calls
+)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+    g_line_state_callback = callback;
+}
+
+void test_USB_console_interface_keeps_shared_buffers(void)
+{
+    static uint8_t const DATA[] = "log";
+    uint8_t rx_data[64];
+    uint8_t tx_data[64];
+    CircularBuffer rx_buffer;
+    CircularBuffer tx_buffer;
+    circular_buffer_init(&rx_buffer, rx_data, sizeof(rx_data));
+    circular_buffer_init(&tx_buffer, tx_data, sizeof(tx_data));
+
+    TEST_ASSERT_EQUAL(USB_BUS_COUNT, USB_get_interface_count());
+
+    USB_LL_set_line_state_callback_StubWithCallback(
+        capture_line_state_callback
+    );
+    USB_Handle *console = USB_init(USB_BUS_1, &rx_buffer, &tx_buffer);
+    TEST_ASSERT_NOT_NULL(console);
+    TEST_ASSERT_NOT_NULL(g_line_state_callback);
+
+    Error error = ERROR_NONE;
+    TRY { USB_init(USB_BUS_1, &rx_buffer, &tx_buffer); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_RESOURCE_BUSY, error);
+
+    // A UART bridged to the console owns the buffer positions too
+    USB_set_shared_buffers(console, true);
+    circular_buffer_write(&rx_buffer, DATA, sizeof(DATA));
+    circular_buffer_write(&tx_buffer, DATA, sizeof(DATA));
+    g_line_state_callback(USB_BUS_1, false, false);
+    TEST_ASSERT_EQUAL_UINT32(
+        sizeof(DATA), circular_buffer_available(&rx_buffer)
+    );
+    TEST_ASSERT_EQUAL_UINT32(
+        sizeof(DATA), circular_buffer_available(&tx_buffer)
+    );
+
+    // The SCPI interface still drops its data when the host closes the port
+    circular_buffer_write(&g_rx_buffer, DATA, sizeof(DATA));
+    g_line_state_callback(USB_BUS_0, false, false);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&g_rx_buffer));
+
+    USB_LL_deinit_Expect(USB_BUS_1);
+    USB_deinit(console);
+}
+
+/**
+ * @brief Run the main loop until the host has received count bytes
+ *
+ * @param count Number of bytes the host waits for
+ * @param loops Receives the number of USB_task calls
+ * @return Time taken in microseconds
+ */
+static uint32_t run_until_received(uint32_t count, uint32_t *loops)
+{
+    uint32_t const start_us = g_time_us;
+    uint32_t const start_calls = g_task_calls;
+
+    while (g_host_count < count && g_task_calls - start_calls < 1000) {
+        USB_task(g_handle);
+    }
+    TEST_ASSERT_EQUAL_UINT32(count, g_host_count);
+
+    *loops = g_task_calls - start_calls;
+    return g_time_us - start_us;
+}
+
+void test_USB_reply_latency(void)
+{
+    static char const REPLY[] = "PSLab,PSLab Mini,0,1.0\n";
+    uint32_t const len = sizeof(REPLY) - 1;
+    char report[128];
+
+    // A loop that spins ten times per frame, which used to mean a 100-call,
+    // 10 ms wait for a reply that does not fill a packet
+    g_loop_us = FAST_LOOP_US;
+    g_time_us = FRAME_US / 2;
+
+    USB_write_all(g_handle, (uint8_t const *)REPLY, len, WRITE_TIMEOUT_MS);
+    USB_tx_flush(g_handle);
+    uint32_t flushed_loops = 0;
+    uint32_t const flushed_us = run_until_received(len, &flushed_loops);
+
+    // Without a message end the reply goes out once it has waited a frame
+    g_host_count = 0;
+    g_time_us += FRAME_US / 2;
+    USB_write_all(g_handle, (uint8_t const *)REPLY, len, WRITE_TIMEOUT_MS);
+    uint32_t held_loops = 0;
+    uint32_t const held_us = run_until_received(len, &held_loops);
+
+    snprintf(
+        report,
+        sizeof(report),
+        "Reply latency: flushed %u loops %u us, unflushed %u loops %u us",
+        (unsigned)flushed_loops,
+        (unsigned)flushed_us,
+        (unsigned)held_loops,
+        (unsigned)held_us
+    );
+    TEST_MESSAGE(report);
+
+    TEST_ASSERT_EQUAL_MEMORY(REPLY, g_host_data, len);
+    // Sent in the next frame
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(FRAME_US, flushed_us);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(FRAME_US / FAST_LOOP_US, flushed_loops);
+    // Held back for at most a frame, then sent in the next one
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(3 * FRAME_US, held_us);
+}
+
+void test_USB_flush_coalesces_long_reply(void)
+{
+    enum { REPLY_SIZE = 1000 };
+
+    USB_write_all(g_handle, g_block, REPLY_SIZE, WRITE_TIMEOUT_MS);
+    USB_tx_flush(g_handle);
+    uint32_t loops = 0;
+    run_until_received(REPLY_SIZE, &loops);
+
+    TEST_ASSERT_EQUAL_MEMORY(g_block, g_host_data, REPLY_SIZE);
+    // Full packets went out on their own; only the tail was flushed
+    TEST_ASSERT_EQUAL_UINT32(1, g_flush_calls);
+    // Every frame but the first carried a packet, the last one the short tail
+    TEST_ASSERT_EQUAL_UINT32(REPLY_SIZE / FAKE_PACKET_SIZE + 2, g_task_calls);
+}
+
+void test_USB_flush_with_next_message_written_before_drain(void)
+{
+    enum { FIRST_SIZE = 300, SECOND_SIZE = 100 };
+
+    // The first message does not fit in the FIFO, and the second one is
+    // written behind it before it has drained
+    USB_write_all(g_handle, g_block, FIRST_SIZE, WRITE_TIMEOUT_MS);
+    USB_tx_flush(g_handle);
+    USB_write_all(
+        g_handle, &g_block[FIRST_SIZE], SECOND_SIZE, WRITE_TIMEOUT_MS
+    );
+    uint32_t loops = 0;
+    run_until_received(FIRST_SIZE + SECOND_SIZE, &loops);
+
+    TEST_ASSERT_EQUAL_MEMORY(g_block, g_host_data, FIRST_SIZE + SECOND_SIZE);
+    // The end of the first message was flushed as soon as it reached the
+    // FIFO, the unflushed tail of the second one after the flush delay
+    TEST_ASSERT_EQUAL_UINT32(2, g_flush_calls);
+}
+
+void test_USB_flush_after_block_waits_for_block(void)
+{
+    USB_write(g_handle, (uint8_t const *)"HDR", 3);
+    queue_block();
+    USB_write(g_handle, (uint8_t const *)"\r\n", 2);
+    USB_tx_flush(g_handle);
+
+    while (g_block_callbacks == 0 && g_task_calls < 2 * BLOCK_SIZE) {
+        USB_task(g_handle);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3 + BLOCK_SIZE, g_host_count);
+
+    // The end of the message follows in the next frame
+    uint32_t loops = 0;
+    run_until_received(BLOCK_SIZE + 5, &loops);
+    TEST_ASSERT_EQUAL_UINT32(1, loops);
+    TEST_ASSERT_EQUAL_MEMORY("\r\n", &g_host_data[3 + BLOCK_SIZE], 2);
+}
+
+void test_USB_span_transfer_benchmark(void)
+{
+    enum { ROUNDS = 20 };
+    static uint8_t received[BLOCK_SIZE];
+    char report[128];
+
+    // TX: the host reads a packet per frame while the driver refills the FIFO
+    clock_t start = clock();
+    for (int round = 0; round < ROUNDS; round++) {
+        g_host_count = 0;
+        USB_write_all(g_handle, g_block, BLOCK_SIZE, WRITE_TIMEOUT_MS);
+        while (g_host_count < BLOCK_SIZE) {
+            USB_task(g_handle);
+        }
+    }
+    double tx_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    TEST_ASSERT_EQUAL_MEMORY(g_block, g_host_data, BLOCK_SIZE);
+
+    // RX: the host sends a packet per frame while the protocol reads
+    start = clock();
+    for (int round = 0; round < ROUNDS; round++) {
+        g_rx_sent = 0;
+        g_rx_taken = 0;
+        g_rx_total = BLOCK_SIZE;
+        uint32_t count = 0;
+        while (count < BLOCK_SIZE) {
+            USB_task(g_handle);
+            count += USB_read(g_handle, &received[count], BLOCK_SIZE - count);
+        }
+    }
+    double rx_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    TEST_ASSERT_EQUAL_MEMORY(g_block, received, BLOCK_SIZE);
+
+    uint32_t const bytes = ROUNDS * BLOCK_SIZE;
+    uint32_t const tx_per_call = bytes / g_write_calls;
+    uint32_t const rx_per_call = bytes / g_read_calls;
+
+    snprintf(
+        report,
+        sizeof(report),
+        "TX %u B/call %.1f MB/s, RX %u B/call %.1f MB/s",
+        (unsigned)tx_per_call,
+        tx_seconds > 0 ? bytes / tx_seconds / 1e6 : 0.0,
+        (unsigned)rx_per_call,
+        rx_seconds > 0 ? bytes / rx_seconds / 1e6 : 0.0
+    );
+    TEST_MESSAGE(report);
+
+    // Each call moves up to a packet; only the buffer wrap splits one
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(FAKE_PACKET_SIZE / 2, tx_per_call);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(FAKE_PACKET_SIZE / 2, rx_per_call);
+}
@@ -0,0 +1,258 @@
+/**
+ * @file test_usb_stream.c
+ * @brief Unit tests for framed streaming over the USB bulk interface
+ *
+ * The vendor endpoint is simulated by a TX FIFO from which the host takes
+ * one multi-packet transfer per USB_LL_task call. The host side is the
+ * stream_host reader, which checks that frames survive the trip and that
+ * lost or damaged data is detected.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity.h"
+#include "mock_platform.h"
+#include "mock_usb_ll.h"
+#include "stream_host.h"
+
+#include "util/error.h"
+
+#include "usb_stream.h"
+
+enum {
+    FAKE_FIFO_SIZE = 2048, // Vendor TX FIFO
+    FAKE_TRANSFER_SIZE = 512, // Bytes per bulk transfer
+    PAYLOAD_SIZE = 10000,
+    WRITE_TIMEOUT_MS = 100,
+    MAX_FRAMES = 8,
+};
+
+// Simulated endpoint
+static uint8_t g_fifo[FAKE_FIFO_SIZE];
+static uint32_t g_fifo_count;
+static bool g_mounted;
+static bool g_host_reading;
+static uint32_t g_tick;
+
+// Simulated host
+static STREAM_HOST_Reader g_reader;
+static uint8_t g_host_payload[PAYLOAD_SIZE];
+static STREAM_HOST_Frame g_frames[MAX_FRAMES];
+static uint32_t g_frame_count;
+static bool g_payload_matches;
+
+static uint8_t g_payload[PAYLOAD_SIZE];
+
+static void on_frame(STREAM_HOST_Frame const *frame, void *context)
+{
+    (void)context;
+    TEST_ASSERT_TRUE(g_frame_count < MAX_FRAMES);
+    g_frames[g_frame_count++] = *frame;
+    g_payload_matches = memcmp(frame->payload, g_payload, frame->size) == 0;
+}
+
+static void host_read(uint32_t max)
+{
+    uint32_t len = g_fifo_count < max ? g_fifo_count : max;
+    STREAM_HOST_feed(&g_reader, g_fifo, len);
+    memmove(g_fifo, &g_fifo[len], g_fifo_count - len);
+    g_fifo_count -= len;
+}
+
+static void fake_task(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+
+    g_tick++;
+    if (g_host_reading) {
+        host_read(FAKE_TRANSFER_SIZE);
+    }
+}
+
+static uint32_t fake_vendor_write(
+    USB_Bus interface_id,
+    uint8_t const *buf,
+    uint32_t size,
+    int cmock_num_calls
+)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+
+    uint32_t free_space = FAKE_FIFO_SIZE - g_fifo_count;
+    uint32_t count = size < free_space ? size : free_space;
+    memcpy(&g_fifo[g_fifo_count], buf, count);
+    g_fifo_count += count;
+    return count;
+}
+
+static uint32_t fake_vendor_tx_flush(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+    return g_fifo_count;
+}
+
+static bool fake_vendor_mounted(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+    return g_mounted;
+}
+
+static uint32_t fake_get_tick(int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    return g_tick;
+}
+
+void setUp(void)
+{
+    mock_platform_Init();
+    mock_usb_ll_Init();
+
+    g_fifo_count = 0;
+    g_mounted = true;
+    g_host_reading = true;
+    g_tick = 0;
+    g_frame_count = 0;
+    g_payload_matches = false;
+
+    for (uint32_t i = 0; i < PAYLOAD_SIZE; i++) {
+        g_payload[i] = (uint8_t)((i * 7U) ^ (i >> 8));
+    }
+
+    STREAM_HOST_init(
+        &g_reader, g_host_payload, sizeof(g_host_payload), on_frame, nullptr
+    );
+
+    USB_LL_task_StubWithCallback(fake_task);
+    USB_LL_vendor_write_StubWithCallback(fake_vendor_write);
+    USB_LL_vendor_tx_flush_StubWithCallback(fake_vendor_tx_flush);
+    USB_LL_vendor_mounted_StubWithCallback(fake_vendor_mounted);
+    PLATFORM_get_tick_StubWithCallback(fake_get_tick);
+}
+
+void tearDown(void)
+{
+    mock_platform_Verify();
+    mock_usb_ll_Verify();
+    mock_platform_Destroy();
+    mock_usb_ll_Destroy();
+}
+
+void test_USB_STREAM_frame_larger_than_fifo_arrives_intact(void)
+{
+    uint32_t sequence = USB_STREAM_write_frame(
+        USB_STREAM_TYPE_DSO_RECORD, g_payload, PAYLOAD_SIZE, WRITE_TIMEOUT_MS
+    );
+    host_read(FAKE_FIFO_SIZE);
+
+    TEST_ASSERT_EQUAL_UINT32(1, g_frame_count);
+    TEST_ASSERT_EQUAL_UINT8(USB_STREAM_TYPE_DSO_RECORD, g_frames[0].type);
+    TEST_ASSERT_EQUAL_UINT32(sequence, g_frames[0].sequence);
+    TEST_ASSERT_EQUAL_UINT32(PAYLOAD_SIZE, g_frames[0].size);
+    TEST_ASSERT_TRUE(g_payload_matches);
+    TEST_ASSERT_EQUAL_UINT32(0, g_reader.skipped_bytes);
+}
+
+void test_USB_STREAM_header_layout(void)
+{
+    g_host_reading = false;
+
+    uint32_t sequence =
+        USB_STREAM_write_frame(USB_STREAM_TYPE_DATA, g_payload, 3, 0);
+
+    uint8_t const expected[USB_STREAM_HEADER_SIZE] = {
+        0x50, 0x53, USB_STREAM_TYPE_DATA, 0,
+        (uint8_t)sequence, (uint8_t)(sequence >> 8),
+        (uint8_t)(sequence >> 16), (uint8_t)(sequence >> 24),
+        3, 0, 0, 0,
+    };
+    TEST_ASSERT_EQUAL_UINT32(USB_STREAM_HEADER_SIZE + 3, g_fifo_count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, g_fifo, USB_STREAM_HEADER_SIZE);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(g_payload, &g_fifo[12], 3);
+}
+
+void test_USB_STREAM_sequence_numbers_reveal_lost_frames(void)
+{
+    g_host_reading = false;
+
+    uint32_t first =
+        USB_STREAM_write_frame(USB_STREAM_TYPE_DATA, g_payload, 4, 0);
+    host_read(FAKE_FIFO_SIZE);
+
+    // The host misses the second frame
+    USB_STREAM_write_frame(USB_STREAM_TYPE_DATA, g_payload, 4, 0);
+    g_fifo_count = 0;
+
+    uint32_t third =
+        USB_STREAM_write_frame(USB_STREAM_TYPE_DATA, nullptr, 0, 0);
+    host_read(FAKE_FIFO_SIZE);
+
+    TEST_ASSERT_EQUAL_UINT32(first + 2, third);
+    TEST_ASSERT_EQUAL_UINT32(2, g_frame_count);
+    TEST_ASSERT_EQUAL_UINT32(0, g_frames[1].size);
+    TEST_ASSERT_EQUAL_UINT32(1, g_reader.lost_frames);
+}
+
+void test_USB_STREAM_host_resyncs_after_garbage(void)
+{
+    g_host_reading = false;
+
+    uint8_t const garbage[] = { 0x50, 0x00, 0x53, 0x50, 0x53, 0x01, 0x80 };
+    STREAM_HOST_feed(&g_reader, garbage, sizeof(garbage));
+
+    USB_STREAM_write_frame(USB_STREAM_TYPE_DATA, g_payload, 100, 0);
+    host_read(FAKE_FIFO_SIZE);
+
+    TEST_ASSERT_EQUAL_UINT32(1, g_frame_count);
+    TEST_ASSERT_EQUAL_UINT32(100, g_frames[0].size);
+    TEST_ASSERT_TRUE(g_payload_matches);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(garbage), g_reader.skipped_bytes);
+}
+
+void test_USB_STREAM_times_out_when_host_stops_reading(void)
+{
+    g_host_reading = false;
+
+    Error error = ERROR_NONE;
+    TRY
+    {
+        USB_STREAM_write_frame(
+            USB_STREAM_TYPE_DATA, g_payload, PAYLOAD_SIZE, WRITE_TIMEOUT_MS
+        );
+    }
+    CATCH(error) {}
+
+    TEST_ASSERT_EQUAL(ERROR_TIMEOUT, error);
+    TEST_ASSERT_UINT32_WITHIN(2, WRITE_TIMEOUT_MS, g_tick);
+}
+
+void test_USB_STREAM_not_mounted(void)
+{
+    g_mounted = false;
+    TEST_ASSERT_FALSE(USB_STREAM_ready());
+
+    Error error = ERROR_NONE;
+    TRY { USB_STREAM_write_frame(USB_STREAM_TYPE_DATA, g_payload, 1, 0); }
+    CATCH(error) {}
+
+    TEST_ASSERT_EQUAL(ERROR_DEVICE_NOT_READY, error);
+    TEST_ASSERT_EQUAL_UINT32(0, g_fifo_count);
+}
+
+void test_USB_STREAM_invalid_payload(void)
+{
+    Error error = ERROR_NONE;
+    TRY { USB_STREAM_write_frame(USB_STREAM_TYPE_DATA, nullptr, 1, 0); }
+    CATCH(error) {}
+
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+}
@@ -0,0 +1,410 @@
+/**
+ * @file test_usbtmc.c
+ * @brief Unit tests for the SCPI transport over USBTMC
+ *
+ * The USBTMC class is simulated on top of the USB_LL mock: callbacks
+ * registered by the transport are called directly, and the simulated host
+ * asks for response data and reads it on each USB_LL_task call.
+ *
+ * @author PSLab Team
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity.h"
+#include "mock_platform.h"
+#include "mock_usb_ll.h"
+
+#include "util/error.h"
+#include "util/util.h"
+
+#include "usbtmc.h"
+
+enum {
+    RX_BUFFER_SIZE = 256,
+    TX_BUFFER_SIZE = 64,
+    HOST_BUFFER_SIZE = 512,
+    HOST_REQUEST_SIZE = 48, // Largest response part the host asks for
+    WRITE_TIMEOUT_MS = 100,
+};
+
+// Transport buffers
+static uint8_t g_rx_data[RX_BUFFER_SIZE];
+static uint8_t g_tx_data[TX_BUFFER_SIZE];
+static CircularBuffer g_rx_buffer;
+static CircularBuffer g_tx_buffer;
+
+// Simulated USBTMC class
+static USB_LL_TmcCallbacks g_callbacks;
+static uint8_t const *g_in_data;
+static uint32_t g_in_size;
+static bool g_in_eom;
+static bool g_in_busy;
+static uint32_t g_start_reads;
+static bool g_srq_busy;
+static uint8_t g_srq_status;
+static uint32_t g_srq_count;
+static bool g_mounted;
+static uint32_t g_tick;
+
+// Simulated host
+static bool g_host_reading;
+static bool g_host_request_pending;
+static uint8_t g_host_data[HOST_BUFFER_SIZE];
+static uint32_t g_host_count;
+static uint32_t g_host_messages;
+
+static uint8_t g_stb;
+
+static void fake_set_callbacks(
+    USB_Bus interface_id,
+    USB_LL_TmcCallbacks const *callbacks,
+    int cmock_num_calls
+)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+    g_callbacks = callbacks ? *callbacks : (USB_LL_TmcCallbacks){ 0 };
+}
+
+static bool fake_start_read(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+    g_start_reads++;
+    return true;
+}
+
+static bool fake_transmit(
+    USB_Bus interface_id,
+    uint8_t const *buf,
+    uint32_t size,
+    bool end_of_message,
+    int cmock_num_calls
+)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+
+    TEST_ASSERT_FALSE(g_in_busy);
+    TEST_ASSERT_TRUE(size > 0);
+    g_in_data = buf;
+    g_in_size = size;
+    g_in_eom = end_of_message;
+    g_in_busy = true;
+    g_host_request_pending = false;
+    return true;
+}
+
+static bool fake_notify_srq(
+    USB_Bus interface_id,
+    uint8_t status_byte,
+    int cmock_num_calls
+)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+
+    if (g_srq_busy) {
+        return false;
+    }
+    g_srq_status = status_byte;
+    g_srq_count++;
+    return true;
+}
+
+static bool fake_mounted(int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    return g_mounted;
+}
+
+static uint32_t fake_get_tick(int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    return g_tick;
+}
+
+static void host_request(uint32_t max_size)
+{
+    g_host_request_pending = true;
+    g_callbacks.bulk_in_request(USB_BUS_0, max_size);
+}
+
+static void host_complete(void)
+{
+    TEST_ASSERT_TRUE(g_in_busy);
+    TEST_ASSERT_TRUE(g_host_count + g_in_size <= HOST_BUFFER_SIZE);
+
+    memcpy(&g_host_data[g_host_count], g_in_data, g_in_size);
+    g_host_count += g_in_size;
+    if (g_in_eom) {
+        g_host_messages++;
+    }
+    g_in_busy = false;
+    g_callbacks.bulk_in_complete(USB_BUS_0);
+}
+
+static void fake_task(USB_Bus interface_id, int cmock_num_calls)
+{
+    (void)interface_id;
+    (void)cmock_num_calls;
+
+    g_tick++;
+    if (!g_host_reading) {
+        return;
+    }
+
+    if (g_in_busy) {
+        host_complete();
+    } else if (!g_host_request_pending) {
+        host_request(HOST_REQUEST_SIZE);
+    }
+}
+
+static void host_send(char const *message, bool end_of_message)
+{
+    g_callbacks.message_data(
+        USB_BUS_0,
+        (uint8_t const *)message,
+        (uint32_t)strlen(message),
+        end_of_message
+    );
+}
+
+static uint8_t status_callback(void) { return g_stb; }
+
+void setUp(void)
+{
+    mock_platform_Init();
+    mock_usb_ll_Init();
+
+    g_callbacks = (USB_LL_TmcCallbacks){ 0 };
+    g_in_busy = false;
+    g_start_reads = 0;
+    g_srq_busy = false;
+    g_srq_count = 0;
+    g_mounted = true;
+    g_tick = 0;
+    g_host_reading = false;
+    g_host_request_pending = false;
+    g_host_count = 0;
+    g_host_messages = 0;
+    g_stb = 0;
+
+    USB_LL_tmc_set_callbacks_StubWithCallback(fake_set_callbacks);
+    USB_LL_tmc_start_read_StubWithCallback(fake_start_read);
+    USB_LL_tmc_transmit_StubWithCallback(fake_transmit);
+    USB_LL_tmc_notify_srq_StubWithCallback(fake_notify_srq);
+    USB_LL_mounted_StubWithCallback(fake_mounted);
+    USB_LL_task_StubWithCallback(fake_task);
+    PLATFORM_get_tick_StubWithCallback(fake_get_tick);
+
+    circular_buffer_init(&g_rx_buffer, g_rx_data, RX_BUFFER_SIZE);
+    circular_buffer_init(&g_tx_buffer, g_tx_data, TX_BUFFER_SIZE);
+    USBTMC_init(&g_rx_buffer, &g_tx_buffer, status_callback);
+}
+
+void tearDown(void)
+{
+    USBTMC_deinit();
+
+    mock_platform_Verify();
+    mock_usb_ll_Verify();
+    mock_platform_Destroy();
+    mock_usb_ll_Destroy();
+}
+
+void test_USBTMC_init_rejects_invalid_buffers(void)
+{
+    USBTMC_deinit();
+
+    CircularBuffer small;
+    circular_buffer_init(&small, g_rx_data, 64);
+
+    Error error = ERROR_NONE;
+    TRY { USBTMC_init(nullptr, &g_tx_buffer, nullptr); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+
+    error = ERROR_NONE;
+    TRY { USBTMC_init(&small, &g_tx_buffer, nullptr); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_INVALID_ARGUMENT, error);
+}
+
+void test_USBTMC_init_twice_is_busy(void)
+{
+    Error error = ERROR_NONE;
+    TRY { USBTMC_init(&g_rx_buffer, &g_tx_buffer, nullptr); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_RESOURCE_BUSY, error);
+}
+
+void test_USBTMC_message_end_adds_newline(void)
+{
+    host_send("*IDN", false);
+    host_send("?", true);
+    host_send("*RST\n", true);
+
+    char message[16] = { 0 };
+    uint32_t len = USBTMC_read((uint8_t *)message, sizeof(message) - 1);
+
+    TEST_ASSERT_EQUAL_STRING("*IDN?\n*RST\n", message);
+    TEST_ASSERT_EQUAL_UINT32(11, len);
+}
+
+void test_USBTMC_read_paused_while_rx_buffer_full(void)
+{
+    char packet[65];
+    memset(packet, 'A', 64);
+    packet[64] = '\0';
+
+    // Room for one more packet and a newline after two packets, not three
+    host_send(packet, false);
+    host_send(packet, false);
+    uint32_t const reads = g_start_reads;
+    host_send(packet, false);
+    TEST_ASSERT_EQUAL_UINT32(reads, g_start_reads);
+
+    USBTMC_task();
+    TEST_ASSERT_EQUAL_UINT32(reads, g_start_reads);
+
+    uint8_t sink[64];
+    USBTMC_read(sink, sizeof(sink));
+    USBTMC_task();
+    TEST_ASSERT_EQUAL_UINT32(reads + 1, g_start_reads);
+}
+
+void test_USBTMC_response_waits_for_end_of_message(void)
+{
+    host_request(HOST_REQUEST_SIZE);
+
+    USBTMC_write_all((uint8_t const *)"1.25", 4, WRITE_TIMEOUT_MS);
+    USBTMC_task();
+    TEST_ASSERT_FALSE(g_in_busy);
+
+    USBTMC_write_all((uint8_t const *)"\r\n", 2, WRITE_TIMEOUT_MS);
+    USBTMC_end_message();
+    TEST_ASSERT_TRUE(g_in_busy);
+    TEST_ASSERT_EQUAL_UINT32(6, g_in_size);
+    TEST_ASSERT_TRUE(g_in_eom);
+
+    uint32_t const reads = g_start_reads;
+    host_complete();
+    TEST_ASSERT_EQUAL_MEMORY("1.25\r\n", g_host_data, 6);
+    TEST_ASSERT_EQUAL_UINT32(reads + 1, g_start_reads);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&g_tx_buffer));
+}
+
+void test_USBTMC_response_split_by_request_size(void)
+{
+    USBTMC_write_all((uint8_t const *)"ABCDEF\n", 7, WRITE_TIMEOUT_MS);
+    USBTMC_end_message();
+
+    host_request(4);
+    TEST_ASSERT_EQUAL_UINT32(4, g_in_size);
+    TEST_ASSERT_FALSE(g_in_eom);
+    host_complete();
+
+    host_request(4);
+    TEST_ASSERT_EQUAL_UINT32(3, g_in_size);
+    TEST_ASSERT_TRUE(g_in_eom);
+    host_complete();
+
+    TEST_ASSERT_EQUAL_UINT32(1, g_host_messages);
+    TEST_ASSERT_EQUAL_MEMORY("ABCDEF\n", g_host_data, 7);
+}
+
+void test_USBTMC_response_longer_than_tx_buffer(void)
+{
+    uint8_t response[300];
+    for (uint32_t i = 0; i < sizeof(response); i++) {
+        response[i] = (uint8_t)(i * 13U);
+    }
+    g_host_reading = true;
+
+    USBTMC_write_all(response, sizeof(response), WRITE_TIMEOUT_MS);
+    USBTMC_end_message();
+    while (g_host_messages == 0 && g_tick < 1000) {
+        USB_LL_task(USB_BUS_0);
+        USBTMC_task();
+    }
+
+    // Parts sent while writing carry no EOM; only the last one does
+    TEST_ASSERT_EQUAL_UINT32(1, g_host_messages);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(response), g_host_count);
+    TEST_ASSERT_EQUAL_MEMORY(response, g_host_data, sizeof(response));
+}
+
+void test_USBTMC_write_times_out_when_host_stops_reading(void)
+{
+    uint8_t response[TX_BUFFER_SIZE + 1] = { 0 };
+
+    Error error = ERROR_NONE;
+    TRY { USBTMC_write_all(response, sizeof(response), WRITE_TIMEOUT_MS); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_TIMEOUT, error);
+}
+
+void test_USBTMC_write_fails_when_unmounted(void)
+{
+    g_mounted = false;
+
+    Error error = ERROR_NONE;
+    TRY { USBTMC_write_all((uint8_t const *)"1\n", 2, WRITE_TIMEOUT_MS); }
+    CATCH(error) {}
+    TEST_ASSERT_EQUAL(ERROR_DEVICE_NOT_READY, error);
+}
+
+void test_USBTMC_status_byte_reports_mav(void)
+{
+    g_stb = 0x04;
+    TEST_ASSERT_EQUAL_HEX8(0x04, g_callbacks.status_byte(USB_BUS_0));
+
+    USBTMC_write_all((uint8_t const *)"1\n", 2, WRITE_TIMEOUT_MS);
+    USBTMC_end_message();
+    TEST_ASSERT_EQUAL_HEX8(
+        0x04 | USBTMC_STB_MAV, g_callbacks.status_byte(USB_BUS_0)
+    );
+}
+
+void test_USBTMC_service_request_retried_when_endpoint_busy(void)
+{
+    g_srq_busy = true;
+    USBTMC_request_service(0x60);
+    TEST_ASSERT_EQUAL_UINT32(0, g_srq_count);
+
+    g_srq_busy = false;
+    USBTMC_task();
+    TEST_ASSERT_EQUAL_UINT32(1, g_srq_count);
+    TEST_ASSERT_EQUAL_HEX8(0x60, g_srq_status);
+
+    USBTMC_task();
+    TEST_ASSERT_EQUAL_UINT32(1, g_srq_count);
+}
+
+void test_USBTMC_clear_discards_response(void)
+{
+    host_send("*IDN?", true);
+    USBTMC_write_all((uint8_t const *)"FOSSASIA,", 9, WRITE_TIMEOUT_MS);
+
+    g_callbacks.clear(USB_BUS_0, true, true);
+    TEST_ASSERT_EQUAL_UINT32(0, USBTMC_rx_available());
+
+    // The rest of the cleared response is dropped as well
+    USBTMC_write_all((uint8_t const *)"PSLab\r\n", 7, WRITE_TIMEOUT_MS);
+    USBTMC_end_message();
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&g_tx_buffer));
+
+    // The next response is sent normally
+    USBTMC_write_all((uint8_t const *)"0\n", 2, WRITE_TIMEOUT_MS);
+    USBTMC_end_message();
+    host_request(HOST_REQUEST_SIZE);
+    host_complete();
+    TEST_ASSERT_EQUAL_UINT32(2, g_host_count);
+    TEST_ASSERT_EQUAL_MEMORY("0\n", g_host_data, 2);
+}